@@ -0,0 +1,567 @@
+#include <semLib.h>
+#include <taskLib.h>
+#include <sys/stat.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#include "../lib/util/isDebug.h"
+#include "../lib/util/isClock.h"
+#include "../lib/util/isHash.h"
+#include "AssetCache.h"
+
+#define ASSET_CACHE_INDEX_FILE		ASSET_CACHE_DIR "/index"
+#define ASSET_CACHE_INDEX_TMP_FILE	ASSET_CACHE_DIR "/index.tmp"
+#define ASSET_CACHE_FETCH_TMP_FMT	ASSET_CACHE_DIR "/fetch%lX.tmp"	/* one per fetching task */
+#define ASSET_CACHE_COPY_SIZE		(0x00010000)
+
+typedef struct {
+	char	szNetPath[ASSET_CACHE_PATH_LEN];
+	int		size;
+	long	mtime;
+	UINT64	hash;
+	UINT32	lastUse;
+	UINT32	numHits;
+	UINT32	fetchUs;
+} AssetEntry;
+
+/* A content file handed out by resolve() and not yet released. */
+typedef struct {
+	UINT64	hash;
+	int		numRefs;
+} AssetPin;
+
+typedef struct {
+	SEM_ID		sidLock;
+	int			numEntries;
+	AssetEntry	entries[ASSET_CACHE_MAX_ENTRIES];
+	AssetPin	pins[ASSET_CACHE_MAX_PINS];
+	UINT32		useSeq;
+	UINT32		numHits;
+	UINT32		numMisses;
+	UINT32		numErrors;
+} AssetCacheInst;
+
+LOCAL AssetCacheInst g_stAssetCache;
+
+LOCAL void contentPath(UINT64 hash, char *szPath, int pathLen) {
+	snprintf(szPath, pathLen, ASSET_CACHE_DIR "/%08lX%08lX",
+			 (unsigned long)(hash >> 32), (unsigned long)(hash & 0xFFFFFFFFU));
+}
+
+LOCAL AssetEntry *findEntry(const char *szNetPath) {
+	int i;
+	
+	for (i = 0; i < g_stAssetCache.numEntries; i++) {
+		if (strcmp(g_stAssetCache.entries[i].szNetPath, szNetPath) == 0)
+			return &g_stAssetCache.entries[i];
+	}
+	
+	return NULL;
+}
+
+LOCAL AssetPin *findPin(UINT64 hash) {
+	int i;
+	
+	for (i = 0; i < ASSET_CACHE_MAX_PINS; i++) {
+		if ((g_stAssetCache.pins[i].numRefs > 0) && (g_stAssetCache.pins[i].hash == hash))
+			return &g_stAssetCache.pins[i];
+	}
+	
+	return NULL;
+}
+
+/* ERROR when all pins are in use; the caller then reads the network file. */
+LOCAL STATUS pinLocked(UINT64 hash) {
+	AssetPin *pPin = findPin(hash);
+	int i;
+	
+	if (pPin == NULL) {
+		for (i = 0; i < ASSET_CACHE_MAX_PINS; i++) {
+			if (g_stAssetCache.pins[i].numRefs == 0) {
+				pPin = &g_stAssetCache.pins[i];
+				pPin->hash = hash;
+				break;
+			}
+		}
+		if (pPin == NULL)
+			return ERROR;
+	}
+	
+	pPin->numRefs++;
+	
+	return OK;
+}
+
+/*
+ * Removes the content file unless another entry still points at it or
+ * it is pinned; unpinLocked() retries once the last pin goes.
+ */
+LOCAL void releaseContent(UINT64 hash) {
+	char szPath[ASSET_CACHE_PATH_LEN];
+	int i;
+	
+	for (i = 0; i < g_stAssetCache.numEntries; i++) {
+		if (g_stAssetCache.entries[i].hash == hash)
+			return;
+	}
+	
+	if (findPin(hash) != NULL)
+		return;
+	
+	contentPath(hash, szPath, sizeof(szPath));
+	remove(szPath);
+}
+
+LOCAL void unpinLocked(UINT64 hash) {
+	AssetPin *pPin = findPin(hash);
+	
+	if ((pPin != NULL) && (--pPin->numRefs == 0))
+		releaseContent(hash);
+}
+
+LOCAL void dropEntry(AssetEntry *pEntry) {
+	UINT64 hash = pEntry->hash;
+	
+	*pEntry = g_stAssetCache.entries[--g_stAssetCache.numEntries];
+	releaseContent(hash);
+}
+
+LOCAL void loadIndex(void) {
+	FILE *fpFile;
+	AssetEntry *pEntry;
+	unsigned long hashHi, hashLo;
+	char szPath[ASSET_CACHE_PATH_LEN];
+	struct stat st;
+	
+	if ((fpFile = fopen(ASSET_CACHE_INDEX_FILE, "r")) == NULL)
+		return;
+	
+	while (g_stAssetCache.numEntries < ASSET_CACHE_MAX_ENTRIES) {
+		pEntry = &g_stAssetCache.entries[g_stAssetCache.numEntries];
+		memset(pEntry, 0, sizeof(AssetEntry));
+		
+		if (fscanf(fpFile, "%d %ld %8lX%8lX %127s", &pEntry->size, &pEntry->mtime,
+				   &hashHi, &hashLo, pEntry->szNetPath) != 5)
+			break;
+		pEntry->hash = ((UINT64)hashHi << 32) | hashLo;
+		
+		/* Keep only entries whose content survived. */
+		contentPath(pEntry->hash, szPath, sizeof(szPath));
+		if ((stat(szPath, &st) == 0) && (st.st_size == pEntry->size))
+			g_stAssetCache.numEntries++;
+	}
+	
+	fclose(fpFile);
+}
+
+LOCAL void saveIndex(void) {
+	FILE *fpFile;
+	const AssetEntry *pEntry;
+	int i;
+	
+	if ((fpFile = fopen(ASSET_CACHE_INDEX_TMP_FILE, "w")) == NULL) {
+		LOGMSG("fopen(%s) error!\n", ASSET_CACHE_INDEX_TMP_FILE);
+		return;
+	}
+	
+	for (i = 0; i < g_stAssetCache.numEntries; i++) {
+		pEntry = &g_stAssetCache.entries[i];
+		fprintf(fpFile, "%d %ld %08lX%08lX %s\n", pEntry->size, pEntry->mtime,
+				(unsigned long)(pEntry->hash >> 32),
+				(unsigned long)(pEntry->hash & 0xFFFFFFFFU), pEntry->szNetPath);
+	}
+	
+	if (fclose(fpFile) == EOF) {
+		LOGMSG("fclose(%s) error!\n", ASSET_CACHE_INDEX_TMP_FILE);
+		return;
+	}
+	
+	remove(ASSET_CACHE_INDEX_FILE);
+	rename(ASSET_CACHE_INDEX_TMP_FILE, ASSET_CACHE_INDEX_FILE);
+}
+
+/* Hashes the cached copy at szPath, for a hit that must be verified. */
+LOCAL STATUS hashFile(const char *szPath, UINT64 *pHash) {
+	FILE *fpFile;
+	char *pBuf;
+	int nReadBytes;
+	UINT64 hash = IS_HASH_FNV64_OFFSET;
+	STATUS nRet = OK;
+	
+	if ((pBuf = (char *)malloc(ASSET_CACHE_COPY_SIZE)) == NULL) {
+		LOGMSG("malloc(%d) error!\n", ASSET_CACHE_COPY_SIZE);
+		return ERROR;
+	}
+	
+	if ((fpFile = fopen(szPath, "rb")) == NULL) {
+		free(pBuf);
+		return ERROR;
+	}
+	
+	while ((nReadBytes = fread(pBuf, 1, ASSET_CACHE_COPY_SIZE, fpFile)) > 0) {
+		hash = isHashFnv1a64(hash, pBuf, nReadBytes);
+	}
+	
+	if (ferror(fpFile))
+		nRet = ERROR;
+	fclose(fpFile);
+	free(pBuf);
+	
+	*pHash = hash;
+	
+	return nRet;
+}
+
+/*
+ * Copies szNetPath into szTmp, a file of the calling task, hashing it on
+ * the way through. Runs without sidLock; publishLocked() then moves the
+ * copy to its content path.
+ */
+LOCAL STATUS copyIn(const char *szNetPath, int size, const char *szTmp, UINT64 *pHash) {
+	FILE *fpSrc, *fpDst;
+	char *pBuf;
+	int nReadBytes, total = 0;
+	UINT64 hash = IS_HASH_FNV64_OFFSET;
+	STATUS nRet = OK;
+	
+	if ((pBuf = (char *)malloc(ASSET_CACHE_COPY_SIZE)) == NULL) {
+		LOGMSG("malloc(%d) error!\n", ASSET_CACHE_COPY_SIZE);
+		return ERROR;
+	}
+	
+	if ((fpSrc = fopen(szNetPath, "rb")) == NULL) {
+		LOGMSG("fopen(%s) error!\n", szNetPath);
+		free(pBuf);
+		return ERROR;
+	}
+	
+	if ((fpDst = fopen(szTmp, "wb")) == NULL) {
+		LOGMSG("fopen(%s) error!\n", szTmp);
+		fclose(fpSrc);
+		free(pBuf);
+		return ERROR;
+	}
+	
+	while ((nReadBytes = fread(pBuf, 1, ASSET_CACHE_COPY_SIZE, fpSrc)) > 0) {
+		if (fwrite(pBuf, 1, nReadBytes, fpDst) != nReadBytes) {
+			LOGMSG("fwrite(%s) error!\n", szTmp);
+			nRet = ERROR;
+			break;
+		}
+		hash = isHashFnv1a64(hash, pBuf, nReadBytes);
+		total += nReadBytes;
+	}
+	
+	if (ferror(fpSrc)) {
+		LOGMSG("fread(%s) error!\n", szNetPath);
+		nRet = ERROR;
+	}
+	fclose(fpSrc);
+	if (fclose(fpDst) == EOF)
+		nRet = ERROR;
+	free(pBuf);
+	
+	/* The file changed under us; try again on the next resolve. */
+	if ((nRet == OK) && (total != size)) {
+		LOGMSG("%s : %d bytes read, %d expected.\n", szNetPath, total, size);
+		nRet = ERROR;
+	}
+	
+	if (nRet == ERROR) {
+		remove(szTmp);
+		return ERROR;
+	}
+	
+	*pHash = hash;
+	
+	return OK;
+}
+
+/*
+ * Called with sidLock held: moves the copy in szTmp to the content path
+ * of hash. A pinned content file is being read, so it is kept and the
+ * copy dropped, as both have the same hash; unless isBad, when the pinned
+ * file is the damaged one and the copy cannot be published.
+ */
+LOCAL STATUS publishLocked(const char *szTmp, UINT64 hash, BOOL isBad) {
+	char szPath[ASSET_CACHE_PATH_LEN];
+	
+	if (findPin(hash) != NULL) {
+		remove(szTmp);
+		return isBad ? ERROR : OK;
+	}
+	
+	contentPath(hash, szPath, sizeof(szPath));
+	remove(szPath);
+	if (rename(szTmp, szPath) != 0) {
+		LOGMSG("rename(%s) error!\n", szPath);
+		remove(szTmp);
+		return ERROR;
+	}
+	
+	return OK;
+}
+
+/*
+ * Called with sidLock held, once copyIn() stored hash for szNetPath.
+ * Another task may have installed the path meanwhile; the later copy wins.
+ */
+LOCAL void installLocked(const char *szNetPath, const struct stat *pNetSt, UINT64 hash,
+						 UINT32 fetchUs) {
+	AssetEntry *pEntry = findEntry(szNetPath);
+	AssetEntry *pCand;
+	BOOL isPinned, isCandPinned;
+	UINT64 oldHash;
+	int i;
+	
+	/*
+	 * Reuse the stale entry, else a free one, else the least recently used,
+	 * preferring one not pinned. releaseContent() keeps a pinned file anyway.
+	 */
+	if (pEntry == NULL) {
+		if (g_stAssetCache.numEntries < ASSET_CACHE_MAX_ENTRIES) {
+			pEntry = &g_stAssetCache.entries[g_stAssetCache.numEntries++];
+			pEntry->hash = hash;
+		} else {
+			pEntry = &g_stAssetCache.entries[0];
+			for (i = 1; i < g_stAssetCache.numEntries; i++) {
+				pCand = &g_stAssetCache.entries[i];
+				isPinned = (findPin(pEntry->hash) != NULL);
+				isCandPinned = (findPin(pCand->hash) != NULL);
+				if ((isPinned && !isCandPinned) ||
+					((isPinned == isCandPinned) && (pCand->lastUse < pEntry->lastUse)))
+					pEntry = pCand;
+			}
+		}
+	}
+	
+	oldHash = pEntry->hash;
+	memset(pEntry, 0, sizeof(AssetEntry));
+	strncpy(pEntry->szNetPath, szNetPath, sizeof(pEntry->szNetPath) - 1);
+	pEntry->size = (int)pNetSt->st_size;
+	pEntry->mtime = (long)pNetSt->st_mtime;
+	pEntry->hash = hash;
+	pEntry->lastUse = ++g_stAssetCache.useSeq;
+	pEntry->fetchUs = fetchUs;
+	
+	if (oldHash != hash)
+		releaseContent(oldHash);
+	
+	saveIndex();
+}
+
+/*
+ * Leaves the cached content path in szPath, pinned. sidLock is only held
+ * to read and update the index, never across the network copy or a
+ * verification. With isVerify a hit also needs the cached copy to hash to
+ * the hash it was stored under; one that does not is fetched again.
+ */
+LOCAL STATUS resolve(const char *szNetPath, const struct stat *pNetSt, BOOL isVerify,
+					 char *szPath, int pathLen, BOOL *pIsHit) {
+	AssetEntry *pEntry;
+	struct stat st;
+	UINT64 hash, fileHash, tStart;
+	char szTmp[ASSET_CACHE_PATH_LEN];
+	BOOL isCached = FALSE, isBad = FALSE;
+	STATUS nRet;
+	
+	*pIsHit = FALSE;
+	
+	semTake(g_stAssetCache.sidLock, WAIT_FOREVER);
+	pEntry = findEntry(szNetPath);
+	if ((pEntry != NULL) && (pEntry->size == (int)pNetSt->st_size) &&
+		(pEntry->mtime == (long)pNetSt->st_mtime)) {
+		hash = pEntry->hash;
+		isCached = (pinLocked(hash) == OK);
+	}
+	semGive(g_stAssetCache.sidLock);
+	
+	if (isCached) {
+		contentPath(hash, szPath, pathLen);
+		if ((stat(szPath, &st) != 0) || (st.st_size != pNetSt->st_size)) {
+			isBad = TRUE;
+		} else if (isVerify &&
+				   ((hashFile(szPath, &fileHash) == ERROR) || (fileHash != hash))) {
+			LOGMSG("%s : cached copy does not match its hash, fetching again.\n", szNetPath);
+			isBad = TRUE;
+		}
+	}
+	
+	/* Let go of the bad copy before the fetch replaces it. */
+	if (isCached && isBad) {
+		semTake(g_stAssetCache.sidLock, WAIT_FOREVER);
+		unpinLocked(hash);
+		semGive(g_stAssetCache.sidLock);
+		isCached = FALSE;
+	}
+	
+	if (isCached) {
+		semTake(g_stAssetCache.sidLock, WAIT_FOREVER);
+		if (((pEntry = findEntry(szNetPath)) != NULL) && (pEntry->hash == hash)) {
+			pEntry->lastUse = ++g_stAssetCache.useSeq;
+			pEntry->numHits++;
+		}
+		g_stAssetCache.numHits++;
+		semGive(g_stAssetCache.sidLock);
+		
+		*pIsHit = TRUE;
+		return OK;
+	}
+	
+	tStart = isClockNs();
+	snprintf(szTmp, sizeof(szTmp), ASSET_CACHE_FETCH_TMP_FMT, (unsigned long)taskIdSelf());
+	if (copyIn(szNetPath, (int)pNetSt->st_size, szTmp, &hash) == ERROR) {
+		semTake(g_stAssetCache.sidLock, WAIT_FOREVER);
+		g_stAssetCache.numMisses++;
+		g_stAssetCache.numErrors++;
+		semGive(g_stAssetCache.sidLock);
+		return ERROR;
+	}
+	
+	semTake(g_stAssetCache.sidLock, WAIT_FOREVER);
+	g_stAssetCache.numMisses++;
+	if ((nRet = publishLocked(szTmp, hash, isBad)) == OK) {
+		installLocked(szNetPath, pNetSt, hash, isClockNsToUs(isClockNs() - tStart));
+		nRet = pinLocked(hash);
+	} else {
+		g_stAssetCache.numErrors++;
+	}
+	semGive(g_stAssetCache.sidLock);
+	
+	contentPath(hash, szPath, pathLen);
+	
+	return nRet;
+}
+
+STATUS AssetCacheInit(void) {
+	if (g_stAssetCache.sidLock != SEM_ID_NULL)
+		return OK;
+	
+	if ((mkdir(ASSET_CACHE_DIR, 0777) != 0) && (errno != EEXIST)) {
+		LOGMSG("mkdir(%s) error! Asset cache disabled.\n", ASSET_CACHE_DIR);
+		return OK;
+	}
+	
+	g_stAssetCache.sidLock = semMCreate(SEM_Q_PRIORITY | SEM_DELETE_SAFE | SEM_INVERSION_SAFE);
+	if (g_stAssetCache.sidLock == SEM_ID_NULL) {
+		LOGMSG("semMCreate() error!\n");
+		return ERROR;
+	}
+	
+	loadIndex();
+	
+	return OK;
+}
+
+LOCAL STATUS resolvePath(const char *szNetPath, BOOL isVerify, char *szPath, int pathLen) {
+	struct stat st;
+	BOOL isHit;
+	
+	if ((g_stAssetCache.sidLock == SEM_ID_NULL) || (stat(szNetPath, &st) != 0) ||
+		(resolve(szNetPath, &st, isVerify, szPath, pathLen, &isHit) == ERROR))
+		snprintf(szPath, pathLen, "%s", szNetPath);
+	
+	return OK;
+}
+
+/*
+ * Puts the path to open for szNetPath into szPath: the cached copy, or
+ * szNetPath itself when the cache is disabled or the fetch failed. Hand
+ * szPath to AssetCacheRelease() once the file is closed.
+ */
+STATUS AssetCacheResolve(const char *szNetPath, char *szPath, int pathLen) {
+	return resolvePath(szNetPath, FALSE, szPath, pathLen);
+}
+
+/*
+ * AssetCacheResolve() for files that must not come from a damaged copy,
+ * such as an image to install: a hit reads the cached copy once more to
+ * check its hash.
+ */
+STATUS AssetCacheResolveVerified(const char *szNetPath, char *szPath, int pathLen) {
+	return resolvePath(szNetPath, TRUE, szPath, pathLen);
+}
+
+/* Unpins the copy AssetCacheResolve() put in szPath, if it was one. */
+void AssetCacheRelease(const char *szPath) {
+	char szPinPath[ASSET_CACHE_PATH_LEN];
+	int i;
+	
+	if (g_stAssetCache.sidLock == SEM_ID_NULL)
+		return;
+	
+	semTake(g_stAssetCache.sidLock, WAIT_FOREVER);
+	for (i = 0; i < ASSET_CACHE_MAX_PINS; i++) {
+		if (g_stAssetCache.pins[i].numRefs == 0)
+			continue;
+		contentPath(g_stAssetCache.pins[i].hash, szPinPath, sizeof(szPinPath));
+		if (strcmp(szPinPath, szPath) == 0) {
+			unpinLocked(g_stAssetCache.pins[i].hash);
+			break;
+		}
+	}
+	semGive(g_stAssetCache.sidLock);
+}
+
+/* Warms the cache for szNetPath; ERROR when it cannot be cached. */
+STATUS AssetCacheFetch(const char *szNetPath, BOOL *pIsHit) {
+	char szPath[ASSET_CACHE_PATH_LEN];
+	struct stat st;
+	STATUS nRet;
+	
+	*pIsHit = FALSE;
+	
+	if (g_stAssetCache.sidLock == SEM_ID_NULL)
+		return ERROR;
+	
+	if (stat(szNetPath, &st) != 0) {
+		LOGMSG("stat(%s) error!\n", szNetPath);
+		return ERROR;
+	}
+	
+	if ((nRet = resolve(szNetPath, &st, FALSE, szPath, sizeof(szPath), pIsHit)) == OK)
+		AssetCacheRelease(szPath);
+	
+	return nRet;
+}
+
+void AssetCacheInvalidate(const char *szNetPath) {
+	AssetEntry *pEntry;
+	
+	if (g_stAssetCache.sidLock == SEM_ID_NULL)
+		return;
+	
+	semTake(g_stAssetCache.sidLock, WAIT_FOREVER);
+	if ((pEntry = findEntry(szNetPath)) != NULL) {
+		dropEntry(pEntry);
+		saveIndex();
+	}
+	semGive(g_stAssetCache.sidLock);
+}
+
+void assetCacheShow(void) {
+	const AssetEntry *pEntry;
+	int i;
+	
+	if (g_stAssetCache.sidLock == SEM_ID_NULL) {
+		printf("\n asset cache is disabled.\n");
+		return;
+	}
+	
+	semTake(g_stAssetCache.sidLock, WAIT_FOREVER);
+	
+	printf("\n %-32s %10s %16s %6s %10s", "File", "Bytes", "Hash", "Hits", "Fetch(us)");
+	for (i = 0; i < g_stAssetCache.numEntries; i++) {
+		pEntry = &g_stAssetCache.entries[i];
+		printf("\n %-32s %10d %08lX%08lX %6u %10u", pEntry->szNetPath, pEntry->size,
+			   (unsigned long)(pEntry->hash >> 32),
+			   (unsigned long)(pEntry->hash & 0xFFFFFFFFU),
+			   pEntry->numHits, pEntry->fetchUs);
+	}
+	printf("\n hit %u, miss %u, error %u\n",
+		   g_stAssetCache.numHits, g_stAssetCache.numMisses, g_stAssetCache.numErrors);
+	
+	semGive(g_stAssetCache.sidLock);
+}
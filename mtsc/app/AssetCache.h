@@ -0,0 +1,26 @@
+#pragma once
+
+#include <vxWorks.h>
+
+/*
+ * Local copies of test assets from NET_DEV_REPO_NAME. An entry is valid
+ * while the network file keeps the size and mtime it had when fetched;
+ * the copy is stored under its 64-bit content hash, so one stat() of the
+ * network path is all a hit costs. AssetCacheResolveVerified() also
+ * re-hashes the copy before trusting it.
+ *
+ * A resolved copy is pinned until AssetCacheRelease(): it is neither
+ * replaced by a fetch nor removed by eviction while the caller reads it.
+ */
+#define ASSET_CACHE_DIR				"/mmc1/cache"
+#define ASSET_CACHE_MAX_ENTRIES		(16)
+#define ASSET_CACHE_PATH_LEN		(128)
+#define ASSET_CACHE_MAX_PINS		(8)
+
+IMPORT STATUS	AssetCacheInit(void);
+IMPORT STATUS	AssetCacheResolve(const char *szNetPath, char *szPath, int pathLen);
+IMPORT STATUS	AssetCacheResolveVerified(const char *szNetPath, char *szPath, int pathLen);
+IMPORT void		AssetCacheRelease(const char *szPath);
+IMPORT STATUS	AssetCacheFetch(const char *szNetPath, BOOL *pIsHit);
+IMPORT void		AssetCacheInvalidate(const char *szNetPath);
+IMPORT void		assetCacheShow(void);
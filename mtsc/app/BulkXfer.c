@@ -0,0 +1,340 @@
+#include <semLib.h>
+#include <vxAtomicLib.h>
+#include <inetLib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "../lib/util/isDebug.h"
+#include "../lib/util/isClock.h"
+#include "common.h"
+#include "SdlcSendGcu.h"
+#include "GcuUnit.h"
+#include "BulkXfer.h"
+
+typedef struct {
+	int		blockIdx;
+	int		msgIdx;			/* txMsg[] the block is posted from */
+	int		retry;
+	UINT64	tSent;
+} BulkXferSlot;
+
+/*
+ * One transfer per unit, claimed by the run that swaps isActive from 0.
+ * Each block in flight is posted from its own txMsg, which is not reused
+ * before the block is acknowledged.
+ */
+typedef struct {
+	atomic32_t			isActive;
+	const ModuleInst *	hSend;
+	volatile int		firstBlock;
+	volatile int		numBlocks;
+	volatile UINT32		ackMap[BULK_XFER_BITMAP_WORDS];
+	volatile int		numDupAcks;
+	SEM_ID				sidAck;
+	SdlcSendGcuMsg		txMsg[BULK_XFER_MAX_WINDOW];
+	char				szName[32];
+	BulkXferResult		last;
+} BulkXferInst;
+
+LOCAL BulkXferInst g_stBulkXfer[GCU_UNIT_MAX];
+
+#define ACK_TEST(pXfer, blk)	((pXfer)->ackMap[(blk) >> 5] & (1U << ((blk) & 31)))
+#define DONE_TEST(pResume, blk)	((pResume)->doneMap[(blk) >> 5] & (1U << ((blk) & 31)))
+
+void BulkXferCfgInit(BulkXferCfg *pCfg, const char *szName,
+					 const void *pData, int numBytes, UINT16 opcode) {
+	memset(pCfg, 0, sizeof(BulkXferCfg));
+	
+	pCfg->szName = szName;
+	pCfg->pData = (const UINT16 *)pData;
+	pCfg->numBytes = numBytes;
+	pCfg->opcode = opcode;
+	pCfg->window = BULK_XFER_DEF_WINDOW;
+	pCfg->timeoutMs = BULK_XFER_DEF_TIMEOUT_MS;
+	pCfg->maxRetry = BULK_XFER_DEF_RETRY;
+}
+
+/*
+ * Called by tSdlcRecvGcu of the unit for each FG3-3 response. Block n
+ * goes out with m_IDX firstBlock + n + 1; index 0 is the header frame and
+ * is not tracked here.
+ */
+void BulkXferAck(int unit, INT16 idx) {
+	BulkXferInst *pXfer;
+	int blk;
+	UINT32 bit;
+	
+	if ((unit < 0) || (unit >= GCU_UNIT_MAX))
+		return;
+	
+	pXfer = &g_stBulkXfer[unit];
+	blk = (int)idx - 1 - pXfer->firstBlock;
+	
+	if (!vxAtomic32Get(&pXfer->isActive) || (blk < 0) || (blk >= pXfer->numBlocks))
+		return;
+	
+	bit = 1U << (blk & 31);
+	if (pXfer->ackMap[blk >> 5] & bit) {
+		pXfer->numDupAcks++;
+		return;
+	}
+	
+	pXfer->ackMap[blk >> 5] |= bit;
+	semGive(pXfer->sidAck);
+}
+
+void BulkXferResumeReset(BulkXferResume *pResume, UINT32 imageCrc, int numBlocks) {
+	memset(pResume, 0, sizeof(BulkXferResume));
+	
+	pResume->imageCrc = imageCrc;
+	pResume->numBlocks = numBlocks;
+}
+
+/* First block not yet acknowledged, or numBlocks when all are. */
+int BulkXferResumeFirst(const BulkXferResume *pResume) {
+	int blk;
+	
+	for (blk = 0; blk < pResume->numBlocks; blk++) {
+		if (!DONE_TEST(pResume, blk))
+			break;
+	}
+	
+	return blk;
+}
+
+LOCAL void markDone(BulkXferResume *pResume, int blk) {
+	if ((pResume == NULL) || (blk >= pResume->numBlocks) || DONE_TEST(pResume, blk))
+		return;
+	
+	pResume->doneMap[blk >> 5] |= 1U << (blk & 31);
+	pResume->numDone++;
+}
+
+/* Frames go to SdlcSendGcu already in wire (big-endian) order. */
+LOCAL STATUS sendBlock(BulkXferInst *pXfer, const BulkXferCfg *pCfg, int blk, int msgIdx) {
+	SdlcSendGcuMsg *pMsg = &pXfer->txMsg[msgIdx];
+	const UINT16 *pSrc = pCfg->pData + (blk * BULK_XFER_WORDS_PER_BLOCK);
+	int numWords = (pCfg->numBytes / 2) - (blk * BULK_XFER_WORDS_PER_BLOCK);
+	int k;
+	
+	if (numWords > BULK_XFER_WORDS_PER_BLOCK)
+		numWords = BULK_XFER_WORDS_PER_BLOCK;
+	
+	memset(&pMsg->body.sdlcTx.fg3.fg3_3, 0, sizeof(pMsg->body.sdlcTx.fg3.fg3_3));
+	
+	pMsg->cmd = SDLC_SEND_GCU_TX;
+	pMsg->len = sizeof(pMsg->body.sdlcTx.fg3.fg3_3);
+	pMsg->body.sdlcTx.fg3.fg3_3.m_ADDRESS = TM_SDLC_ADDRESS;
+	pMsg->body.sdlcTx.fg3.fg3_3.m_CONTROL = TM_FG3_SDLC_CONTROL;
+	pMsg->body.sdlcTx.fg3.fg3_3.m_OPCODE = htons(pCfg->opcode);
+	pMsg->body.sdlcTx.fg3.fg3_3.m_IDX = htons((UINT16)(pCfg->firstBlock + blk + 1));
+	
+	for (k = 0; k < numWords; k++)
+		pMsg->body.sdlcTx.fg3.fg3_3.m_DATA[k] = htons(pSrc[k]);
+	
+	return PostCmdEx(pXfer->hSend, pMsg);
+}
+
+LOCAL int expiredMs(UINT64 tSent, UINT64 tNow) {
+	return (int)((tNow - tSent) / (IS_CLOCK_NS_PER_US * 1000));
+}
+
+/*
+ * Sends pCfg->numBytes from pCfg->pData and returns once every block is
+ * acknowledged. Returns ERROR when a block runs out of retries, when a
+ * post to SdlcSendGcu fails or when pfnCancelled reports a cancel;
+ * pResult holds the counters either way.
+ */
+STATUS BulkXferRun(const BulkXferCfg *pCfg, BulkXferResult *pResult) {
+	BulkXferInst *pXfer;
+	BulkXferSlot slots[BULK_XFER_MAX_WINDOW];
+	int freeMsg[BULK_XFER_MAX_WINDOW];
+	int numSlots = 0;
+	int window = pCfg->window;
+	int numBlocks = ((pCfg->numBytes / 2) + BULK_XFER_WORDS_PER_BLOCK - 1) /
+					BULK_XFER_WORDS_PER_BLOCK;
+	int nextBlk = 0;
+	int totalBlocks;
+	int waitTick, waitMs;
+	UINT64 tStart, tNow;
+	const GcuUnit *pUnit = GcuUnitGet(pCfg->unit);
+	STATUS nRet = OK;
+	int i;
+	
+	memset(pResult, 0, sizeof(BulkXferResult));
+	pResult->numBlocks = numBlocks;
+	
+	if ((numBlocks <= 0) || (numBlocks > BULK_XFER_MAX_BLOCKS)) {
+		LOGMSG("[%s] Invalid size. (%d bytes)\n", pCfg->szName, pCfg->numBytes);
+		return ERROR;
+	}
+	
+	if ((pUnit == NULL) || (pUnit->hSend == NULL)) {
+		LOGMSG("[%s] GCU unit %d has no SdlcSendGcu.\n", pCfg->szName, pCfg->unit);
+		return ERROR;
+	}
+	
+	pXfer = &g_stBulkXfer[pCfg->unit];
+	
+	if (vxAtomic32Cas(&pXfer->isActive, FALSE, TRUE) == FALSE) {
+		LOGMSG("[%s] %s is in progress on unit %d.\n", pCfg->szName, pXfer->szName,
+			   pCfg->unit);
+		return ERROR;
+	}
+	
+	/* Only the run that holds isActive gets here, so this cannot race. */
+	if (pXfer->sidAck == SEM_ID_NULL) {
+		pXfer->sidAck = semCCreate(SEM_Q_FIFO, 0);
+		if (pXfer->sidAck == SEM_ID_NULL) {
+			LOGMSG("semCCreate() error!\n");
+			vxAtomic32Set(&pXfer->isActive, FALSE);
+			return ERROR;
+		}
+	}
+	
+	totalBlocks = (pCfg->totalBlocks > 0) ? pCfg->totalBlocks : numBlocks;
+	
+	if (window < 1)
+		window = 1;
+	if (window > BULK_XFER_MAX_WINDOW)
+		window = BULK_XFER_MAX_WINDOW;
+	
+	for (i = 0; i < window; i++)
+		freeMsg[i] = i;
+	
+	/* BulkXferAck() ignores the unit until numBlocks is set again. */
+	pXfer->numBlocks = 0;
+	VX_MEM_BARRIER_W();
+	while (semTake(pXfer->sidAck, NO_WAIT) == OK)
+		;
+	memset((void *)pXfer->ackMap, 0, sizeof(pXfer->ackMap));
+	pXfer->numDupAcks = 0;
+	pXfer->firstBlock = pCfg->firstBlock;
+	pXfer->hSend = pUnit->hSend;
+	strncpy(pXfer->szName, pCfg->szName, sizeof(pXfer->szName) - 1);
+	VX_MEM_BARRIER_W();
+	pXfer->numBlocks = numBlocks;
+	
+	tStart = isClockNs();
+	
+	while (pResult->numAcked < numBlocks) {
+		if ((pCfg->pfnCancelled != NULL) && pCfg->pfnCancelled()) {
+			nRet = ERROR;
+			break;
+		}
+		
+		/* Retire acknowledged blocks; the oldest slot keeps the window base. */
+		for (i = 0; i < numSlots; ) {
+			if (ACK_TEST(pXfer, slots[i].blockIdx)) {
+				markDone(pCfg->pResume, pCfg->firstBlock + slots[i].blockIdx);
+				pResult->numAcked++;
+				freeMsg[window - numSlots] = slots[i].msgIdx;
+				slots[i] = slots[--numSlots];
+			} else {
+				i++;
+			}
+		}
+		
+		if (pCfg->pfnProgress != NULL) {
+			pCfg->pfnProgress(pCfg->progressArg,
+							  (pCfg->pResume != NULL) ? pCfg->pResume->numDone :
+														pCfg->firstBlock + pResult->numAcked,
+							  totalBlocks);
+		}
+		
+		if (pResult->numAcked >= numBlocks)
+			break;
+		
+		/* Selective retransmit of the blocks whose ack is overdue. */
+		tNow = isClockNs();
+		for (i = 0; i < numSlots; i++) {
+			if (expiredMs(slots[i].tSent, tNow) < pCfg->timeoutMs)
+				continue;
+			
+			if (slots[i].retry >= pCfg->maxRetry) {
+				LOGMSG("[%s] IDX(%d) Data No Ack.\n", pCfg->szName,
+					   pCfg->firstBlock + slots[i].blockIdx + 1);
+				nRet = ERROR;
+				break;
+			}
+			
+			if (sendBlock(pXfer, pCfg, slots[i].blockIdx, slots[i].msgIdx) == ERROR) {
+				nRet = ERROR;
+				break;
+			}
+			slots[i].retry++;
+			slots[i].tSent = tNow;
+			pResult->numRetx++;
+			pResult->numSent++;
+		}
+		if (nRet == ERROR)
+			break;
+		
+		while ((numSlots < window) && (nextBlk < numBlocks)) {
+			if ((pCfg->pResume != NULL) && DONE_TEST(pCfg->pResume, pCfg->firstBlock + nextBlk)) {
+				nextBlk++;
+				pResult->numAcked++;
+				pResult->numSkipped++;
+				continue;
+			}
+			
+			slots[numSlots].msgIdx = freeMsg[window - numSlots - 1];
+			if (sendBlock(pXfer, pCfg, nextBlk, slots[numSlots].msgIdx) == ERROR) {
+				LOGMSG("[%s] PostCmdEx(IDX = %d) error!\n", pCfg->szName,
+					   pCfg->firstBlock + nextBlk + 1);
+				nRet = ERROR;
+				break;
+			}
+			slots[numSlots].blockIdx = nextBlk++;
+			slots[numSlots].retry = 0;
+			slots[numSlots].tSent = isClockNs();
+			numSlots++;
+			pResult->numSent++;
+		}
+		if ((nRet == ERROR) || (pResult->numAcked >= numBlocks))
+			break;
+		
+		/* Sleep until the next ack or the oldest deadline, whichever first. */
+		tNow = isClockNs();
+		waitMs = pCfg->timeoutMs;
+		for (i = 0; i < numSlots; i++) {
+			if ((pCfg->timeoutMs - expiredMs(slots[i].tSent, tNow)) < waitMs)
+				waitMs = pCfg->timeoutMs - expiredMs(slots[i].tSent, tNow);
+		}
+		waitTick = GET_DELAY_TICK((waitMs > 0) ? waitMs : 0);
+		semTake(pXfer->sidAck, (waitTick > 0) ? waitTick : 1);
+	}
+	
+	pResult->numDupAcks = pXfer->numDupAcks;
+	pResult->elapsedUs = isClockNsToUs(isClockNs() - tStart);
+	if (pResult->elapsedUs > 0) {
+		pResult->bytesPerSec = (UINT32)(((UINT64)(pResult->numAcked - pResult->numSkipped) *
+										 BULK_XFER_WORDS_PER_BLOCK * 2 *
+										 1000000) / pResult->elapsedUs);
+	}
+	
+	pXfer->last = *pResult;
+	vxAtomic32Set(&pXfer->isActive, FALSE);
+	
+	return nRet;
+}
+
+void bulkXferShow(int unit) {
+	const BulkXferInst *pXfer;
+	const BulkXferResult *pLast;
+	
+	if ((unit < 0) || (unit >= GCU_UNIT_MAX))
+		return;
+	
+	pXfer = &g_stBulkXfer[unit];
+	pLast = &pXfer->last;
+	
+	printf("\n transfer   : %s@%d%s", pXfer->szName, unit,
+		   pXfer->isActive ? " (active)" : "");
+	printf("\n blocks     : %d / %d acked (%d resumed)", pLast->numAcked, pLast->numBlocks,
+		   pLast->numSkipped);
+	printf("\n sent       : %d (retransmit %d, dup. ack %d)",
+		   pLast->numSent, pLast->numRetx, pLast->numDupAcks);
+	printf("\n elapsed    : %u us", pLast->elapsedUs);
+	printf("\n throughput : %u bytes/s\n", pLast->bytesPerSec);
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <vxWorks.h>
+
+/*
+ * Windowed FG3-3 block transfer to the GCU. Up to window blocks are in
+ * flight; each is acknowledged by index through BulkXferAck() from
+ * tSdlcRecvGcu, and only the blocks whose ack timed out are sent again.
+ * Each GCU unit runs one transfer at a time.
+ */
+#define BULK_XFER_WORDS_PER_BLOCK	(125)
+#define BULK_XFER_MAX_BLOCKS		(16384)
+#define BULK_XFER_BITMAP_WORDS		(BULK_XFER_MAX_BLOCKS / 32)
+#define BULK_XFER_MAX_WINDOW		(32)
+#define BULK_XFER_DEF_WINDOW		(8)
+#define BULK_XFER_DEF_TIMEOUT_MS	(200)
+#define BULK_XFER_DEF_RETRY			(3)
+
+/*
+ * Blocks of one image acknowledged so far, indexed from the image's first
+ * block. Shared by every run over that image, so a later run sends only
+ * what is still missing. imageCrc names the image the map belongs to.
+ */
+typedef struct {
+	UINT32	imageCrc;
+	int		numBlocks;
+	int		numDone;
+	UINT32	doneMap[BULK_XFER_BITMAP_WORDS];
+} BulkXferResume;
+
+typedef void (*BULK_XFER_PROGRESS_FUNC)(void *arg, int numAcked, int numBlocks);
+typedef BOOL (*BULK_XFER_CANCEL_FUNC)(void);
+
+typedef struct {
+	const char *			szName;
+	int						unit;			/* GCU unit, see GcuUnit.h */
+	const UINT16 *			pData;			/* host byte order */
+	int						numBytes;
+	UINT16					opcode;
+	int						firstBlock;		/* block n goes out as IDX firstBlock + n + 1 */
+	int						totalBlocks;	/* progress denominator, 0 for this run only */
+	int						window;
+	int						timeoutMs;
+	int						maxRetry;
+	BULK_XFER_PROGRESS_FUNC	pfnProgress;
+	void *					progressArg;
+	BULK_XFER_CANCEL_FUNC	pfnCancelled;
+	BulkXferResume *		pResume;		/* optional */
+} BulkXferCfg;
+
+typedef struct {
+	int		numBlocks;
+	int		numAcked;
+	int		numSkipped;		/* already done in pResume */
+	int		numSent;
+	int		numRetx;
+	int		numDupAcks;
+	UINT32	elapsedUs;
+	UINT32	bytesPerSec;
+} BulkXferResult;
+
+IMPORT void		BulkXferCfgInit(BulkXferCfg *pCfg, const char *szName,
+								const void *pData, int numBytes, UINT16 opcode);
+IMPORT STATUS	BulkXferRun(const BulkXferCfg *pCfg, BulkXferResult *pResult);
+IMPORT void		BulkXferAck(int unit, INT16 idx);
+IMPORT void		BulkXferResumeReset(BulkXferResume *pResume, UINT32 imageCrc, int numBlocks);
+IMPORT int		BulkXferResumeFirst(const BulkXferResume *pResume);
+IMPORT void		bulkXferShow(int unit);
@@ -0,0 +1,209 @@
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <ctype.h>
+#include <stdio.h>
+#include <errno.h>
+
+#include "CmdArgs.h"
+
+LOCAL void	copyNoBlank(char *szDst, const char *szSrc, size_t len);
+LOCAL void	setArgMask(CmdArgs *pArgs, char *szArg);
+LOCAL void	convertArg(CmdArg *pArg);
+LOCAL UINT64	getBe64(const UINT8 *p);
+LOCAL STATUS	parseText(CmdArgs *pArgs, const char *szArg, size_t len);
+LOCAL STATUS	parseBinary(CmdArgs *pArgs, const UINT8 *pBuf, size_t len);
+
+LOCAL void copyNoBlank(char *szDst, const char *szSrc, size_t len) {
+	size_t n = 0;
+	
+	size_t i;
+	
+	for (i = 0; (i < len) && (szSrc[i] != '\0') && (n < len - 1); i++) {
+		if (!isspace((unsigned char)szSrc[i])) {
+			szDst[n++] = szSrc[i];
+		}
+	}
+	szDst[n] = '\0';
+}
+
+/*
+ * "0x**FF" compares only the digits that are not '*': the mask becomes
+ * 0x00FF and the argument itself is rewritten to "0x00FF".
+ */
+LOCAL void setArgMask(CmdArgs *pArgs, char *szArg) {
+	char ch = 0;
+	
+	if (strlen(szArg) <= 2)
+		return;
+	
+	if (szArg[0] != '0' || szArg[1] != 'x')
+		return;
+	
+	szArg += 2;
+	
+	pArgs->mask = 0;
+	
+	while ((ch = *szArg) != 0) {
+		pArgs->mask <<= 4;
+		
+		if (ch == '*') {
+			*szArg = '0';
+		} else {
+			pArgs->mask |= 0xF;
+		}
+		
+		szArg++;
+	}
+}
+
+/* A number only if the whole argument converts: "3V" is neither. */
+LOCAL void convertArg(CmdArg *pArg) {
+	char *endptr;
+	
+	errno = 0;
+	pArg->lVal = strtol(pArg->str, &endptr, 0);
+	pArg->isLong = ((endptr != pArg->str) && (*endptr == '\0') && (errno == 0)) ? TRUE : FALSE;
+	
+	errno = 0;
+	pArg->dVal = strtod(pArg->str, &endptr);
+	pArg->isDouble = ((endptr != pArg->str) && (*endptr == '\0') && (errno == 0)) ? TRUE : FALSE;
+}
+
+LOCAL UINT64 getBe64(const UINT8 *p) {
+	UINT64 val = 0;
+	int i;
+	
+	for (i = 0; i < 8; i++) {
+		val = (val << 8) | p[i];
+	}
+	
+	return val;
+}
+
+LOCAL STATUS parseText(CmdArgs *pArgs, const char *szArg, size_t len) {
+	char szBuf[GUI_CMD_ARG_MAX_SIZE];
+	char *pToken, *pNext;
+	CmdArg *pArg;
+	
+	copyNoBlank(szBuf, szArg, (len < sizeof(szBuf)) ? len : sizeof(szBuf));
+	
+	for (pToken = szBuf; (pToken != NULL) && (pArgs->num < GUI_CMD_ARG_MAX_NUM);
+		 pToken = pNext) {
+		if ((pNext = strchr(pToken, ',')) != NULL) {
+			*pNext++ = '\0';
+		}
+		
+		/* Empty fields are skipped, as strtok() used to do. */
+		if (*pToken == '\0')
+			continue;
+		
+		pArg = &pArgs->arg[pArgs->num++];
+		strncpy(pArg->str, pToken, sizeof(pArg->str) - 1);
+		setArgMask(pArgs, pArg->str);
+		convertArg(pArg);
+	}
+	
+	return OK;
+}
+
+LOCAL STATUS parseBinary(CmdArgs *pArgs, const UINT8 *pBuf, size_t len) {
+	const UINT8 *pEnd = pBuf + len;
+	size_t rawOff = 0;
+	UINT64 val;
+	INT64 lVal;
+	CmdArg *pArg;
+	UINT8 tag;
+	UINT16 itemLen;
+	int i, count;
+	
+	if (pBuf[2] != CMD_ARGS_BIN_VERSION)
+		return ERROR;
+	
+	count = pBuf[3];
+	if (count > GUI_CMD_ARG_MAX_NUM)
+		return ERROR;
+	
+	pBuf += CMD_ARGS_BIN_HDR_SIZE;
+	
+	for (i = 0; i < count; i++) {
+		if (pEnd - pBuf < CMD_ARGS_BIN_ITEM_SIZE)
+			return ERROR;
+		
+		tag = pBuf[0];
+		itemLen = (UINT16)((pBuf[2] << 8) | pBuf[3]);
+		pBuf += CMD_ARGS_BIN_ITEM_SIZE;
+		
+		if (pEnd - pBuf < itemLen)
+			return ERROR;
+		
+		pArg = &pArgs->arg[pArgs->num++];
+		
+		switch (tag) {
+		case CMD_ARG_TAG_INT:
+			if (itemLen != 8)
+				return ERROR;
+			/* long is 32 bits on the target. */
+			lVal = (INT64)getBe64(pBuf);
+			if ((lVal < LONG_MIN) || (lVal > LONG_MAX))
+				return ERROR;
+			pArg->lVal = (long)lVal;
+			pArg->dVal = (double)pArg->lVal;
+			pArg->isLong = TRUE;
+			pArg->isDouble = TRUE;
+			snprintf(pArg->str, sizeof(pArg->str), "%ld", pArg->lVal);
+			break;
+		case CMD_ARG_TAG_DOUBLE:
+			if (itemLen != 8)
+				return ERROR;
+			val = getBe64(pBuf);
+			memcpy(&pArg->dVal, &val, sizeof(double));
+			pArg->isLong = FALSE;
+			pArg->isDouble = TRUE;
+			snprintf(pArg->str, sizeof(pArg->str), "%.17g", pArg->dVal);
+			break;
+		case CMD_ARG_TAG_STRING:
+			if (itemLen >= sizeof(pArg->str))
+				return ERROR;
+			memcpy(pArg->str, pBuf, itemLen);
+			setArgMask(pArgs, pArg->str);
+			convertArg(pArg);
+			break;
+		case CMD_ARG_TAG_BLOB:
+			if (rawOff + itemLen > sizeof(pArgs->raw.buf))
+				return ERROR;
+			memcpy(&pArgs->raw.buf[rawOff], pBuf, itemLen);
+			pArg->pBlob = &pArgs->raw.buf[rawOff];
+			pArg->blobLen = itemLen;
+			rawOff = (rawOff + itemLen + 7) & ~(size_t)7;
+			break;
+		default:
+			return ERROR;
+		}
+		
+		pBuf += itemLen;
+	}
+	
+	return OK;
+}
+
+/*
+ * pArg is the OPS argument buffer of len bytes, either a comma separated
+ * string or the tagged binary list described in CmdArgs.h.
+ */
+STATUS CmdArgsParse(CmdArgs *pArgs, const char *pArg, size_t len) {
+	const UINT8 *pBuf = (const UINT8 *)pArg;
+	
+	memset(pArgs, 0, sizeof(CmdArgs));
+	pArgs->mask = UINT32_MAX;
+	
+	if (pArg == NULL)
+		return ERROR;
+	
+	if ((len >= CMD_ARGS_BIN_HDR_SIZE) &&
+		(pBuf[0] == CMD_ARGS_BIN_MAGIC0) && (pBuf[1] == CMD_ARGS_BIN_MAGIC1)) {
+		return parseBinary(pArgs, pBuf, len);
+	}
+	
+	return parseText(pArgs, pArg, len);
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <vxWorks.h>
+
+#include "typeDef/opsType.h"
+
+#define GUI_CMD_ARG_MAX_NUM		(16)
+#define GUI_CMD_ARG_MAX_SIZE	OPS_TYPE_ARGS_BUF_LEN
+
+/*
+ * Binary argument encoding. An argument buffer that starts with the two
+ * magic bytes is a tagged list instead of a comma separated string:
+ *
+ *   header : UINT8 magic[2], UINT8 version, UINT8 count
+ *   item   : UINT8 tag, UINT8 reserved, UINT16 len, UINT8 value[len]
+ *
+ * All multi-byte values are in network byte order. INT is a 64-bit two's
+ * complement integer and DOUBLE an IEEE 754 double, both with len 8; an
+ * INT outside the range of long fails the parse.
+ */
+#define CMD_ARGS_BIN_MAGIC0		(0xA5)
+#define CMD_ARGS_BIN_MAGIC1		(0x5A)
+#define CMD_ARGS_BIN_VERSION	(1)
+#define CMD_ARGS_BIN_HDR_SIZE	(4)
+#define CMD_ARGS_BIN_ITEM_SIZE	(4)
+
+typedef enum {
+	CMD_ARG_TAG_INT = 1,
+	CMD_ARG_TAG_DOUBLE,
+	CMD_ARG_TAG_STRING,
+	CMD_ARG_TAG_BLOB
+} CmdArgTag;
+
+typedef struct {
+	char			str[GUI_CMD_ARG_MAX_SIZE];
+	long			lVal;
+	double			dVal;
+	BOOL			isLong;
+	BOOL			isDouble;
+	const void *	pBlob;
+	UINT16			blobLen;
+} CmdArg;
+
+/*
+ * Arguments of one command invocation, parsed once by CmdExec.
+ * raw holds BLOB values, each 8-byte aligned; a BLOB passed as the
+ * first argument therefore starts at raw.buf.
+ */
+typedef struct {
+	int		num;
+	UINT32	mask;
+	int		unit;			/* GCU unit, from an "@n" suffix on the command name */
+	CmdArg	arg[GUI_CMD_ARG_MAX_NUM];
+	union {
+		char	buf[GUI_CMD_ARG_MAX_SIZE];
+		double	align;
+	} raw;
+} CmdArgs;
+
+typedef STATUS (*CMD_FUNCPTR)(const CmdArgs *pArgs);
+
+IMPORT STATUS	CmdArgsParse(CmdArgs *pArgs, const char *pArg, size_t len);
@@ -3,25 +3,119 @@
 #include <vxworks.h>
 #include <symLib.h>
 #include <errnoLib.h>
+#include <vxAtomicLib.h>
 #include <usrLib.h>
 #include <string.h>
 #include <ctype.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdarg.h>
 
 #include "../lib/util/isDebug.h"
+#include "../lib/util/isClock.h"
 #include "common.h"
 #include "CmdExec.h"
 #include "CmdFuncs.h"
+#include "PwrChan.h"
+#include "AssetCache.h"
+#include "TmWait.h"
+#include "GcuUnit.h"
 #include "UdpSendOps.h"
 
 #define CMD_EXEC_MSG_Q_LEN	(20)
 #define CMD_TBL_POOL_SIZE	(4096)
-#define CMD_TBL_ITEM(x)		{ #x, x }
+#define CMD_TBL_ITEM(x, res)	{ #x, x, res }
+#define CMD_NAME_MAX_LEN	(64)
+#define CMD_TAG_SUFFIX		('#')		/* "name#": results carry "#<jobId> " */
+
+/*
+ * Resources a command uses while it runs. Commands whose masks overlap
+ * are run one after the other, in the order they were requested.
+ */
+#define CMD_RES_NONE			(0)
+#define CMD_RES_FG2				(1 << 0)
+#define CMD_RES_FG3				(1 << 1)
+#define CMD_RES_FG5				(1 << 2)
+#define CMD_RES_FG7				(1 << 3)
+#define CMD_RES_GCU_IMG			(1 << 4)
+#define CMD_RES_PWR_SUPPLY		(1 << 5)
+#define CMD_RES_SQUIB			(1 << 6)
+#define CMD_RES_DIO_OUT			(1 << 7)
+#define CMD_RES_ADC				(1 << 8)
+#define CMD_RES_RDC_DATA		(1 << 9)
+#define CMD_RES_SDLC_TEST		(1 << 10)
+#define CMD_RES_ALL				(0xFFFFFFFF)
+
+/*
+ * The FG resources and the loaded GCU image belong to one GCU unit, so
+ * the same command runs on two units at once. jobResMask() moves them to
+ * bits 32 + 5 * unit of the resources owned; CMD_RES_ALL still takes
+ * those of every unit.
+ */
+#define CMD_RES_UNIT			(CMD_RES_FG2 | CMD_RES_FG3 | CMD_RES_FG5 | CMD_RES_FG7 | CMD_RES_GCU_IMG)
+#define CMD_RES_UNIT_BITS		(5)
+#define CMD_RES_UNIT_SHIFT(unit)	(32 + CMD_RES_UNIT_BITS * (unit))
+
+#if 32 + CMD_RES_UNIT_BITS * GCU_UNIT_MAX > 64
+#error "The unit resources of GCU_UNIT_MAX units do not fit in 64 bits."
+#endif
+
+#define CMD_WORKER_NUM			(4)
+#define CMD_WORKER_PRIORITY		(100)
+#define CMD_WORKER_STACK_SIZE	(100000)
+#define CMD_JOB_NUM				(16)
+#define CMD_JOB_IDX_QUIT		(-1)
+#define CMD_CANCEL_POLL_MS		(10)
+#define CMD_CANCEL_TIMEOUT_MS	(3000)
+#define CMD_RESULT_MAX_LEN		(256)
 
 typedef enum {
 	RUNNING,
 	STOP
 } CmdExecState;
 
+typedef enum {
+	CMD_JOB_FREE,
+	CMD_JOB_PENDING,
+	CMD_JOB_QUEUED,
+	CMD_JOB_RUNNING,
+	CMD_JOB_CANCELLED
+} CmdJobState;
+
+typedef struct tagCmdTblItem CMD_TBL_ITEM;
+
+/* QUEUED leaves by CAS only: to RUNNING by a worker, to CANCELLED by stopCmd(). */
+typedef struct {
+	atomic32_t				state;			/* CmdJobState */
+	UINT32					jobId;
+	BOOL					isTagged;		/* started as "name#" */
+	const CMD_TBL_ITEM *	pCmdItem;
+	CmdArgs					args;
+	UINT64					resHeld;
+	volatile int			workerIdx;
+	volatile BOOL			cancelReq;
+	CmdStamps				stamps;
+	UINT64					tStopReq;
+} CmdJob;
+
+typedef struct {
+	TASK_ID			tid;
+	volatile int	jobIdx;
+	char			name[16];
+} CmdWorker;
+
+typedef struct {
+	UINT32			numJobs;
+	UINT32			numRejected;
+	UINT32			lastStartUs;
+	UINT32			maxStartUs;
+	UINT64			sumStartUs;
+	UINT32			numStops;
+	UINT32			numForcedStops;
+	UINT32			lastStopUs;
+	UINT32			maxStopUs;
+} CmdPoolStats;
+
 typedef struct {
 	TASK_ID			taskId;
 	ModuleType		ipcType;
@@ -35,127 +129,143 @@ typedef struct {
 	TaskStatus *	taskStatus;
 #endif
 	CmdExecState 	state;
-	PART_ID			cmdPoolId;
-	SYMTAB_ID		cmdTblId;
-	TASK_ID			tidCmdExec;
+	MSG_Q_ID		jobQId;
+	CmdWorker		workers[CMD_WORKER_NUM];
+	CmdJob			jobs[CMD_JOB_NUM];
+	UINT32			nextJobId;
+	UINT64			resOwned;
+	UINT64			tRecv;
+	int				pendingJobs[CMD_JOB_NUM];
+	int				numPending;
+	CmdPoolStats	poolStats;
 } CmdExecInst;
 
-typedef struct tagCmdTblItem {
-	char *	name;
-	FUNCPTR pfn;
-} CMD_TBL_ITEM;
+struct tagCmdTblItem {
+	const char *	name;
+	CMD_FUNCPTR		pfn;
+	UINT32			resMask;
+};
+
+#define JOB_TAG(pJob)	((pJob)->isTagged ? (pJob)->jobId : 0)
 
 LOCAL CmdExecInst g_stCmdExecInst = {
 	TASK_ID_ERROR, MSGQ, {MSG_Q_ID_NULL}, "",
 };
 
-LOCAL char g_cmdTblPool[CMD_TBL_POOL_SIZE];
-
-LOCAL CMD_TBL_ITEM g_cmdTblItems[] = {
-	CMD_TBL_ITEM(mtsTestFunc),
-	CMD_TBL_ITEM(invokeMethod_uint),
-	CMD_TBL_ITEM(invokeMethod_uint_double),
-	CMD_TBL_ITEM(checkResult_equal),
-	CMD_TBL_ITEM(checkResult_range),
-	CMD_TBL_ITEM(mtsCommTestTxReq),
-	CMD_TBL_ITEM(mtsCommTest),
-	
-	CMD_TBL_ITEM(mtsReset),
-	CMD_TBL_ITEM(mtsUpdate),
-	
-	CMD_TBL_ITEM(mtsPowerExtOn),
-	CMD_TBL_ITEM(mtsPowerExtOff),
-	CMD_TBL_ITEM(mtsPowerExtGd),
-	CMD_TBL_ITEM(mtsPowerMeasureVolt),
-	CMD_TBL_ITEM(mtsPowerMeasureCurrent),
-	CMD_TBL_ITEM(mtsInitActPwrSuplOut),
-	CMD_TBL_ITEM(mtsSetActPwrSuplOut),
-	CMD_TBL_ITEM(mtsSetActPwrSuplOutBit),
-	CMD_TBL_ITEM(mtsGetActPwrSuplOut),
-	CMD_TBL_ITEM(mtsChkGf2),
-	CMD_TBL_ITEM(mtsGcuMslStsChk),
-	CMD_TBL_ITEM(mtsSwVerChk),
-	CMD_TBL_ITEM(mtsGcuFireModeStart),
-	CMD_TBL_ITEM(mtsNavCal),
-	CMD_TBL_ITEM(mtsNavDataInput),
-	CMD_TBL_ITEM(mtsSaveAlignData),
-	CMD_TBL_ITEM(mtsChkGf3NavData),
-	CMD_TBL_ITEM(mtsGcaStart),
-	CMD_TBL_ITEM(mtsShaStart),
-	CMD_TBL_ITEM(mtsGcaDone),
-	CMD_TBL_ITEM(mtsGcuiMslGpsModeSet),
-	CMD_TBL_ITEM(mtsMslGpsTrkStart),
-	CMD_TBL_ITEM(mtsActMotorOn),
-	CMD_TBL_ITEM(mtsAcuCtrlCommandSetErrorDeg),
-	CMD_TBL_ITEM(mtsAcuSlewStart),
-	CMD_TBL_ITEM(mtsAcuSlewEnd),
-	CMD_TBL_ITEM(mtsAcuWingCommandSetErrorDeg),
-	CMD_TBL_ITEM(mtsArm1OnOff),
-	CMD_TBL_ITEM(mtsBit),
-	CMD_TBL_ITEM(steBit),
-	CMD_TBL_ITEM(mtsChkGf7),
-	CMD_TBL_ITEM(mtsGcuLoad),
-	CMD_TBL_ITEM(mtsGcuProgramMode),
-	CMD_TBL_ITEM(mtsGcuProgramStart),
-	CMD_TBL_ITEM(mtsGcuProgramEnd),
-	CMD_TBL_ITEM(mtsGcuTestMode),
-	CMD_TBL_ITEM(mtsImuOn),
-	CMD_TBL_ITEM(mtsIntArmingOn),
-	CMD_TBL_ITEM(mtsIntArmingOff),
-	CMD_TBL_ITEM(mtsIntSync),
-	CMD_TBL_ITEM(mtsLiftOffMslOn),
-	CMD_TBL_ITEM(mtsLiftOffMslOff),
-	CMD_TBL_ITEM(mtsLiftOffReady),
-	CMD_TBL_ITEM(mtsLiftOffTestOn),
-	CMD_TBL_ITEM(mtsLiftOffTestOff),
-	CMD_TBL_ITEM(mtsPowerBatGd),
-	CMD_TBL_ITEM(mtsPowerBatOn),
-	CMD_TBL_ITEM(mtsPowerBatOnBit),
-	CMD_TBL_ITEM(mtsPowerBatOff),
-	CMD_TBL_ITEM(mtsRdcDataLoad),
-	CMD_TBL_ITEM(mtsRdcDataMode),
-	CMD_TBL_ITEM(mtsRdcDataStart),
-	CMD_TBL_ITEM(mtsRdcDataEnd),
-	CMD_TBL_ITEM(mtsRdcModeInput),
-	CMD_TBL_ITEM(mtsFireModeOn),
-	CMD_TBL_ITEM(mtsFireMOdeOff),
-	CMD_TBL_ITEM(mtsNavChk1),
-	CMD_TBL_ITEM(mtsNavChk2),
-	CMD_TBL_ITEM(mtsNavChk3),
-	CMD_TBL_ITEM(mtsChkGf12),
-	CMD_TBL_ITEM(mtsSimHotStartLoad),
-	CMD_TBL_ITEM(mtsSimHotStartStart),
-	CMD_TBL_ITEM(mtsSimHotStartStop),
-	CMD_TBL_ITEM(mtsLarModeSet),
-	CMD_TBL_ITEM(mtsLarHotStartReq),
-	CMD_TBL_ITEM(mtsLarLnsAidingStart),
-	CMD_TBL_ITEM(mtsLarLnsAidingStop),
-	CMD_TBL_ITEM(mtsSetGcuDio),
-	CMD_TBL_ITEM(mtsCluArm1TestOn),
-	CMD_TBL_ITEM(mtsCluArm1TestOff),
-	CMD_TBL_ITEM(mtsCluEdResetTestOn),
-	CMD_TBL_ITEM(mtsCluEdResetTestOff),
-	CMD_TBL_ITEM(mtsCluLiftOffTestOn),
-	CMD_TBL_ITEM(mtsCluLiftOffTestOff),
-	CMD_TBL_ITEM(mtsTxGcuCtrlCmd),
-	CMD_TBL_ITEM(mtsLnsSetTravelLock),
-	CMD_TBL_ITEM(mtsLnsChkBit),
-	CMD_TBL_ITEM(mtsLnsALignStart),
-	CMD_TBL_ITEM(mtsLnsAlignDone),
-	CMD_TBL_ITEM(mtsTaStart),
-	CMD_TBL_ITEM(mtsTaLchUp),
-	CMD_TBL_ITEM(mtsTaDataInputStart),
-	CMD_TBL_ITEM(mtsTaDataInputStop),
+/*
+ * Sorted by name in strcmp() order, so that findCmd() can binary-search it.
+ * InitCmdExec() refuses to start if an entry is added out of order.
+ * Commands that are not known to be safe alongside others use CMD_RES_ALL.
+ */
+LOCAL const CMD_TBL_ITEM g_cmdTblItems[] = {
+	CMD_TBL_ITEM(checkResult_equal, CMD_RES_ALL),
+	CMD_TBL_ITEM(checkResult_range, CMD_RES_ALL),
+	CMD_TBL_ITEM(invokeMethod_uint, CMD_RES_ALL),
+	CMD_TBL_ITEM(invokeMethod_uint_double, CMD_RES_ALL),
+	CMD_TBL_ITEM(mtsActMotorOn, CMD_RES_FG2),
+	CMD_TBL_ITEM(mtsAcuCtrlCommandSetErrorDeg, CMD_RES_FG2),
+	CMD_TBL_ITEM(mtsAcuSlewEnd, CMD_RES_FG2),
+	CMD_TBL_ITEM(mtsAcuSlewStart, CMD_RES_FG2),
+	CMD_TBL_ITEM(mtsAcuWingCommandSetErrorDeg, CMD_RES_FG2),
+	CMD_TBL_ITEM(mtsArm1OnOff, CMD_RES_DIO_OUT),
+	CMD_TBL_ITEM(mtsAssetPrefetch, CMD_RES_NONE),
+	CMD_TBL_ITEM(mtsBit, CMD_RES_PWR_SUPPLY),
+	CMD_TBL_ITEM(mtsChkGf12, CMD_RES_ALL),
+	CMD_TBL_ITEM(mtsChkGf2, CMD_RES_NONE),
+	CMD_TBL_ITEM(mtsChkGf3NavData, CMD_RES_NONE),
+	CMD_TBL_ITEM(mtsChkGf7, CMD_RES_NONE),
+	CMD_TBL_ITEM(mtsChkTmMulti, CMD_RES_NONE),
+	CMD_TBL_ITEM(mtsCluArm1TestOff, CMD_RES_ALL),
+	CMD_TBL_ITEM(mtsCluArm1TestOn, CMD_RES_ALL),
+	CMD_TBL_ITEM(mtsCluEdResetTestOff, CMD_RES_ALL),
+	CMD_TBL_ITEM(mtsCluEdResetTestOn, CMD_RES_ALL),
+	CMD_TBL_ITEM(mtsCluLiftOffTestOff, CMD_RES_ALL),
+	CMD_TBL_ITEM(mtsCluLiftOffTestOn, CMD_RES_ALL),
+	CMD_TBL_ITEM(mtsCmdStats, CMD_RES_NONE),
+	CMD_TBL_ITEM(mtsCommTest, CMD_RES_SDLC_TEST),
+	CMD_TBL_ITEM(mtsCommTestTxReq, CMD_RES_SDLC_TEST),
+	CMD_TBL_ITEM(mtsFireMOdeOff, CMD_RES_ALL),
+	CMD_TBL_ITEM(mtsFireModeOn, CMD_RES_ALL),
+	CMD_TBL_ITEM(mtsGcaDone, CMD_RES_NONE),
+	CMD_TBL_ITEM(mtsGcaStart, CMD_RES_FG7),
+	CMD_TBL_ITEM(mtsGcuFireModeStart, CMD_RES_FG2),
+	CMD_TBL_ITEM(mtsGcuLatency, CMD_RES_NONE),
+	CMD_TBL_ITEM(mtsGcuLoad, CMD_RES_GCU_IMG),
+	CMD_TBL_ITEM(mtsGcuMslStsChk, CMD_RES_FG2),
+	CMD_TBL_ITEM(mtsGcuProgramEnd, CMD_RES_FG3 | CMD_RES_GCU_IMG),
+	CMD_TBL_ITEM(mtsGcuProgramMode, CMD_RES_FG2),
+	CMD_TBL_ITEM(mtsGcuProgramResume, CMD_RES_FG3 | CMD_RES_GCU_IMG),
+	CMD_TBL_ITEM(mtsGcuProgramStart, CMD_RES_FG3 | CMD_RES_GCU_IMG),
+	CMD_TBL_ITEM(mtsGcuTestMode, CMD_RES_ALL),
+	CMD_TBL_ITEM(mtsGcuiMslGpsModeSet, CMD_RES_FG5),
+	CMD_TBL_ITEM(mtsGetActPwrSuplOut, CMD_RES_PWR_SUPPLY),
+	CMD_TBL_ITEM(mtsImuOn, CMD_RES_ALL),
+	CMD_TBL_ITEM(mtsInitActPwrSuplOut, CMD_RES_PWR_SUPPLY),
+	CMD_TBL_ITEM(mtsIntArmingOff, CMD_RES_ALL),
+	CMD_TBL_ITEM(mtsIntArmingOn, CMD_RES_ALL),
+	CMD_TBL_ITEM(mtsIntSync, CMD_RES_ALL),
+	CMD_TBL_ITEM(mtsLarHotStartReq, CMD_RES_ALL),
+	CMD_TBL_ITEM(mtsLarLnsAidingStart, CMD_RES_ALL),
+	CMD_TBL_ITEM(mtsLarLnsAidingStop, CMD_RES_ALL),
+	CMD_TBL_ITEM(mtsLarModeSet, CMD_RES_ALL),
+	CMD_TBL_ITEM(mtsLiftOffMslOff, CMD_RES_ALL),
+	CMD_TBL_ITEM(mtsLiftOffMslOn, CMD_RES_ALL),
+	CMD_TBL_ITEM(mtsLiftOffReady, CMD_RES_ALL),
+	CMD_TBL_ITEM(mtsLiftOffTestOff, CMD_RES_ALL),
+	CMD_TBL_ITEM(mtsLiftOffTestOn, CMD_RES_ALL),
+	CMD_TBL_ITEM(mtsLimitAdd, CMD_RES_NONE),
+	CMD_TBL_ITEM(mtsLimitClear, CMD_RES_NONE),
+	CMD_TBL_ITEM(mtsLimitShow, CMD_RES_NONE),
+	CMD_TBL_ITEM(mtsLinkStats, CMD_RES_NONE),
+	CMD_TBL_ITEM(mtsLnsALignStart, CMD_RES_ALL),
+	CMD_TBL_ITEM(mtsLnsAlignDone, CMD_RES_ALL),
+	CMD_TBL_ITEM(mtsLnsChkBit, CMD_RES_ALL),
+	CMD_TBL_ITEM(mtsLnsSetTravelLock, CMD_RES_ALL),
+	CMD_TBL_ITEM(mtsMslGpsTrkStart, CMD_RES_FG5),
+	CMD_TBL_ITEM(mtsNavCal, CMD_RES_FG2),
+	CMD_TBL_ITEM(mtsNavChk1, CMD_RES_ALL),
+	CMD_TBL_ITEM(mtsNavChk2, CMD_RES_ALL),
+	CMD_TBL_ITEM(mtsNavChk3, CMD_RES_ALL),
+	CMD_TBL_ITEM(mtsNavDataInput, CMD_RES_FG3),
+	CMD_TBL_ITEM(mtsPowerBatGd, CMD_RES_ALL),
+	CMD_TBL_ITEM(mtsPowerBatOff, CMD_RES_ALL),
+	CMD_TBL_ITEM(mtsPowerBatOn, CMD_RES_ALL),
+	CMD_TBL_ITEM(mtsPowerBatOnBit, CMD_RES_ALL),
+	CMD_TBL_ITEM(mtsPowerExtGd, CMD_RES_NONE),
+	CMD_TBL_ITEM(mtsPowerExtOff, CMD_RES_DIO_OUT),
+	CMD_TBL_ITEM(mtsPowerExtOn, CMD_RES_DIO_OUT),
+	CMD_TBL_ITEM(mtsPowerMeasureCurrent, CMD_RES_ADC),
+	CMD_TBL_ITEM(mtsPowerMeasureMulti, CMD_RES_ADC),
+	CMD_TBL_ITEM(mtsPowerMeasureVolt, CMD_RES_ADC),
+	CMD_TBL_ITEM(mtsRdcDataEnd, CMD_RES_ALL),
+	CMD_TBL_ITEM(mtsRdcDataLoad, CMD_RES_ALL),
+	CMD_TBL_ITEM(mtsRdcDataMode, CMD_RES_ALL),
+	CMD_TBL_ITEM(mtsRdcDataStart, CMD_RES_ALL),
+	CMD_TBL_ITEM(mtsRdcModeInput, CMD_RES_ALL),
+	CMD_TBL_ITEM(mtsReset, CMD_RES_ALL),
+	CMD_TBL_ITEM(mtsSaveAlignData, CMD_RES_FG7),
+	CMD_TBL_ITEM(mtsSetActPwrSuplOut, CMD_RES_PWR_SUPPLY | CMD_RES_SQUIB),
+	CMD_TBL_ITEM(mtsSetActPwrSuplOutBit, CMD_RES_PWR_SUPPLY),
+	CMD_TBL_ITEM(mtsSetGcuDio, CMD_RES_ALL),
+	CMD_TBL_ITEM(mtsShaStart, CMD_RES_FG7),
+	CMD_TBL_ITEM(mtsSimHotStartLoad, CMD_RES_ALL),
+	CMD_TBL_ITEM(mtsSimHotStartStart, CMD_RES_ALL),
+	CMD_TBL_ITEM(mtsSimHotStartStop, CMD_RES_ALL),
+	CMD_TBL_ITEM(mtsSwVerChk, CMD_RES_FG3),
+	CMD_TBL_ITEM(mtsTaDataInputStart, CMD_RES_ALL),
+	CMD_TBL_ITEM(mtsTaDataInputStop, CMD_RES_ALL),
+	CMD_TBL_ITEM(mtsTaLchUp, CMD_RES_ALL),
+	CMD_TBL_ITEM(mtsTaStart, CMD_RES_ALL),
+	CMD_TBL_ITEM(mtsTestFunc, CMD_RES_NONE),
+	CMD_TBL_ITEM(mtsTxGcuCtrlCmd, CMD_RES_ALL),
+	CMD_TBL_ITEM(mtsUpdate, CMD_RES_ALL),
+	CMD_TBL_ITEM(steBit, CMD_RES_PWR_SUPPLY),
 };
 
-LOCAL int g_numCmdFunc = NELEMENTS(g_cmdTblItems);
-LOCAL int g_numCmdFuncAdded = 0;
+LOCAL const int g_numCmdFunc = NELEMENTS(g_cmdTblItems);
 
 const ModuleInst *g_hCmdExec = (ModuleInst *)&g_stCmdExecInst;
 
-char	g_szArgs[GUI_CMD_ARG_MAX_NUM][GUI_CMD_ARG_MAX_SIZE];
-UINT32	g_dwArgMask = UINT32_MAX;
-
 LOCAL STATUS	InitCmdExec(CmdExecInst *this);
 LOCAL STATUS	FinalizeCmdExec(CmdExecInst *this);
 LOCAL STATUS	ExecuteCmdExec(CmdExecInst *this);
@@ -164,20 +274,54 @@ LOCAL void		OnStart(CmdExecInst *this);
 LOCAL void		OnStop(CmdExecInst *this);
 LOCAL STATUS	OnExecute(CmdExecInst *this, OPS_TYPE_TEST_CONTROL *pTestControl);
 
-LOCAL void		removeBlank(char *szArg);
-LOCAL STATUS	setArgMask(char *szArg);
-LOCAL STATUS	parseArgs(char *szArg);
+LOCAL const CMD_TBL_ITEM *	findCmd(const char *szCmd);
+LOCAL STATUS				checkCmdTblOrder(void);
+
+LOCAL STATUS	spawnWorker(CmdExecInst *this, int workerIdx);
+LOCAL void		cmdWorkerMain(CmdExecInst *this, int workerIdx);
+LOCAL CmdJob *	allocJob(CmdExecInst *this);
+LOCAL void		releaseJob(CmdExecInst *this, CmdJob *pJob);
+LOCAL void		OnJobDone(CmdExecInst *this, const CmdExecJobDone *pJobDone);
+LOCAL void		OnChkCancel(CmdExecInst *this);
+LOCAL STATUS	killWorker(CmdExecInst *this, CmdJob *pJob);
+LOCAL void		recordStop(CmdExecInst *this, const CmdJob *pJob, UINT64 tIdle);
+LOCAL CmdJob *	findSelfJob(void);
+LOCAL void		txJobResult(UINT32 jobId, OPS_TYPE_RESULT_TYPE eResult, const char *szValue);
+LOCAL BOOL		isStopTarget(const CmdJob *pJob, const char *szTarget);
+LOCAL void		removePending(CmdExecInst *this, int jobIdx);
+LOCAL UINT64	jobResMask(const CmdJob *pJob);
+LOCAL void		dispatchJobs(CmdExecInst *this);
 
 LOCAL STATUS 	startCmd(CmdExecInst *this, char *szCmd, char *szArg);
-LOCAL STATUS	stopCmd(CmdExecInst *this);
+LOCAL STATUS	stopCmd(CmdExecInst *this, const char *szTarget);
 
 LOCAL STATUS 	InitCmdExec(CmdExecInst *this) {
 	this->taskId = taskIdSelf();
 	this->state = STOP;
-	this->cmdPoolId = NULL;
-	this->cmdTblId = NULL;
-	this->tidCmdExec = TASK_ID_NULL;
-	g_numCmdFuncAdded = 0;
+	this->jobQId = MSG_Q_ID_NULL;
+	this->nextJobId = 1;
+	this->resOwned = CMD_RES_NONE;
+	this->numPending = 0;
+	memset(this->jobs, 0, sizeof(this->jobs));
+	memset(&this->poolStats, 0, sizeof(this->poolStats));
+	
+	int i;
+	for (i = 0; i < CMD_WORKER_NUM; i++) {
+		this->workers[i].tid = TASK_ID_NULL;
+		this->workers[i].jobIdx = CMD_JOB_IDX_QUIT;
+	}
+	
+	if (checkCmdTblOrder() == ERROR) {
+		return ERROR;
+	}
+	
+	if (PwrChanInit() == ERROR) {
+		return ERROR;
+	}
+	
+	if (AssetCacheInit() == ERROR) {
+		return ERROR;
+	}
 	
 	this->ipcObj.msgQId = msgQCreate(CMD_EXEC_MSG_Q_LEN,
 									sizeof(CmdExecMsg), MSG_Q_FIFO);
@@ -186,34 +330,17 @@ LOCAL STATUS 	InitCmdExec(CmdExecInst *this) {
 		return ERROR;
 	}
 	
-	this->cmdPoolId = memPartCreate((char *)g_cmdTblPool, CMD_TBL_POOL_SIZE);
-	if(this->cmdPoolId == NULL) {
-		LOGMSG("MemPart Creation Fail! (errNo: 0x%08X)\n", errnoGet());
-		printErrno(errnoGet());
+	this->jobQId = msgQCreate(CMD_JOB_NUM, sizeof(int), MSG_Q_FIFO);
+	if (!(this->jobQId)) {
+		LOGMSG("Job Q Creation Fail!\n");
 		return ERROR;
 	}
 	
-	this->cmdTblId = symTblCreate(7, FALSE, this->cmdPoolId);
-	if(this->cmdTblId == NULL) {
-		LOGMSG("SymTbl Creation Fail! (errNo: 0x%08X)\n", errnoGet());
-		printErrno(errnoGet());
-		return ERROR;
-	}
-	
-	int i;
-	for (i = 0; i < g_numCmdFunc; i++) {
-		if (symAdd(this->CcmdTblId, g_cmdTblItems[i].name, (SYM_VALUE)g_cmdTblItems[i].pfn,
-				SYM_GLOBAL | SYM_TEST, 1) == ERROR) {
-			LOGMSG("symAdd() error! (errNo: 0x%08X)\n", errnoGet());
-			printErrno(errnoGet());
-			
-			g_numCmdFuncAdded = i + 1;
-			
+	for (i = 0; i < CMD_WORKER_NUM; i++) {
+		if (spawnWorker(this, i) == ERROR) {
 			return ERROR;
 		}
 	}
-	
-	g_numCmdFuncAdded = i;
 
 	return OK;
 }
@@ -230,33 +357,23 @@ LOCAL STATUS FinalizeCmdExec(CmdExecInst *this) {
 	}
 	
 	int i;
-	for (i = 0; i < g_numCmdFuncAdded; i++) {
-		if (symRemove(this->cmdTblId, g_cmdTblItems[i].name, SYM_GLOBAL | SYM_TEXT) == ERROR) {
-			LOGMSG("symRemove() error! (errNo: 0x%08X)\n", errnoGet());
-			printErrno(errnoGet());
-			
-			return ERROR;
-		}
-	}
-	
-	if (this->cmdTblId != NULL){
-		if (symTblDelete(this->cmdTblId) == ERROR){
-			LOGMSG("symTblDelete() error! (errNo: 0x%08X)\n", errnoGet());
-			printErrno(errnoGet();
-			nRet = ERROR;
-		}
-		else {
-			this->cmdTblId = NULL;
+	for (i = 0; i < CMD_WORKER_NUM; i++) {
+		if ((this->workers[i].tid != TASK_ID_NULL) &&
+			(taskIdVerify(this->workers[i].tid) == OK)) {
+			if (taskDelete(this->workers[i].tid) == ERROR) {
+				LOGMSG("taskDelete(%s) error!\n", this->workers[i].name);
+				nRet = ERROR;
+			}
 		}
+		this->workers[i].tid = TASK_ID_NULL;
 	}
 	
-	if (this->cmdPoolId != NULL) {
-		if (memPartDelete(this->cmdPoolId) == ERROR) {
-			LOGMSG("memPartDelete() error! (errNo: 0x%08X)\n", errnoGet());
-			printErrno(errnoGet());
+	if (this->jobQId) {
+		if (msgQDelete(this->jobQId)) {
+			LOGMSG("msgQDelete(jobQ) error!\n");
 			nRet = ERROR;
 		} else {
-			this->cmdPoolId = NULL;
+			this->jobQId = NULL;
 		}
 	}
 	
@@ -274,6 +391,7 @@ LOCAL STATUS ExecuteCmdExec(CmdExecInst *this) {
 			nRet = ERROR;
 			break;
 		}
+		this->tRecv = isClockNs();
 
 #ifdef USE_CHK_TASK_STATUS
 		updateTaskStatus(this->taskStatus);
@@ -291,11 +409,18 @@ LOCAL STATUS ExecuteCmdExec(CmdExecInst *this) {
 		case CMD_EXEC_EXECUTE:
 			OnExecute(this, &(stMsg.body.testControl));
 			break;
+		case CMD_EXEC_JOB_DONE:
+			OnJobDone(this, &(stMsg.body.jobDone));
+			break;
+		case CMD_EXEC_CHK_CANCEL:
+			OnChkCancel(this);
+			break;
 		}
-	
-	return nRet;
 	}
 	
+	return nRet;
+}
+
 LOCAL void OnStart(CmdExecInst *this) {
 	this->state = RUNNING;
 }
@@ -311,144 +436,550 @@ LOCAL STATUS OnExecute(CmdExecInst *this, OPS_TYPE_TEST_CONTROL *pTestControl) {
 		return startCmd(this, pTestControl->cmd, pTestControl->args);
 	}
 	else if (pTestControl->cmdType == CMD_TYPE_STOP) {
-		return stopCmd(this);
+		return stopCmd(this, pTestControl->cmd);
 	}
 	else {
 		return ERROR;
 	}
 }
 
-LOCAL void removeBlank(char *szArg) {
-	char *d = szArg;
+LOCAL const CMD_TBL_ITEM *findCmd(const char *szCmd) {
+	int lo = 0;
+	int hi = g_numCmdFunc - 1;
+	int mid, cmp;
 	
-	do {
-		while (isspace(*d)) {
-			d++;
+	while (lo <= hi) {
+		mid = (lo + hi) >> 1;
+		cmp = strcmp(szCmd, g_cmdTblItems[mid].name);
+		
+		if (cmp == 0) {
+			return &g_cmdTblItems[mid];
+		} else if (cmp < 0) {
+			hi = mid - 1;
+		} else {
+			lo = mid + 1;
 		}
-		*szArg++ = *d++;
-	} while (*szArg != NULL);
+	}
+	
+	return NULL;
 }
 
-LOCAL STATUS setArgMask(char *szArg) {
-	char ch = 0;
+LOCAL STATUS checkCmdTblOrder(void) {
+	int i;
 	
-	if (szArg == NULL)
+	for (i = 1; i < g_numCmdFunc; i++) {
+		if (strcmp(g_cmdTblItems[i - 1].name, g_cmdTblItems[i].name) >= 0) {
+			LOGMSG("Command table is not sorted at \"%s\"!\n",
+				   g_cmdTblItems[i].name);
+			return ERROR;
+		}
+	}
+	
+	return OK;
+}
+
+/*
+ * szCmd is "name", "name@n" for GCU unit n, either followed by
+ * CMD_TAG_SUFFIX when the client wants the results of the job tagged
+ * with its id. Untagged results are sent exactly as before.
+ */
+LOCAL STATUS startCmd(CmdExecInst *this, char *szCmd, char *szArg) {
+	const CMD_TBL_ITEM *pCmdItem;
+	CmdJob *pJob;
+	UINT64 tResolve;
+	char szName[CMD_NAME_MAX_LEN];
+	int unit;
+	size_t len = strlen(szCmd);
+	BOOL isTagged = FALSE;
+	
+	if ((len > 0) && (szCmd[len - 1] == CMD_TAG_SUFFIX)) {
+		szCmd[len - 1] = '\0';
+		isTagged = TRUE;
+	}
+	
+	if (GcuUnitSplitName(szCmd, szName, sizeof(szName), &unit) == ERROR) {
+		LOGMSG("Invalid GCU unit in \"%s\"...\n", szCmd);
+		UdpSendOpsTxResult(RESULT_TYPE_FAIL, "ERROR");
+		
+		return ERROR;
+	}
+	
+	if ((pCmdItem = findCmd(szName)) == NULL) {
+		LOGMSG("Cannot find \"%s\"...\n", szCmd);
+		UdpSendOpsTxResult(RESULT_TYPE_FAIL, "ERROR");
+		
 		return ERROR;
+	}
+	tResolve = isClockNs();
 	
-	if (strlen(szArg) <=2)
+	if ((pJob = allocJob(this)) == NULL) {
+		LOGMSG("No free job slot for \"%s\"...\n", szCmd);
+		this->poolStats.numRejected++;
+		UdpSendOpsTxResult(RESULT_TYPE_FAIL, "BUSY");
+		
 		return ERROR;
+	}
+	
+	pJob->isTagged = isTagged;
+	pJob->stamps.t[CMD_STAMP_RECV] = this->tRecv;
+	pJob->stamps.t[CMD_STAMP_RESOLVE] = tResolve;
 	
-	if (szArg[0] != '0' || szArg[1] != 'x'_OvrInitEms
+	if (CmdArgsParse(&pJob->args, szArg, GUI_CMD_ARG_MAX_SIZE) == ERROR) {
+		LOGMSG("CmdArgsParse: Invalid Arguments.\n");
+		txJobResult(JOB_TAG(pJob), RESULT_TYPE_FAIL, "ERROR");
+		releaseJob(this, pJob);
 		return ERROR;
+	}
+	
+	pJob->args.unit = unit;
+	pJob->pCmdItem = pCmdItem;
+	pJob->stamps.t[CMD_STAMP_PARSE] = isClockNs();
+	pJob->state = CMD_JOB_PENDING;
+	
+	this->pendingJobs[this->numPending++] = pJob - this->jobs;
+	dispatchJobs(this);
+	
+	return OK;
+}
+
+LOCAL void removePending(CmdExecInst *this, int jobIdx) {
+	int i;
+	
+	for (i = 0; i < this->numPending; i++) {
+		if (this->pendingJobs[i] == jobIdx) {
+			memmove(&this->pendingJobs[i], &this->pendingJobs[i + 1],
+					(this->numPending - i - 1) * sizeof(int));
+			this->numPending--;
+			return;
+		}
+	}
+}
+
+LOCAL UINT64 jobResMask(const CmdJob *pJob) {
+	UINT32 resMask = pJob->pCmdItem->resMask;
+	
+	if (resMask == CMD_RES_ALL)
+		return ~0ULL;
+	
+	return (UINT64)(resMask & ~CMD_RES_UNIT) |
+		   ((UINT64)(resMask & CMD_RES_UNIT) << CMD_RES_UNIT_SHIFT(pJob->args.unit));
+}
+
+/*
+ * Hands pending jobs to the workers in request order. A job may overtake
+ * an earlier pending job only if it shares no resource with it, so
+ * conflicting commands still run in the order they were requested.
+ */
+LOCAL void dispatchJobs(CmdExecInst *this) {
+	CmdJob *pJob;
+	UINT64 resBlocked = CMD_RES_NONE;
+	UINT64 resMask;
+	int i = 0, jobIdx;
+	
+	while (i < this->numPending) {
+		jobIdx = this->pendingJobs[i];
+		pJob = &this->jobs[jobIdx];
+		resMask = jobResMask(pJob);
+		
+		if (resMask & (this->resOwned | resBlocked)) {
+			resBlocked |= resMask;
+			i++;
+			continue;
+		}
+		
+		removePending(this, jobIdx);
 		
-	szArg += 2;
+		this->resOwned |= resMask;
+		pJob->resHeld = resMask;
+		pJob->state = CMD_JOB_QUEUED;
+		
+		if (msgQSend(this->jobQId, (char *)&jobIdx, sizeof(jobIdx),
+					 NO_WAIT, MSG_PRI_NORMAL) == ERROR) {
+			LOGMSG("msgQSend(jobQ) error!\n");
+			txJobResult(JOB_TAG(pJob), RESULT_TYPE_FAIL, "ERROR");
+			releaseJob(this, pJob);
+		}
+	}
+}
+
+LOCAL BOOL isStopTarget(const CmdJob *pJob, const char *szTarget) {
+	char szName[CMD_NAME_MAX_LEN];
+	int unit;
+	
+	if ((szTarget == NULL) || (szTarget[0] == '\0'))
+		return TRUE;
 	
-	g_dwArgMask = 0;
+	if (szTarget[0] == '#')
+		return (strtoul(szTarget + 1, NULL, 0) == pJob->jobId) ? TRUE : FALSE;
+	
+	if ((GcuUnitSplitName(szTarget, szName, sizeof(szName), &unit) == ERROR) ||
+		(strcmp(szName, pJob->pCmdItem->name) != 0))
+		return FALSE;
+	
+	return ((strchr(szTarget, GCU_UNIT_SEP) == NULL) || (unit == pJob->args.unit)) ? TRUE : FALSE;
+}
+
+/*
+ * szTarget selects the jobs to stop: empty stops every job, "#<jobId>"
+ * stops one job, a command name stops every job of that command and
+ * "name@n" only those on GCU unit n.
+ * A job that has not started reports STOPPED at once; a running job is
+ * asked to cancel and reports STOPPED once its worker is idle, and
+ * OnChkCancel() deletes the worker if it does not stop in time. The
+ * STOPPED of a tagged job carries its id. A stop that selects no job
+ * fails with "NO JOB".
+ */
+LOCAL STATUS stopCmd(CmdExecInst *this, const char *szTarget) {
+	CmdJob *pJob;
+	int i, numCancelled = 0, numMatched = 0;
 	
-	while ((ch = *szArg) != 0) {
-		g_dwArgMask <<= 4;
+	for (i = 0; i < CMD_JOB_NUM; i++) {
+		pJob = &this->jobs[i];
 		
-		if (ch == '*') {
-			*szArg = '0';
-		} else {
-			g_dwArgMask |= 0xF;
+		if ((pJob->state == CMD_JOB_FREE) || (isStopTarget(pJob, szTarget) == FALSE))
+			continue;
+		
+		numMatched++;
+		
+		if (pJob->state == CMD_JOB_PENDING) {
+			txJobResult(JOB_TAG(pJob), RESULT_TYPE_STOPPED, "STOP");
+			removePending(this, i);
+			releaseJob(this, pJob);
+			continue;
+		}
+		
+		/*
+		 * Still in jobQ: the worker that picks it up skips it. If a worker
+		 * took it first, it is stopped below as a running job.
+		 */
+		if ((pJob->state == CMD_JOB_QUEUED) &&
+			vxAtomic32Cas(&pJob->state, CMD_JOB_QUEUED, CMD_JOB_CANCELLED)) {
+			txJobResult(JOB_TAG(pJob), RESULT_TYPE_STOPPED, "STOP");
+			continue;
 		}
 		
-		szArg++;
+		if ((pJob->state != CMD_JOB_RUNNING) || (pJob->cancelReq))
+			continue;
+		
+		pJob->tStopReq = isClockNs();
+		pJob->cancelReq = TRUE;
+		TmWaitAbort(this->workers[pJob->workerIdx].tid);
+		numCancelled++;
+	}
+	
+	dispatchJobs(this);
+	
+	if (numCancelled > 0) {
+		addDeferredWork(g_hCmdExec, GET_DELAY_TICK(CMD_CANCEL_TIMEOUT_MS),
+						CMD_EXEC_CHK_CANCEL);
+	} else if (numMatched == 0) {
+		UdpSendOpsTxResult(RESULT_TYPE_FAIL, "NO JOB");
 	}
 	
 	return OK;
 }
 
-LOCAL STATUS parseArgs(char *szArg) {
-	char *pToken;
-	int i = 0;
+LOCAL STATUS killWorker(CmdExecInst *this, CmdJob *pJob) {
+	int workerIdx = pJob->workerIdx;
+	CmdWorker *pWorker = &this->workers[workerIdx];
 	
-	removeBlank(szArg);
+	if (taskIdVerify(pWorker->tid) == OK) {
+		if (taskDelete(pWorker->tid) == ERROR) {
+			DEBUG("taskDelete(%s) error!\n", pWorker->name);
+			return ERROR;
+		}
+	}
 	
-	memset(g_szArgs, 0, sizeof(g_szArgs));
-	g_dwArgMask = UINT32_MAX;
+	TmWaitDrop(pWorker->tid);
 	
-	pToken = strtok(szArg, ",");
-	if (pToken == NULL) {
-		strcpy(g_szArgs[0], szArg);
-		setArgMask(g_szArgs[0]);
-	} else {
-		for (i = 0; i < GUI_CMD_ARG_MAX_NUM && pToken != NULL; i++) {
-			if (pToken) {
-				strycpy(g_szArgs[i], pToken);
-				setArgMask(g_szArgs[i]);
-			}
+	pWorker->tid = TASK_ID_NULL;
+	pWorker->jobIdx = CMD_JOB_IDX_QUIT;
+	releaseJob(this, pJob);
+	
+	return spawnWorker(this, workerIdx);
+}
+
+/*
+ * Last resort for a command that did not reach a cancellation point
+ * within CMD_CANCEL_TIMEOUT_MS of its stop request. A stop requested
+ * after the one that armed this check is not due yet; the check is
+ * armed again for the earliest of those.
+ */
+LOCAL void OnChkCancel(CmdExecInst *this) {
+	CmdJob *pJob;
+	UINT64 tNow = isClockNs();
+	UINT32 jobId, elapsedMs;
+	UINT32 nextMs = 0;
+	int i;
+	
+	for (i = 0; i < CMD_JOB_NUM; i++) {
+		pJob = &this->jobs[i];
+		
+		if ((pJob->state != CMD_JOB_RUNNING) || (!pJob->cancelReq))
+			continue;
+		
+		elapsedMs = isClockNsToUs(tNow - pJob->tStopReq) / 1000;
+		if (elapsedMs < CMD_CANCEL_TIMEOUT_MS) {
+			if ((nextMs == 0) || (CMD_CANCEL_TIMEOUT_MS - elapsedMs < nextMs))
+				nextMs = CMD_CANCEL_TIMEOUT_MS - elapsedMs;
+			continue;
+		}
+		
+		LOGMSG("\"%s\" did not stop in %d ms, deleting worker.\n",
+			   pJob->pCmdItem->name, CMD_CANCEL_TIMEOUT_MS);
+		
+		this->poolStats.numForcedStops++;
+		recordStop(this, pJob, tNow);
+		
+		jobId = JOB_TAG(pJob);
+		
+		if (killWorker(this, pJob) == ERROR) {
+			txJobResult(jobId, RESULT_TYPE_FAIL, "ERROR");
+			continue;
+		}
+		
+		txJobResult(jobId, RESULT_TYPE_STOPPED, "STOP");
+	}
+	
+	if (nextMs > 0)
+		addDeferredWork(g_hCmdExec, GET_DELAY_TICK(nextMs), CMD_EXEC_CHK_CANCEL);
+	
+	dispatchJobs(this);
+}
+
+LOCAL void recordStop(CmdExecInst *this, const CmdJob *pJob, UINT64 tIdle) {
+	CmdPoolStats *pStats = &this->poolStats;
+	UINT32 stopUs = isClockNsToUs(tIdle - pJob->tStopReq);
+	
+	pStats->numStops++;
+	pStats->lastStopUs = stopUs;
+	if (stopUs > pStats->maxStopUs)
+		pStats->maxStopUs = stopUs;
+}
+
+/* jobId 0 is an untagged job or none: the value is sent as is. */
+LOCAL void txJobResult(UINT32 jobId, OPS_TYPE_RESULT_TYPE eResult, const char *szValue) {
+	if (jobId == 0)
+		UdpSendOpsTxResult(eResult, "%s", szValue);
+	else
+		UdpSendOpsTxResult(eResult, "#%u %s", jobId, szValue);
+}
+
+LOCAL CmdJob *findSelfJob(void) {
+	CmdExecInst *this = &g_stCmdExecInst;
+	TASK_ID tid = taskIdSelf();
+	int i, jobIdx;
+	
+	for (i = 0; i < CMD_WORKER_NUM; i++) {
+		if (this->workers[i].tid == tid) {
+			jobIdx = this->workers[i].jobIdx;
 			
-			pToken = strtok(NULL, ",");
+			return (jobIdx == CMD_JOB_IDX_QUIT) ? NULL : &this->jobs[jobIdx];
 		}
 	}
 	
-	return OK;
+	return NULL;
 }
 
-LOCAL STATUS startcmd(CmdExecInst *this, char *szCmd, char *szArg) {
-	SYMBOL_DESC symbolDesc;
-	FUNCPTR pfnCmdFunc;
-	
-	memset(&symbolDesc, 0, sizeof(SYMBOL_DESC));
-	symbolDesc.mask = SYM_FIND_BY_NAME;
-	symbolDesc.name = szCmd;
-	
-	if (symFind(this->cmdTblId, &symbolDesc) == OK {
-		// printf ("Symbol name : %s\n", symbolDesc.name);
-	} else {
-		LOGMSG("Cannot fine \*%s\"...\n", szCmd);
-		printErrno(errnoGet());
-		UdpSendOpsTxResult(RESULT TYPE FAIL, "ERROR");
-		
-		return ERROR:
+/* Records the first time the calling job reaches the given stamp. */
+void CmdExecStamp(CmdStamp stamp) {
+	CmdExecStampAt(stamp, isClockNs());
+}
+
+/*
+ * As CmdExecStamp() for an event that happened at timeNs, e.g. the
+ * HwTimeCount() of a received frame; the stamps are on isClockNs().
+ */
+void CmdExecStampAt(CmdStamp stamp, UINT64 timeNs) {
+	CmdJob *pJob = findSelfJob();
+	
+	if ((pJob != NULL) && (pJob->stamps.t[stamp] == 0) && (timeNs != 0)) {
+		pJob->stamps.t[stamp] = timeNs;
+	}
+}
+
+BOOL CmdExecIsCancelled(void) {
+	CmdJob *pJob = findSelfJob();
+	
+	return ((pJob != NULL) && (pJob->cancelReq)) ? TRUE : FALSE;
+}
+
+/*
+ * UdpSendOpsTxResult() for command functions. A job started as "name#"
+ * has the value prefixed with "#<jobId> ", the target stopCmd() takes, so
+ * the results of jobs running at once can be told apart; others send the
+ * value as is.
+ */
+void CmdExecTxResult(OPS_TYPE_RESULT_TYPE eResult, const char *fmt, ...) {
+	CmdJob *pJob = findSelfJob();
+	char szValue[CMD_RESULT_MAX_LEN];
+	va_list ap;
+	
+	va_start(ap, fmt);
+	vsnprintf(szValue, sizeof(szValue), fmt, ap);
+	va_end(ap);
+	
+	txJobResult((pJob != NULL) ? JOB_TAG(pJob) : 0, eResult, szValue);
+}
+
+void CmdExecTxResultTx(OPS_TYPE_RESULT_TYPE eResult, const void *pData, int len,
+					   const char *szValue) {
+	CmdJob *pJob = findSelfJob();
+	char szTagged[CMD_RESULT_MAX_LEN];
+	
+	if ((pJob == NULL) || !pJob->isTagged) {
+		UdpSendOpsTxResultTx(eResult, pData, len, szValue);
+		return;
 	}
 	
-	if (SYM_IS_TEST(symbolDesc.type) == 0) {
-		LOGMSG("\"%s\" is not .text...!\n", szCmd);
-		UdpSendOpsTxResult(RESULT_TYPE_FAIL, "ERROR");
+	snprintf(szTagged, sizeof(szTagged), "#%u %s", pJob->jobId, szValue);
+	UdpSendOpsTxResultTx(eResult, pData, len, szTagged);
+}
+
+/*
+ * taskDelay() for command functions: sleeps in CMD_CANCEL_POLL_MS slices
+ * and returns ERROR as soon as the calling job is asked to stop.
+ */
+STATUS CmdExecDelay(int ticks) {
+	CmdJob *pJob = findSelfJob();
+	int slice = GET_DELAY_TICK(CMD_CANCEL_POLL_MS);
+	int n;
+	
+	if (pJob == NULL)
+		return taskDelay(ticks);
+	
+	if (slice < 1)
+		slice = 1;
+	
+	while (ticks > 0) {
+		if (pJob->cancelReq)
+			return ERROR;
 		
-		return ERROR;
+		n = (ticks < slice) ? ticks : slice;
+		taskDelay(n);
+		ticks -= n;
 	}
 	
-	if ((strcmp(szCmd, "mtsNavDataInput") == 0) ||
-		(strcmp(szCmd, "mtsLnsALignStart") == 0)) {
-		memcpy(g_szArgs[0], szArg, GUI_CMD_ARG_MAX_SIZE);
-	} else if (parseArgs(szArg) == ERROR) {
-		LOGMSG("parseArgs: Invalid Arguments.\n");
-		UdpSendOpsTxResult(RESULT_TYPE_FAIL, "ERROR");
+	return (pJob->cancelReq) ? ERROR : OK;
+}
+
+LOCAL STATUS spawnWorker(CmdExecInst *this, int workerIdx) {
+	CmdWorker *pWorker = &this->workers[workerIdx];
+	
+	snprintf(pWorker->name, sizeof(pWorker->name), "tCmdWorker%d", workerIdx);
+	pWorker->jobIdx = CMD_JOB_IDX_QUIT;
+	pWorker->tid = taskSpawn(pWorker->name, CMD_WORKER_PRIORITY, VX_FP_TASK,
+							 CMD_WORKER_STACK_SIZE, (FUNCPTR)cmdWorkerMain,
+							 (_Vx_usr_arg_t)this, workerIdx, 0, 0, 0, 0, 0, 0, 0, 0);
+	if (pWorker->tid == TASK_ID_ERROR) {
+		LOGMSG("taskSpawn(%s) error!\n", pWorker->name);
+		pWorker->tid = TASK_ID_NULL;
 		return ERROR;
 	}
 	
-	pfnCmdFunc = (FUNCPTR)symbolDesc.value;
-	this->tidCmdExec = taskSpawn(szCmd, 100, 8, 100000, (FUNCPTR)pfnCmdFunc, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
-	
 	return OK;
 }
 
-LOCAL STATUS stopCmd(CmdExecInst *this) {
-	if (taskIdVerify(this->tidCmdExec) == OK) {
-		// if (taskSuspend(this->tidCmdExec) == ERROR) {
-		//		DEBUG("taskSuspend(tidCmdExec) error!\n");
-		//		UdpSendOpsTxResult(RESULT_TYPE_FAIL, "ERROR");
-		//		return ERROR;
-		// }
-		// taskDelay(10);
-	if (taskDelete(this->tidCmdExec) == ERROR) {
-		DEBUG("taskDelete(tidCmdExec) error!\n");
-		UdpSendOpsTxResult(RESULT_TYPE_FAIL, "ERROR");
-		return ERROR;
+LOCAL void cmdWorkerMain(CmdExecInst *this, int workerIdx) {
+	CmdWorker *pWorker = &this->workers[workerIdx];
+	CmdExecMsg stDoneMsg;
+	CmdJob *pJob;
+	int jobIdx;
+	
+	stDoneMsg.cmd = CMD_EXEC_JOB_DONE;
+	stDoneMsg.len = sizeof(CmdExecJobDone);
+	
+	FOREVER {
+		if (msgQReceive(this->jobQId, (char *)&jobIdx, sizeof(jobIdx),
+						WAIT_FOREVER) == ERROR) {
+			LOGMSG("[%s] msgQReceive() Error!\n", pWorker->name);
+			break;
+		}
+		
+		if ((jobIdx < 0) || (jobIdx >= CMD_JOB_NUM))
+			break;
+		
+		pJob = &this->jobs[jobIdx];
+		
+		/* workerIdx first: stopCmd() aborts the waits of a RUNNING job's worker. */
+		pJob->workerIdx = workerIdx;
+		pJob->stamps.t[CMD_STAMP_START] = isClockNs();
+		
+		if (vxAtomic32Cas(&pJob->state, CMD_JOB_QUEUED, CMD_JOB_RUNNING)) {
+			pWorker->jobIdx = jobIdx;
+			
+			pJob->pCmdItem->pfn(&pJob->args);
+			
+			pJob->stamps.t[CMD_STAMP_RESULT] = isClockNs();
+			pWorker->jobIdx = CMD_JOB_IDX_QUIT;
+		}
+		
+		stDoneMsg.body.jobDone.jobIdx = jobIdx;
+		stDoneMsg.body.jobDone.jobId = pJob->jobId;
+		PostCmdEx(g_hCmdExec, &stDoneMsg);
 	}
+}
+
+LOCAL CmdJob *allocJob(CmdExecInst *this) {
+	int i;
 	
-	UdpSendOpsTxResult(RESULT_TYPE_STOPPED, "STOP");
-	this->tidCmdExec = TASK_ID_NULL;
-	} else {
-		// LOGMSG("CMD Task was Stopped.\n");
-		UdpSendOpsTxResult(RESULT_TYPE_STOPPED, "STOP");
+	for (i = 0; i < CMD_JOB_NUM; i++) {
+		if (this->jobs[i].state == CMD_JOB_FREE) {
+			memset(&this->jobs[i], 0, sizeof(CmdJob));
+			this->jobs[i].jobId = this->nextJobId++;
+			if (this->nextJobId == 0)
+				this->nextJobId = 1;
+			this->jobs[i].workerIdx = CMD_JOB_IDX_QUIT;
+			
+			return &this->jobs[i];
+		}
 	}
 	
-	return OK;
+	return NULL;
+}
+
+LOCAL void releaseJob(CmdExecInst *this, CmdJob *pJob) {
+	this->resOwned &= ~pJob->resHeld;
+	pJob->resHeld = CMD_RES_NONE;
+	pJob->state = CMD_JOB_FREE;
+	pJob->pCmdItem = NULL;
+}
+
+LOCAL void OnJobDone(CmdExecInst *this, const CmdExecJobDone *pJobDone) {
+	CmdJob *pJob;
+	CmdPoolStats *pStats = &this->poolStats;
+	UINT32 startUs;
+	
+	if ((pJobDone->jobIdx < 0) || (pJobDone->jobIdx >= CMD_JOB_NUM))
+		return;
+	
+	pJob = &this->jobs[pJobDone->jobIdx];
+	
+	/* The slot was already released (and maybe reused) by stopCmd(). */
+	if ((pJob->state == CMD_JOB_FREE) || (pJob->jobId != pJobDone->jobId))
+		return;
+	
+	if (pJob->state == CMD_JOB_RUNNING) {
+		startUs = isClockNsToUs(pJob->stamps.t[CMD_STAMP_START] -
+								pJob->stamps.t[CMD_STAMP_PARSE]);
+		
+		pStats->numJobs++;
+		pStats->lastStartUs = startUs;
+		pStats->sumStartUs += startUs;
+		if (startUs > pStats->maxStartUs)
+			pStats->maxStartUs = startUs;
+		
+		if (pJob->cancelReq) {
+			recordStop(this, pJob, pJob->stamps.t[CMD_STAMP_RESULT]);
+			txJobResult(JOB_TAG(pJob), RESULT_TYPE_STOPPED, "STOP");
+		} else {
+			CmdStatsRecord(pJob->pCmdItem - g_cmdTblItems, pJob->pCmdItem->name,
+						   &pJob->stamps);
+		}
+	}
+	
+	releaseJob(this, pJob);
+	dispatchJobs(this);
 }
 
 void CmdExecMain(ModuleInst *pModuleInst) {
@@ -463,4 +994,120 @@ void CmdExecMain(ModuleInst *pModuleInst) {
 		LOGMSG("FinalizeCmdExec() error!\n");
 	}
 }
-			
\ No newline at end of file
+			
+
+/*
+ * Shell helper: compares findCmd() against the symFind() lookup that
+ * CmdExec used before, over every entry of g_cmdTblItems.
+ */
+void cmdExecBenchLookup(int nLoops) {
+	char *pPool;
+	PART_ID partId;
+	SYMTAB_ID symTblId;
+	SYMBOL_DESC symbolDesc;
+	UINT64 tStart, tSymFind, tFindCmd;
+	int i, loop, nMiss = 0;
+	
+	if (nLoops <= 0)
+		nLoops = 1000;
+	
+	if ((pPool = (char *)malloc(CMD_TBL_POOL_SIZE)) == NULL) {
+		printf("malloc(%d) error!\n", CMD_TBL_POOL_SIZE);
+		return;
+	}
+	
+	if ((partId = memPartCreate(pPool, CMD_TBL_POOL_SIZE)) == NULL) {
+		printf("memPartCreate() error! (errNo: 0x%08X)\n", errnoGet());
+		free(pPool);
+		return;
+	}
+	
+	if ((symTblId = symTblCreate(7, FALSE, partId)) == NULL) {
+		printf("symTblCreate() error! (errNo: 0x%08X)\n", errnoGet());
+		memPartDelete(partId);
+		free(pPool);
+		return;
+	}
+	
+	for (i = 0; i < g_numCmdFunc; i++) {
+		symAdd(symTblId, (char *)g_cmdTblItems[i].name,
+			   (SYM_VALUE)g_cmdTblItems[i].pfn, SYM_GLOBAL | SYM_TEXT, 1);
+	}
+	
+	tStart = isClockNs();
+	for (loop = 0; loop < nLoops; loop++) {
+		for (i = 0; i < g_numCmdFunc; i++) {
+			memset(&symbolDesc, 0, sizeof(SYMBOL_DESC));
+			symbolDesc.mask = SYM_FIND_BY_NAME;
+			symbolDesc.name = (char *)g_cmdTblItems[i].name;
+			
+			if (symFind(symTblId, &symbolDesc) == ERROR)
+				nMiss++;
+		}
+	}
+	tSymFind = isClockNs() - tStart;
+	
+	tStart = isClockNs();
+	for (loop = 0; loop < nLoops; loop++) {
+		for (i = 0; i < g_numCmdFunc; i++) {
+			if (findCmd(g_cmdTblItems[i].name) == NULL)
+				nMiss++;
+		}
+	}
+	tFindCmd = isClockNs() - tStart;
+	
+	for (i = 0; i < g_numCmdFunc; i++) {
+		symRemove(symTblId, (char *)g_cmdTblItems[i].name, SYM_GLOBAL | SYM_TEXT);
+	}
+	symTblDelete(symTblId);
+	memPartDelete(partId);
+	free(pPool);
+	
+	printf("\n %d commands x %d loops (miss: %d)", g_numCmdFunc, nLoops, nMiss);
+	printf("\n symFind()  : %8u ns/lookup",
+		   (UINT32)(tSymFind / ((UINT64)nLoops * g_numCmdFunc)));
+	printf("\n findCmd()  : %8u ns/lookup",
+		   (UINT32)(tFindCmd / ((UINT64)nLoops * g_numCmdFunc)));
+	printf("\n");
+}
+
+void cmdExecShowPool(void) {
+	CmdExecInst *this = &g_stCmdExecInst;
+	CmdPoolStats *pStats = &this->poolStats;
+	CmdJob *pJob;
+	int i, numBusy = 0;
+	
+	static const char *szJobState[] = {
+		"FREE", "PENDING", "QUEUED", "RUNNING", "CANCELLED"
+	};
+	
+	for (i = 0; i < CMD_WORKER_NUM; i++) {
+		if (this->workers[i].jobIdx != CMD_JOB_IDX_QUIT)
+			numBusy++;
+	}
+	
+	printf("\n workers busy		= %d / %d", numBusy, CMD_WORKER_NUM);
+	printf("\n job queue depth		= %d", (this->jobQId) ? msgQNumMsgs(this->jobQId) : 0);
+	printf("\n jobs pending		= %d", this->numPending);
+	printf("\n resources owned		= 0x%016llX", (unsigned long long)this->resOwned);
+	printf("\n jobs done			= %u", pStats->numJobs);
+	printf("\n jobs rejected		= %u", pStats->numRejected);
+	printf("\n start latency (us)	= last %u, avg %u, max %u",
+		   pStats->lastStartUs,
+		   (pStats->numJobs) ? (UINT32)(pStats->sumStartUs / pStats->numJobs) : 0,
+		   pStats->maxStartUs);
+	printf("\n stops				= %u (forced %u)", pStats->numStops, pStats->numForcedStops);
+	printf("\n stop to idle (us)	= last %u, max %u", pStats->lastStopUs, pStats->maxStopUs);
+	printf("\n");
+	
+	for (i = 0; i < CMD_JOB_NUM; i++) {
+		pJob = &this->jobs[i];
+		if (pJob->state == CMD_JOB_FREE)
+			continue;
+		
+		printf("\n #%-6u %-29s@%-2d %-10s worker %d res 0x%08X", pJob->jobId,
+			   pJob->pCmdItem->name, pJob->args.unit, szJobState[pJob->state],
+			   pJob->workerIdx, pJob->pCmdItem->resMask);
+	}
+	printf("\n");
+}
@@ -4,10 +4,10 @@
 
 #include "../lib/util/ModuleCommon.h"
 #include "typeDef/opsType.h"
+#include "CmdArgs.h"
+#include "CmdStats.h"
 
 #define CMD_EXEC_TASK_NAME		"tCmdExec"
-#define GUI_CMD_ARG_MAX_NUM		(10)
-#define GUI_CMD_ARG_MAX_SIZE	OPS_TYPE_ARGS_BUF_LEN
 
 typedef enum {
 	CMD_EXEC_NULL,
@@ -15,19 +15,32 @@ typedef enum {
 	CMD_EXEC_STOP,
 	CMD_EXEC_QUIT,
 	CMD_EXEC_EXECUTE,
+	CMD_EXEC_JOB_DONE,
+	CMD_EXEC_CHK_CANCEL,
 	CMD_EXEC_MAX
 } CmdExecCmd;
 
+typedef struct {
+	int		jobIdx;
+	UINT32	jobId;
+} CmdExecJobDone;
+
 typedef struct {
 	unsigned int	cmd;
 	unsigned int 	len;
 	union {
 		unsigned char 			buf[1];
 		OPS_TYPE_TEST_CONTROL	testControl;
+		CmdExecJobDone			jobDone;
 	} body;
 } CmdExecMsg;
 
 IMPORT const 	ModuleInst *g_hCmdExec;
-IMPORT char 	g_szArgs[GUI_CMD_ARG_MAX_NUM][GUI_CMD_ARG_MAX_SIZE]'
-IMPORT UINT32	g_dwArgMask;
 IMPORT void 	CmdExecMain(ModuleInst *pModuleInst);
+IMPORT void		CmdExecStamp(CmdStamp stamp);
+IMPORT void		CmdExecStampAt(CmdStamp stamp, UINT64 timeNs);
+IMPORT BOOL		CmdExecIsCancelled(void);
+IMPORT STATUS	CmdExecDelay(int ticks);
+IMPORT void		CmdExecTxResult(OPS_TYPE_RESULT_TYPE eResult, const char *fmt, ...);
+IMPORT void		CmdExecTxResultTx(OPS_TYPE_RESULT_TYPE eResult, const void *pData, int len,
+								  const char *szValue);
@@ -11,6 +11,8 @@
 #include <usrFsLib.h>
 
 #include "../lib/util/isDebug.h"
+#include "../lib/util/isClock.h"
+#include "../lib/util/isCksum.h"
 #include "../lib/util/isUtil.h"
 #include "../lib/util/isProfile.h"
 #include "../lib/mtsLibPsCtrl.h"
@@ -21,9 +23,20 @@
 #include "typeDef/opsType.h"
 #include "CmdFuncs.h"
 #include "CmdExec.h"
+#include "PwrChan.h"
+#include "TmWait.h"
+#include "TmField.h"
+#include "TmLimit.h"
+#include "BulkXfer.h"
+#include "ImgStream.h"
+#include "AssetCache.h"
 #include "UdpSendOps.h"
 #include "SdlcRecvGcu.h"
 #include "SdlcSendGcu.h"
+#include "GcuUnit.h"
+#include "HwTime.h"
+#include "GcuLatency.h"
+#include "LinkStats.h"
 #include "SimHotStart.h"
 #include "UdpSendLar.h"
 #include "UdpRecvLar.h"
@@ -37,14 +50,22 @@
 #define GCU_RESPONSE_TIME		(200)
 #define LAR_RESPONSE_TIME 		(200)
 #define CHK_DBL_TOLERANCE		(0.0000000001)
+#define CHK_TM_MULTI_MAX		(GUI_CMD_ARG_MAX_NUM - 1)
 #define	PWR_SUPPLY_MAX_VOLT		(150.0)
 #define PWR_SUPPLY_MAX_AMP		(18.0)
-#define GCU_IMG_BUFF_LENGTH		(0x00280000)
-#define RDC_DATA_BUFF_LENGTH	(0x00300000)
-#define DATA_BLOCK_SIZE			(0x00020000)
+#define GCU_IMG_MAX_LENGTH		(0x00280000)
+#define RDC_DATA_MAX_LENGTH		(0x00300000)
 #define	GCU_IMG_FILE			NET_DEV_REPO_NAME "/GCU.bin"
 #define RDC_DATA_FILE			NET_DEV_REPO_NAME "/RDC.bin"
 
+#define ABAT_VTG_LSB			(0.01)
+#define ABAT_ON_VOLT			(100.0)
+#define ABAT_ON_TIMEOUT			(15000)
+#define ABAT_OFF_VOLT			(1.2)
+#define ABAT_OFF_TIMEOUT		(20000)
+#define FIN_SETTLE_STEPS		(35)
+#define FIN_SETTLE_STEP_MS		(100)
+
 #define HOTSTART_TIMEOUT		(3000)
 #define SQUIB_PULSE_DURATION	(100)
 #define LNS_BOOT_TIMEOUT		(5000)
@@ -53,46 +74,124 @@
 #define LNS_LF2_RESPONSE_TIME	(200)
 
 #define MTS_VIP_FILE			NET_DEV_REPO_NAME "/vxWorks"
+#define MTS_VIP_LOCAL_FILE		"/mmc1/vxWorks"
 
 #define REPORT_ERROR(fmt, args...)
 	do {
 		LOGMSG(fmt, ##args);
-		UdpSendOpsTxResult(RESULT_TYPE_FAIL, "ERROR");
+		CmdExecTxResult(RESULT_TYPE_FAIL, "ERROR");
 	} while (0)
 		
+/* Commands run concurrently: szResultValue[] is a local of the command. */
 #define SET_RESULT_VALUE(fmt, args...)
 	do {
-		snprintf(g_szResultValue, sizeof(g_szResultValue),
+		snprintf(szResultValue, sizeof(szResultValue),
 				fmt, ##args);
 	} while (0)
 
-#define TRY_STR_TO_LONG(dst, argIdx, casting)
+#define ARG_STR(argIdx)			(pArgs->arg[argIdx].str)
+#define ARG_BLOB(argIdx)		(pArgs->arg[argIdx].pBlob)
+#define ARG_BLOB_LEN(argIdx)	(pArgs->arg[argIdx].blobLen)
+
+#define TRY_ARG_TO_LONG(dst, argIdx, casting)
+	do {
+		if (!pArgs->arg[argIdx].isLong) {
+			REPORT_ERROR("Invalid Argument. [#%d(%s)]\n",
+						argIdx, ARG_STR(argIdx));
+			return ERROR;
+		}
+		dst = (casting)pArgs->arg[argIdx].lVal;
+	} while (0)
+
+#define TRY_ARG_TO_DOUBLE(dst, argIdx)
+	do {
+		if (!pArgs->arg[argIdx].isDouble) {
+			REPORT_ERROR("Invalid Argument. [#%d(%s)]\n",
+						argIdx, ARG_STR(argIdx));
+			return ERROR;
+		}
+		dst = pArgs->arg[argIdx].dVal;
+	} while (0)
+
+#define TRY_ARG_TO_PWR_CHAN(dst, argIdx)
 	do {
-		dst = (casting)strtol(g_szArgs[argIdx], &g_endptr, 0);
-		if ((g_endptr == g_szArgs[argIdx]) || (errno != 0)) {
+		if ((dst = PwrChanResolve(&pArgs->arg[argIdx])) == NULL) {
 			REPORT_ERROR("Invalid Argument. [#%d(%s)]\n",
-						argIdx, g_szArgs[argIdx]);
+						argIdx, ARG_STR(argIdx));
 			return ERROR;
 		}
 	} while (0)
 
-#define WAIT_RESPONSE_MASK(numTrial, tickPoll, refVal, targetVal, targetVar, chkMask, resultVar)
+#define RETURN_IF_CANCELLED()
+	do {
+		if (CmdExecIsCancelled()) {
+			LOGMSG("Cancelled.\n");
+			return ERROR;
+		}
+	} while (0)
+
+#define CMD_DELAY_TICK(tick)
+	do {
+		if (CmdExecDelay(tick) == ERROR) {
+			LOGMSG("Cancelled.\n");
+			return ERROR;
+		}
+	} while (0)
+#define CMD_DELAY_MS(ms)		CMD_DELAY_TICK(GET_DELAY_TICK(ms))
+#define CMD_DELAY_SEC(sec)		CMD_DELAY_TICK(GET_DELAY_TICK((sec) * 1000))
+
+/*
+ * A polled value has no receipt time, and the wake-up that sees it may be
+ * a whole poll later, so it does not stamp CMD_STAMP_FIRST_RESP.
+ */
+#define POLL_RESPONSE_MASK(numTrial, tickPoll, refVal, targetVal, targetVar, chkMask, resultVar)
 	do {
 		int waitLoopIdx;
 		for (waitLoopIdx = 0; waitLoopIdx < (numTrial); waitLoopIdx++) {
 			taskDelay((tickPoll));
+			RETURN_IF_CANCELLED();
 			targetVar = (targetVal);
 			resultVar = mtsCheckEqual((refVal), targetVar & (chkMask));
-			if (resultVar == RESULT_TYPE_PASS) {
+			if (resultVar == RESULT_TYPE_PASS)
 				break;
-			}
 		}
 	} while (0)
+
+#define WAIT_TM_FIELD_RX(src, timeout, field, chkMask, op, refVal, targetVar, resultVar, rxCountVar)
+	do {
+		TmWaitPred waitPred;
+		INT32 waitVal;
+		TM_WAIT_PRED_INIT(waitPred, GCU_SRC(pUnit, src), field, chkMask, op, refVal);
+		if (TmWaitFor(&waitPred, (timeout), CmdExecIsCancelled, &waitVal, &(rxCountVar)) == OK) {
+			resultVar = RESULT_TYPE_PASS;
+		} else {
+			RETURN_IF_CANCELLED();
+			resultVar = RESULT_TYPE_FAIL;
+		}
+		targetVar = waitVal;
+	} while (0)
+#define WAIT_TM_FIELD(src, timeout, field, chkMask, op, refVal, targetVar, resultVar)
+	do {
+		UINT64 waitRxCount;
+		WAIT_TM_FIELD_RX(src, timeout, field, chkMask, op, refVal, targetVar, resultVar, waitRxCount);
+	} while (0)
+
+/*
+ * The response is stamped when its frame was received, not when the wait
+ * returned, including a response already in when the wait starts.
+ */
+#define WAIT_RESPONSE_MASK(src, timeout, refVal, targetVal, targetVar, chkMask, resultVar)
+	do {
+		UINT64 respRxCount;
+		WAIT_TM_FIELD_RX(src, timeout, targetVal, chkMask, TM_WAIT_OP_EQ, refVal, targetVar, resultVar, respRxCount);
+		if (resultVar == RESULT_TYPE_PASS)
+			CmdExecStampAt(CMD_STAMP_FIRST_RESP, respRxCount);
+	} while (0)
 		
-#define WAIT_RESPONSE(numTrial, tickPoll, refVal, targetVal, targetVar, resultVar)
-	WAIT_RESPONSE_MASK(numTrial, tickPoll, refVal, targetVal, targetVar, 0xFF00, resultVar)
+#define WAIT_RESPONSE(src, timeout, refVal, targetVal, targetVar, resultVar)
+	WAIT_RESPONSE_MASK(src, timeout, refVal, targetVal, targetVar, 0xFF00, resultVar)
 #define WAIT_LNS_RESPONSE(numTrial, tickPoll, refVal, targetVal, targetVar, resultVar)
-	WAIT_RESPONSE_MASK(numTrial, tickPoll, refVal, targetVal, targetVar, 0xFFFFFFFF, resultVar)
+	POLL_RESPONSE_MASK(numTrial, tickPoll, refVal, targetVal, targetVar, 0xFFFFFFFF, resultVar)
 #define GET_BIT(field, pos)		(((field) >> (pos)) & 0x1)
 
 typedef struct {
@@ -118,21 +217,40 @@ typedef struct {
 	double	aqqc4;
 } VALUE_EX_QUATERNION;
 
-LOCAL char *g_endptr = NULL;
+typedef struct {
+	TmField	field;
+	BOOL	isReportOnly;
+	long	refVal;
+	double	refMin;
+	double	refMax;
+} CHK_TM_ITEM;
+
+/* GCU image loaded by mtsGcuLoad and its upload, per GCU unit. */
+typedef struct {
+	int				totalBytes;
+	IsCksum			cksum;
+	BulkXferResume	resume;
+} GCU_IMG_STATE;
 
-LOCAL char g_szResultValue[80] = {0, };
+LOCAL GCU_IMG_STATE g_stGcuImg[GCU_UNIT_MAX];
 
-LOCAL int g_nGcuImgTotalBytes;
-LOCAL char g_pGcuImgBuf[GCU_IMG_BUFF_LENGTH];
-LOCAL int g_nRdcDataTotalBytes;
-LOCAL char g_pRdcDataBuf[GCU_IMG_BUFF_LENGTH];
+LOCAL const char *g_szAssetFiles[] = {
+	GCU_IMG_FILE,
+	RDC_DATA_FILE,
+	SIM_HOTSTART_DATA_FILE,
+	MTS_VIP_FILE
+};
 
 LOCAL int mtsCheckEqual(int nReference, int nMeasure);
 LOCAL int mtsCheckRange(double dLowerLimit, double dUpperLimit, double dMeasure);
 LOCAL int mtsCheckDouble(double reference, double measure, double tolerance);
 
-LOCAL int mtsMakeChecksum(void *pBuf, UINT32 dwLen);
 LOCAL int mtsCalProgress(int x, int y);
+LOCAL STATUS postGcuCmd(GcuUnit *pUnit, int cmd, UINT16 opcode);
+LOCAL STATUS setPwrChan(const PwrChan *pChan, int on);
+LOCAL STATUS measurePwrChan(const CmdArgs *pArgs, PwrChanQty qty);
+LOCAL void reportXferProgress(void *arg, int numAcked, int numBlocks);
+LOCAL STATUS uploadGcuImage(ImgStream *pStream, int window, int unit);
 
 LOCAL STATUS mtsTbatSqbOn(void);
 LOCAL STATUS mtsCbatSqbOn(void);
@@ -179,22 +297,77 @@ LOCAL int mtsCheckDouble(double reference, double measure, double tolerance) {
 	return resultType;
 }
 
-LOCAL int mtsMakeChecksum(void *pBuf, UINT32 dwLen) {
-	int i;
-	int checksum;
-	int *imageint = (int *)pBu
+LOCAL int mtsCalProgress(int x, int y) {
+	return (x * 100) / y;
+}
+
+/* opcode is the one set in the FG frame, for the latency of its response. */
+LOCAL STATUS postGcuCmd(GcuUnit *pUnit, int cmd, UINT16 opcode) {
+	if (pUnit->hSend == NULL) {
+		LOGMSG("GCU unit %d has no SdlcSendGcu.\n", pUnit->unit);
+		return ERROR;
+	}
 	
-	checksum = 0;
+	CmdExecStamp(CMD_STAMP_FIRST_POST);
+	pUnit->txTimeNs = HwTimeNow();
+	GcuLatencyTx(pUnit->unit, cmd, opcode, pUnit->txTimeNs);
 	
-	for (i = 0; i < dwLen; i += 4) {
-		checksum += *imageint++;
+	return PostCmd(pUnit->hSend, cmd);
+}
+
+LOCAL STATUS setPwrChan(const PwrChan *pChan, int on) {
+	FOREVER {
+		if (pChan->pfnSet == NULL) {
+			REPORT_ERROR("%s has no power switch.\n", pChan->szName);
+			return ERROR;
+		}
+		
+		if (pChan->pfnSet(on) == ERROR) {
+			REPORT_ERROR("%s Power(%d) Error.\n", pChan->szName, on);
+			return ERROR;
+		}
+		
+		LOGMSG("%s, %s.\n", pChan->szName, on ? "ON" : "OFF");
+		
+		if (pChan->seqNext == PWR_CHAN_NONE)
+			break;
+		
+		DELAY_MS(pChan->seqDelayMs);
+		pChan = PwrChanGet(pChan->seqNext);
 	}
 	
-	return checksum;
+	return OK;
 }
 
-LOCAL int mtsCalProgress(int x, int y) {
-	return (x * 100) / y;
+LOCAL void reportXferProgress(void *arg, int numAcked, int numBlocks) {
+	int *pProgressPrev = (int *)arg;
+	int progressCurr = mtsCalProgress(numAcked, numBlocks);
+	
+	if (progressCurr != *pProgressPrev) {
+		CmdExecTxResult(RESULT_TYPE_ONGOING, "%d", progressCurr);
+		*pProgressPrev = progressCurr;
+	}
+}
+
+LOCAL STATUS measurePwrChan(const CmdArgs *pArgs, PwrChanQty qty) {
+	const PwrChan *pChan;
+	OPS_TYPE_RESULT_TYPE eResult;
+	double dVal;
+	double refMin, refMax;
+	
+	TRY_ARG_TO_PWR_CHAN(pChan, 0);
+	
+	if (PwrChanMeasure(pChan, qty, &dVal) == ERROR) {
+		REPORT_ERROR("Invalid Argument. [#%d(%s)]\n", 0, ARG_STR(0));
+		return ERROR;
+	}
+	
+	TRY_ARG_TO_DOUBLE(refMin, 1);
+	TRY_ARG_TO_DOUBLE(refMax, 2);
+	eResult = mtsCheckRange(refMin, refMax, dVal);
+	CmdExecTxResult(eResult, pChan->szFmt, dVal);
+	
+	return OK;
 }
 	
 
@@ -262,7 +435,7 @@ LOCAL STATUS mtsAbatSqbOn(voO(1) == ERROR) {
 	if (steLibDoSqbAbat1Sqb2(1) == ERROR) {
 		REPORT_ERROR("steLibDoSqbAbat1Sqb2(1) Error.\n");
 		return ERROR;
-		
+	
 	LOGMSG("ABAT1 Squib2, ON.\n");
 	
 	DELAY_MS(SQUIB_PULSE_DURATION);
@@ -316,72 +489,72 @@ LOCAL FUNCPTR findFunc(char *name, SYMTAB_ID symTbl) {
 	return (FUNCPTR)symDesc.value;
 }
 
-STATUS mtsTestFunc(void) {
+STATUS mtsTestFunc(const CmdArgs *pArgs) {
 	LOGMSG("Start...!\n");
 	
 	int i = 10;
 	for (; i > 0; i--) {
-		taskDelay(sysClkRateGet());
+		CMD_DELAY_TICK(sysClkRateGet());
 		LOGMSG("Cnt = %d\n", i);
 	}
 	
 	LOGMSG("End...!\n");
 	
-	UdpSendOpsTxResult(RESULT_TYPE_PASS, "OK");
+	CmdExecTxResult(RESULT_TYPE_PASS, "OK");
 	
 	return OK;
 }
 
-STATUS invokeMethod_uint(void) {
+STATUS invokeMethod_uint(const CmdArgs *pArgs) {
 	FUNCPTR pfnFunc;
 	unsigned int uArg;
 	
-	TRY_STR_TO_LONG(uArg, 1, unsigned int);
+	TRY_ARG_TO_LONG(uArg, 1, unsigned int);
 	
-	if ((pfnFunc = findFunc(g_szArgs[0], NULL)) == NULL) {
-		UdpSendOpsTxResult(RESULT_TYPE_FAIL, "ERROR");
+	if ((pfnFunc = findFunc(ARG_STR(0), NULL)) == NULL) {
+		CmdExecTxResult(RESULT_TYPE_FAIL, "ERROR");
 		
 		return ERROR;
 	}
 	
 	pfnFunc(uArg);
 	
-	UdpSendOpsTxResult(RESULT_TYPE_PASS, "OK");
+	CmdExecTxResult(RESULT_TYPE_PASS, "OK");
 	
 	return OK;
 }
 
-STATUS invokeMethod_uint_double(void) {
+STATUS invokeMethod_uint_double(const CmdArgs *pArgs) {
 	FUNCPTR pfnFunc;
 	unsigned int uArg;
 	double dArg;
 	
-	TRY_STR_TO_LONG(uArg, 1, unsigned int);
-	TRY_STR_TO_DOUBLE(dArg, 2);
+	TRY_ARG_TO_LONG(uArg, 1, unsigned int);
+	TRY_ARG_TO_DOUBLE(dArg, 2);
 	
-	if ((pfnFunc = findFunc(g_szArgs[0], NULL)) == NULL) {
-		UdpSendOpsTxResult(RESULT_TYPE_FAIL, "ERROR");
+	if ((pfnFunc = findFunc(ARG_STR(0), NULL)) == NULL) {
+		CmdExecTxResult(RESULT_TYPE_FAIL, "ERROR");
 		
 		return ERROR;
 	}
 	
 	pfnFunc(uArg, dArg);
 	
-	UdpSendOpsTxResult(RESULT_TYPE_PASS, "OK");
+	CmdExecTxResult(RESULT_TYPE_PASS, "OK");
 	
 	return OK;
 }
 
-STATUS checkResult equal(void) {
+STATUS checkResult_equal(const CmdArgs *pArgs) {
 	FUNCPTR pfnFunc;
 	UINT32 funcRet;
 	unsigned int refVal;
 	OPS_TYPE_RESULT_TYPE eResult;
 	
-	TRY_STR_TO_LONG(refVal, 1, unsigned int);
+	TRY_ARG_TO_LONG(refVal, 1, unsigned int);
 	
-	if ((pfnFunc = findFunc(g_szArgs[0], NULL)) == NULL) {
-		UdpSendOpsTxResult(RESULT_TYPE_FAIL, "ERROR");
+	if ((pfnFunc = findFunc(ARG_STR(0), NULL)) == NULL) {
+		CmdExecTxResult(RESULT_TYPE_FAIL, "ERROR");
 		
 		return ERROR;
 	}
@@ -389,22 +562,22 @@ STATUS checkResult equal(void) {
 	funcRet = pfnFunc();
 	
 	eResult = mtsCheckEqual(refVal, funcRet);
-	UdpSendOpsTxResult(eResult, "0x%X", funcRet);
+	CmdExecTxResult(eResult, "0x%X", funcRet);
 	
 	return OK;
 }
 
-STATUS checkResult_range(void) {
+STATUS checkResult_range(const CmdArgs *pArgs) {
 	DBLFUNCPTR pfnFunc;
 	double funcRet;
 	double refMin, refMax;
 	OPS_TYPE_RESULT_TYPE eResult;
 	
-	TRY_STR_TO_DOUBLE(refMin, 1);
-	TRY_STR_TO_DOUBLE(refMax, 2);
+	TRY_ARG_TO_DOUBLE(refMin, 1);
+	TRY_ARG_TO_DOUBLE(refMax, 2);
 	
-	if ((pfnFunc = (DBLFUNCPTR)findFunc(g_szArgs[0], NULL)) == NULL) {
-		UdpSendOpsTxResult(RESULT_TYPE_FAIL, "ERROR");
+	if ((pfnFunc = (DBLFUNCPTR)findFunc(ARG_STR(0), NULL)) == NULL) {
+		CmdExecTxResult(RESULT_TYPE_FAIL, "ERROR");
 		
 		return ERROR;
 	}
@@ -412,54 +585,128 @@ STATUS checkResult_range(void) {
 	funcRet = pfnFunc();
 	
 	eResult = mtsCheckRange(refMin, refMax, funcRet);
-	UdpSendOpsTxResult(eResult, "%0.3lf", funcRet);
+	CmdExecTxResult(eResult, "%0.3lf", funcRet);
 	
 	return OK;
 }
 
-STATUS mtsCommTestTxReq(void) {
+/*
+ * Copies assets into the local cache ahead of a procedure. Arguments are
+ * file names under NET_DEV_REPO_NAME; with none, every known asset.
+ */
+STATUS mtsAssetPrefetch(const CmdArgs *pArgs) {
+	char szNetPath[ASSET_CACHE_PATH_LEN];
+	const char *szFile;
+	BOOL isHit;
+	OPS_TYPE_RESULT_TYPE eResult;
+	int numFiles = (pArgs->num > 0) ? pArgs->num : NELEMENTS(g_szAssetFiles);
+	int numFailed = 0;
+	int i;
+	
+	for (i = 0; i < numFiles; i++) {
+		RETURN_IF_CANCELLED();
+		
+		if (pArgs->num > 0) {
+			snprintf(szNetPath, sizeof(szNetPath), "%s/%s", NET_DEV_REPO_NAME, ARG_STR(i));
+			szFile = szNetPath;
+		} else {
+			szFile = g_szAssetFiles[i];
+		}
+		
+		if (AssetCacheFetch(szFile, &isHit) == ERROR) {
+			LOGMSG("%s : not cached.\n", szFile);
+			numFailed++;
+			continue;
+		}
+		
+		CmdExecTxResult(RESULT_TYPE_ONGOING, "%s %s", szFile, isHit ? "HIT" : "FETCH");
+	}
+	
+	eResult = mtsCheckEqual(0, numFailed);
+	CmdExecTxResult(eResult, "%d/%d", numFiles - numFailed, numFiles);
+	
+	return OK;
+}
+
+STATUS mtsCmdStats(const CmdArgs *pArgs) {
+	CmdPhaseSummary summary[CMD_PHASE_MAX];
+	
+	if (CmdStatsSummary(ARG_STR(0), summary) == ERROR) {
+		REPORT_ERROR("No statistics for \"%s\".\n", ARG_STR(0));
+		return ERROR;
+	}
+	
+	CmdExecTxResultTx(RESULT_TYPE_PASS, summary, sizeof(summary), "OK");
+	
+	return OK;
+}
+
+/*
+ * mtsGcuLatency [RESET] : the value is a GcuLatencySummary vector of the
+ * command's unit, one element per FG opcode. With RESET the statistics
+ * are cleared once reported.
+ */
+STATUS mtsGcuLatency(const CmdArgs *pArgs) {
+	GcuLatencySummary summary[GCU_LATENCY_OP_MAX];
+	int num;
+	
+	if ((pArgs->num > 0) && (strcmp(ARG_STR(0), "RESET") != 0)) {
+		REPORT_ERROR("Invalid Argument. [#%d(%s)]\n", 0, ARG_STR(0));
+		return ERROR;
+	}
+	
+	num = GcuLatencySummaryGet(pArgs->unit, summary, GCU_LATENCY_OP_MAX);
+	if (pArgs->num > 0)
+		GcuLatencyReset(pArgs->unit);
+	
+	CmdExecTxResultTx(RESULT_TYPE_PASS, summary, num * sizeof(GcuLatencySummary), "OK");
+	
+	return OK;
+}
+
+STATUS mtsCommTestTxReq(const CmdArgs *pArgs) {
 	unsigned int uCh;
 	
-	TRY_STR_TO_LONG(uCh, 0, unsigned int);
+	TRY_ARG_TO_LONG(uCh, 0, unsigned int);
 	
 	switch (uCh) {
 		case LOG_SEND_INDEX_ID_COMM_TEST_MTE:
-			SdlcSendTextTx(g_szArgs[1]);
+			SdlcSendTextTx(ARG_STR(1));
 			break;
 		default:
-			REPORT_ERROR("Invalid Argument. [#%d(%s)]\n", 0, g_szArgs[0]);
+			REPORT_ERROR("Invalid Argument. [#%d(%s)]\n", 0, ARG_STR(0));
 			return ERROR;
 	}
 	
 	return OK;
 }
 
-STATUS mtsCommTest(void) {
+STATUS mtsCommTest(const CmdArgs *pArgs) {
 	unsigned int Uch;
 	
-	TRY_STR_TO_LONG(uCh, 0, unsigned int);
+	TRY_ARG_TO_LONG(uCh, 0, unsigned int);
 	
 	switch (uCh) {
 		case LOG_SEND_INDEX_ID_COMM_TEST_MTE;
-		SdlSendTestTx(g_szArgs[1]));
+		SdlSendTestTx(ARG_STR(1)));
 		break;
 		default:
-			REPORT_ERROR("Invalid Argument. [#%d(%s)]\n", 0, g_szArgs[0]);
+			REPORT_ERROR("Invalid Argument. [#%d(%s)]\n", 0, ARG_STR(0));
 			return ERROR;
 	}
 	
-	DELAY_MS(20);
+	CMD_DELAY_MS(20);
 	
-	if (strncmp(g_szArgs[1], g_pSdlcRecvTestBuf, sizeof(g_szArgs[1])) == 0) {
-		UdpSendOpsTxResult(RESULT_TYPE_PASS, "OK");
+	if (strncmp(ARG_STR(1), g_pSdlcRecvTestBuf, sizeof(ARG_STR(1))) == 0) {
+		CmdExecTxResult(RESULT_TYPE_PASS, "OK");
 	} else {
-		UdpSendOpsTxResult(RESULT_TYPE_FAIL, "ERROR");
+		CmdExecTxResult(RESULT_TYPE_FAIL, "ERROR");
 	}
 	
 	return OK;
 }
 
-STATUS mtsReset(void)
+STATUS mtsReset(const CmdArgs *pArgs)
 {
 	mtsLibPsSetOutput(0);
 	
@@ -470,222 +717,122 @@ STATUS mtsReset(void)
 	return OK;
 }
 
-STATUS mtsUpdate(void) {
-	if (cp(MTS_VIP_FILE, "/mmc1") == ERROR) {
-		REPORT_ERROR("cp(%s to %s) Error.\n", MTS_VIP_FILE, "/mmc1");
+STATUS mtsUpdate(const CmdArgs *pArgs) {
+	char szFile[ASSET_CACHE_PATH_LEN];
+	
+	AssetCacheResolveVerified(MTS_VIP_FILE, szFile, sizeof(szFile));
+	
+	if (cp(szFile, MTS_VIP_LOCAL_FILE) == ERROR) {
+		AssetCacheRelease(szFile);
+		REPORT_ERROR("cp(%s to %s) Error.\n", szFile, MTS_VIP_LOCAL_FILE);
 		return ERROR;
 	}
+	AssetCacheRelease(szFile);
 	
-	UdpSendOpsTxResult(RESULT_TYPE_PASS, "OK");
+	CmdExecTxResult(RESULT_TYPE_PASS, "OK");
 	
 	return OK;
 }
 
-STATUS mtsPowerExtOn(void) {
-	if (strcmp(g_szArgs[0], "MSL_EXT") == 0) {
-		if (mtsLibDoSysPwrMslExtEn(1) == ERROR) {
-			REPORT_ERROR("mtsLibDoSysPwrMslExtEn(1) Error.\n");
-			return ERROR;
-		}
-		
-		LOGMSG("MSL_EXT, ON.\n");
-		
-	} else if (strcmp(g_szArgs[0], "TLM_EXT") == 0) {
-		if (mtsLibDoSysPwrTlmExtEn(1) == ERROR) {
-			REPORT_ERROR("mtsLibDoSysPwrTlmExtEn(1) Error.\n");
-			return ERROR;
-		}
-		
-		LOGMSG("TLM_EXT, ON.\n");
-		
-		DELAY_SEC(0.5);
-		
-		if (mtsLibDoSysPwrCluExtEn(1) == ERROR) {
-			REPORT_ERROR("mtsLibDoSysPwrCluExtEn(1) Error.\n");
-			return ERROR;
-		}
-		
-		LOGMSG("CLU_EXT, ON.\n");
-		
-	} else if (strcmp(g_szArgs[0], "LNS") == 0) {
-		if (steLibDoSysPwrLnsEn(1) == ERROR) {
-			REPORT_ERROR("steLibDoSysPwrLnsEn(1) Error.\n");
-			return ERROR;
-		}
-		
-		LOGMSG("LNS Power, ON.\n");
+STATUS mtsPowerExtOn(const CmdArgs *pArgs) {
+	const PwrChan *pChan;
 	
-	} else if (strcmp(g_szArgs[0], "LAR") == 0) {
-		if (steLibDoSysPwrLarEn(1) == ERROR) {
-			REPORT_ERROR("steLibDoSysPwrLarEn(1) Error.\n");
-			return ERROR;
-		}
-		
-		LOGMSG("LAR Power, ON.\n");
-		
-	} else {
-		REPORT_ERROR("Invalid Argument. [#%d(%s)]\n", 0, g_szArgs[0]);
+	TRY_ARG_TO_PWR_CHAN(pChan, 0);
+	
+	if (setPwrChan(pChan, 1) == ERROR)
 		return ERROR;
-	}
 	
-	UdpSendOpsTxResult(RESULT_TYPE_PASS, "OK");
+	CmdExecTxResult(RESULT_TYPE_PASS, "OK");
 	
 	return OK;
 }
 
-STATUS mtsPowerExtOff(void) {
-	if (strcmp(g_szArgs[0], "MSL_EXT") == 0) {
-		if (mtsLibDoSysPwrMslExtEn(0) == ERROR) {
-			REPORT_ERROR("mtsLibDoSysPwrMslExtEn(0) Error.\n");
-			return ERROR;
-		}
-		
-		LOGMSG("MSL_EXT, OFF.\n");
-		
-	} else if (strcmp(g_szArgs[0], "TLM_EXT") == 0) {
-		if (mtsLibDoSysPwrTlmExtEn(0) == ERROR) {
-			REPORT_ERROR("mtsLibDoSysPwrTlmExtEn(0) Error.\n");
-			return ERROR;
-		}
-		
-		LOGMSG("TLM_EXT, OFF.\n");
-		
-		DELAY_SEC(0.5);
-		
-		if (mtsLibDoSysPwrCluExtEn(0) == ERROR) {
-			REPORT_ERROR("mtsLibDoSysPwrCluExtEn(0) Error.\n");
-			return ERROR;
-		}
-		
-		LOGMSG("CLU_EXT, OFF.\n");
+STATUS mtsPowerExtOff(const CmdArgs *pArgs) {
+	const PwrChan *pChan;
 	
-	} else if (strcmp(g_szArgs[0], "LNS") == 0) {
-		if (steLibDoSysPwrLnsEn(0) == ERROR) {
-			REPORT_ERROR("steLibDoSysPwrLnsEn(0) Error.\n");
-			return ERROR;
-		}
-		
-		LOGMSG("LNS Power, OFF.\n");
-		
-	} else if (strcmp(g_szArgs[0], "LAR") == 0) {
-		if (steLibDoSysPwrLarEn(0) == ERROR) {
-			REPORT_ERROR("steLibDoSysPwrLarEn(0) Error.\n");
-			return ERROR;
-		}
-		
-		LOGMSG("LAR Power, OFF.\n");
-		
-	} else {
-		REPORT_ERROR("Invalid Argument. [#%d(%s)]\n", 0, g_szArgs[0]);
+	TRY_ARG_TO_PWR_CHAN(pChan, 0);
+	
+	if (setPwrChan(pChan, 0) == ERROR)
 		return ERROR;
-	}
 	
-	UdpSendOpsTxResult(RESULT_TYPE_PASS, "OK");
+	CmdExecTxResult(RESULT_TYPE_PASS, "OK");
 	
 	return OK;
 }
 
-STATUS mtsPowerExtGd(void) {
+STATUS mtsPowerExtGd(const CmdArgs *pArgs) {
+	const PwrChan *pChan;
 	UINT32 dwPwrGd;
 	OPS_TYPE_RESULT_TYPE eResult;
 	long refVal;
 	
-	if (strcmp(g_szArgs[0], "TLM_EXT") == 0) {
-		dwPwrGd = mtsLibDiBitPwrTlmExtPg();
-	} else if (strcmp(g_szArgs[0], "CLU_EXT") == 0) {
-		dwPwrGd = mtsLibDiBitPwrCluExtPg();
-	} else if (strcmp(g_szArgs[0], "MSL_EXT") == 0) {
-		dwPwrGd = mtsLibDiBitPwrMslExtPg();
-	} else if (strcmp(g_szArgs[0], "LNS") == 0) {
-		dwPwrGd = steLibDiBitPwrLnsPg();
-	} else if (strcmp(g_szArgs[0], "LAR") == 0) {
-		dwPwrGd = steLibDiBitPwrLarPg();
-	} else {
-		REPORT_ERROR("Invalid Argument. [#%d(%s)]\n", 0, g_szArgs[0]);
+	TRY_ARG_TO_PWR_CHAN(pChan, 0);
+	
+	if (pChan->pfnPg == NULL) {
+		REPORT_ERROR("%s has no power good bit.\n", pChan->szName);
 		return ERROR;
 	}
 	
-	TRY_STR_TO_LONG(refVal, 1, int);
+	TRY_ARG_TO_LONG(refVal, 1, int);
+	dwPwrGd = pChan->pfnPg();
 	eResult = (refVal == dwPwrGd ? RESULT_TYPE_PASS : RESULT_TYPE_FAIL);
-	UdpSendOpsTxResult(eResult, "%d", dwPwrGd);
+	CmdExecTxResult(eResult, "%d", dwPwrGd);
 	
 	return OK;
 }
 
-STATUS mtsPowerMeasureVolt(void) {
-	double dAdcVolt;
-	
-	OPS_TYPE_RESULT_TYPE eResult;
-	double refMin, refMax;
+STATUS mtsPowerMeasureVolt(const CmdArgs *pArgs) {
+	return measurePwrChan(pArgs, PWR_CHAN_QTY_VOLT);
+}
+
+STATUS mtsPowerMeasureCurrent(const CmdArgs *pArgs) {
+	return measurePwrChan(pArgs, PWR_CHAN_QTY_CURR);
+}
+
+/*
+ * Arguments: quantity ("VOLT" or "CURR") followed by up to
+ * GUI_CMD_ARG_MAX_NUM - 1 channels. Every channel is resolved before the
+ * first ADC read, and the readings go back as an array of doubles in
+ * argument order.
+ */
+STATUS mtsPowerMeasureMulti(const CmdArgs *pArgs) {
+	const PwrChan *pChan[GUI_CMD_ARG_MAX_NUM - 1];
+	double dVal[GUI_CMD_ARG_MAX_NUM - 1];
+	PwrChanQty qty;
+	int numChan = pArgs->num - 1;
+	int i;
 	
-	if (strcmp(g_szArgs[0], "TLM_EXT") == 0) {
-		dAdcVolt = mtsLibAdcTlmExtVoltage();
-	} else if (strcmp(g_szArgs[0], "CLU_EXT") == 0) {
-		dAdcVolt = mtsLibAdcCluExtVoltage();
-	} else if (strcmp(g_szArgs[0], "MSL_EXT") == 0) {
-		dAdcVolt = mtsLibAdcMslExtVoltage();
-	} else if (strcmp(g_szArgs[0], "TBAT") == 0) {
-		dAdcVolt = steLibAdcTbatVoltage();
-	} else if (strcmp(g_szArgs[0], "CBAT") == 0) {
-		dAdcVolt = steLibAdcCbatVoltage();
-	} else if (strcmp(g_szArgs[0], "BAT") == 0) {
-		dAdcVolt = ateLibAdcBatVoltage();
-	} else if (strcmp(g_szArgs[0], "LNS") == 0) {
-		dAdcVolt = steLibAdcLnsExtVoltage();
-	} else if (strcmp(g_szArgs[0], "LAR") == 0) {
-		dAdcVolt = steLibAdcLarExtVoltage();
-	} else {
-		REPORT_ERROR("Invalid Argument. [#%d(%s)]\n", 0, g_szArgs[0]);
+	if (PwrChanQtyFind(ARG_STR(0), &qty) == ERROR) {
+		REPORT_ERROR("Invalid Argument. [#%d(%s)]\n", 0, ARG_STR(0));
 		return ERROR;
 	}
 	
-	TRY_STR_TO_DOUBLE(refMin, 1);
-	TRY_STR_TO_DOUBLE(refMax, 2);
-	eResult = mtsCheck Rangge(refMin, refMax, dAdcVolt);
-	UdpSendOpsTxResult(eResult, "%0.3lf", aAdcVolt);
+	if (numChan <= 0) {
+		REPORT_ERROR("No power channel.\n");
+		return ERROR;
+	}
 	
-	return OK;
-}
-
-STATUS mtsPowerMeasureCurrent(void) {
-	double dAdcCurrent;
-	OPS_TYPE_RESULT_TYPE eResult;
-	double refMin, refMax;
+	for (i = 0; i < numChan; i++) {
+		TRY_ARG_TO_PWR_CHAN(pChan[i], i + 1);
+	}
 	
-	if (strcmp(g_szArgs[0], "TLM_EXT") == 0) {
-		dAdcCurrent = mtsLibAdcTlmExtCurrent();
-	} else if (strcmp(g_szArgs[0], "CLU_EXT") == 0) {
-		dAdcCurrent = mtsLibAdcCluExtCurrent();
-	} else if (strcmp(g_szArgs[0], "MSL_EXT") == 0) {
-		dAdcCurrent = mtsLibAdcMslExtCurrent();
-	} else if (strcmp(g_szArgs[0], "TBAT") == 0) {
-		dAdcCurrent = steLibAdcTbatCurrent();
-	} else if (strcmp(g_szArgs[0], "CBAT") == 0) {
-		dAdcCurrent - steLibAdcCbatCurrent();
-	} else if (strcmp(g_szArgs[0], "BAT") == 0) {
-		dAdcCurrent = steLibAdcBatCurrent();
-	} else if (strcmp(g_szArgs[0], "LNS") == 0) {
-		dAdcCurrent = steLibAdcLnsExtCurrent();
-	} else if (strcmp(g_szArgs[0], "LAR") == 0) {
-		dAdcCurrent = steLibAdcLarExtCurrent();
-	} else {
-		REPORT_ERROR("Invalid Argument. [#%d(%s)]\n", 0, g_szArgs[0]);
-		return ERROR;
+	for (i = 0; i < numChan; i++) {
+		if (PwrChanMeasure(pChan[i], qty, &dVal[i]) == ERROR) {
+			REPORT_ERROR("%s cannot measure %s.\n", pChan[i]->szName, ARG_STR(0));
+			return ERROR;
+		}
 	}
 	
-	TRY_STR_TO_DOUBLE(refMin, 1);
-	TRY_STR_TO_DOUBLE(refMax, 2);
-	eResult = mtsCheckRange(refMin, refMax, dAdcCurrent);
-	UdpSendOpsTxResult(eResult, "%0.3lf", dAdcCurrent);
+	CmdExecTxResultTx(RESULT_TYPE_PASS, dVal, numChan * sizeof(double), "OK");
 	
 	return OK;
 }
 
-STATUS mtsInitActPwrSuplOut(void) {
+STATUS mtsInitActPwrSuplOut(const CmdArgs *pArgs) {
 	double dVolt, dCurr;
 	
-	TRY_STR_TO_DOUBLE(dVolt, 0);
-	TRY_STR_TO_DOUBLE(dCurr, 1);
+	TRY_ARG_TO_DOUBLE(dVolt, 0);
+	TRY_ARG_TO_DOUBLE(dCurr, 1);
 	
 	if ((dVolt > PWR_SUPPLY_MAX_VOLT) || (dCurr > PWR_SUPPLY_MAX_AMP)) {
 		REPORT_ERROR("Setting Value is Too High.\n");
@@ -704,54 +851,54 @@ STATUS mtsInitActPwrSuplOut(void) {
 	}
 #endif
 
-	UdpSendOpsTxResult(RESULT_TYPE_PASS, "OK");
-		
+	CmdExecTxResult(RESULT_TYPE_PASS, "OK");
+	
 	return OK;
 }
 
-STATUS mtsSetActPwrSuplOut(void) {
-	int i;
+STATUS mtsSetActPwrSuplOut(const CmdArgs *pArgs) {
+	GcuUnit *pUnit = GcuUnitGet(pArgs->unit);
+	OPS_TYPE_RESULT_TYPE eResult;
+	INT32 abatVtg;
 	
 	if (mtsLibPsIsReady() == ERROR) {
 		REPORT_ERROR("ActPwrSupl is not Initialized.\n");
 		return ERROR;
 	}
 	
-	if (strcmp(g_szArgs[0], "ON") == 0) {
+	if (strcmp(ARG_STR(0), "ON") == 0) {
 		if (mtsAbatSqbOn() == ERROR) {
 			REPORT_ERROR("mtsAbatSqbOn() Error.\n");
 			return ERROR;
 		}
-	
-		for (i = 0; i < 150; i++) {
-			if (((double)(g_pTmGf2->m_ABAT_VTG) * 0.01) >= 100.0)
-				break;
-			
-			DELAY_MS(100);
-		}
-	} else if (strcmp(g_szaArgs[0], "OFF") == 0) {
+		
+		WAIT_TM_FIELD(TM_WAIT_SRC_GF2, GET_DELAY_TICK(ABAT_ON_TIMEOUT),
+					  GCU_GF(pUnit, 2)->m_ABAT_VTG, 0xFFFFFFFF, TM_WAIT_OP_GE,
+					  (INT32)(ABAT_ON_VOLT / ABAT_VTG_LSB), abatVtg, eResult);
+	} else if (strcmp(ARG_STR(0), "OFF") == 0) {
 		if (mtsLibPsSetOutput(0) == ERROR) {
 			REPORT_ERROR("mtsLibPsSetOutput(0) Result is Abnormal.\n");
 			return ERROR;
 		}
 		
-		for (i = 0; i < 200; i++) {
-			if (((double)(g_pTmGf2->m_ABAT_VTG) * 0.01) < 1.2)
-				break;
-			
-			DELAY_MS(100);
-		}
+		WAIT_TM_FIELD(TM_WAIT_SRC_GF2, GET_DELAY_TICK(ABAT_OFF_TIMEOUT),
+					  GCU_GF(pUnit, 2)->m_ABAT_VTG, 0xFFFFFFFF, TM_WAIT_OP_LT,
+					  (INT32)(ABAT_OFF_VOLT / ABAT_VTG_LSB), abatVtg, eResult);
 	} else {
-		REPORT_ERROR("Invalid Argument. [#%d(%s)]\n", 0, g_szArgs[0]);
+		REPORT_ERROR("Invalid Argument. [#%d(%s)]\n", 0, ARG_STR(0));
 		return ERROR;
 	}
 	
-	UdpSendOpsTxResult(RESULT_TYPE_PASS, "OK");
+	if (eResult != RESULT_TYPE_PASS)
+		LOGMSG("ABAT_VTG : %0.2lf V\n", abatVtg * ABAT_VTG_LSB);
+	
+	CmdExecTxResult(RESULT_TYPE_PASS, "OK");
 	
 	return OK;
 }
 
-STATUS mtsSetActPwrSuplOutBit(void) {
+STATUS mtsSetActPwrSuplOutBit(const CmdArgs *pArgs) {
+	GcuUnit *pUnit = GcuUnitGet(pArgs->unit);
 	int i;
 	
 	if (mtsLibPsIsReady() == ERROR) {
@@ -759,698 +906,753 @@ STATUS mtsSetActPwrSuplOutBit(void) {
 		return ERROR;
 	}
 	
-	if (strcmp(g_szArgs[0], "ON") == 0) {
+	if (strcmp(ARG_STR(0), "ON") == 0) {
 		if (mtsLibPsSetOutput(1) == ERROR) {
 			REPORT_ERROR("mtsLibPsSetOutput(1) Result is Abnormal.\n");
 			return ERROR;
 		}
-	} else if (strcmp(g_szArgs[0], "OFF") == 0) {
+	} else if (strcmp(ARG_STR(0), "OFF") == 0) {
 		if (mtsLibPsSetOutput(0) == ERROR) {
 			REPORT_ERROR("mtsLibPsSetOutput(0) Result is Abnormal.\n");
 			return ERROR;
 		}
 		
 		for (i = 0; i < 200; i++) {
-			if (((double)(g_pTmGf2->m_ABAT_VTG) * 0.01) < 1.2)
+			if (((double)(GCU_GF(pUnit, 2)->m_ABAT_VTG) * 0.01) < 1.2)
 				break;
 			
-			DELAY_MS(100);
+			CMD_DELAY_MS(100);
 		}
 	} else {
-		REPORT_ERROR("Invalid Argument. [#%d(%s)]\n", 0, g_szArgs[0]);
+		REPORT_ERROR("Invalid Argument. [#%d(%s)]\n", 0, ARG_STR(0));
 		return ERROR;
 	}
 	
-	UdpSendOpsTxResult(RESULT_TYPE_PASS, "OK");
+	CmdExecTxResult(RESULT_TYPE_PASS, "OK");
 	
 	return OK;
 }
 
-STATUS mtsGetActPwrSuplOut(void) {
+STATUS mtsGetActPwrSuplOut(const CmdArgs *pArgs) {
 	OPS_TYPE_RESULT_TYPE eResult;
 	double dValue;
 	double refMin, refMax;
 	
-	TRY_STR_TO_DOUBLE(refMin, 1);
-	TRY_STR_TO_DOUBLE(refMax, 2);
+	TRY_ARG_TO_DOUBLE(refMin, 1);
+	TRY_ARG_TO_DOUBLE(refMax, 2);
 	
 	if (mtsLibPsIsReady() == ERROR) {
 		REPORT_ERROR("ActPwrSupl is not Initialized.\n");
 		return ERROR;
 	}
 	
-	if (strcmp(g_szArgs[0], "VOLT") == 0) {
+	if (strcmp(ARG_STR(0), "VOLT") == 0) {
 		if (mtsLibPsGetVolt(&dValue) == ERROR) {
 			REPORT_ERROR("mtsLibPsGetVolt() Failed.\n");
 			return ERROR;
 		}
-	} else if (strcmp(g_szArgs[0], "AMP") == 0) {
+	} else if (strcmp(ARG_STR(0), "AMP") == 0) {
 		if (mtsLibPsGetCurr(&dValue) == ERROR) {
 			REPORT_ERROR("mtsLibPsGetCurr() Failed.\n");
 			return ERROR;
 		}
 	} else {
-		REPORT_ERROR("Invalid Argument. [#%d(%s)]\n", 0, g_szArgs[0]);
+		REPORT_ERROR("Invalid Argument. [#%d(%s)]\n", 0, ARG_STR(0));
 		return ERROR;
 	}
 	
 	eResult = mtsCheckRange(refMin, refMax, dValue);
-	UdpSendOpsTxResult(eResult, "%0.1lf", dValue);
+	CmdExecTxResult(eResult, "%0.1lf", dValue);
 	
 	return OK;
 }
 
-STATUS mtsChkGf2(void) {
+STATUS mtsChkGf2(const CmdArgs *pArgs) {
+	GcuUnit *pUnit = GcuUnitGet(pArgs->unit);
 	OPS_TYPE_RESULT_TYPE eResult;
 	long refVal;
 	double refMin, refMax;
 	double dValue;
 	int nValue;
 	
-	if (strcmp(g_szArgs[0], "GCU_28V") == 0) {
-		TRY_STR_TO_DOUBLE(refMin, 1);
-		TRY_STR_TO_DOUBLE(refMax, 2);
+	if (strcmp(ARG_STR(0), "GCU_28V") == 0) {
+		TRY_ARG_TO_DOUBLE(refMin, 1);
+		TRY_ARG_TO_DOUBLE(refMax, 2);
 		
-		dValue = (double)(g_pTmGf2->m_GCU_28V) * 0.002;
+		dValue = (double)(GCU_GF(pUnit, 2)->m_GCU_28V) * 0.002;
 		eResult = mtsCheckRange(refMin, refMax, dValue);
-		UdpSendOpsTxResult(eResult, "%0.3lf", dValue);
+		CmdExecTxResult(eResult, "%0.3lf", dValue);
 		
 		return OK;
-	} else if (strcmp(g_szArgs[0], "GCU_FAIL") == 0) {
-		nValue = GET_BIT(g_pTmGf2->m_MSL_STS, 15);
+	} else if (strcmp(ARG_STR(0), "GCU_FAIL") == 0) {
+		nValue = GET_BIT(GCU_GF(pUnit, 2)->m_MSL_STS, 15);
 		eResult = mtsCheckEqual(0x0, nValue);
-		UdpSendOpsTxResult(eResult, "%d", nValue);
+		CmdExecTxResult(eResult, "%d", nValue);
 		
 		return OK;
-	} else if (strcmp(g_szArgs[0], "ACU_FAIL") == 0) {
-		nValue = GET_BIT(g_pTmGf2->m_MSL_STS, 14);
+	} else if (strcmp(ARG_STR(0), "ACU_FAIL") == 0) {
+		nValue = GET_BIT(GCU_GF(pUnit, 2)->m_MSL_STS, 14);
 		eResult = mtsCheckEqual(0x0, nValue);
-		UdpSendOpsTxResult(eResult, "%d", nValue);
+		CmdExecTxResult(eResult, "%d", nValue);
 		
 		return OK;
-	} else if (strcmp(g_szArgs[0], "GPS_FAIL") == 0) {
-		nValue = GET_BIT(g_pTmGf2->m_MSL_STS, 13);
+	} else if (strcmp(ARG_STR(0), "GPS_FAIL") == 0) {
+		nValue = GET_BIT(GCU_GF(pUnit, 2)->m_MSL_STS, 13);
 		eResult = mtsCheckEqual(0x0, nValue);
-		UdpSendOpsTxResult(eResult, "%d", nValue);
+		CmdExecTxResult(eResult, "%d", nValue);
 		
 		return OK;
-	} else if (strcmp(g_szArgs[0], "IMU_FAIL") == 0) {
-		nValue = GET_BIT(g_pTmGf2->m_MSL_STS, 11);
+	} else if (strcmp(ARG_STR(0), "IMU_FAIL") == 0) {
+		nValue = GET_BIT(GCU_GF(pUnit, 2)->m_MSL_STS, 11);
 		eResult = mtsCheckEqual(0x0, nValue);
-		UdpSendOpsTxResult(eResult, "%d", nValue);
+		CmdExecTxResult(eResult, "%d", nValue);
 		
 		return OK;
-	} else if (strcmp(g_szArgs[0], "FUZ_FAIL") == 0) {
-		nValue = GET_BIT(g_pTmGf2->m_MSL_STS, 10);
+	} else if (strcmp(ARG_STR(0), "FUZ_FAIL") == 0) {
+		nValue = GET_BIT(GCU_GF(pUnit, 2)->m_MSL_STS, 10);
 		eResult = mtsCheckEqual(0x0, nValue);
-		UdpSendOpsTxResult(eResult, "%d", nValue);
+		CmdExecTxResult(eResult, "%d", nValue);
 		
 		return OK;
-	} else if (strcmp(g_szArgs[0], "PARAM_FAIL") == 0) {
-		nValue = GET_BIT(g_pTmGf2->m_MSL_STS, 8);
+	} else if (strcmp(ARG_STR(0), "PARAM_FAIL") == 0) {
+		nValue = GET_BIT(GCU_GF(pUnit, 2)->m_MSL_STS, 8);
 		eResult = mtsCheckEqual(0x0, nValue);
-		UdpSendOpsTxResult(eResult, "%d", nValue);
+		CmdExecTxResult(eResult, "%d", nValue);
 		
 		return OK;
-	} else if (strcmp(g_szArgs[0], "ACU_STS") == 0) {
-		TRY_STR_TO_LONG(refVal, 1, long);
+	} else if (strcmp(ARG_STR(0), "ACU_STS") == 0) {
+		TRY_ARG_TO_LONG(refVal, 1, long);
 		
-		nValue = g_pTmGf2->m_ACU_STS;
-		eResult = mtsCheckEqual(refVal, nValue & g_dwArgMask);
-		UdpSendOpsTxResult(eResult, "0x%04X", nValue);
+		nValue = GCU_GF(pUnit, 2)->m_ACU_STS;
+		eResult = mtsCheckEqual(refVal, nValue & pArgs->mask);
+		CmdExecTxResult(eResult, "0x%04X", nValue);
 		
 		return OK;
-	} else if (strcmp(g_szArgs[0], "MSL_STS") == 0) {
-		TRY_STR_TO_LONG(refVal, 1, long);
+	} else if (strcmp(ARG_STR(0), "MSL_STS") == 0) {
+		TRY_ARG_TO_LONG(refVal, 1, long);
 		
-		nValue = g_pTmGf2->m_MSL_STS;
-		eResult = mtsCheckEqual(refVal, nValue & g_dwArgMask);
-		UdpSendOpsTxResult(eResult, "0x%04X", nValue);
+		nValue = GCU_GF(pUnit, 2)->m_MSL_STS;
+		eResult = mtsCheckEqual(refVal, nValue & pArgs->mask);
+		CmdExecTxResult(eResult, "0x%04X", nValue);
 		
 		return OK;
-	} else if (strcmp(g_szArgs[0], "ABAT_VTG") == 0) {
-		TRY_STR_TO_DOUBLE(refMin, 1);
-		TRY_STR_TO_DOUBLE(refMax, 2);
+	} else if (strcmp(ARG_STR(0), "ABAT_VTG") == 0) {
+		TRY_ARG_TO_DOUBLE(refMin, 1);
+		TRY_ARG_TO_DOUBLE(refMax, 2);
 		
-		dValue = (double)(g_pTmGf2->m_ABAT_VTG) * 0.01;
+		dValue = (double)(GCU_GF(pUnit, 2)->m_ABAT_VTG) * 0.01;
 		eResult = mtsCheckRange(refMin, refMax, dValue);
-		UdpSendOpsTxResult(eResult, "%0.2lf", dValue);
+		CmdExecTxResult(eResult, "%0.2lf", dValue);
 		
 		return OK;
-	} else if (strcmp(g_szArgs[0], "BAT1_VTG") == 0) {
-		TRY_STR_TO_DOUBLE(refMin, 1);
-		TRY_STR_TO_DOUBLE(refMax, 2);
+	} else if (strcmp(ARG_STR(0), "BAT1_VTG") == 0) {
+		TRY_ARG_TO_DOUBLE(refMin, 1);
+		TRY_ARG_TO_DOUBLE(refMax, 2);
 		
-		dValue = (double)(g_pTmGf2->m_BAT1_VTG) * 0.002;
+		dValue = (double)(GCU_GF(pUnit, 2)->m_BAT1_VTG) * 0.002;
 		eResult = mtsCheckRange(refMin, refMax, dValue);
-		UdpSendOpsTxResult(eResult, "%0.3lf", dValue);
+		CmdExecTxResult(eResult, "%0.3lf", dValue);
 		
 		return OK;
-	} else if (strcmp(g_szArgs[0], "BAT2_VTG") == 0) {
-		TRY_STR_TO_DOUBLE(refMin, 1);
-		TRY_STR_TO_DOUBLE(refMax, 2);
+	} else if (strcmp(ARG_STR(0), "BAT2_VTG") == 0) {
+		TRY_ARG_TO_DOUBLE(refMin, 1);
+		TRY_ARG_TO_DOUBLE(refMax, 2);
 		
-		dValue = (double)(g_pTmGf2->m_BAT2_VTG) * 0.002;
+		dValue = (double)(GCU_GF(pUnit, 2)->m_BAT2_VTG) * 0.002;
 		eResult = mtsCheckRange(refMin, refMax, dValue);
-		UdpSendOpsTxResult(eResult, "%0.3lf", dValue);
+		CmdExecTxResult(eResult, "%0.3lf", dValue);
 		
 		return OK;
-	} else if (strcmp(g_szArgs[0], "FIN1_FB") == 0) {
-		TRY_STR_TO_DOUBLE(refMin, 1);
-		TRY_STR_TO_DOUBLE(refMax, 2);
+	} else if (strcmp(ARG_STR(0), "FIN1_FB") == 0) {
+		TRY_ARG_TO_DOUBLE(refMin, 1);
+		TRY_ARG_TO_DOUBLE(refMax, 2);
 		
-		dValue = (double)(g_pTmGf2->m_FIN1_FB) * 0.001;
+		dValue = (double)(GCU_GF(pUnit, 2)->m_FIN1_FB) * 0.001;
 		eResult = mtsCheckRange(refMin, refMax, dValue);
-		UdpSendOpsTxResult(eResult, "%0.3lf", dValue);
+		CmdExecTxResult(eResult, "%0.3lf", dValue);
 		
 		return OK;
-	} else if (strcmp(g_szArgs[0], "FIN2_FB) == 0) {
-		TRY_STR_TO_DOUBLE(refMin, 1);
-		TRY_STR_TO_DOUBLE(refMax, 2);
+	} else if (strcmp(ARG_STR(0), "FIN2_FB) == 0) {
+		TRY_ARG_TO_DOUBLE(refMin, 1);
+		TRY_ARG_TO_DOUBLE(refMax, 2);
 		
-		dValue = (double)(g_pTmGf2->m_FIN2_FB) * 0.001;
+		dValue = (double)(GCU_GF(pUnit, 2)->m_FIN2_FB) * 0.001;
 		eResult = mtsCheckRange(refMin, refMax, dValue);
-		UdpSendOpsTxResult(eResult, "%0.3lf", dValue);
+		CmdExecTxResult(eResult, "%0.3lf", dValue);
 		
 		return OK;
-	} else if (strcmp(g_szArgs[0], "FIN3_FB") == 0) {
-		TRY_STR_TO_DOUBLE(refMin, 1);
-		TRY_STR_TO_DOUBLE(refMax, 2);
+	} else if (strcmp(ARG_STR(0), "FIN3_FB") == 0) {
+		TRY_ARG_TO_DOUBLE(refMin, 1);
+		TRY_ARG_TO_DOUBLE(refMax, 2);
 		
-		dValue = (double)(g_pTmGf2->m_FIN3_FB) * 0.001;
+		dValue = (double)(GCU_GF(pUnit, 2)->m_FIN3_FB) * 0.001;
 		eResult = mtsCheckRange(refMin, refMax, dValue);
-		UdpSendOpsTxResult(eResult, "%0.3lf", dValue);
+		CmdExecTxResult(eResult, "%0.3lf", dValue);
 		
 		return OK;
-	} else if (strcmp(g_szArgs[0], "FIN4_FB") == 0) {
-		TRY_STR_TO_DOUBLE(refMin, 1);
-		TRY_STR_TO_DOUBLE(refMax, 2);
+	} else if (strcmp(ARG_STR(0), "FIN4_FB") == 0) {
+		TRY_ARG_TO_DOUBLE(refMin, 1);
+		TRY_ARG_TO_DOUBLE(refMax, 2);
 		
-		dValue = (double)(g_pTmGf2->m_FIN4_FB) * 0.001;
+		dValue = (double)(GCU_GF(pUnit, 2)->m_FIN4_FB) * 0.001;
 		eResult = mtsCheckRange(refMin, refMax, dValue);
-		UdpSendOpsTxResult(eResult, "%0.3lf", dValue);
+		CmdExecTxResult(eResult, "%0.3lf", dValue);
 		
 		return OK;
 	} else {
-		REPORT_ERROR("Invalid Argument. [#%d(%s)]\n", 0, g_szArgs[0]);
+		REPORT_ERROR("Invalid Argument. [#%d(%s)]\n", 0, ARG_STR(0));
 		return ERROR;
 	}
 }
 
-STATUS mtsGcuMslStsChk(void) {
+STATUS mtsGcuMslStsChk(const CmdArgs *pArgs) {
+	GcuUnit *pUnit = GcuUnitGet(pArgs->unit);
 	OPS_TYPE_RESULT_TYPE eResult;
 	CODE usResp;
 	
-	memset((void *)(g_pTmFg2), 0, sizeof(TM_TYPE_FG2));
+	memset((void *)(pUnit->pTmFg2), 0, sizeof(TM_TYPE_FG2));
 	
-	g_pTmFg2->fg2_1.m_ADDRESS = TM_SDLC_ADDRESS;
-	g_pTmFg2->fg2_1.m_CONTROL = TM_FG2_SDLC_CONTROL;
-	g_pTmFg2->fg2_1.m_OPCODE = TM_FG2_1_OPCODE_MSL_COMM_START;
+	pUnit->pTmFg2->fg2_1.m_ADDRESS = TM_SDLC_ADDRESS;
+	pUnit->pTmFg2->fg2_1.m_CONTROL = TM_FG2_SDLC_CONTROL;
+	pUnit->pTmFg2->fg2_1.m_OPCODE = TM_FG2_1_OPCODE_MSL_COMM_START;
 	
-	if (PostCmd(g_hSdlcSendGcu, SDLC_SEND_GCU_TX_FG2) == ERROR) {
+	if (postGcuCmd(pUnit, SDLC_SEND_GCU_TX_FG2, TM_FG2_1_OPCODE_MSL_COMM_START) == ERROR) {
 		REPORT_ERROR("PostCmd(SDLC_SEND_GCU_TX_FG2)\n";
 		return ERROR;
 	}
 	
-	WAIT_RESPONSE(GCU_RESPONSE_TIME, 1, TM_FG2_1_OPCODE_MSL_COMM_START, g_pTmGf2->m_GCU_RESP, usResp, eResult);
+	WAIT_RESPONSE(TM_WAIT_SRC_GF2, GCU_RESPONSE_TIME, TM_FG2_1_OPCODE_MSL_COMM_START, GCU_GF(pUnit, 2)->m_GCU_RESP, usResp, eResult);
 	
-	UdpSendOpsTxResult(eResult, "0x%04X", usResp);
+	CmdExecTxResult(eResult, "0x%04X", usResp);
 	
 	return OK;
 }
 
-STATUS mtsSwVerChk(void) {
+STATUS mtsSwVerChk(const CmdArgs *pArgs) {
+	GcuUnit *pUnit = GcuUnitGet(pArgs->unit);
 	int refVal, targetVal;
 	OPS_TYPE_RESULT_TYPE eResult;
 	CODE usGcuResp;
 	
-	memset((void *)(g_pTmFg3), 0, sizeof(TM_TYPE_FG3));
+	memset((void *)(pUnit->pTmFg3), 0, sizeof(TM_TYPE_FG3));
 	
-	g_pTmFg3->fg3_4.m_ADDRESS = TM_SDLC_ADDRESS;
-	g_pTmFg3->fg3_4.m_CONTROL = TM_FG3_SDLC_CONTROL;
-	g_pTmFg3->fg3_4.m_OPCODE = TM_FG3_4_OPCODE;
+	pUnit->pTmFg3->fg3_4.m_ADDRESS = TM_SDLC_ADDRESS;
+	pUnit->pTmFg3->fg3_4.m_CONTROL = TM_FG3_SDLC_CONTROL;
+	pUnit->pTmFg3->fg3_4.m_OPCODE = TM_FG3_4_OPCODE;
 	
-	if (PostCmd(g_hSdlcSendGcu, SDLC_SEND_GCU_TX_FG3) == ERROR) {
+	if (postGcuCmd(pUnit, SDLC_SEND_GCU_TX_FG3, TM_FG3_4_OPCODE) == ERROR) {
 		REPORT_ERROR("PostCmd(SDLC_SEND_GCU_TX_FG3)\n");
 		return ERROR;
 	}
 	
-	WAIT_RESPONSE(GCU_RESPONSE_TIME, 1, TM_FG3_4_OPCODE, g_pTmGf3->gf3_4.m_GCU_RESP, usGcuResp, eResult);
+	WAIT_RESPONSE(TM_WAIT_SRC_GF3, GCU_RESPONSE_TIME, TM_FG3_4_OPCODE, GCU_GF(pUnit, 3)->gf3_4.m_GCU_RESP, usGcuResp, eResult);
 	
 	if (eResult == RESULT_TYPE_FAIL) {
 		REPORT_ERROR("GCU : No Response.\n");
 		return ERROR;
 	}
 	
-	if (strcmp(g_szArgs[0], "GCU_SW_VER") == 0) {
-		targetVal = g_pTmGf3->gf3_4.m_GCU_SW_VER;
-	} else if (strcmp(g_szArgs[0], "GCU_SW_CREATE") == 0) {
-		targetVal = g_pTmGf3->gf3_4.m_GCU_SW_CREATE;
-	} else if (strcmp(g_szArgs[0], "GCU_FW_VER") == 0) {
-		targetVal = g_pTmGf3->gf3_4.m_GCU_FW_VER;
-	} else if (strcmp(g_szArgs[0], "GCU_FW_CREATE") == 0 {
-		targetVal = g_pTmGf3->gf3_4.m_GCU_FW_CREATE;
-	} else if (strcmp(g_szArgs[0], "GCU_SW_VER") == 0 {
-		targetVal = g_pTmGf3->gf3_4.m_GCU_SW_VER;
-	} else if (strcmp(g_szArgs[0], "GCU_SW_CREATE") == 0 {
-		targetVal = g_pTmGf3->gf3_4.m_GCU_SW_CREATE;
-	} else if (strcmp(g_szArgs[0], "INS_UPDATE_VER1") == 0 {
-		targetVal = g_pTmGf3->gf3_4.m_INS_UPDATE_VER1;
-	} else if (strcmp(g_szArgs[0], "INS_UPDATE_VER2") == 0 {
-		targetVal = g_pTmGf3->gf3_4.m_INS_UPDATE_VER2;
-	} else if (strcmp(g_szArgs[0], "ACU_VER") == 0 {
-		targetVal = g_pTmGf3->gf3_4.m_ACU_VER;
-	} else if (strcmp(g_szArgs[0], "ACU_UPDATE") == 0 {
-		targetVal = g_pTmGf3->gf3_4.m_ACU_UPDATE;
-	} else if (strcmp(g_szArgs{[0], "MAR_VER") == 0 {
-		targetVal = g_pTmGf3->gf3_4.m_MAR_VER;
-	} else if (strcmp(g_szArgs[0], "MAR_UPDATE") == 0 {
-		targetVal = g_pTmGf3->gf3_4.m_MAR_UPDATE{;
+	if (strcmp(ARG_STR(0), "GCU_SW_VER") == 0) {
+		targetVal = GCU_GF(pUnit, 3)->gf3_4.m_GCU_SW_VER;
+	} else if (strcmp(ARG_STR(0), "GCU_SW_CREATE") == 0) {
+		targetVal = GCU_GF(pUnit, 3)->gf3_4.m_GCU_SW_CREATE;
+	} else if (strcmp(ARG_STR(0), "GCU_FW_VER") == 0) {
+		targetVal = GCU_GF(pUnit, 3)->gf3_4.m_GCU_FW_VER;
+	} else if (strcmp(ARG_STR(0), "GCU_FW_CREATE") == 0 {
+		targetVal = GCU_GF(pUnit, 3)->gf3_4.m_GCU_FW_CREATE;
+	} else if (strcmp(ARG_STR(0), "GCU_SW_VER") == 0 {
+		targetVal = GCU_GF(pUnit, 3)->gf3_4.m_GCU_SW_VER;
+	} else if (strcmp(ARG_STR(0), "GCU_SW_CREATE") == 0 {
+		targetVal = GCU_GF(pUnit, 3)->gf3_4.m_GCU_SW_CREATE;
+	} else if (strcmp(ARG_STR(0), "INS_UPDATE_VER1") == 0 {
+		targetVal = GCU_GF(pUnit, 3)->gf3_4.m_INS_UPDATE_VER1;
+	} else if (strcmp(ARG_STR(0), "INS_UPDATE_VER2") == 0 {
+		targetVal = GCU_GF(pUnit, 3)->gf3_4.m_INS_UPDATE_VER2;
+	} else if (strcmp(ARG_STR(0), "ACU_VER") == 0 {
+		targetVal = GCU_GF(pUnit, 3)->gf3_4.m_ACU_VER;
+	} else if (strcmp(ARG_STR(0), "ACU_UPDATE") == 0 {
+		targetVal = GCU_GF(pUnit, 3)->gf3_4.m_ACU_UPDATE;
+	} else if (strcmp(ARG_STR(0), "MAR_VER") == 0) {
+		targetVal = GCU_GF(pUnit, 3)->gf3_4.m_MAR_VER;
+	} else if (strcmp(ARG_STR(0), "MAR_UPDATE") == 0 {
+		targetVal = GCU_GF(pUnit, 3)->gf3_4.m_MAR_UPDATE{;
 	} else {
-		REPORT_ERROR("Invalid Argument. [#%d(%s)]\n", 0, g_szArgs[0]);
+		REPORT_ERROR("Invalid Argument. [#%d(%s)]\n", 0, ARG_STR(0));
 		return ERROR;
 	}
 	
-	if (strcmp(g_szArgs[1], "PASS") == 0) {
+	if (strcmp(ARG_STR(1), "PASS") == 0) {
 		eResult = RESULT_TYPE_PASS;
 	} else {
-		TRY_STR_TO_LONG(refVal, 1, int);
+		TRY_ARG_TO_LONG(refVal, 1, int);
 		eResult = mtsCheckEqual(refVal, targetVal);
 	}
 	
-	UdpSendOpsTxResult(eResult, "0x%04X", targetVal);
+	CmdExecTxResult(eResult, "0x%04X", targetVal);
 	
 	return OK;
 }
 
-STATUS mtsGcuFireModeStart(void) {
+STATUS mtsGcuFireModeStart(const CmdArgs *pArgs) {
+	GcuUnit *pUnit = GcuUnitGet(pArgs->unit);
 	OPS_TYPE_RESULT_TYPE eResult;
 	CODE usGcuResp, usGcuMode;
 	
-	memset((void *)(g_pTmFg2), 0, sizeof(TM_TYPE_FG2));
+	memset((void *)(pUnit->pTmFg2), 0, sizeof(TM_TYPE_FG2));
 	
-	g_pTmFg2->fg2_1.m_ADDRESS = TM_SDLC_ADDRESS;
-	g_pTmFg2->fg2_1.m_CONTROL = TM_FG2_SDLC_CONTROL;
-	g_pTmFg2->fg2_1.m_OPCODE = TM_FG2_1_OPCODE_MODE_LAUNCH;
+	pUnit->pTmFg2->fg2_1.m_ADDRESS = TM_SDLC_ADDRESS;
+	pUnit->pTmFg2->fg2_1.m_CONTROL = TM_FG2_SDLC_CONTROL;
+	pUnit->pTmFg2->fg2_1.m_OPCODE = TM_FG2_1_OPCODE_MODE_LAUNCH;
 	
-	if (PostCmd(g_hSdlcSendGcu, SDLC_SEND_GCU_TX_FG2) == ERROR) {
+	if (postGcuCmd(pUnit, SDLC_SEND_GCU_TX_FG2, TM_FG2_1_OPCODE_MODE_LAUNCH) == ERROR) {
 		REPORT_ERROR("PostCmd(SDLC_SEND_GCU_TX_FG2)\n");
 		return ERROR;
 	}
 	
-	WAIT_RESPONSE(GCU_RESPONSE_TIME, 1, TM_FG2_1_OPCODE_MODE_LAUNCH, g_pTmGf2->m_GCU_RESP, usGcuResp, eResult);
+	WAIT_RESPONSE(TM_WAIT_SRC_GF2, GCU_RESPONSE_TIME, TM_FG2_1_OPCODE_MODE_LAUNCH, GCU_GF(pUnit, 2)->m_GCU_RESP, usGcuResp, eResult);
 	
 	if (eResult == RESULT_TYPE_FAIL) {
 		REPORT_ERROR("GCU : No Response.\n");
 		return ERROR;
 	}
 	
-	usGcuMode = g_pTmGf2->m_GCU_MODE;
+	usGcuMode = GCU_GF(pUnit, 2)->m_GCU_MODE;
 	eResult = mtsCheckEqual(0x1400, usGcuMode & 0xFFF0);
-	UdpSendOpsTxResult(eResult, "0x%04X", usGcuMode);
+	CmdExecTxResult(eResult, "0x%04X", usGcuMode);
 	
 	return OK;
 }
 
-STATUS mtsNavCal(void) {
+STATUS mtsNavCal(const CmdArgs *pArgs) {
+	GcuUnit *pUnit = GcuUnitGet(pArgs->unit);
 	OPS_TYPE_RESULT_TYPE eResult;
 	CODE usGcuResp, usGcuMode;
 	
-	memset((void *)(g_pTmFg2), 0, sizeof(TM_TYPE_FG2));
+	memset((void *)(pUnit->pTmFg2), 0, sizeof(TM_TYPE_FG2));
 	
-	g_pTmFg2->fg2_1.m_ADDRESS = TM_SDLC_ADDRESS;
-	g_pTmFg2->fg2_1.m_CONTROL = TM_FG2_SDLC_CONTROL;
-	g_pTmFg2->fg2_1.m_OPCODE = TM_FG2_1_OPCODE_MSL_START_GNC;
+	pUnit->pTmFg2->fg2_1.m_ADDRESS = TM_SDLC_ADDRESS;
+	pUnit->pTmFg2->fg2_1.m_CONTROL = TM_FG2_SDLC_CONTROL;
+	pUnit->pTmFg2->fg2_1.m_OPCODE = TM_FG2_1_OPCODE_MSL_START_GNC;
 	
-	if (PostCmd(g_hSdlcSendGcu, SDLC_SEND_GCU_TX_FG2) == ERROR) {
+	if (postGcuCmd(pUnit, SDLC_SEND_GCU_TX_FG2, TM_FG2_1_OPCODE_MSL_START_GNC) == ERROR) {
 		REPORT_ERROR("PostCmd(SDLC_SEND_GCU_TX_FG2)\n");
 		return ERROR;
 	}
 	
-	WAIT_RESPONSE(GCU_RESPONSE_TIME, 1, TM_FG2_1_OPCODE_MSL_START_GNC, g_pTmGf2->m_GCU_RESP, usGcuResp, eResult);
+	WAIT_RESPONSE(TM_WAIT_SRC_GF2, GCU_RESPONSE_TIME, TM_FG2_1_OPCODE_MSL_START_GNC, GCU_GF(pUnit, 2)->m_GCU_RESP, usGcuResp, eResult);
 	
 	if (eResult == RESULT_TYPE_FAIL) {
 		REPORT_ERROR("GCU : No Response.\n");
 		return ERROR;
 	}
 	
-	usGcuMode = g_pTmGf2->m_GCU_MODE;
+	usGcuMode = GCU_GF(pUnit, 2)->m_GCU_MODE;
 	eResult = mtsCheckEqual(0x1812, usGcuMode);
 	
-	UdpSendOpsTxResult(eResult, "0x%04X", usGcuMode);
+	CmdExecTxResult(eResult, "0x%04X", usGcuMode);
 	
 	return OK;
 }
 
-STATUS mtsNavDataInput(void) {
+/*
+ * Takes ARGS_NAV_DATA either as one BLOB argument or as 13 numbers in
+ * field order, so full double precision survives the OPS link. The bare
+ * struct is not accepted as the argument buffer: its first two bytes may
+ * read as the tagged list magic.
+ */
+STATUS mtsNavDataInput(const CmdArgs *pArgs) {
+	GcuUnit *pUnit = GcuUnitGet(pArgs->unit);
 	STATUS ret = OK;
+	ARGS_NAV_DATA stNavData;
+	const ARGS_NAV_DATA *pNavData = &stNavData;
+	TM_TYPE_GF3 stGf3;
+	const TM_TYPE_GF3 *pGf3 = &stGf3;
+	double *pField = (double *)&stNavData;
+	int i;
 	
-	ARGS_NAV_DATA *pNavData = (ARGS_NAV_DATA *)g_szArgs[0];
-	
-	memset((void *)(g_pTmFg3), 0, sizeof(TM_TYPE_FG3));
-	
-	g_pTmFg3->fg3_1.m_ADDRESS = TM_SDLC_ADDRESS;
-	g_pTmFg3->fg3_1.m_CONTROL = TM_FG3_SDLC_CONTROL;
-	g_pTmFg3->fg3_1.m_OPCODE = TM_FG3_1_OPCODE;
-	
-	g_pTmFg3->fg3_1.m_XLATL = pNavData->latL;
-	g_pTmFg3->fg3_1.m_XLONL = pNavData->lonL;
-	g_pTmFg3->fg3_1.m_HL = pNavData->altL;
-	g_pTmFg3->fg3_1.m_XLATT = pNavData->latT;
-	g_pTmFg3->fg3_1.m_XLONT = pNavData->lonT;
-	g_pTmFg3->fg3_1.m_HT = pNavData->altT;
-	g_pTmFg3->fg3_1.m_IMU_LA_X = pNavData->laX;
-	g_pTmFg3->fg3_1.m_IMU_LA_Y = pNavData->laY;
-	g_pTmFg3->fg3_1.m_IMU_LA_Z = pNavData->laZ;
-	g_pTmFg3->fg3_1.m_AQQC1 = pNavData->aqqc1;
-	g_pTmFg3->fg3_1.m_AQQC2 = pNavData->aqqc2;
-	g_pTmFg3->fg3_1.m_AQQC3 = pNavData->aqqc3;
-	g_pTmFg3->fg3_1.m_AQQC4 = pNavData->aqqc4;
-	
-	if (PostCmd(g_hSdlcSendGcu, SDLC_SEND_GCU_TX_FG3) == ERROR) {
+	if (ARG_BLOB_LEN(0) == sizeof(ARGS_NAV_DATA)) {
+		memcpy(&stNavData, ARG_BLOB(0), sizeof(ARGS_NAV_DATA));
+	} else if (pArgs->num == sizeof(ARGS_NAV_DATA) / sizeof(double)) {
+		for (i = 0; i < pArgs->num; i++) {
+			TRY_ARG_TO_DOUBLE(pField[i], i);
+		}
+	} else {
+		REPORT_ERROR("Invalid Argument. [#%d(%s)]\n", 0, ARG_STR(0));
+		return ERROR;
+	}
+	
+	memset((void *)(pUnit->pTmFg3), 0, sizeof(TM_TYPE_FG3));
+	
+	pUnit->pTmFg3->fg3_1.m_ADDRESS = TM_SDLC_ADDRESS;
+	pUnit->pTmFg3->fg3_1.m_CONTROL = TM_FG3_SDLC_CONTROL;
+	pUnit->pTmFg3->fg3_1.m_OPCODE = TM_FG3_1_OPCODE;
+	
+	pUnit->pTmFg3->fg3_1.m_XLATL = pNavData->latL;
+	pUnit->pTmFg3->fg3_1.m_XLONL = pNavData->lonL;
+	pUnit->pTmFg3->fg3_1.m_HL = pNavData->altL;
+	pUnit->pTmFg3->fg3_1.m_XLATT = pNavData->latT;
+	pUnit->pTmFg3->fg3_1.m_XLONT = pNavData->lonT;
+	pUnit->pTmFg3->fg3_1.m_HT = pNavData->altT;
+	pUnit->pTmFg3->fg3_1.m_IMU_LA_X = pNavData->laX;
+	pUnit->pTmFg3->fg3_1.m_IMU_LA_Y = pNavData->laY;
+	pUnit->pTmFg3->fg3_1.m_IMU_LA_Z = pNavData->laZ;
+	pUnit->pTmFg3->fg3_1.m_AQQC1 = pNavData->aqqc1;
+	pUnit->pTmFg3->fg3_1.m_AQQC2 = pNavData->aqqc2;
+	pUnit->pTmFg3->fg3_1.m_AQQC3 = pNavData->aqqc3;
+	pUnit->pTmFg3->fg3_1.m_AQQC4 = pNavData->aqqc4;
+	
+	if (postGcuCmd(pUnit, SDLC_SEND_GCU_TX_FG3, TM_FG3_1_OPCODE) == ERROR) {
 		REPORT_ERROR("PostCmd(SDLC_SEND_GCU_TX_FG3)\n");
 		return ERROR;
 	}
 	
-	DELAY_MS(GCU_RESPONSE_TIME);
+	CMD_DELAY_MS(GCU_RESPONSE_TIME);
+	
+	if (TmFieldSnapshot(GCU_SRC(pUnit, TM_WAIT_SRC_GF3), &stGf3, sizeof(stGf3)) == ERROR) {
+		REPORT_ERROR("GF3 : No snapshot.\n");
+		return ERROR;
+	}
 	
-	if (mtsCheckDouble(g_pTmFg3->fg3_1.m_XLATL, g_pTmGf3->gf3_1.m_XLATL, 0) == RESULT_TYPE_FAIL) {
+	if (mtsCheckDouble(pUnit->pTmFg3->fg3_1.m_XLATL, pGf3->gf3_1.m_XLATL, 0) == RESULT_TYPE_FAIL) {
 		LOGMSG("XLATL Data Mismatch.\n FG3: %0.10f\n GF3: %0.10f \n",
-				g_pTmFg3->fg3_1.m_XLATL, g_pTmGf3->gf3_1.m_XLATL);
+				pUnit->pTmFg3->fg3_1.m_XLATL, pGf3->gf3_1.m_XLATL);
 		ret = ERROR;
 	}
-	if (mtsCheckDouble(g_pTmFg3->fg3_1.m_XLONL, g_pTmGf3->gf3_1.m_XLONL, 0) == RESULT_TYPE_FAIL) {
+	if (mtsCheckDouble(pUnit->pTmFg3->fg3_1.m_XLONL, pGf3->gf3_1.m_XLONL, 0) == RESULT_TYPE_FAIL) {
 		LOGMSG("XLONL Data Mismatch.\n FG3: %0.10f\n GF3: %0.10f \n",
-				g_pTmFg3->fg3_1.m_XLONL, g_pTmGf3->gf3_1.m_XLONL);
+				pUnit->pTmFg3->fg3_1.m_XLONL, pGf3->gf3_1.m_XLONL);
 		ret = ERROR;
 	}
-	if (mtsCheckDouble(g_pTmFg3->fg3_1.m_HL, g_pTmGf3->gf3_1.m_HL, 0) == RESULT_TYPE_FAIL) {
+	if (mtsCheckDouble(pUnit->pTmFg3->fg3_1.m_HL, pGf3->gf3_1.m_HL, 0) == RESULT_TYPE_FAIL) {
 		LOGMSG("HL Data Mismatch.\n FG3: %0.10f\n GF3: %0.10f \n",
-				g_pTmFg3->fg3_1.m_HL, g_pTmGf3->gf3_1.m_HL);
+				pUnit->pTmFg3->fg3_1.m_HL, pGf3->gf3_1.m_HL);
 		ret = ERROR;
 	}
-	if (mtsCheckDouble(g_pTmFg3->fg3_1.m_XLATT, g_pTmGf3->gf3_1.m_XLATT, 0) == RESULT_TYPE_FAIL) {
+	if (mtsCheckDouble(pUnit->pTmFg3->fg3_1.m_XLATT, pGf3->gf3_1.m_XLATT, 0) == RESULT_TYPE_FAIL) {
 		LOGMSG("XLATT Data Mismatch.\n FG3: %0.10f\n GF3: %0.10f \n",
-				g_pTmFg3->fg3_1.m_XLATT, g_pTmGf3->gf3_1.m_HL);
+				pUnit->pTmFg3->fg3_1.m_XLATT, pGf3->gf3_1.m_HL);
 		ret = ERROR;
 	}
-	if (mtsCheckDouble(g_pTmFg3->fg3_1.m_XLONT, g_pTmGf3->gf3_1.m_XLONT, 0) == RESULT_TYPE_FAIL) {
+	if (mtsCheckDouble(pUnit->pTmFg3->fg3_1.m_XLONT, pGf3->gf3_1.m_XLONT, 0) == RESULT_TYPE_FAIL) {
 		LOGMSG("XLONT Data Mismatch.\n FG3: %0.10f\n GF3: %0.10f \n",
-				g_pTmFg3->fg3_1.m_XLONT, g_pTmGf3->gf3_1.m_XLONT);
+				pUnit->pTmFg3->fg3_1.m_XLONT, pGf3->gf3_1.m_XLONT);
 		ret = ERROR;
 	}
 	
-	if (mtsCheckDouble(g_pTmFg3->fg3_1.m_HT, g_pTmGf3->gf3_1.m_HT, 0) == RESULT_TYPE_FAIL) {
+	if (mtsCheckDouble(pUnit->pTmFg3->fg3_1.m_HT, pGf3->gf3_1.m_HT, 0) == RESULT_TYPE_FAIL) {
 		LOGMSG("HT Data Mismatch.\n FG3: %0.10f\n GF3: %0.10f \n",
-				g_pTmFg3->fg3_1.m_HT, g_pTmGf3->gf3_1.m_HT);
+				pUnit->pTmFg3->fg3_1.m_HT, pGf3->gf3_1.m_HT);
 		ret = ERROR;
 	}
 	
-	if (mtsCheckDouble(g_pTmFg3->fg3_1.m_AQQC1, g_pTmGf3->gf3_1.m_AQQC1, 0) == RESULT_TYPE_FAIL) {
+	if (mtsCheckDouble(pUnit->pTmFg3->fg3_1.m_AQQC1, pGf3->gf3_1.m_AQQC1, 0) == RESULT_TYPE_FAIL) {
 		LOGMSG("AQQC1 Data Mismatch.\n FG3: %0.10f\n GF3: %0.10f \n",
-				g_pTmFg3->fg3_1.m_AQQC1, g_pTmGf3->gf3_1.m_AQQC1);
+				pUnit->pTmFg3->fg3_1.m_AQQC1, pGf3->gf3_1.m_AQQC1);
 		ret = ERROR;
 	}
-	if (mtsCheckDouble(g_pTmFg3->fg3_1.m_AQQC2, g_pTmGf3->gf3_1.m_AQQC2, 0) == RESULT_TYPE_FAIL) {
+	if (mtsCheckDouble(pUnit->pTmFg3->fg3_1.m_AQQC2, pGf3->gf3_1.m_AQQC2, 0) == RESULT_TYPE_FAIL) {
 		LOGMSG("AQQC2 Data Mismatch.\n FG3: %0.10f\n GF3: %0.10f \n",
-				g_pTmFg3->fg3_1.m_AQQC2, g_pTmGf3->gf3_1.m_AQQC2);
+				pUnit->pTmFg3->fg3_1.m_AQQC2, pGf3->gf3_1.m_AQQC2);
 		ret = ERROR;
 	}
-	if (mtsCheckDouble(g_pTmFg3->fg3_1.m_AQQC3, g_pTmGf3->gf3_1.m_AQQC3, 0) == RESULT_TYPE_FAIL) {
+	if (mtsCheckDouble(pUnit->pTmFg3->fg3_1.m_AQQC3, pGf3->gf3_1.m_AQQC3, 0) == RESULT_TYPE_FAIL) {
 		LOGMSG("AQQC3 Data Mismatch.\n FG3: %0.10f\n GF3: %0.10f \n",
-				g_pTmFg3->fg3_1.m_AQQC3, g_pTmGf3->gf3_1.m_AQQC3);
+				pUnit->pTmFg3->fg3_1.m_AQQC3, pGf3->gf3_1.m_AQQC3);
 		ret = ERROR;
 	}
-	if (mtsCheckDouble(g_pTmFg3->fg3_1.m_AQQC4, g_pTmGf3->gf3_1.m_AQQC4, 0) == RESULT_TYPE_FAIL) {
+	if (mtsCheckDouble(pUnit->pTmFg3->fg3_1.m_AQQC4, pGf3->gf3_1.m_AQQC4, 0) == RESULT_TYPE_FAIL) {
 		LOGMSG("AQQC4 Data Mismatch.\n FG3: %0.10f\n GF3: %0.10f \n",
-				g_pTmFg3->fg3_1.m_AQQC4, g_pTmGf3->gf3_1.m_AQQC4);
+				pUnit->pTmFg3->fg3_1.m_AQQC4, pGf3->gf3_1.m_AQQC4);
 		ret = ERROR;
 	}
-	if (mtsCheckDouble(g_pTmFg3->fg3_1.m_ROLL, g_pTmGf3->gf3_1.m_ROLL, 0) == RESULT_TYPE_FAIL) {
+	if (mtsCheckDouble(pUnit->pTmFg3->fg3_1.m_ROLL, pGf3->gf3_1.m_ROLL, 0) == RESULT_TYPE_FAIL) {
 		LOGMSG("ROLL Data Mismatch.\n FG3: %0.10f\n GF3: %0.10f \n",
-				g_pTmFg3->fg3_1.m_ROLL, g_pTmGf3->gf3_1.m_ROLL);
+				pUnit->pTmFg3->fg3_1.m_ROLL, pGf3->gf3_1.m_ROLL);
 		ret = ERROR;
 	}
-	if (mtsCheckDouble(g_pTmFg3->fg3_1.m_PITCH, g_pTmGf3->gf3_1.m_PITCH, 0) == RESULT_TYPE_FAIL) {
+	if (mtsCheckDouble(pUnit->pTmFg3->fg3_1.m_PITCH, pGf3->gf3_1.m_PITCH, 0) == RESULT_TYPE_FAIL) {
 		LOGMSG("PITCH Data Mismatch.\n FG3: %0.10f\n GF3: %0.10f \n",
-				g_pTmFg3->fg3_1.m_PITCH, g_pTmGf3->gf3_1.m_PITCH);
+				pUnit->pTmFg3->fg3_1.m_PITCH, pGf3->gf3_1.m_PITCH);
 		ret = ERROR;
 	}
-	if (mtsCheckDouble(g_pTmFg3->fg3_1.m_YAW, g_pTmGf3->gf3_1.m_YAW, 0) == RESULT_TYPE_FAIL) {
+	if (mtsCheckDouble(pUnit->pTmFg3->fg3_1.m_YAW, pGf3->gf3_1.m_YAW, 0) == RESULT_TYPE_FAIL) {
 		LOGMSG("YAW Data Mismatch.\n FG3: %0.10f\n GF3: %0.10f \n",
-				g_pTmFg3->fg3_1.m_YAW, g_pTmGf3->gf3_1.m_YAW);
+				pUnit->pTmFg3->fg3_1.m_YAW, pGf3->gf3_1.m_YAW);
 		ret = ERROR;
 	}
-	if (mtsCheckDouble(g_pTmFg3->fg3_1.m_IMU_LA_X, g_pTmGf3->gf3_1.m_IMU_LA_X, 0) == RESULT_TYPE_FAIL) {
+	if (mtsCheckDouble(pUnit->pTmFg3->fg3_1.m_IMU_LA_X, pGf3->gf3_1.m_IMU_LA_X, 0) == RESULT_TYPE_FAIL) {
 		LOGMSG("IMU_LA_X Data Mismatch.\n FG3: %0.10f\n GF3: %0.10f \n",
-				g_pTmFg3->fg3_1.m_IMU_LA_X, g_pTmGf3->gf3_1.m_IMU_LA_X);
+				pUnit->pTmFg3->fg3_1.m_IMU_LA_X, pGf3->gf3_1.m_IMU_LA_X);
 		ret = ERROR;
 	}
-	if (mtsCheckDouble(g_pTmFg3->fg3_1.m_IMU_LA_Y, g_pTmGf3->gf3_1.m_IMU_LA_Y, 0) == RESULT_TYPE_FAIL) {
+	if (mtsCheckDouble(pUnit->pTmFg3->fg3_1.m_IMU_LA_Y, pGf3->gf3_1.m_IMU_LA_Y, 0) == RESULT_TYPE_FAIL) {
 		LOGMSG("IMU_LA_Y Data Mismatch.\n FG3: %0.10f\n GF3: %0.10f \n",
-				g_pTmFg3->fg3_1.m_IMU_LA_Y, g_pTmGf3->gf3_1.m_IMU_LA_Y);
+				pUnit->pTmFg3->fg3_1.m_IMU_LA_Y, pGf3->gf3_1.m_IMU_LA_Y);
 		ret = ERROR;
 	}
-	if (mtsCheckDouble(g_pTmFg3->fg3_1.m_IMU_LA_Z, g_pTmGf3->gf3_1.m_IMU_LA_Z, 0) == RESULT_TYPE_FAIL) {
+	if (mtsCheckDouble(pUnit->pTmFg3->fg3_1.m_IMU_LA_Z, pGf3->gf3_1.m_IMU_LA_Z, 0) == RESULT_TYPE_FAIL) {
 		LOGMSG("IMU_LA_Z Data Mismatch.\n FG3: %0.10f\n GF3: %0.10f \n",
-				g_pTmFg3->fg3_1.m_IMU_LA_Z, g_pTmGf3->gf3_1.m_IMU_LA_Z);
+				pUnit->pTmFg3->fg3_1.m_IMU_LA_Z, pGf3->gf3_1.m_IMU_LA_Z);
 		ret = ERROR;
 	}
 	
 	if (ret == ERROR) {
 		REPORT_ERROR("FG3 and GF3 NavData Mismatch. \n");
 	} else {
-		UdpSendOpsTxResult(RESULT_TYPE_PASS, "OK");
+		CmdExecTxResult(RESULT_TYPE_PASS, "OK");
 	}
 	
 	return ret;
 }
 
-STATUS mtsSaveAlignData(void) {
+STATUS mtsSaveAlignData(const CmdArgs *pArgs) {
+	GcuUnit *pUnit = GcuUnitGet(pArgs->unit);
 	VALUE_EX_QUATERNION quaternion;
+	TM_TYPE_GF7 stGf7;
 	
-	quaternion.aqqc1 = g_pTmGf7->m_AQQC1 * 5.0e-10;
-	quaternion.aqqc2 = g_pTmGf7->m_AQQC2 * 5.0e-10;
-	quaternion.aqqc3 = g_pTmGf7->m_AQQC3 * 5.0e-10;
-	quaternion.aqqc4 = g_pTmGf7->m_AQQC4 * 5.0e-10;
+	/* The four components must come from the same frame. */
+	if (TmFieldSnapshot(GCU_SRC(pUnit, TM_WAIT_SRC_GF7), &stGf7, sizeof(stGf7)) == ERROR) {
+		REPORT_ERROR("GF7 : No snapshot.\n");
+		return ERROR;
+	}
 	
-	UdpSendOpsTxResultTx(RESULT_TYPE_PASS, &quaternion, sizeof(quaternion), "OK");
+	quaternion.aqqc1 = stGf7.m_AQQC1 * 5.0e-10;
+	quaternion.aqqc2 = stGf7.m_AQQC2 * 5.0e-10;
+	quaternion.aqqc3 = stGf7.m_AQQC3 * 5.0e-10;
+	quaternion.aqqc4 = stGf7.m_AQQC4 * 5.0e-10;
+	
+	CmdExecTxResultTx(RESULT_TYPE_PASS, &quaternion, sizeof(quaternion), "OK");
 	
 	return OK;
 }
 
-STATUS mtsChkGf3NavData(void) {
+STATUS mtsChkGf3NavData(const CmdArgs *pArgs) {
+	GcuUnit *pUnit = GcuUnitGet(pArgs->unit);
 	const char * szValueFormat = "%0.5f";
+	TM_TYPE_GF3 stGf3;
+	const TM_TYPE_GF3 *pGf3 = &stGf3;
 	
-	if (strcmp(g_szArgs[0], "XLATL") == 0) {
-		UdpSendOpsTxResult(RESULT_TYPE_PASS, szValueFormat, g_pTmGf3->gf3_1.m_XLATL);
+	if (TmFieldSnapshot(GCU_SRC(pUnit, TM_WAIT_SRC_GF3), &stGf3, sizeof(stGf3)) == ERROR) {
+		REPORT_ERROR("GF3 : No snapshot.\n");
+		return ERROR;
+	}
+	
+	if (strcmp(ARG_STR(0), "XLATL") == 0) {
+		CmdExecTxResult(RESULT_TYPE_PASS, szValueFormat, pGf3->gf3_1.m_XLATL);
 		return OK;
-	} else if (strcmp(g_szArgs[0], "XLONL") == 0) {
-		UdpSendOpsTxResult(RESULT_TYPE_PASS, szValueFormat, g_pTmGf3->gf3_1.m_XLONL);
+	} else if (strcmp(ARG_STR(0), "XLONL") == 0) {
+		CmdExecTxResult(RESULT_TYPE_PASS, szValueFormat, pGf3->gf3_1.m_XLONL);
 		return OK;
-	} else if (strcmp(g_szArgs[0], "HL") == 0) {
-		UdpSendOpsTxResult(RESULT_TYPE_PASS, szValueFormat, g_pTmGf3->gf3_1.m_HL);
+	} else if (strcmp(ARG_STR(0), "HL") == 0) {
+		CmdExecTxResult(RESULT_TYPE_PASS, szValueFormat, pGf3->gf3_1.m_HL);
 		return OK;
-	} else if (strcmp(g_szArgs[0], "XLATT") == 0) {
-		UdpSendOpsTxResult(RESULT_TYPE_PASS, szValueFormat, g_pTmGf3->gf3_1.m_XLATT);
+	} else if (strcmp(ARG_STR(0), "XLATT") == 0) {
+		CmdExecTxResult(RESULT_TYPE_PASS, szValueFormat, pGf3->gf3_1.m_XLATT);
 		return OK;
-	} else if (strcmp(g_szArgs[0], "XLONT") == 0) {
-		UdpSendOpsTxResult(RESULT_TYPE_PASS, szValueFormat, g_pTmGf3->gf3_1.m_XLONT);
+	} else if (strcmp(ARG_STR(0), "XLONT") == 0) {
+		CmdExecTxResult(RESULT_TYPE_PASS, szValueFormat, pGf3->gf3_1.m_XLONT);
 		return OK;
-	} else if (strcmp(g_szArgs[0], "HT") == 0) {
-		UdpSendOpsTxResult(RESULT_TYPE_PASS, szValueFormat, g_pTmGf3->gf3_1.m_XHT);
+	} else if (strcmp(ARG_STR(0), "HT") == 0) {
+		CmdExecTxResult(RESULT_TYPE_PASS, szValueFormat, pGf3->gf3_1.m_XHT);
 		return OK;
-	} else if (strcmp(g_szArgs[0], "IMU_LA_X") == 0) {
-		UdpSendOpsTxResult(RESULT_TYPE_PASS, szValueFormat, g_pTmGf3->gf3_1.m_IMU_LA_X);
+	} else if (strcmp(ARG_STR(0), "IMU_LA_X") == 0) {
+		CmdExecTxResult(RESULT_TYPE_PASS, szValueFormat, pGf3->gf3_1.m_IMU_LA_X);
 		return OK;
-	} else if (strcmp(g_szArgs[0], "IMU_LA_Y") == 0) {
-		UdpSendOpsTxResult(RESULT_TYPE_PASS, szValueFormat, g_pTmGf3->gf3_1.m_IMU_LA_Y);
+	} else if (strcmp(ARG_STR(0), "IMU_LA_Y") == 0) {
+		CmdExecTxResult(RESULT_TYPE_PASS, szValueFormat, pGf3->gf3_1.m_IMU_LA_Y);
 		return OK;
-	} else if (strcmp(g_szArgs[0], "IMU_LA_Z") == 0) {
-		UdpSendOpsTxResult(RESULT_TYPE_PASS, szValueFormat, g_pTmGf3->gf3_1.m_IMU_LA_Z);
+	} else if (strcmp(ARG_STR(0), "IMU_LA_Z") == 0) {
+		CmdExecTxResult(RESULT_TYPE_PASS, szValueFormat, pGf3->gf3_1.m_IMU_LA_Z);
 		return OK;
 	} else {
-		REPORT_ERROR("Invalid Argument. [#%d(%s)]\n", 0, g_szArgs[0]);
+		REPORT_ERROR("Invalid Argument. [#%d(%s)]\n", 0, ARG_STR(0));
 		return ERROR;
 	}
 }
 
-STATUS mtsGcaStart(void) {
+STATUS mtsGcaStart(const CmdArgs *pArgs) {
+	GcuUnit *pUnit = GcuUnitGet(pArgs->unit);
 	OPS_TYPE_RESULT_TYPE eResult;
 	CODE usNavResp, usNavSts;
 	
-	memset((void *)(g_pTmFg7), 0, sizeof(TM_TYPE_FG7));
+	memset((void *)(pUnit->pTmFg7), 0, sizeof(TM_TYPE_FG7));
 	
-	g_pTmFg7->fg7_1.m_ADDRESS = TM_SDLC_ADDRESS;
-	g_pTmFg7->fg7_1.m_CONTROL = TM_FG7_SDLC_CONTROL;
-	g_pTmFg7->fg7_1.m_OPCODE = TM_FG7_1_OPCODE_GCA;
+	pUnit->pTmFg7->fg7_1.m_ADDRESS = TM_SDLC_ADDRESS;
+	pUnit->pTmFg7->fg7_1.m_CONTROL = TM_FG7_SDLC_CONTROL;
+	pUnit->pTmFg7->fg7_1.m_OPCODE = TM_FG7_1_OPCODE_GCA;
 	
-	if (PostCmd(g_hSdlcSendGcu, SDLC_SEND_GCU_TX_FG7) == ERROR) {
+	if (postGcuCmd(pUnit, SDLC_SEND_GCU_TX_FG7, TM_FG7_1_OPCODE_GCA) == ERROR) {
 		REPORT_ERROR("PostCmd(SDLC_SEND_GCU_TX_FG7)\n");
 		return ERROR;
 	}
 	
-	WAIT_RESPONSE(GCU_RESPONSE_TIME, 1, TM_FG7_1_OPCODE_GCA, g_pTmGf7->m_NAV_RESP, usNavResp, eResult);
+	WAIT_RESPONSE(TM_WAIT_SRC_GF7, GCU_RESPONSE_TIME, TM_FG7_1_OPCODE_GCA, GCU_GF(pUnit, 7)->m_NAV_RESP, usNavResp, eResult);
 	
-	UdpSendOpsTxResult(eResult, "0x%X", usNavSts & 0xF);
+	CmdExecTxResult(eResult, "0x%X", usNavSts & 0xF);
 	
 	return OK;
 }
 
-STATUS mtsShaStart(void) {
+STATUS mtsShaStart(const CmdArgs *pArgs) {
+	GcuUnit *pUnit = GcuUnitGet(pArgs->unit);
 	OPS_TYPE_RESULT_TYPE eResult;
 	CODE usNavResp, usNavSts;
 	
-	memset((void *)(g_pTmFg7), 0, sizeof(TM_TYPE_FG7));
+	memset((void *)(pUnit->pTmFg7), 0, sizeof(TM_TYPE_FG7));
 	
-	g_pTmFg7->fg7_1.m_ADDRESS = TM_SDLC_ADDRESS;
-	g_pTmFg7->fg7_1.m_CONTROL = TM_FG7_SDLC_CONTROL;
-	g_pTmFg7->fg7_1.m_OPCODE = TM_FG7_1_OPCODE_SHA;
+	pUnit->pTmFg7->fg7_1.m_ADDRESS = TM_SDLC_ADDRESS;
+	pUnit->pTmFg7->fg7_1.m_CONTROL = TM_FG7_SDLC_CONTROL;
+	pUnit->pTmFg7->fg7_1.m_OPCODE = TM_FG7_1_OPCODE_SHA;
 	
-	if (PostCmd)(g_hSdlcSendGcu, SDLC_SEND_GCU_TX_FG7) == ERROR) {
+	if (postGcuCmd(pUnit, SDLC_SEND_GCU_TX_FG7, TM_FG7_1_OPCODE_SHA) == ERROR) {
 		REPORT_ERROR("PostCmd(SDLC_SEND_GCU_TX_FG7)\n");
 		return ERROR;
 	}
 	
-	WAIT_RESPONSE_MASK(GCU_RESPONSE_TIME, 1, 0x1, g_pTmGf7->m_NAV_STS, usNavSts, 0xF, eResult);
+	WAIT_RESPONSE_MASK(TM_WAIT_SRC_GF7, GCU_RESPONSE_TIME, 0x1, GCU_GF(pUnit, 7)->m_NAV_STS, usNavSts, 0xF, eResult);
 	
-	UdpSendOpsTxResult(eResult, "0x%X", usNavSts & 0xF);
+	CmdExecTxResult(eResult, "0x%X", usNavSts & 0xF);
 	
 	return OK;
 }
 
-STATUS mtsGcaDone(void) {
-	OPS_TYPE_RESULT_TYPE eResult;
-	int waitTImeSec;
-	int refVal, targetVal;
+STATUS mtsGcaDone(const CmdArgs *pArgs) {
+	GcuUnit *pUnit = GcuUnitGet(pArgs->unit);
+	OPS_TYPE_RESULT_TYPE eResult = RESULT_TYPE_FAIL;
+	int waitTimeSec;
+	int refVal, targetVal = 0;
 	
-	TRY_STR_TO_LONG(waitTimeSec, 0, int);
-	TRY_STR_TO_LONG(refVal, 1, int);
+	TRY_ARG_TO_LONG(waitTimeSec, 0, int);
+	TRY_ARG_TO_LONG(refVal, 1, int);
 	
 	for (; waitTimeSec > 0; waitTimeSec--) {
-		DELAY_SEC(1);
+		WAIT_TM_FIELD(TM_WAIT_SRC_GF7, GET_DELAY_TICK(1000),
+					  GCU_GF(pUnit, 7)->m_ALIGN_STS, pArgs->mask, TM_WAIT_OP_EQ,
+					  refVal, targetVal, eResult);
 		
-		targetVal = g_pTmGf7->m_ALIGN_STS;
+		CmdExecTxResult(RESULT_TYPE_ONGOING, "0x%04X", targetVal);
 		
-		UdpSendOpsTxResult(RESULT_TYPE_ONGOING, "0x%04X", targetVal);
-		
-		eResult = mtsCheckEqual(refVal, targetVal & g_dwArgMask);
 		if (eResult == RESULT_TYPE_PASS)
 			break;
 	}
 	
-	UdpSendOpsTxResult(eResult, "0x%04X", targetVal);
+	CmdExecTxResult(eResult, "0x%04X", targetVal);
 	
 	return OK;
 }
 
-	UdpSendOpsTxResult(eResult, "0x%04X", targetVal);
+	CmdExecTxResult(eResult, "0x%04X", targetVal);
 	
 	return OK;
 }
 
-STATUS mtsGcuMslGpsModeSet(void) {
+STATUS mtsGcuMslGpsModeSet(const CmdArgs *pArgs) {
+	GcuUnit *pUnit = GcuUnitGet(pArgs->unit);
 	OPS_TYPE_RESULT_TYPE eResult;
 	CODE usResp;
 	
-	memset((void *)g_pTmFg5, 0, sizeof(TM_TYPE_FG5));
+	memset((void *)pUnit->pTmFg5, 0, sizeof(TM_TYPE_FG5));
 	
-	g_pTmFg5->m_ADDRESS = TM_SDLC_ADDRESS;
-	g_pTmFg5->m_CONTROL = TM_FG5_SDLC_CONTROL;
-	g_pTmFg5->m_OPCODE = TM_FG5_OPCODE;
+	pUnit->pTmFg5->m_ADDRESS = TM_SDLC_ADDRESS;
+	pUnit->pTmFg5->m_CONTROL = TM_FG5_SDLC_CONTROL;
+	pUnit->pTmFg5->m_OPCODE = TM_FG5_OPCODE;
 	
-	TRY_STR_TO_LONG(g_pTmFg5->m_VALID_WORD, 0, UINT16);
-	TRY_STR_TO_LONG(g_pTmFg5->m_AR_MODE, 1, UINT16);
-	TRY_STR_TO_LONG(g_pTmFg5->m_SBAS_SELECT, 2, UINT16);
-	TRY_STR_TO_LONG(g_pTmFg5->m_SET_AJ_MODE, 3, UINT16);
-	TRY_STR_TO_LONG(g_pTmFg5->m_SET_RCV_MODE, 4, UINT16);
+	TRY_ARG_TO_LONG(pUnit->pTmFg5->m_VALID_WORD, 0, UINT16);
+	TRY_ARG_TO_LONG(pUnit->pTmFg5->m_AR_MODE, 1, UINT16);
+	TRY_ARG_TO_LONG(pUnit->pTmFg5->m_SBAS_SELECT, 2, UINT16);
+	TRY_ARG_TO_LONG(pUnit->pTmFg5->m_SET_AJ_MODE, 3, UINT16);
+	TRY_ARG_TO_LONG(pUnit->pTmFg5->m_SET_RCV_MODE, 4, UINT16);
 	
-	LOGMSG("VALID_WORD = 0x%04X\n", g_pTMFg5->m_VALID_WORD);
-	LOGMSG("AR_MODE = %d\n", g_pTmFg5->m_AR_MODE);
-	LOGMSG("SBAS_SELECT" = %d\n", g_TmFg5->m_SBAS_SELECT);
-	LOGMSG("SET_AJ_MODE" = %d\n", g_pTmFg5->m_SET_AJ_MODE);
-	LOGMSG("SET_RCV_MODE" = %d\n", g_pTmFg5->m_SET_RCV_MODE);
+	LOGMSG("VALID_WORD = 0x%04X\n", pUnit->pTmFg5->m_VALID_WORD);
+	LOGMSG("AR_MODE = %d\n", pUnit->pTmFg5->m_AR_MODE);
+	LOGMSG("SBAS_SELECT" = %d\n", pUnit->pTmFg5->m_SBAS_SELECT);
+	LOGMSG("SET_AJ_MODE" = %d\n", pUnit->pTmFg5->m_SET_AJ_MODE);
+	LOGMSG("SET_RCV_MODE" = %d\n", pUnit->pTmFg5->m_SET_RCV_MODE);
 	
-	if (PostCmd(g_hSdlcSendGcu, SDLC_SEND_GCU_TX_FG5) == ERROR) {
+	if (postGcuCmd(pUnit, SDLC_SEND_GCU_TX_FG5, TM_FG5_OPCODE) == ERROR) {
 		REPORT_ERROR("PostCmd(SDLC_SEND_GCU_TX_FG5)\n");
 		return ERROR;
 	}
 	
-	WAIT_RESPONSE(GCU_RESPONSE_TIME, 1, TM_GF5_OPCODE, g_pTmGf5->m_MAR_RESP, usResp, eResult);
+	WAIT_RESPONSE(TM_WAIT_SRC_GF5, GCU_RESPONSE_TIME, TM_GF5_OPCODE, GCU_GF(pUnit, 5)->m_MAR_RESP, usResp, eResult);
 	
-	UdpSendOpsTxResult(eResult, "0x%04X", usResp);
+	CmdExecTxResult(eResult, "0x%04X", usResp);
 	
 	return OK;
 }
 
-STATUS mtsMslGpsTrkStart(void) {
+STATUS mtsMslGpsTrkStart(const CmdArgs *pArgs) {
+	GcuUnit *pUnit = GcuUnitGet(pArgs->unit);
 	OPS_TYPE_RESULT_TYPE eResult;
 	CODE usResp;
 	
-	memset((void *)g_pTmFg5, 0, sizeof(TM_TYPE_FG5));
+	memset((void *)pUnit->pTmFg5, 0, sizeof(TM_TYPE_FG5));
 	
-	g_pTMFg5->m_ADDRESS = TM_SDLC_ADDRESS;
-	g_pTmFg5->m_CONTROL = TM_FG5_SDLC_CONTROL;
-	g_pTmFg5->m_OPCODE = TM_FG5_OPCODE;
+	pUnit->pTmFg5->m_ADDRESS = TM_SDLC_ADDRESS;
+	pUnit->pTmFg5->m_CONTROL = TM_FG5_SDLC_CONTROL;
+	pUnit->pTmFg5->m_OPCODE = TM_FG5_OPCODE;
 	
-	g_pTmFg5->m_VALID_WORD = 0x0200;
-	TRY_STR_TO_LONG(g_pTMFg5->m_TRK_START, 0, UINT16);
+	pUnit->pTmFg5->m_VALID_WORD = 0x0200;
+	TRY_ARG_TO_LONG(pUnit->pTmFg5->m_TRK_START, 0, UINT16);
 	
-	LOGMSG("VALID_WORD = 0x%04X\n", g_pTMFg5->m_VALID_WORD);
-	LOGMSG("TRK_START = %d\n", g_pTMFg5->m_TRK_START);
+	LOGMSG("VALID_WORD = 0x%04X\n", pUnit->pTmFg5->m_VALID_WORD);
+	LOGMSG("TRK_START = %d\n", pUnit->pTmFg5->m_TRK_START);
 	
-	if (PostCmd(g_hSdlcSendGcu, SDLC_SEND_GCU_TX_FG5) == ERROR) {
+	if (postGcuCmd(pUnit, SDLC_SEND_GCU_TX_FG5, TM_FG5_OPCODE) == ERROR) {
 		REPORT_ERROR("PostCmd(SDLC_SEND_GCU_TX_FG5)\n");
 		return ERROR;
 	}
 	
-	WAIT_RESPONSE(GCU_RESPONSE_TIME, 1, TM_GF5_OPCODE, g_pTmGf5->m_MAR_RESP, usResp, eResult);
+	WAIT_RESPONSE(TM_WAIT_SRC_GF5, GCU_RESPONSE_TIME, TM_GF5_OPCODE, GCU_GF(pUnit, 5)->m_MAR_RESP, usResp, eResult);
 	
-	UdpSendOpsTxResult(eResult, "0x%04X", usResp);
+	CmdExecTxResult(eResult, "0x%04X", usResp);
 	
 	return OK;
 }
 
-STATUS mtsActMotorOn(void) {
+STATUS mtsActMotorOn(const CmdArgs *pArgs) {
+	GcuUnit *pUnit = GcuUnitGet(pArgs->unit);
 	OPS_TYPE_RESULT_TYPE eResult;
 	int refVal;
 	CODE usGcuResp, usGcuMode;
 	
-	TRY_STR_TO_LONG(refVal, 0, int);
+	TRY_ARG_TO_LONG(refVal, 0, int);
 	
-	memset((void *)(g_pTmFg2), 0, sizeof(TM_TYPE_FG2));
+	memset((void *)(pUnit->pTmFg2), 0, sizeof(TM_TYPE_FG2));
 	
-	g_pTmFg2->fg2_1.m_ADDRESS = TM_SDLC_ADDRESS;
-	g_pTmFg2->fg2_1.m_CONTROL = TM_FG2_1_OPCODE_MSL_MOTOR_ON;
+	pUnit->pTmFg2->fg2_1.m_ADDRESS = TM_SDLC_ADDRESS;
+	pUnit->pTmFg2->fg2_1.m_CONTROL = TM_FG2_1_OPCODE_MSL_MOTOR_ON;
 	
-	if (PostCmd(g_hSdlcSendGcu, SDLC_SEND_GCU_TX_FG2) == ERROR) {
+	if (postGcuCmd(pUnit, SDLC_SEND_GCU_TX_FG2, TM_FG2_1_OPCODE_MSL_MOTOR_ON) == ERROR) {
 		REPORT_ERROR("PostCmd(SDLC_SEND_GCU_TX_FG2)\n");
 		return ERROR;
 	}
 	
-	WAIT_RESPONSE(GCU_RESPONSE_TIME, 1, TM_FG2_1_OPCODE_MSL_MOTOR_ON, g_pTmFg2->m_GCU_RESP, usGcuResp, eResult);
+	WAIT_RESPONSE(TM_WAIT_SRC_GF2, GCU_RESPONSE_TIME, TM_FG2_1_OPCODE_MSL_MOTOR_ON, GCU_GF(pUnit, 2)->m_GCU_RESP, usGcuResp, eResult);
 	
 	if (eResult == RESULT_TYPE_FAIL) {
 		REPORT_ERROR("GCU : No Response.\n");
 		return ERROR;
 	}
 	
-	DELAY_MS(GCU_RESPONSE_TIME);
+	CMD_DELAY_MS(GCU_RESPONSE_TIME);
 	
-	usGcuMode = g_pTmGf2->m_GCU_MODE;
-	eResult = mtsCheckEqual(refVal, usGcuMode & g_dwArgMask);
+	usGcuMode = GCU_GF(pUnit, 2)->m_GCU_MODE;
+	eResult = mtsCheckEqual(refVal, usGcuMode & pArgs->mask);
 	
-	UdpSendOpsTxResult(eResult, "0x%04X", usGcuMode);
+	CmdExecTxResult(eResult, "0x%04X", usGcuMode);
 	
 	return OK;
 }
 
-STATUS mtsAcuCtrlCommandSetErrorDeg(void) {
+STATUS mtsAcuCtrlCommandSetErrorDeg(const CmdArgs *pArgs) {
+	GcuUnit *pUnit = GcuUnitGet(pArgs->unit);
 	OPS_TYPE_RESULT_TYPE eResult;
 	UINT16 usActKind;
 	INT16 sDeg;
 	int dDegError;
 	CODE usGcuResp;
+	TM_TYPE_GF2 stGf2;
 	
 	UINT32 uResCode = 0;
 	int dDeg1 = 0;
@@ -1458,31 +1660,31 @@ STATUS mtsAcuCtrlCommandSetErrorDeg(void) {
 	int dDeg3 = 0;
 	int dDeg4 = 0;
 	
-	TRY_STR_TO_LONG(usActKind, 0, UINT16);
-	TRY_STR_TO_LONG(sDeg, 1, INT16);
-	TRY_STR_TO_LONG(dDegError, 2, int);
+	TRY_ARG_TO_LONG(usActKind, 0, UINT16);
+	TRY_ARG_TO_LONG(sDeg, 1, INT16);
+	TRY_ARG_TO_LONG(dDegError, 2, int);
 	
-	memset((void *)(g_pTmFg2), 0, sizeof(TM_TYPE_FG2));
+	memset((void *)(pUnit->pTmFg2), 0, sizeof(TM_TYPE_FG2));
 	
-	g_pTmFg2->fg2_2.m_ADDRESS = TM_SDLC_ADDRESS;
-	g_pTmFg2->fg2_2.m_CONTROL = TM_FG2_SDLC_CONTROL;
-	g_pTmFg2->fg2_2.m_OPCODE = TM_FG2_2_OPCODE;
-	g_pTmFg2->fg2_2.m_ACTKIND = usActKind;
-	g_pTmFg2->fg2_2.m_VALUE = sDeg;
+	pUnit->pTmFg2->fg2_2.m_ADDRESS = TM_SDLC_ADDRESS;
+	pUnit->pTmFg2->fg2_2.m_CONTROL = TM_FG2_SDLC_CONTROL;
+	pUnit->pTmFg2->fg2_2.m_OPCODE = TM_FG2_2_OPCODE;
+	pUnit->pTmFg2->fg2_2.m_ACTKIND = usActKind;
+	pUnit->pTmFg2->fg2_2.m_VALUE = sDeg;
 	
-	if (PostCmd(g_hSdlcSendGcu, SDLC_SEND_GCU_TX_FG2) == ERROR) {
+	if (postGcuCmd(pUnit, SDLC_SEND_GCU_TX_FG2, TM_FG2_2_OPCODE) == ERROR) {
 		REPORT_ERROR("PostCmd(SDLC_SEND_GCU_TX_FG2)\n");
 		return ERROR;
 	}
 	
-	WAIT_RESPONSE(GCU_RESPONSE_TIME, 1, TM_FG2_2_OPCODE, g_pTmGf2->m_GCU_RESP, usGcuResp, eResult);
+	WAIT_RESPONSE(TM_WAIT_SRC_GF2, GCU_RESPONSE_TIME, TM_FG2_2_OPCODE, GCU_GF(pUnit, 2)->m_GCU_RESP, usGcuResp, eResult);
 	
 	if (eResult == RESULT_TYPE_FAIL) {
 		REPORT_ERROR("GCU : No Response.\n");
 		return ERROR;
 	}
 	
-	DELAY_SEC(3.5);
+	CMD_DELAY_SEC(3.5);
 	
 	switch (usActKind) {
 		case 1: /* Roll */
@@ -1508,139 +1710,161 @@ STATUS mtsAcuCtrlCommandSetErrorDeg(void) {
 			return ERROR;
 	}
 	
-	uResCode = uResCode + (mtsCheckRange(dDeg1 - dDegError, dDeg1 + dDegError, g_pTmGf2->m_FIN1_FB) * 1000);
-	uResCode = uResCode + (mtsCheckRange(dDeg2 - dDegError, dDeg2 + dDegError, g_pTmGf2->m_FIN2_FB) * 100);
-	uResCode = uResCode + (mtsCheckRange(dDeg3 - dDegError, dDeg3 + dDegError, g_pTmGf2->m_FIN3_FB) * 10);
-	uResCode = uResCode + (mtsCheckRange(dDeg4 - dDegError, dDeg4 + dDegError, g_pTmGf2->m_FIN4_FB) * 1);
+	/* The four feedbacks must come from the same frame. */
+	if (TmFieldSnapshot(GCU_SRC(pUnit, TM_WAIT_SRC_GF2), &stGf2, sizeof(stGf2)) == ERROR) {
+		REPORT_ERROR("GF2 : No snapshot.\n");
+		return ERROR;
+	}
+	
+	uResCode = uResCode + (mtsCheckRange(dDeg1 - dDegError, dDeg1 + dDegError, stGf2.m_FIN1_FB) * 1000);
+	uResCode = uResCode + (mtsCheckRange(dDeg2 - dDegError, dDeg2 + dDegError, stGf2.m_FIN2_FB) * 100);
+	uResCode = uResCode + (mtsCheckRange(dDeg3 - dDegError, dDeg3 + dDegError, stGf2.m_FIN3_FB) * 10);
+	uResCode = uResCode + (mtsCheckRange(dDeg4 - dDegError, dDeg4 + dDegError, stGf2.m_FIN4_FB) * 1);
 	
 	eResult = mtsCheckEqual(1111, uResCode);
 	
 	return OK;
 }
 
-STATUS mtsAcuSlewStart(void) {
+STATUS mtsAcuSlewStart(const CmdArgs *pArgs) {
+	GcuUnit *pUnit = GcuUnitGet(pArgs->unit);
 	OPS_TYPE_RESULT_TYPE eResult;
 	CODE usGcuResp;
 	
-	memset((void *)(g_pTmFg2), 0, sizeof(TM_TYPE_FG2));
+	memset((void *)(pUnit->pTmFg2), 0, sizeof(TM_TYPE_FG2));
 	
-	g_pTmFg2->fg2_1.m_ADDRESS = TM_SDLC_ADDRESS;
-	g_pTmFg2->fg2_1.m_CONTROL = TM_FG2_SDLC_CONTROL;
-	g_pTmFg2->fg2_1.m_OPCODE = TM_FG2_1_OPCODE_ACT_TEST_START;
+	pUnit->pTmFg2->fg2_1.m_ADDRESS = TM_SDLC_ADDRESS;
+	pUnit->pTmFg2->fg2_1.m_CONTROL = TM_FG2_SDLC_CONTROL;
+	pUnit->pTmFg2->fg2_1.m_OPCODE = TM_FG2_1_OPCODE_ACT_TEST_START;
 	
-	if (PostCmd(g_hSdlcSendGcu, SDLC_SEND_GCU_TX_FG2) == ERROR) {
+	if (postGcuCmd(pUnit, SDLC_SEND_GCU_TX_FG2, TM_FG2_1_OPCODE_ACT_TEST_START) == ERROR) {
 		REPORT_ERROR("PostCmd(SDLC_SEND_GCU_TX_FG2)\n");
 		return ERROR;
 	}
 	
-	WAIT_RESPONSE(GET_DELAY_TICK(3500), 1, TM_FG2_1_OPCODE_ACT_TEST_START, g_pTmGf2->m_GCU_RESP, usGcuResp, eResult);
+	WAIT_RESPONSE(TM_WAIT_SRC_GF2, GET_DELAY_TICK(3500), TM_FG2_1_OPCODE_ACT_TEST_START, GCU_GF(pUnit, 2)->m_GCU_RESP, usGcuResp, eResult);
 	
 	UdpSendOPsTxResult(eResult, "0x%04X", usGcuResp);
 	
 	return OK;
 }
 
-STATUS mtsAcuSlewEnd(void) {
+STATUS mtsAcuSlewEnd(const CmdArgs *pArgs) {
+	GcuUnit *pUnit = GcuUnitGet(pArgs->unit);
 	OPS_TYPE_RESULT_TYPE eResult;
 	CODE usGcuResp;
 	
-	memset((void *)(g_pTmFg2), 0, sizeof(TM_TYPE_FG2));
+	memset((void *)(pUnit->pTmFg2), 0, sizeof(TM_TYPE_FG2));
 	
-	g_pTmFg2->fg2_1.m_ADDRESS = TM_SDLC_ADDRESS;
-	g_pTmFg2->fg2_1.m_CONTROL = TM_FG2_SDLC_CONTROL;
-	g_pTmFg2->fg2_1.m_OPCODE = TM_FG2_1_OPCODE_ACT_TEST_END;
+	pUnit->pTmFg2->fg2_1.m_ADDRESS = TM_SDLC_ADDRESS;
+	pUnit->pTmFg2->fg2_1.m_CONTROL = TM_FG2_SDLC_CONTROL;
+	pUnit->pTmFg2->fg2_1.m_OPCODE = TM_FG2_1_OPCODE_ACT_TEST_END;
 	
-	if (PostCmd(g_hSdlcSendGcu, SDLC_SEND_GCU_TX_FG2) == ERROR) {
+	if (postGcuCmd(pUnit, SDLC_SEND_GCU_TX_FG2, TM_FG2_1_OPCODE_ACT_TEST_END) == ERROR) {
 		REPORT_ERROR("PostCmd(SDLC_SEND_GCU_TX_FG2)\n");
 		return ERROR;
 	}
 	
-	WAIT_RESPONSE(GET_DELAY_TICK(3500), 1, TM_FG2_1_OPCODE_ACT_TEST_END, g_pTmGf2->m_GCU_RESP, usGcuResp, eResult);
+	WAIT_RESPONSE(TM_WAIT_SRC_GF2, GET_DELAY_TICK(3500), TM_FG2_1_OPCODE_ACT_TEST_END, GCU_GF(pUnit, 2)->m_GCU_RESP, usGcuResp, eResult);
 	
-	UdpSendOpsTxResult(eResult, "0x%04X", usGcuResp);
+	CmdExecTxResult(eResult, "0x%04X", usGcuResp);
 	
 	return OK;
 }
 
-STATUS mtsAcuWingCommandSetErrorDeg(void) {
-	UINT usFInNum;
+STATUS mtsAcuWingCommandSetErrorDeg(const CmdArgs *pArgs) {
+	GcuUnit *pUnit = GcuUnitGet(pArgs->unit);
+	UINT16 usFinNum;
 	INT16 sDeg;
 	int nDegError;
 	int idx;
 	CODE usGcuResp;
-	INT16 sFinFb;
+	INT32 finFb;
+	const volatile INT16 *pFinFb;
 	OPS_TYPE_RESULT_TYPE eResult;
+	TmWaitPred pred;
 	
-	TRY_STR_TO_LONG(usFinNum, 0, UINT16);
-	TRY_STR_TO_LONG(sDeg, 1, INT16);
-	TRY_STR_TO_LONG(nDegError, 2, int);
+	TRY_ARG_TO_LONG(usFinNum, 0, UINT16);
+	TRY_ARG_TO_LONG(sDeg, 1, INT16);
+	TRY_ARG_TO_LONG(nDegError, 2, int);
 	
-	memset((void *)(g_pTmFg2), 0, sizeof(TM_TYPE_FG2));
+	switch (usFinNum) {
+		case 1:
+			pFinFb = &GCU_GF(pUnit, 2)->m_FIN1_FB;
+			break;
+		case 2:
+			pFinFb = &GCU_GF(pUnit, 2)->m_FIN2_FB;
+			break;
+		case 3:
+			pFinFb = &GCU_GF(pUnit, 2)->m_FIN3_FB;
+			break;
+		case 4:
+			pFinFb = &GCU_GF(pUnit, 2)->m_FIN4_FB;
+			break;
+		default:
+			REPORT_ERROR("Invalid Argument. [#%d(%s)]\n", 0, ARG_STR(0));
+			return ERROR;
+	}
+	
+	memset((void *)(pUnit->pTmFg2), 0, sizeof(TM_TYPE_FG2));
 	
-	g_pTmFg2->fg2_3.m_ADDRESS = TM_SDLC_ADDRESS;
-	g_pTmFg2->fg2_3.m_CONTROL = TM_FG2_SDLC_CONTROL;
-	g_pTmFg2->fg2_3.m_OPCODE = TM_FG2_3_OPCODE;
-	g_pTmFg2->fg2_3.m_ACTNO = usFinNum;
-	g_pTmFg2->fg2_3.m_VALUE = sDeg;
+	pUnit->pTmFg2->fg2_3.m_ADDRESS = TM_SDLC_ADDRESS;
+	pUnit->pTmFg2->fg2_3.m_CONTROL = TM_FG2_SDLC_CONTROL;
+	pUnit->pTmFg2->fg2_3.m_OPCODE = TM_FG2_3_OPCODE;
+	pUnit->pTmFg2->fg2_3.m_ACTNO = usFinNum;
+	pUnit->pTmFg2->fg2_3.m_VALUE = sDeg;
 	
-	if (PostCmd(g_hSdlcSendGcu, SDLC_SEND_GCU_TX_FG2) == ERROR) {
+	if (postGcuCmd(pUnit, SDLC_SEND_GCU_TX_FG2, TM_FG2_3_OPCODE) == ERROR) {
 		REPORT_ERROR("PostCmd(SDLC_SEND_GCU_TX_FG2)\n");
 		return ERROR;
 	}
 	
-	WAIT_RESPONSE(GCU_RESPONSE_TIME, 1, TM_FG2_3_OPCDE, g_pTmGf2->m_GCU_RESP, usGcuResp, eResult);
+	WAIT_RESPONSE(TM_WAIT_SRC_GF2, GCU_RESPONSE_TIME, TM_FG2_3_OPCODE, GCU_GF(pUnit, 2)->m_GCU_RESP, usGcuResp, eResult);
 	
 	if (eResult == RESULT_TYPE_FAIL) {
 		REPORT_ERROR("GCU : No Response.\n");
 		return ERROR;
 	}
 	
-	for (idx = 0; idx < 35; idx++) {
-		DELAY_MS(100);
-		
-		switch (usFinNum) {
-			case 1:
-				sFinFb = g_pTmGf2->m_FIN1_FB;
-				break;
-			case 2:
-				sFinFb = g_pTmGf2->m_FIN2_FB;
-				break;
-			case 3:
-				sFinFb = g_pTmGf2->m_FIN3_FB;
-				break;
-			case 4:
-				sFinFb = g_pTmGf2->m_FIN4_FB;
-				break;
-		}
-		UdpSendOpsTxResult(RESULT_TYPE_ONGOING, "%0.3f", sFinFb / 1000.);
-	}
+	/* Progress every FIN_SETTLE_STEP_MS until the feedback is in range. */
+	TM_WAIT_PRED_INIT(pred, GCU_SRC(pUnit, TM_WAIT_SRC_GF2), *pFinFb, 0xFFFFFFFF,
+					  TM_WAIT_OP_IN, sDeg - nDegError);
+	pred.ref2 = sDeg + nDegError;
 	
-	switch (usFinNum) {
-		case 1:
-			sFinFb = g_pTmGf2->m_FIN1_FB;
-			break;
-		case 2:
-			sFinFb = g_pTmGf2->m_FIN2_FB;
-			break;
-		case 3:
-			sFinFb = g_pTmGf2->m_FIN3_FB;
-			break;
-		case 4:
-			sFinFb = g_pTmGf2->m_FIN4_FB;
+	for (idx = 0; idx < FIN_SETTLE_STEPS; idx++) {
+		if (TmWaitFor(&pred, GET_DELAY_TICK(FIN_SETTLE_STEP_MS),
+					  CmdExecIsCancelled, &finFb, NULL) == OK)
 			break;
+		
+		RETURN_IF_CANCELLED();
+		CmdExecTxResult(RESULT_TYPE_ONGOING, "%0.3f", finFb / 1000.);
 	}
 	
-	eResult = mtsCheckRange(sDeg - nDegError, sDeg + nDegError, sFinFb);
-	UdpSendOpsTxResult(RESULT_TYPE_ONGOING, "%0.3f", sFinFb / 1000.);
+	eResult = mtsCheckRange(sDeg - nDegError, sDeg + nDegError, finFb);
+	CmdExecTxResult(eResult, "%0.3f", finFb / 1000.);
 	
 	return OK;
 }
 
-STATUS mtsArm1OnOff(void) {
+/* ERROR unless bit 7 (ARM1_GOOD) of GCU_DIO_STS reads isGood, logged and checked from one frame. */
+LOCAL STATUS chkArm1Good(GcuUnit *pUnit, int isGood) {
+	TM_TYPE_GF2 stGf2;
+	
+	if (TmFieldSnapshot(GCU_SRC(pUnit, TM_WAIT_SRC_GF2), &stGf2, sizeof(stGf2)) == ERROR) {
+		LOGMSG("GF2 : No snapshot.\n");
+		return ERROR;
+	}
+	
+	LOGMSG("GCU_DIO_STS : 0x%04X\n", stGf2.m_GCU_DIO_STS);
+	
+	return ((stGf2.m_GCU_DIO_STS >> 7 & 0x1) != isGood) ? ERROR : OK;
+}
+
+STATUS mtsArm1OnOff(const CmdArgs *pArgs) {
+	GcuUnit *pUnit = GcuUnitGet(pArgs->unit);
 	STATUS gcuDioValid = OK;
 	
-	LOGMSG("GCU_DIO_STS : 0x%04X\n", g_pTmGf2->m_GCU_DIO_STS;
-	if ((g_pTmGf2->m_GCU_DIO_STS >> 7 & 0x1) != 0x0) {
+	if (chkArm1Good(pUnit, 0) == ERROR) {
 		gcuDioValid = ERROR;
 	}
 	
@@ -1652,8 +1876,7 @@ STATUS mtsArm1OnOff(void) {
 	DELAY MS(GCU_RESPONSE_TIME);
 	
 	/* ARM1_GOOD check */
-	LOGMSG("GCU_DIO_STS : 0x%04X\n", g_pTMGf2->m_GCU_DIO_STS);
-	if ((g_pTmGf2->m_GCU_DIO_STS >> 7 & 0x1) != 0x1) {
+	if (chkArm1Good(pUnit, 1) == ERROR) {
 		gcuDioValid = ERROR;
 	}
 	
@@ -1666,8 +1889,7 @@ STATUS mtsArm1OnOff(void) {
 	
 	DELAY_MS(GCU_RESPONSE_TIME);
 	
-	LOGMSG("GCU_DIO_STS : 0x%04X\n", g_pTmGf2->m_GCU_DIO_STS);
-	if ((g_pTmGf2->m_GCU_DIO_STS >> 7 & 0x1) != 0x0) {
+	if (chkArm1Good(pUnit, 0) == ERROR) {
 		gcuDioValid = ERROR;
 	}
 	
@@ -1676,294 +1898,692 @@ STATUS mtsArm1OnOff(void) {
 		return ERROR;
 	}
 	
-	UdpSendOpsTxResult(RESULT_TYPE_PASS, "OK");
+	CmdExecTxResult(RESULT_TYPE_PASS, "OK");
 	
 	return OK;
 }
 
-STATUS mtsBit(void) {
+STATUS mtsBit(const CmdArgs *pArgs) {
 	OPS_TYPE_RESULT_TYPE eResult;
 	UINT32 regVal;
 	
-	if (strcmp(g_szArgs[0], "SPB") == 0) {
+	if (strcmp(ARG_STR(0), "SPB") == 0) {
 		regVal = mtsLibDiBitSpbPg();
-	} else if (strcmp(g_szArgs[0], "ESB") == 0) {
+	} else if (strcmp(ARG_STR(0), "ESB") == 0) {
 		regVal = mtsLibDiBitEsuPg();
-	} else if (strcmp(g_szArgs[0], "IOB") == 0) {
+	} else if (strcmp(ARG_STR(0), "IOB") == 0) {
 		regVal = mtsLibDiBitIobPg();
-	} else if (strcmp(g_szArgs[0], "PCB") == 0) {
+	} else if (strcmp(ARG_STR(0), "PCB") == 0) {
 		regVal = mtsLibDiBitPcbPg();
-	} else if (strcmp(g_szArgs[0], "MCB") == 0) {
+	} else if (strcmp(ARG_STR(0), "MCB") == 0) {
 		regVal = 1;
 	} else {
-		REPORT_ERROR("Invalid Argument. [#%d(%s)]\n", 0, g_szArgs[0]);
+		REPORT_ERROR("Invalid Argument. [#%d(%s)]\n", 0, ARG_STR(0));
 		return ERROR;
 	}
 	
 	eResult = mtsCheckEqual(0x1, regVal);
-	UdpSendOpsTxResult(eResult, "0x%X", regVal);
+	CmdExecTxResult(eResult, "0x%X", regVal);
 	
 	return OK;
 }
 
-STATUS steBit(void) {
+STATUS steBit(const CmdArgs *pArgs) {
 	OPS_TYPE_RESULT_TYPE eResult;
 	UINT32 regVal;
 	
-	if (strcmp(g_szArgs[0], "IOB1") == 0) {
+	if (strcmp(ARG_STR(0), "IOB1") == 0) {
 		regVal = steLibDiBitIob1Pg();
-	} else if (strcmp(g_szArgs[0], "IOB2") == 0) {
+	} else if (strcmp(ARG_STR(0), "IOB2") == 0) {
 		regVal = steLibDiBitIob2Pg();
-	} else if (strcmp(g_szArgs[0], "PCB1") == 0) {
+	} else if (strcmp(ARG_STR(0), "PCB1") == 0) {
 		regVal = steLibDiBitPcb1Pg();
-	} else if (strcmp(g_szArgs[0], "PCB2") == 0) {
+	} else if (strcmp(ARG_STR(0), "PCB2") == 0) {
 		regVal = steLibDiBitPcb2Pg();
-	} else if (strcmp(g_szArgs[0], "ESB") == 0) {
+	} else if (strcmp(ARG_STR(0), "ESB") == 0) {
 		regVal = steLibDiBitEsuPg();
-	} else if (strcmp(g_szArgs[0], "MCB") == 0) {
+	} else if (strcmp(ARG_STR(0), "MCB") == 0) {
 		regVal = 1;
 	} else {
-		REPORT_ERROR("Invalid Argument. [#%d(%s)]\n", 0, g_szArgs[0]);
+		REPORT_ERROR("Invalid Argument. [#%d(%s)]\n", 0, ARG_STR(0));
 		return ERROR;
 	}
 	
 	eResult = mtsCheckEqual(0x1, regVal);
-	UdpSendOpsTxResult(eResult, "0x%X", regVal);
+	CmdExecTxResult(eResult, "0x%X", regVal);
 	
 	return OK;
 }
 
-STATUS mtsChkGf7(void) {
+STATUS mtsChkGf7(const CmdArgs *pArgs) {
+	GcuUnit *pUnit = GcuUnitGet(pArgs->unit);
 	OPS_TYPE_RESULT_TYPE eResult = RESULT_TYPE_FAIL;
+	char szResultValue[80];
 	int refVal, nValue;
 	double dValue;
 	
-	if (strcmp(g_szArgs[0], "NAV_STS") == 0) {
-		TRY_STR_TO_LONG(refVal, 1, int);
-		nValue = g_pTmGf7->m_NAV_STS;
+	if (strcmp(ARG_STR(0), "NAV_STS") == 0) {
+		TRY_ARG_TO_LONG(refVal, 1, int);
+		nValue = GCU_GF(pUnit, 7)->m_NAV_STS;
 		
 		SET_RESULT_VALUE("0x%04X", nValue);
-		eResult = mtsCheckEqual(refVal, nValue & g_dwArgMask);
-	} else if (strcmp(g_szArgs[0], "ALIGN_STS") == 0) {
-		TRY_STR_TO_LONG(refVal, 1, int);
-		nValue = g_pTmGf7->m_ALIGN_STS;
+		eResult = mtsCheckEqual(refVal, nValue & pArgs->mask);
+	} else if (strcmp(ARG_STR(0), "ALIGN_STS") == 0) {
+		TRY_ARG_TO_LONG(refVal, 1, int);
+		nValue = GCU_GF(pUnit, 7)->m_ALIGN_STS;
 		
 		SET_RESULT_VALUE("0x%04X", nValue);
-		eResult = mtsCheckEqual(refVal, nValue & g_dwArgMask);
-	} else if (strcmp(g_szArgs[0], "AQQC1") == 0_ {
-		dValue = (double)(g_pTmGf7->m_AQQC1 * 0.0000000005);
+		eResult = mtsCheckEqual(refVal, nValue & pArgs->mask);
+	} else if (strcmp(ARG_STR(0), "AQQC1") == 0_ {
+		dValue = (double)(GCU_GF(pUnit, 7)->m_AQQC1 * 0.0000000005);
 		
 		SET_RESULT_VALUE("%0.10f", dValue);
 		eResult = RESULT_TYPE_PASS;
-	} else if (strcmp(g_szArgs[0], "AQQC2") == 0_ {
-		dValue = (double)(g_pTmGf7->m_AQQC * 0.0000000005);
+	} else if (strcmp(ARG_STR(0), "AQQC2") == 0_ {
+		dValue = (double)(GCU_GF(pUnit, 7)->m_AQQC * 0.0000000005);
 		
 		SET_RESULT_VALUE("%0.10f", dValue);
 		eResult = RESULT_TYPE_PASS;
-	} else if (strcmp(g_szArgs[0], "AQQC3") == 0_ {
-		dValue = (double)(g_pTmGf7->m_AQQC3 * 0.0000000005);
+	} else if (strcmp(ARG_STR(0), "AQQC3") == 0_ {
+		dValue = (double)(GCU_GF(pUnit, 7)->m_AQQC3 * 0.0000000005);
 		
 		SET_RESULT_VALUE("%0.10f", dValue);
 		eResult = RESULT_TYPE_PASS;
-	} else if (strcmp(g_szArgs[0], "AQQC4") == 0_ {
-		dValue = (double)(g_pTmGf7->m_AQQC4 * 0.0000000005);
+	} else if (strcmp(ARG_STR(0), "AQQC4") == 0_ {
+		dValue = (double)(GCU_GF(pUnit, 7)->m_AQQC4 * 0.0000000005);
 		
 		SET_RESULT_VALUE("%0.10f", dValue);
 		eResult = RESULT_TYPE_PASS;
 	} else {
-		REPORT_ERROR("Invalid Argument. [#%d(%s)]\n", 0, g_szArgs[0]);
+		REPORT_ERROR("Invalid Argument. [#%d(%s)]\n", 0, ARG_STR(0));
 		return ERROR;
 	}
 	
-	UdpSendOpsTxResult(eResult, g_szResultValue);
+	CmdExecTxResult(eResult, "%s", szResultValue);
 	
 	return OK;
 }
 
-STATUS mtsGcuLoad(void) {
-	FILE *fpFile;
-	char *pBuffer;
-	int nReadBytes;
+/*
+ * mtsChkTmMulti <GFn> <field> <limits> [<field> <limits> ...]
+ *
+ * A RANGE field takes min and max, an EQUAL field a reference value (or
+ * PASS to only report it) and a report-only field nothing. All checks
+ * are evaluated on one copy of the frame, and the values and results are
+ * returned as a TmFieldResult vector in argument order.
+ */
+STATUS mtsChkTmMulti(const CmdArgs *pArgs) {
+	GcuUnit *pUnit = GcuUnitGet(pArgs->unit);
+	TM_TYPE_SDLC_RX stFrame;
+	CHK_TM_ITEM chk[CHK_TM_MULTI_MAX];
+	TmFieldResult result[CHK_TM_MULTI_MAX];
+	const TmField *pField;
+	TmWaitSrc src;
+	OPS_TYPE_RESULT_TYPE eResult = RESULT_TYPE_PASS;
+	int numChk = 0;
+	int argIdx = 1;
+	int i;
 	
-	g_nGcuImgTotalBytes = 0;
-	memset((void *)g_pGcuImgBuf, 0, sizeof(g_pGcuImgBuf));
+	if (TmFieldSrcFind(ARG_STR(0), &src) == ERROR) {
+		REPORT_ERROR("Invalid Argument. [#%d(%s)]\n", 0, ARG_STR(0));
+		return ERROR;
+	}
 	
-	printf("\n fopen %s . . . ", GCU_IMG_FILE);
-	if ((fpFile = fopen(GCU_IMG_FILE, "rb")) == NULL) {
-		printf("ERROR.\n");
-		
-		REPORT_ERROR("GCU File Open Error.\n");
+	while (argIdx < pArgs->num) {
+		if (ARG_STR(argIdx)[0] == '@') {
+			if (TmFieldParseRaw(src, ARG_STR(argIdx), &chk[numChk].field) == ERROR) {
+				REPORT_ERROR("Invalid Argument. [#%d(%s)]\n", argIdx, ARG_STR(argIdx));
+				return ERROR;
+			}
+		} else {
+			if ((pField = TmFieldFind(src, ARG_STR(argIdx))) == NULL) {
+				REPORT_ERROR("Invalid Argument. [#%d(%s)]\n", argIdx, ARG_STR(argIdx));
+				return ERROR;
+			}
+			chk[numChk].field = *pField;
+		}
+		argIdx++;
+		
+		chk[numChk].isReportOnly = FALSE;
+		switch (chk[numChk].field.chk) {
+		case TM_FIELD_CHK_RANGE:
+			if (argIdx + 2 > pArgs->num) {
+				REPORT_ERROR("Invalid Argument. [#%d(%s)] No min and max.\n",
+							 argIdx - 1, ARG_STR(argIdx - 1));
+				return ERROR;
+			}
+			TRY_ARG_TO_DOUBLE(chk[numChk].refMin, argIdx);
+			TRY_ARG_TO_DOUBLE(chk[numChk].refMax, argIdx + 1);
+			argIdx += 2;
+			break;
+		case TM_FIELD_CHK_EQUAL:
+			if (argIdx + 1 > pArgs->num) {
+				REPORT_ERROR("Invalid Argument. [#%d(%s)] No reference value.\n",
+							 argIdx - 1, ARG_STR(argIdx - 1));
+				return ERROR;
+			}
+			if (strcmp(ARG_STR(argIdx), "PASS") == 0) {
+				chk[numChk].isReportOnly = TRUE;
+			} else {
+				TRY_ARG_TO_LONG(chk[numChk].refVal, argIdx, long);
+			}
+			argIdx++;
+			break;
+		default:
+			chk[numChk].isReportOnly = TRUE;
+			break;
+		}
+		numChk++;
+	}
+	
+	if (numChk == 0) {
+		REPORT_ERROR("No field to check.\n");
 		return ERROR;
 	}
-	printf("OK.");
 	
-	printf("\n read %s ", GCU_IMG_FILE);
-	pBuffer = (char *)g_pGcuImgBuf;
-	FOREVER {
-		nReadBytes = fread((void *)pBuffer, 1, DATA_BLOCK_SIZE, fPFile);
-		g_nGcuImgTotalBytes += nReadBytes;
-		pBugger += DATA_BLOCK_SIZE;
+	if (TmFieldSnapshot(GCU_SRC(pUnit, src), &stFrame, sizeof(stFrame)) == ERROR) {
+		REPORT_ERROR("%s : No snapshot.\n", ARG_STR(0));
+		return ERROR;
+	}
+	
+	for (i = 0; i < numChk; i++) {
+		pField = &chk[i].field;
+		result[i].dValue = TmFieldGet(pField, &stFrame);
+		result[i].reserved = 0;
 		
-		printf(". ");
+		if (chk[i].isReportOnly) {
+			result[i].eResult = RESULT_TYPE_PASS;
+		} else if (pField->chk == TM_FIELD_CHK_RANGE) {
+			result[i].eResult = mtsCheckRange(chk[i].refMin, chk[i].refMax, result[i].dValue);
+		} else {
+			result[i].eResult = mtsCheckEqual((int)chk[i].refVal,
+											  (int)(TmFieldGetBits(pField, &stFrame) & pArgs->mask));
+		}
 		
-		if (nReadBytes < DATA_BLOCK_SIZE) {
-			LOGMSG(" %d Bytes Read.\n", g_nGcuImgTotalBytes);
-			break;
+		if (result[i].eResult != RESULT_TYPE_PASS)
+			eResult = RESULT_TYPE_FAIL;
+	}
+	
+	CmdExecTxResultTx(eResult, result, numChk * sizeof(TmFieldResult), "OK");
+	
+	return OK;
+}
+
+/*
+ * mtsLimitAdd <GFn> <field> <min> <max>  (RANGE field)
+ * mtsLimitAdd <GFn> <field> <ref>        (EQUAL field, with the mask)
+ *
+ * tSdlcRecvGcu checks the limit on every frame of GFn from the GCU unit
+ * of the command ("mtsLimitAdd@1") from now on and
+ * logs each transition; the result value is the limit ID.
+ */
+STATUS mtsLimitAdd(const CmdArgs *pArgs) {
+	GcuUnit *pUnit = GcuUnitGet(pArgs->unit);
+	TmField stField;
+	const TmField *pField;
+	TmWaitSrc src;
+	long refVal;
+	double refMin, refMax;
+	int id;
+	
+	if (TmFieldSrcFind(ARG_STR(0), &src) == ERROR) {
+		REPORT_ERROR("Invalid Argument. [#%d(%s)]\n", 0, ARG_STR(0));
+		return ERROR;
+	}
+	
+	if (ARG_STR(1)[0] == '@') {
+		if (TmFieldParseRaw(src, ARG_STR(1), &stField) == ERROR) {
+			REPORT_ERROR("Invalid Argument. [#%d(%s)]\n", 1, ARG_STR(1));
+			return ERROR;
 		}
+	} else if ((pField = TmFieldFind(src, ARG_STR(1))) == NULL) {
+		REPORT_ERROR("Invalid Argument. [#%d(%s)]\n", 1, ARG_STR(1));
+		return ERROR;
+	} else {
+		stField = *pField;
+	}
+	
+	/* The limit watches the frames of this unit only. */
+	stField.src = GCU_SRC(pUnit, src);
+	pField = &stField;
+	
+	if (pField->chk == TM_FIELD_CHK_RANGE) {
+		TRY_ARG_TO_DOUBLE(refMin, 2);
+		TRY_ARG_TO_DOUBLE(refMax, 3);
+	} else if (pField->chk == TM_FIELD_CHK_EQUAL) {
+		TRY_ARG_TO_LONG(refVal, 2, long);
+		refMin = refMax = (double)refVal;
+	} else {
+		REPORT_ERROR("%s : Report only field.\n", ARG_STR(1));
+		return ERROR;
+	}
+	
+	if ((id = TmLimitAdd(pField, refMin, refMax, pArgs->mask)) == ERROR) {
+		REPORT_ERROR("Limit table is full.\n");
+		return ERROR;
 	}
 	
-	printf("\n fclose %s . . .", GCU_IMG_FILE);
-	if (fclose(fpFile) == EOF) {
-		printf("ERROR.\n");
+	CmdExecTxResult(RESULT_TYPE_PASS, "%d", id);
+	
+	return OK;
+}
+
+/*
+ * mtsLimitClear [<GFn> | <ID>] : without an argument every limit of every
+ * unit is removed, with GFn only those on GFn of the command's unit.
+ */
+STATUS mtsLimitClear(const CmdArgs *pArgs) {
+	GcuUnit *pUnit = GcuUnitGet(pArgs->unit);
+	TmWaitSrc src;
+	
+	if (pArgs->num == 0) {
+		TmLimitClear(TM_WAIT_SRC_MAX);
+	} else if (pArgs->arg[0].isLong) {
+		if (TmLimitRemove((int)pArgs->arg[0].lVal) == ERROR) {
+			REPORT_ERROR("Invalid Argument. [#%d(%s)]\n", 0, ARG_STR(0));
+			return ERROR;
+		}
+	} else if (TmFieldSrcFind(ARG_STR(0), &src) == OK) {
+		TmLimitClear(GCU_SRC(pUnit, src));
+	} else {
+		REPORT_ERROR("Invalid Argument. [#%d(%s)]\n", 0, ARG_STR(0));
+		return ERROR;
+	}
+	
+	CmdExecTxResult(RESULT_TYPE_PASS, "OK");
+	
+	return OK;
+}
+
+/* Fails while any limit is failing; the value is a TmLimitStatus vector. */
+STATUS mtsLimitShow(const CmdArgs *pArgs) {
+	TmLimitStatus status[TM_LIMIT_MAX];
+	OPS_TYPE_RESULT_TYPE eResult = RESULT_TYPE_PASS;
+	int num, i;
+	
+	num = TmLimitStatusGet(status, TM_LIMIT_MAX);
+	for (i = 0; i < num; i++) {
+		if (status[i].isFailing)
+			eResult = RESULT_TYPE_FAIL;
+	}
+	
+	CmdExecTxResultTx(eResult, status, num * sizeof(TmLimitStatus), "OK");
+	
+	return OK;
+}
+
+/*
+ * mtsLinkStats [RESET] : the value is a LinkStatsSummary vector, one
+ * element per GCU unit, so one request polls every link. With RESET the
+ * statistics are cleared once reported.
+ */
+STATUS mtsLinkStats(const CmdArgs *pArgs) {
+	LinkStatsSummary summary[GCU_UNIT_NUM];
+	int num = 0;
+	int unit;
+	
+	if ((pArgs->num > 0) && (strcmp(ARG_STR(0), "RESET") != 0)) {
+		REPORT_ERROR("Invalid Argument. [#%d(%s)]\n", 0, ARG_STR(0));
+		return ERROR;
+	}
+	
+	for (unit = 0; unit < GCU_UNIT_NUM; unit++) {
+		if (LinkStatsGet(unit, &summary[num].link, summary[num].rx,
+						 TM_WAIT_SRC_TYPES) == ERROR)
+			continue;
 		
-		REPORT_ERROR("GCU File Close Error.\n");
-		return ERROR:
+		if (pArgs->num > 0)
+			LinkStatsReset(unit);
+		num++;
 	}
 	
-	printf("OK.");
+	CmdExecTxResultTx(RESULT_TYPE_PASS, summary, num * sizeof(LinkStatsSummary), "OK");
 	
-	if (g_nGcuImgTotalBytes > GCU_IMG_BUFF_LENGTH) {
+	return OK;
+}
+
+/*
+ * Reads szFile through ImgStream, as an upload streams it, for its size
+ * and digests.
+ */
+LOCAL STATUS digestGcuImage(const char *szFile, int *pTotalBytes, IsCksum *pCksum) {
+	ImgStream stream;
+	const void *pChunk;
+	int nReadBytes;
+	
+	printf("\n read %s ", szFile);
+	if (ImgStreamOpen(&stream, szFile) == ERROR) {
+		REPORT_ERROR("GCU File Open Error.\n");
+		return ERROR;
+	}
+	
+	do {
+		if (ImgStreamNext(&stream, &pChunk, &nReadBytes) == ERROR) {
+			ImgStreamClose(&stream);
+			REPORT_ERROR("GCU File Read Error.\n");
+			return ERROR;
+		}
+		ImgStreamRelease(&stream);
+		
+		printf(". ");
+	} while (nReadBytes == IMG_STREAM_CHUNK_BYTES);
+	
+	ImgStreamClose(&stream);
+	
+	LOGMSG(" %d Bytes Read.\n", stream.totalBytes);
+	
+	*pTotalBytes = stream.totalBytes;
+	*pCksum = stream.cksum;
+	
+	return OK;
+}
+
+/*
+ * Only the size and digests are kept; mtsGcuProgramStart streams the
+ * file again while it uploads.
+ */
+STATUS mtsGcuLoad(const CmdArgs *pArgs) {
+	GCU_IMG_STATE *pImg = &g_stGcuImg[pArgs->unit];
+	char szFile[ASSET_CACHE_PATH_LEN];
+	int totalBytes;
+	IsCksum cksum;
+	STATUS nRet;
+	
+	pImg->totalBytes = 0;
+	memset(&pImg->cksum, 0, sizeof(pImg->cksum));
+	
+	AssetCacheResolveVerified(GCU_IMG_FILE, szFile, sizeof(szFile));
+	nRet = digestGcuImage(szFile, &totalBytes, &cksum);
+	AssetCacheRelease(szFile);
+	
+	if (nRet == ERROR)
+		return ERROR;
+	
+	if (totalBytes > GCU_IMG_MAX_LENGTH) {
 		REPORT_ERROR("GCU File size is too big.\n");
 		return ERROR;
 	}
 	
-	UdpSendOpsTxResult(RESULT_TYPE_PASS, "OK");
+	pImg->totalBytes = totalBytes;
+	pImg->cksum = cksum;
+	
+	LOGMSG("GCU image : sum 0x%08X, CRC-32 0x%08X\n", pImg->cksum.sum, pImg->cksum.crc32);
+	
+	CmdExecTxResult(RESULT_TYPE_PASS, "OK");
 	
 	return OK;
 }
 
-STATUS mtsGcuProgramMode(void) {
+/*
+ * Checks that szFile is still the image mtsGcuLoad read; once it is not,
+ * no upload of that image can be resumed.
+ */
+LOCAL STATUS chkGcuImage(const char *szFile, GCU_IMG_STATE *pImg) {
+	int totalBytes;
+	IsCksum cksum;
+	
+	if (digestGcuImage(szFile, &totalBytes, &cksum) == ERROR)
+		return ERROR;
+	
+	if ((totalBytes != pImg->totalBytes) || (cksum.crc32 != pImg->cksum.crc32)) {
+		pImg->resume.imageCrc = 0;
+		REPORT_ERROR("GCU File changed after mtsGcuLoad.\n");
+		return ERROR;
+	}
+	
+	return OK;
+}
+
+STATUS mtsGcuProgramMode(const CmdArgs *pArgs) {
+	GcuUnit *pUnit = GcuUnitGet(pArgs->unit);
 	OPS_TYPE_RESULT_TYPE eResult;
 	CODE usGcuResp, usGcuMode;
 	
-	memset((void *)(g_pTmFg2), 0, sizeof(TM_TYPE_FG2));
+	memset((void *)(pUnit->pTmFg2), 0, sizeof(TM_TYPE_FG2));
 	
-	g_pTmFg2->fg2_1.m_ADDRESS = TM_SDLC_ADDRESS;
-	g_pTmFg2->fg2_1.m_CONTROL = TM_FG2_SDLC_CONTROL;
-	g_pTmFg2->fg2_1.m_OPCODE = TM_FG2_1_OPCODE_MODE_GCU_PROGRAM;
+	pUnit->pTmFg2->fg2_1.m_ADDRESS = TM_SDLC_ADDRESS;
+	pUnit->pTmFg2->fg2_1.m_CONTROL = TM_FG2_SDLC_CONTROL;
+	pUnit->pTmFg2->fg2_1.m_OPCODE = TM_FG2_1_OPCODE_MODE_GCU_PROGRAM;
 	
-	if (PostCmd(g_hSdlcSendGcu, SDLC_SEND_GCU_TX_FG2) == ERROR) {
+	if (postGcuCmd(pUnit, SDLC_SEND_GCU_TX_FG2, TM_FG2_1_OPCODE_MODE_GCU_PROGRAM) == ERROR) {
 		REPORT_ERROR("PostCmd(SDLC_SEND_GCU_TX_FG2)\n");
 		return ERROR;
 	}
 	
-	WAIT_RESPONSE(GCU_RESPONSE_TIME, 1, TM_FG2_1_OPCODE_MODE_GCU_PROGRAM, g_pTmGf2->m_GCU_RESP, usGcuResp, eResult);
+	WAIT_RESPONSE(TM_WAIT_SRC_GF2, GCU_RESPONSE_TIME, TM_FG2_1_OPCODE_MODE_GCU_PROGRAM, GCU_GF(pUnit, 2)->m_GCU_RESP, usGcuResp, eResult);
 	
 	if (eResult == RESULT_TYPE_FAIL) {
 		REPORT_ERROR("GCU : No Response.\n");
 		return ERROR;
 	}
 	
-	usGcuMode = g_pTMGf2->m_GCU_MODE;
+	usGcuMode = GCU_GF(pUnit, 2)->m_GCU_MODE;
 	eResult = mtsCheckEqual(0x5000, usGcuMode & 0xF000);
 	
-	UdpSendOpsTxResult(eResult, "0x%04X", usGcuMode);
+	CmdExecTxResult(eResult, "0x%04X", usGcuMode);
 	
 	return OK;
 }
 
-STATUS mtsGcuProgramStart(void) {
-	int i, k;
-	int *ptr_int;
+/*
+ * Streams the GCU image loaded for unit from pStream, sending only the
+ * blocks its resume map still lacks, and reports the result. Closes pStream.
+ */
+LOCAL STATUS uploadGcuImage(ImgStream *pStream, int window, int unit) {
+	GCU_IMG_STATE *pImg = &g_stGcuImg[unit];
+	const void *pChunk;
+	int nChunkBytes;
+	BulkXferCfg cfg;
+	BulkXferResult result;
+	int blkBase = 0, numSent = 0, numRetx = 0;
+	UINT64 tStart;
+	UINT32 elapsedUs;
+	STATUS nRet = OK;
+	OPS_TYPE_RESULT_TYPE eResult;
+	int progressPrev = 0;
 	
-	int block_num;
-	int block_rem;
-	int content_num;
+	tStart = isClockNs();
+	do {
+		if (ImgStreamNext(pStream, &pChunk, &nChunkBytes) == ERROR) {
+			nRet = ERROR;
+			break;
+		}
+		
+		if (nChunkBytes > 0) {
+			BulkXferCfgInit(&cfg, "GCU", pChunk, nChunkBytes, TM_FG3_3_OPCODE_SW_TX);
+			cfg.unit = unit;
+			cfg.window = window;
+			cfg.firstBlock = blkBase;
+			cfg.totalBlocks = pImg->resume.numBlocks;
+			cfg.pfnProgress = reportXferProgress;
+			cfg.progressArg = &progressPrev;
+			cfg.pfnCancelled = CmdExecIsCancelled;
+			cfg.pResume = &pImg->resume;
+			
+			nRet = BulkXferRun(&cfg, &result);
+			numSent += result.numSent;
+			numRetx += result.numRetx;
+		}
+		
+		ImgStreamRelease(pStream);
+		blkBase += IMG_STREAM_CHUNK_BLOCKS;
+	} while ((nRet == OK) && (nChunkBytes == IMG_STREAM_CHUNK_BYTES));
+	elapsedUs = isClockNsToUs(isClockNs() - tStart);
 	
-	short *imageshort;
-	CODE usGcuResp;
-	OPS_TYPE_RESULT_TYPE eResult;
-	int progressPrev = 0, progressCurr = 0;
+	ImgStreamClose(pStream);
 	
-	memset((void *)(g_pTmFg3), 0, sizeof(TM_TYPE_FG3));
+	LOGMSG("GCU Program : %d/%d blocks, %d sent, %d retx, %u us (file wait %u us)\n",
+		   pImg->resume.numDone, pImg->resume.numBlocks, numSent, numRetx,
+		   elapsedUs, pStream->stallUs);
 	
-	g_pTmFg3->fg3_3.m_ADDRESS = TM_SDLC_ADDRESS;
-	g_pTmFg3->fg3_3.m_CONTROL= TM_FG3_SDLC_CONTROL;
-	g_pTmFg3->fg3_3.m_OPCODE = TM_FG3_3_OPCODE_SW_TX;
-	g_pTMFg3->fg3_3.m_IDX = 0;
+	RETURN_IF_CANCELLED();
 	
-	ptr_int = (int *)(&g_pTmFg3->fg3_3.m_DATA[0]);
-	*ptr_int++ = g_nGcuImgTotalBytes;
-	*ptr_int = mtsMakeChecksum(g_pGcuImgBuf, g_nGcuImgTotalBytes);
+	/* The header already went out with the size and checksum from mtsGcuLoad. */
+	if ((nRet == OK) && ((pStream->totalBytes != pImg->totalBytes) ||
+						 (pStream->cksum.crc32 != pImg->cksum.crc32))) {
+		pImg->resume.imageCrc = 0;
+		REPORT_ERROR("GCU File changed after mtsGcuLoad.\n");
+		return ERROR;
+	}
 	
-	if (PostCmd(g_hSdlcSendGcu, SDLC_SEND_GCU_TX_FG33) == ERROR) {
+	if (pImg->resume.numDone < pImg->resume.numBlocks) {
+		LOGMSG("GCU Program : resume from IDX(%d) with mtsGcuProgramResume.\n",
+			   BulkXferResumeFirst(&pImg->resume) + 1);
+	}
+	
+	eResult = mtsCheckEqual(pImg->resume.numBlocks, pImg->resume.numDone);
+	CmdExecTxResult(eResult, "%d", mtsCalProgress(pImg->resume.numDone, pImg->resume.numBlocks));
+	
+	return OK;
+}
+
+/*
+ * Sends the FG3-3 header prepared in pUnit->pTmFg3 and waits for the GCU
+ * to accept it. Kept apart so a cancelled wait returns here and the
+ * caller still closes its stream.
+ */
+LOCAL STATUS startGcuProgram(GcuUnit *pUnit) {
+	CODE usGcuResp;
+	OPS_TYPE_RESULT_TYPE eResult;
+	
+	if (postGcuCmd(pUnit, SDLC_SEND_GCU_TX_FG33, TM_FG3_3_OPCODE_SW_TX) == ERROR) {
 		REPORT_ERROR("PostCmd(SDLC_SEND_GCU_TX_FG33)\n");
 		return ERROR;
 	}
 	
-	WAIT_RESPONSE(GCU_RESPONSE_TIME, 1, TM_FG3_3_OPCODE_SW_TX, g_pTmGf3->gf3_3.m_GCU_RESP, usGcuResp, eResult);
+	WAIT_RESPONSE(TM_WAIT_SRC_GF3, GCU_RESPONSE_TIME, TM_FG3_3_OPCODE_SW_TX, GCU_GF(pUnit, 3)->gf3_3.m_GCU_RESP, usGcuResp, eResult);
 	
 	if (eResult == RESULT_TYPE_FAIL) {
 		REPORT_ERROR("GCU : No Response.\n");
 		return ERROR;
 	}
 	
+	return OK;
+}
+
+/*
+ * Optional argument: number of FG3-3 blocks in flight
+ * (BULK_XFER_DEF_WINDOW when omitted, 1 for the old stop-and-wait).
+ *
+ * The image is read from GCU_IMG_FILE (or its cached copy) chunk by
+ * chunk; the next chunk is read while the current one is on the link.
+ * The file is first checked against mtsGcuLoad, whose size and sum go
+ * out in the header.
+ */
+STATUS mtsGcuProgramStart(const CmdArgs *pArgs) {
+	GcuUnit *pUnit = GcuUnitGet(pArgs->unit);
+	GCU_IMG_STATE *pImg = &g_stGcuImg[pArgs->unit];
+	int *ptr_int;
+	
+	char szFile[ASSET_CACHE_PATH_LEN];
+	ImgStream stream;
+	int window = BULK_XFER_DEF_WINDOW;
+	STATUS nRet;
+	
+	if (pImg->totalBytes == 0) {
+		REPORT_ERROR("GCU image is not loaded.\n");
+		return ERROR;
+	}
+	
+	if (pArgs->num > 0) {
+		TRY_ARG_TO_LONG(window, 0, int);
+	}
+	
+	memset((void *)(pUnit->pTmFg3), 0, sizeof(TM_TYPE_FG3));
+	
+	pUnit->pTmFg3->fg3_3.m_ADDRESS = TM_SDLC_ADDRESS;
+	pUnit->pTmFg3->fg3_3.m_CONTROL= TM_FG3_SDLC_CONTROL;
+	pUnit->pTmFg3->fg3_3.m_OPCODE = TM_FG3_3_OPCODE_SW_TX;
+	pUnit->pTmFg3->fg3_3.m_IDX = 0;
+	
+	ptr_int = (int *)(&pUnit->pTmFg3->fg3_3.m_DATA[0]);
+	*ptr_int++ = pImg->totalBytes;
+	*ptr_int = (int)pImg->cksum.sum;
+	
+	AssetCacheResolveVerified(GCU_IMG_FILE, szFile, sizeof(szFile));
+	
+	if (chkGcuImage(szFile, pImg) == ERROR) {
+		AssetCacheRelease(szFile);
+		return ERROR;
+	}
+	
+	if (ImgStreamOpen(&stream, szFile) == ERROR) {
+		AssetCacheRelease(szFile);
+		REPORT_ERROR("GCU File Open Error.\n");
+		return ERROR;
+	}
+	
+	if (startGcuProgram(pUnit) == ERROR) {
+		ImgStreamClose(&stream);
+		AssetCacheRelease(szFile);
+		return ERROR;
+	}
+	
 	LOGMSG("GCU Program Start...\n");
 	
-	block_num = (g_nGcuImgTotalBytes / 2) / 125;
-	block_rem = (g_nGcuImgTotalBytes / 2) % 125;
+	BulkXferResumeReset(&pImg->resume, pImg->cksum.crc32,
+						((pImg->totalBytes / 2) + BULK_XFER_WORDS_PER_BLOCK - 1) /
+						BULK_XFER_WORDS_PER_BLOCK);
+	
+	nRet = uploadGcuImage(&stream, window, pArgs->unit);
+	AssetCacheRelease(szFile);
+	
+	return nRet;
+}
+
+/*
+ * Continues an interrupted mtsGcuProgramStart of the same image on the
+ * same GCU unit from its first unacknowledged block, without resending
+ * the header. The file is checked against mtsGcuLoad before any block
+ * is sent, so a changed image is not mixed into the blocks already on
+ * the GCU.
+ * Optional argument: window, as for mtsGcuProgramStart.
+ */
+STATUS mtsGcuProgramResume(const CmdArgs *pArgs) {
+	GCU_IMG_STATE *pImg = &g_stGcuImg[pArgs->unit];
+	char szFile[ASSET_CACHE_PATH_LEN];
+	ImgStream stream;
+	int window = BULK_XFER_DEF_WINDOW;
+	STATUS nRet;
+	
+	if ((pImg->totalBytes == 0) || (pImg->resume.numBlocks == 0) ||
+		(pImg->resume.imageCrc != pImg->cksum.crc32)) {
+		REPORT_ERROR("No GCU Program to resume.\n");
+		return ERROR;
+	}
 	
-	if (block_rem != 0) {
-		block_num += 1;
+	if (pArgs->num > 0) {
+		TRY_ARG_TO_LONG(window, 0, int);
 	}
 	
-	imageshort = (short *)g_pGcuImgBuf;
+	AssetCacheResolveVerified(GCU_IMG_FILE, szFile, sizeof(szFile));
 	
-	memset((void *)(g_pTmFg3), 0, sizeof(TM_TYPE_FG3));
+	if (chkGcuImage(szFile, pImg) == ERROR) {
+		AssetCacheRelease(szFile);
+		return ERROR;
+	}
 	
-	for (i = 0; i < block_num; i++) {
-		if ((block_rem != 0) && (i == (block_num -1))) {
-			content_num = block_rem;
-		} else {
-			content_num = 125;
-		}
-		
-		g_pTmFg3->fg3_3.m_ADDRESS = TM_SDLC_ADDRESS;
-		g_pTmFg3->fg3_3.m_CONTROL = TM_FG3_SDLC_CONTROL;
-		g_pTmFg3->fg3_3.m_OPCODE = TM_FG3_3_OPCODE_SW_TX;
-		g_pTmFg3->fg3_3.m_IDX = (INT16)(i + 1);
-		
-		for (k = 0; k < content_num; k++) {
-			g_pTmFg3->fg3_3.m_DATA[k] = imageshort[k + 125 * i];
-		}
-		
-		if (PostCmd(g_hSdlcSendGcu, SDLC_SEND_GCU_TX_FG33) == ERROR) {
-			REPORT_ERROR("PostCmd(SDLC_SEND_GCU_TX_FG33, IDX = %d)\n", g_pTmFg3->fg3_3.m_IDX);
-			return ERROR;
-		}
-		
-		for (k = 0; k < 1000; k++) {
-			if (g_pTmFg3->fg3_3.m_IDX == g_pTmGf3->gf3_3.m_IDX) {
-				break;
-			}
-			
-			DELAY_MS(1);
-		}
-		
-		if (g_pTmFg3->fg3_3.m_IDX != g_pTmGf3->gf3_3.m_IDX) {
-			LOGMSG("IDX(%d) Data No Ack.\n", g_pTmFg3->fg3_3.m_IDX);
-			break;
-		}
-		
-		progressCurr = mtsCalProgress(i, block_num);
-		if (progressCurr != progressPrev) {
-			UdpSendOpsTxResult(RESULT_TYPE_ONGOING, "%d", progressCurr);
-			progressPrev = progressCurr;
-		}
+	if (ImgStreamOpen(&stream, szFile) == ERROR) {
+		AssetCacheRelease(szFile);
+		REPORT_ERROR("GCU File Open Error.\n");
+		return ERROR;
 	}
 	
-	eResult = mtsCheckEqual(block_num, i);
-	UdpSendOpsTxResult(eResult, "%d", mtsCalProgress(i, block_num));
+	LOGMSG("GCU Program Resume from IDX(%d)...\n", BulkXferResumeFirst(&pImg->resume) + 1);
 	
-	return OK;
+	nRet = uploadGcuImage(&stream, window, pArgs->unit);
+	AssetCacheRelease(szFile);
+	
+	return nRet;
 }
 
-STATUS mtsGcuProgramEnd(void) {
+STATUS mtsGcuProgramEnd(const CmdArgs *pArgs) {
+	GcuUnit *pUnit = GcuUnitGet(pArgs->unit);
 	int i;
 	int *ptr_int;
 	CODE usGcuResp;
 	
-	memset((void *)(g_pTmFg3), 0, sizeof(TM_TYPE_FG3));
+	memset((void *)(pUnit->pTmFg3), 0, sizeof(TM_TYPE_FG3));
 	
-	g_pTmFg3->fg3_3.m_ADDRESS = TM_SDLC_ADDRESS;
-	g_pTmFg3->fg3_3.m_CONTROL = TM_FG3_SDLC_CONTROL;
\ No newline at end of file
+	pUnit->pTmFg3->fg3_3.m_ADDRESS = TM_SDLC_ADDRESS;
+	pUnit->pTmFg3->fg3_3.m_CONTROL = TM_FG3_SDLC_CONTROL;
\ No newline at end of file
@@ -2,94 +2,107 @@
 
 #include <vxworks.h>
 
-IMPORT STATUS mtsTestFunc(void);
-IMPROT STATUS invokeMethod_uint(void);
-IMPORT STATUS invokeMethod_uint_double(void);
-IMPORT STATUS checkResult_equal(void);
-IMPORT STATUS mtsCommTestTxReq(void);
-IMPORT STATUS mtsCommTest(void);
-IMPORT STATUS mtsReset(void);
-IMPORT STATUS mtsUpdate(void);
-IMPORT STATUS mtsPowerExtOn(void);
-IMPORT STATUS mtsPowerExtOff(void);
-IMPORT STATUS mtsPowerExtGd(void);
-IMPORT STATUS mtsPowerMeasureVolt(void);
-IMPORT STATUS mtsPowerMeasureCurrent(void);
-IMPORT STATUS mtsInitActPwrSuplOut(void);
-IMPORT STATUS mtsGetActPwrSuplOut(void);
-IMPORT STATUS mtsSetActPwrSuplOut(void);
-IMPORT STATUS mtsSetActPwrSuplOutBit(void);
-IMPORT STATUS mtsChkGf2(void);
-IMPORT STATUS mtsGcuMslStsChk(void);
-IMPORT STATUS mtsSwVerChek(void);
-IMPORT STATUS mtsGcuFireModeStart(void);
-IMPORT STATUS mtsNavCal(void);
-IMPORT STATUS mtsNavDataInput(void);
-IMPORT STATUS mtsSaveAlignData(void);
-IMPORT STATUS mtsChkGf3NavData(void);
-IMPORT STATUS mtsGcaStart(void);
-IMPORT STATUS mtsShaStart(void);
-IMPORT STATUS mtsGcaDone(void);
-IMPORT STATUS mtsGcuMslGpsModeSet(void);
-IMPORT STATUS mtsMslGpsTrkStart(void);
-IMPORT STATUS mtsActMotorOn(void);
-IMPORT STATUS mtsAcuCtrlCommandSetErrorDeg(void);
-IMPORT STATUS mtsAcuSlewStart(void);
-IMPORT STATUS mtsAcuSlewEnd(void);
-IMPORT STATUS mtsAcuWingCommandSetErrorDeg(void);
-IMPORT STATUS mtsArm1OnOff(void);
-IMPORT STATUS mtsBit(void);
-IMPORT STATUS steBit(void);
-IMPORT STATUS mtsChkGf7(void);
-IMPORT STATUS mtsGcuLoad(void);
-IMPORT STATUS mtsGcuProgramMode(void);
-IMPORT STATUS mtsGcuProgramStart(void);
-IMPORT STATUS mtsGcuProgramEnd(void);
-IMPORT STATUS mtsGcuTestMode(void);
-IMPORT STATUS mtsImuOn(void);
-IMPORT STATUS mtsIntArmingOn(void);
-IMPORT STATUS mtsIntArmingOff(void);
-IMPORT STATUS mtsIntSync(void);
-IMPORT STATUS mtsLiftOffMslOn(void);
-IMPORT STATUS mtsLiftOffMslOff(void);
-IMPORT STATUS mtsLiftOffReady(void);
-IMPORT STATUS mtsLiftOffTestOff(void);
-IMPORT STATUS mtsPowerBatGd(void);
-IMPORT STATUS mtsPowerBatOn(void);
-IMPORT STATUS mtsPowerBatOnBit(void);
-IMPORT STATUS mtsPowerBatOff(void);
-IMPORT STATUS mtsRdcDataLoad(void);
-IMPORT STATUS mtsRdcDataMode(void);
-IMPORT STATUS mtsRdcDataStart(void);
-IMPORT STATUS mtsRdcDataEnd(void);
-IMPORT STATUS mtsRdcModeInput(void);
-IMPORT STATUS mtsFireModeOn(void);
-IMPORT STATUS mtsFireModeOff(void);
-IMPORT STATUS mtsNavChk1(void);
-IMPORT STATUS mtsNavCHk2(void);
-IMPORT STATUS mtsNavChk3(void);
-IMPORT STATUS mtsChkGf12(void);
-IMPORT STATUS mtsSimHotStartLoad(void);
-IMPORT STATUS mtsSimHotStartStart(void);
-IMPORT STATUS mtsSimHotStartStop(void);
-IMPORT STATUS mtsLarModeSet(void);
-IMPORT STATUS mtsLarHotStartReq(void);
-IMPORT STATUS mtsLarLnsAidingStart(void);
-IMPORT STATUS mtsLarLnsAidingStop(void);
-IMPORT STATUS mtsSetGcuDio(void);
-IMPORT STATUS mtsCluArm1TestOn(void);
-IMPORT STATUS mtsCluArm1TestOff(void);
-IMPORT STATUS mtsCluEdResetTestOn(void);
-IMPORT STATUS mtsCluEdResetTestOff(void);
-IMPORT STATUS mtsCluLiftOffTestOn(void);
-IMPORT STATUS mtsCluLiftOffTestOff(void);
-IMPORT STATUS mtsTxGcuCtrlCmd(void);
-IMPORT STATUS mtsLnsSetTravelLock(void);
-IMPORT STATUS mtsLnsChkBit(void);
-IMPORT STATUS mtsLnsAlignStart(void);
-IMPORT STATUS mtsLnsAlignDone(void);
-IMPORT STATUS mtsTaStart(void);
-IMPORT STATUS mtsTaLchUp(void);
-IMPORT STATUS mtsTaDataInputStart(void);
-IMPORT STATUS mtsTaDataInputStop(void);
+#include "CmdArgs.h"
+
+IMPORT STATUS mtsTestFunc(const CmdArgs *pArgs);
+IMPORT STATUS invokeMethod_uint(const CmdArgs *pArgs);
+IMPORT STATUS invokeMethod_uint_double(const CmdArgs *pArgs);
+IMPORT STATUS checkResult_equal(const CmdArgs *pArgs);
+IMPORT STATUS checkResult_range(const CmdArgs *pArgs);
+IMPORT STATUS mtsAssetPrefetch(const CmdArgs *pArgs);
+IMPORT STATUS mtsCmdStats(const CmdArgs *pArgs);
+IMPORT STATUS mtsGcuLatency(const CmdArgs *pArgs);
+IMPORT STATUS mtsCommTestTxReq(const CmdArgs *pArgs);
+IMPORT STATUS mtsCommTest(const CmdArgs *pArgs);
+IMPORT STATUS mtsReset(const CmdArgs *pArgs);
+IMPORT STATUS mtsUpdate(const CmdArgs *pArgs);
+IMPORT STATUS mtsPowerExtOn(const CmdArgs *pArgs);
+IMPORT STATUS mtsPowerExtOff(const CmdArgs *pArgs);
+IMPORT STATUS mtsPowerExtGd(const CmdArgs *pArgs);
+IMPORT STATUS mtsPowerMeasureVolt(const CmdArgs *pArgs);
+IMPORT STATUS mtsPowerMeasureCurrent(const CmdArgs *pArgs);
+IMPORT STATUS mtsPowerMeasureMulti(const CmdArgs *pArgs);
+IMPORT STATUS mtsInitActPwrSuplOut(const CmdArgs *pArgs);
+IMPORT STATUS mtsGetActPwrSuplOut(const CmdArgs *pArgs);
+IMPORT STATUS mtsSetActPwrSuplOut(const CmdArgs *pArgs);
+IMPORT STATUS mtsSetActPwrSuplOutBit(const CmdArgs *pArgs);
+IMPORT STATUS mtsChkGf2(const CmdArgs *pArgs);
+IMPORT STATUS mtsGcuMslStsChk(const CmdArgs *pArgs);
+IMPORT STATUS mtsSwVerChk(const CmdArgs *pArgs);
+IMPORT STATUS mtsGcuFireModeStart(const CmdArgs *pArgs);
+IMPORT STATUS mtsNavCal(const CmdArgs *pArgs);
+IMPORT STATUS mtsNavDataInput(const CmdArgs *pArgs);
+IMPORT STATUS mtsSaveAlignData(const CmdArgs *pArgs);
+IMPORT STATUS mtsChkGf3NavData(const CmdArgs *pArgs);
+IMPORT STATUS mtsGcaStart(const CmdArgs *pArgs);
+IMPORT STATUS mtsShaStart(const CmdArgs *pArgs);
+IMPORT STATUS mtsGcaDone(const CmdArgs *pArgs);
+IMPORT STATUS mtsGcuMslGpsModeSet(const CmdArgs *pArgs);
+IMPORT STATUS mtsMslGpsTrkStart(const CmdArgs *pArgs);
+IMPORT STATUS mtsActMotorOn(const CmdArgs *pArgs);
+IMPORT STATUS mtsAcuCtrlCommandSetErrorDeg(const CmdArgs *pArgs);
+IMPORT STATUS mtsAcuSlewStart(const CmdArgs *pArgs);
+IMPORT STATUS mtsAcuSlewEnd(const CmdArgs *pArgs);
+IMPORT STATUS mtsAcuWingCommandSetErrorDeg(const CmdArgs *pArgs);
+IMPORT STATUS mtsArm1OnOff(const CmdArgs *pArgs);
+IMPORT STATUS mtsBit(const CmdArgs *pArgs);
+IMPORT STATUS steBit(const CmdArgs *pArgs);
+IMPORT STATUS mtsChkGf7(const CmdArgs *pArgs);
+IMPORT STATUS mtsChkTmMulti(const CmdArgs *pArgs);
+IMPORT STATUS mtsLimitAdd(const CmdArgs *pArgs);
+IMPORT STATUS mtsLimitClear(const CmdArgs *pArgs);
+IMPORT STATUS mtsLimitShow(const CmdArgs *pArgs);
+IMPORT STATUS mtsLinkStats(const CmdArgs *pArgs);
+IMPORT STATUS mtsGcuLoad(const CmdArgs *pArgs);
+IMPORT STATUS mtsGcuProgramMode(const CmdArgs *pArgs);
+IMPORT STATUS mtsGcuProgramStart(const CmdArgs *pArgs);
+IMPORT STATUS mtsGcuProgramResume(const CmdArgs *pArgs);
+IMPORT STATUS mtsGcuProgramEnd(const CmdArgs *pArgs);
+IMPORT STATUS mtsGcuTestMode(const CmdArgs *pArgs);
+IMPORT STATUS mtsImuOn(const CmdArgs *pArgs);
+IMPORT STATUS mtsIntArmingOn(const CmdArgs *pArgs);
+IMPORT STATUS mtsIntArmingOff(const CmdArgs *pArgs);
+IMPORT STATUS mtsIntSync(const CmdArgs *pArgs);
+IMPORT STATUS mtsLiftOffMslOn(const CmdArgs *pArgs);
+IMPORT STATUS mtsLiftOffMslOff(const CmdArgs *pArgs);
+IMPORT STATUS mtsLiftOffReady(const CmdArgs *pArgs);
+IMPORT STATUS mtsLiftOffTestOff(const CmdArgs *pArgs);
+IMPORT STATUS mtsPowerBatGd(const CmdArgs *pArgs);
+IMPORT STATUS mtsPowerBatOn(const CmdArgs *pArgs);
+IMPORT STATUS mtsPowerBatOnBit(const CmdArgs *pArgs);
+IMPORT STATUS mtsPowerBatOff(const CmdArgs *pArgs);
+IMPORT STATUS mtsRdcDataLoad(const CmdArgs *pArgs);
+IMPORT STATUS mtsRdcDataMode(const CmdArgs *pArgs);
+IMPORT STATUS mtsRdcDataStart(const CmdArgs *pArgs);
+IMPORT STATUS mtsRdcDataEnd(const CmdArgs *pArgs);
+IMPORT STATUS mtsRdcModeInput(const CmdArgs *pArgs);
+IMPORT STATUS mtsFireModeOn(const CmdArgs *pArgs);
+IMPORT STATUS mtsFireModeOff(const CmdArgs *pArgs);
+IMPORT STATUS mtsNavChk1(const CmdArgs *pArgs);
+IMPORT STATUS mtsNavCHk2(const CmdArgs *pArgs);
+IMPORT STATUS mtsNavChk3(const CmdArgs *pArgs);
+IMPORT STATUS mtsChkGf12(const CmdArgs *pArgs);
+IMPORT STATUS mtsSimHotStartLoad(const CmdArgs *pArgs);
+IMPORT STATUS mtsSimHotStartStart(const CmdArgs *pArgs);
+IMPORT STATUS mtsSimHotStartStop(const CmdArgs *pArgs);
+IMPORT STATUS mtsLarModeSet(const CmdArgs *pArgs);
+IMPORT STATUS mtsLarHotStartReq(const CmdArgs *pArgs);
+IMPORT STATUS mtsLarLnsAidingStart(const CmdArgs *pArgs);
+IMPORT STATUS mtsLarLnsAidingStop(const CmdArgs *pArgs);
+IMPORT STATUS mtsSetGcuDio(const CmdArgs *pArgs);
+IMPORT STATUS mtsCluArm1TestOn(const CmdArgs *pArgs);
+IMPORT STATUS mtsCluArm1TestOff(const CmdArgs *pArgs);
+IMPORT STATUS mtsCluEdResetTestOn(const CmdArgs *pArgs);
+IMPORT STATUS mtsCluEdResetTestOff(const CmdArgs *pArgs);
+IMPORT STATUS mtsCluLiftOffTestOn(const CmdArgs *pArgs);
+IMPORT STATUS mtsCluLiftOffTestOff(const CmdArgs *pArgs);
+IMPORT STATUS mtsTxGcuCtrlCmd(const CmdArgs *pArgs);
+IMPORT STATUS mtsLnsSetTravelLock(const CmdArgs *pArgs);
+IMPORT STATUS mtsLnsChkBit(const CmdArgs *pArgs);
+IMPORT STATUS mtsLnsAlignStart(const CmdArgs *pArgs);
+IMPORT STATUS mtsLnsAlignDone(const CmdArgs *pArgs);
+IMPORT STATUS mtsTaStart(const CmdArgs *pArgs);
+IMPORT STATUS mtsTaLchUp(const CmdArgs *pArgs);
+IMPORT STATUS mtsTaDataInputStart(const CmdArgs *pArgs);
+IMPORT STATUS mtsTaDataInputStop(const CmdArgs *pArgs);
 
@@ -0,0 +1,126 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "../lib/util/isClock.h"
+#include "CmdStats.h"
+
+typedef struct {
+	const char *	szName;
+	IsHist			phase[CMD_PHASE_MAX];
+} CmdStatsItem;
+
+LOCAL const struct {
+	CmdStamp	from;
+	CmdStamp	to;
+	const char *szName;
+} g_cmdPhaseDef[CMD_PHASE_MAX] = {
+	{ CMD_STAMP_RECV,		CMD_STAMP_RESOLVE,		"resolve"	},
+	{ CMD_STAMP_RESOLVE,	CMD_STAMP_PARSE,		"parse"		},
+	{ CMD_STAMP_PARSE,		CMD_STAMP_START,		"dispatch"	},
+	{ CMD_STAMP_START,		CMD_STAMP_FIRST_POST,	"toPost"	},
+	{ CMD_STAMP_FIRST_POST,	CMD_STAMP_FIRST_RESP,	"gcuResp"	},
+	{ CMD_STAMP_START,		CMD_STAMP_RESULT,		"run"		},
+	{ CMD_STAMP_RECV,		CMD_STAMP_RESULT,		"total"		},
+};
+
+/* Written by tCmdExec only; readers may see a sample in progress. */
+LOCAL CmdStatsItem g_cmdStatsItems[CMD_STATS_MAX_CMDS];
+
+LOCAL CmdStatsItem *findItem(const char *szName) {
+	int i;
+	
+	for (i = 0; i < CMD_STATS_MAX_CMDS; i++) {
+		if ((g_cmdStatsItems[i].szName != NULL) &&
+			(strcmp(g_cmdStatsItems[i].szName, szName) == 0)) {
+			return &g_cmdStatsItems[i];
+		}
+	}
+	
+	return NULL;
+}
+
+/*
+ * Phases whose end stamp was never taken (e.g. a command that posts no
+ * FG frame) are not sampled. An end stamped before the start, e.g. a
+ * response whose frame was already in when the FG frame was posted,
+ * counts as 0.
+ */
+void CmdStatsRecord(int cmdIdx, const char *szName, const CmdStamps *pStamps) {
+	CmdStatsItem *pItem;
+	UINT64 tFrom, tTo;
+	int i;
+	
+	if ((cmdIdx < 0) || (cmdIdx >= CMD_STATS_MAX_CMDS))
+		return;
+	
+	pItem = &g_cmdStatsItems[cmdIdx];
+	pItem->szName = szName;
+	
+	for (i = 0; i < CMD_PHASE_MAX; i++) {
+		tFrom = pStamps->t[g_cmdPhaseDef[i].from];
+		tTo = pStamps->t[g_cmdPhaseDef[i].to];
+		
+		if ((tFrom == 0) || (tTo == 0))
+			continue;
+		
+		isHistAdd(&pItem->phase[i], (tTo < tFrom) ? 0 : isClockNsToUs(tTo - tFrom));
+	}
+}
+
+STATUS CmdStatsSummary(const char *szName, CmdPhaseSummary summary[CMD_PHASE_MAX]) {
+	CmdStatsItem *pItem;
+	int i;
+	
+	if ((pItem = findItem(szName)) == NULL)
+		return ERROR;
+	
+	for (i = 0; i < CMD_PHASE_MAX; i++) {
+		summary[i].count = pItem->phase[i].count;
+		summary[i].p50Us = isHistPercentile(&pItem->phase[i], 50);
+		summary[i].p99Us = isHistPercentile(&pItem->phase[i], 99);
+		summary[i].maxUs = pItem->phase[i].max;
+	}
+	
+	return OK;
+}
+
+void CmdStatsReset(void) {
+	memset(g_cmdStatsItems, 0, sizeof(g_cmdStatsItems));
+}
+
+void cmdStatsShow(void) {
+	CmdStatsItem *pItem;
+	int i, k;
+	
+	printf("\n %-32s %6s", "command (p50/p99 us)", "n");
+	for (k = 0; k < CMD_PHASE_MAX; k++) {
+		printf(" %17s", g_cmdPhaseDef[k].szName);
+	}
+	
+	for (i = 0; i < CMD_STATS_MAX_CMDS; i++) {
+		pItem = &g_cmdStatsItems[i];
+		if (pItem->szName == NULL)
+			continue;
+		
+		printf("\n %-32s %6u", pItem->szName, pItem->phase[CMD_PHASE_TOTAL].count);
+		for (k = 0; k < CMD_PHASE_MAX; k++) {
+			printf(" %8u/%8u", isHistPercentile(&pItem->phase[k], 50),
+				   isHistPercentile(&pItem->phase[k], 99));
+		}
+	}
+	printf("\n");
+}
+
+void cmdStatsShowCmd(const char *szName) {
+	CmdStatsItem *pItem;
+	int k;
+	
+	if ((szName == NULL) || ((pItem = findItem(szName)) == NULL)) {
+		printf("\n no samples for \"%s\"\n", (szName) ? szName : "");
+		return;
+	}
+	
+	for (k = 0; k < CMD_PHASE_MAX; k++) {
+		isHistShow(&pItem->phase[k], g_cmdPhaseDef[k].szName);
+	}
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <vxWorks.h>
+
+#include "../lib/util/isHist.h"
+
+#define CMD_STATS_MAX_CMDS		(128)
+
+typedef enum {
+	CMD_STAMP_RECV,			/* CMD_EXEC_EXECUTE received by tCmdExec */
+	CMD_STAMP_RESOLVE,		/* command name looked up */
+	CMD_STAMP_PARSE,		/* arguments parsed */
+	CMD_STAMP_START,		/* command function entered on a worker */
+	CMD_STAMP_FIRST_POST,	/* first FG frame posted to SdlcSendGcu */
+	CMD_STAMP_FIRST_RESP,	/* first matching GF response seen */
+	CMD_STAMP_RESULT,		/* command function returned with its result */
+	CMD_STAMP_MAX
+} CmdStamp;
+
+typedef enum {
+	CMD_PHASE_RESOLVE,		/* RECV -> RESOLVE */
+	CMD_PHASE_PARSE,		/* RESOLVE -> PARSE */
+	CMD_PHASE_DISPATCH,		/* PARSE -> START */
+	CMD_PHASE_TO_POST,		/* START -> FIRST_POST */
+	CMD_PHASE_GCU_RESP,		/* FIRST_POST -> FIRST_RESP */
+	CMD_PHASE_RUN,			/* START -> RESULT */
+	CMD_PHASE_TOTAL,		/* RECV -> RESULT */
+	CMD_PHASE_MAX
+} CmdPhase;
+
+typedef struct {
+	UINT64	t[CMD_STAMP_MAX];
+} CmdStamps;
+
+typedef struct {
+	UINT32	count;
+	UINT32	p50Us;
+	UINT32	p99Us;
+	UINT32	maxUs;
+} CmdPhaseSummary;
+
+IMPORT void		CmdStatsRecord(int cmdIdx, const char *szName, const CmdStamps *pStamps);
+IMPORT STATUS	CmdStatsSummary(const char *szName, CmdPhaseSummary summary[CMD_PHASE_MAX]);
+IMPORT void		CmdStatsReset(void);
+IMPORT void		cmdStatsShow(void);
+IMPORT void		cmdStatsShowCmd(const char *szName);
@@ -0,0 +1,197 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "../lib/util/isDebug.h"
+#include "common.h"
+#include "FrameRing.h"
+#include "LogBatch.h"
+
+typedef struct {
+	FrameSlot *				pSlots;
+	int						frameSize;
+	int						next;
+	FrameSlot *				pWriting;
+	FrameSlot * volatile	pLatest;
+	FrameRingStats			stats;
+} FrameRing;
+
+LOCAL FrameRing g_frameRing[TM_WAIT_SRC_MAX];
+
+STATUS FrameRingAttach(TmWaitSrc src, FrameSlot *pSlots, int frameSize) {
+	FrameRing *pRing;
+	
+	if ((src >= TM_WAIT_SRC_MAX) || (pSlots == NULL))
+		return ERROR;
+	
+	pRing = &g_frameRing[src];
+	memset(pRing, 0, sizeof(FrameRing));
+	pRing->pSlots = pSlots;
+	pRing->frameSize = frameSize;
+	pRing->next = 1;
+	pRing->pLatest = &pSlots[0];
+	
+	return OK;
+}
+
+LOCAL LOG_DATA *beginWrite(FrameRing *pRing, FrameSlot *pSlot) {
+	pSlot->seq++;
+	VX_MEM_BARRIER_W();
+	pRing->pWriting = pSlot;
+	
+	return &pSlot->log;
+}
+
+/*
+ * Returns the slot the next frame of src is swapped into. A slot LogSend
+ * still holds is skipped; if all of them are held the oldest is reused.
+ */
+LOG_DATA *FrameRingNext(TmWaitSrc src) {
+	FrameRing *pRing = &g_frameRing[src];
+	FrameSlot *pOldest = &pRing->pSlots[pRing->next];
+	FrameSlot *pSlot;
+	int i;
+	
+	for (i = 0; i < FRAME_RING_DEPTH - 1; i++) {
+		pSlot = &pRing->pSlots[pRing->next];
+		pRing->next = (pRing->next + 1) % FRAME_RING_DEPTH;
+		if (pSlot->refCnt == 0)
+			return beginWrite(pRing, pSlot);
+	}
+	
+	/* Never the slot of the latest frame, which readers may still be on. */
+	pRing->stats.numOverruns++;
+	pRing->next = (int)(pOldest - pRing->pSlots + 1) % FRAME_RING_DEPTH;
+	
+	return beginWrite(pRing, pOldest);
+}
+
+/* Called once the frame in the slot from FrameRingNext() is complete. */
+void FrameRingPublish(TmWaitSrc src) {
+	FrameRing *pRing = &g_frameRing[src];
+	
+	VX_MEM_BARRIER_W();
+	pRing->pWriting->seq++;
+	pRing->pLatest = pRing->pWriting;
+	pRing->stats.numFrames++;
+	pRing->stats.bytesCopied += pRing->frameSize;
+}
+
+const void *FrameRingLatest(TmWaitSrc src) {
+	if ((src >= TM_WAIT_SRC_MAX) || (g_frameRing[src].pSlots == NULL))
+		return NULL;
+	
+	return &g_frameRing[src].pLatest->log.formatted.body;
+}
+
+/*
+ * Offset of pField in a frame of src when it points into any slot of the
+ * ring, ERROR otherwise. Lets a reader that took the address of a field
+ * of the latest frame follow later frames instead of the slot it saw.
+ */
+int FrameRingOffset(TmWaitSrc src, const volatile void *pField) {
+	const FrameRing *pRing;
+	const char *pBody;
+	int i;
+	
+	if ((src >= TM_WAIT_SRC_MAX) || (g_frameRing[src].pSlots == NULL))
+		return ERROR;
+	
+	pRing = &g_frameRing[src];
+	for (i = 0; i < FRAME_RING_DEPTH; i++) {
+		pBody = (const char *)&pRing->pSlots[i].log.formatted.body;
+		if (((const char *)pField >= pBody) &&
+			((const char *)pField < pBody + pRing->frameSize))
+			return (int)((const char *)pField - pBody);
+	}
+	
+	return ERROR;
+}
+
+/*
+ * Copies the latest frame of src into pDst; returns its size or ERROR.
+ * The latest slot is only rewritten after FRAME_RING_DEPTH - 1 newer
+ * frames, so a retry is rare and the writer never waits on it.
+ */
+int FrameRingRead(TmWaitSrc src, void *pDst, int size) {
+	FrameRing *pRing;
+	const FrameSlot *pSlot;
+	UINT32 seq;
+	
+	if ((src >= TM_WAIT_SRC_MAX) || (g_frameRing[src].pSlots == NULL))
+		return ERROR;
+	
+	pRing = &g_frameRing[src];
+	if (size < pRing->frameSize)
+		return ERROR;
+	
+	for (;;) {
+		pSlot = pRing->pLatest;
+		seq = pSlot->seq;
+		VX_MEM_BARRIER_R();
+		if ((seq & 1) == 0) {
+			memcpy(pDst, &pSlot->log.formatted.body, pRing->frameSize);
+			VX_MEM_BARRIER_R();
+			if (pSlot->seq == seq)
+				return pRing->frameSize;
+		}
+		pRing->stats.numRetries++;
+	}
+}
+
+void FrameRingPost(TmWaitSrc src, LOG_DATA *pLog, int len, UINT64 timeNs) {
+	FrameRing *pRing = &g_frameRing[src];
+#ifdef LOG_SEND_BY_REF
+	FrameSlot *pSlot = (FrameSlot *)pLog;
+	
+	pSlot->timeNs = timeNs;
+	pSlot->refCnt = 1;
+	PostLogSendCmdEx(LOG_SEND_TX_REF, (const char *)(&pLog), sizeof(pLog));
+	pRing->stats.bytesCopied += sizeof(pLog);
+#else
+	LogBatchPost(pLog, len, timeNs, FALSE);
+	pRing->stats.bytesCopied += len;
+#endif
+}
+
+/* Called by LogSend once a slot posted by reference has been sent. */
+void FrameRingRelease(const LOG_DATA *pLog) {
+	((FrameSlot *)pLog)->refCnt = 0;
+}
+
+void FrameRingStatsGet(TmWaitSrc src, FrameRingStats *pStats) {
+	if (src < TM_WAIT_SRC_MAX)
+		*pStats = g_frameRing[src].stats;
+	else
+		memset(pStats, 0, sizeof(FrameRingStats));
+}
+
+void frameRingShow(void) {
+	const FrameRing *pRing;
+	int busy;
+	int i, j;
+
+#ifdef LOG_SEND_BY_REF
+	printf("LogSend by reference, %d slots per type\n", FRAME_RING_DEPTH);
+#else
+	printf("LogSend by copy, %d slots per type\n", FRAME_RING_DEPTH);
+#endif
+	printf("%4s %3s %6s %10s %9s %8s %5s %12s\n",
+		   "UNIT", "SRC", "SIZE", "FRAMES", "OVERRUNS", "RETRIES", "BUSY", "BYTES/FRAME");
+	for (i = 0; i < TM_WAIT_SRC_MAX; i++) {
+		pRing = &g_frameRing[i];
+		if (pRing->pSlots == NULL)
+			continue;
+		
+		for (busy = 0, j = 0; j < FRAME_RING_DEPTH; j++) {
+			if (pRing->pSlots[j].refCnt != 0)
+				busy++;
+		}
+		
+		printf("%4d %3d %6d %10u %9u %8u %5d %12.1f\n",
+			   TM_WAIT_SRC_UNIT(i), TM_WAIT_SRC_TYPE(i), pRing->frameSize,
+			   pRing->stats.numFrames, pRing->stats.numOverruns,
+			   pRing->stats.numRetries, busy,
+			   pRing->stats.numFrames ?
+			   (double)pRing->stats.bytesCopied / pRing->stats.numFrames : 0.0);
+	}
+}
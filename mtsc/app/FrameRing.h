@@ -0,0 +1,45 @@
+#pragma once
+
+#include <vxWorks.h>
+
+#include "LogSend.h"
+#include "TmWait.h"
+
+/*
+ * Per-type rings of LOG_DATA slots for received GF frames. tSdlcRecvGcu
+ * swaps each frame straight into the next free slot, publishes it as the
+ * latest frame of its type and posts the slot to LogSend. Built with
+ * LOG_SEND_BY_REF, LogSend is handed the slot address and returns the
+ * slot with FrameRingRelease(); otherwise the slot is copied as before.
+ *
+ * Each slot carries a sequence count that is odd while the frame is being
+ * written. FrameRingRead() copies the latest frame and retries if the
+ * count moved under it, so readers get a whole frame without ever making
+ * tSdlcRecvGcu wait for them.
+ */
+#define FRAME_RING_DEPTH		(8)
+
+typedef struct {
+	LOG_DATA		log;			/* first, so a LOG_DATA * is a FrameSlot * */
+	volatile UINT32	refCnt;			/* held by LogSend while posted by reference */
+	volatile UINT32	seq;			/* odd while tSdlcRecvGcu writes the slot */
+	UINT64			timeNs;			/* HwTime of the receipt, for LogSend by reference */
+} FrameSlot;
+
+typedef struct {
+	UINT32	numFrames;
+	UINT32	numOverruns;		/* every slot still held by LogSend */
+	UINT32	numRetries;			/* FrameRingRead() copies taken again */
+	UINT64	bytesCopied;		/* swap and post copies */
+} FrameRingStats;
+
+IMPORT STATUS		FrameRingAttach(TmWaitSrc src, FrameSlot *pSlots, int frameSize);
+IMPORT LOG_DATA *	FrameRingNext(TmWaitSrc src);
+IMPORT void			FrameRingPublish(TmWaitSrc src);
+IMPORT const void *	FrameRingLatest(TmWaitSrc src);
+IMPORT int			FrameRingOffset(TmWaitSrc src, const volatile void *pField);
+IMPORT int			FrameRingRead(TmWaitSrc src, void *pDst, int size);
+IMPORT void			FrameRingPost(TmWaitSrc src, LOG_DATA *pLog, int len, UINT64 timeNs);
+IMPORT void			FrameRingRelease(const LOG_DATA *pLog);
+IMPORT void			FrameRingStatsGet(TmWaitSrc src, FrameRingStats *pStats);
+IMPORT void			frameRingShow(void);
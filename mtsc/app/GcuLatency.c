@@ -0,0 +1,310 @@
+#include <semLib.h>
+#include <vxAtomicLib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "../lib/util/isDebug.h"
+#include "../lib/util/isClock.h"
+#include "common.h"
+#include "typeDef/tmType/tmSts.h"
+#include "SdlcRecvGcu.h"
+#include "SdlcSendGcu.h"
+#include "SdlcGfTbl.h"
+#include "GcuUnit.h"
+#include "HwTime.h"
+#include "GcuLatency.h"
+
+#define GCU_LATENCY_OP(name, fg, opcode, gf, resp) \
+	{ name, SDLC_SEND_GCU_TX_##fg, opcode, TM_WAIT_SRC_##gf, resp }
+#define GCU_LATENCY_OP_NUM		NELEMENTS(g_gcuLatencyOps)
+
+/*
+ * HwTime in us, truncated: differences stay right across the wrap. A
+ * frame received before the FG was posted gives a negative one.
+ */
+#define GCU_LATENCY_US(timeNs)	((atomic32Val_t)(UINT32)((timeNs) / 1000))
+#define GCU_LATENCY_TIMEOUT_MAX_MS	(30 * 60 * 1000)	/* inside the 35 minute half wrap */
+#define GCU_LATENCY_ELAPSED_US(tNowUs, tTxUs)	((INT32)((tNowUs) - (tTxUs)))
+
+typedef struct {
+	const char *	szName;
+	int				fgCmd;			/* SDLC_SEND_GCU_TX_FGn the FG is posted with */
+	UINT16			opcode;
+	TmWaitSrc		respSrc;
+	UINT16			respCode;		/* response word under GCU_LATENCY_RESP_MASK */
+} GcuLatencyOp;
+
+/* What tSdlcRecvGcu counts, without a lock; see GcuLatencyReset(). */
+typedef struct {
+	UINT32		numRx;
+	IsHist		latencyUs;
+} GcuLatencyBank;
+
+/*
+ * tTxUs is the only field both sides change: GcuLatencyTx() swaps its
+ * stamp in, and whoever swaps it back to 0 first, the response or the
+ * timeout, counts the FG. A stamp of 0 is moved to 1.
+ */
+typedef struct {
+	atomic32_t		tTxUs;			/* GCU_LATENCY_US() of the FG waiting for its response, 0 if none */
+	UINT32			numTx;
+	atomic32_t		numTimeouts;
+	GcuLatencyBank	bank[2];
+} GcuLatencyItem;
+
+/*
+ * FG type and opcode -> the response type and word that answer it, as
+ * CmdFuncs waits for them. FG3_1 has no response word: mtsNavDataInput
+ * reads the data back from GF3 after a fixed delay.
+ */
+LOCAL const GcuLatencyOp g_gcuLatencyOps[] = {
+	GCU_LATENCY_OP("FG2 LAUNCH",		FG2,	TM_FG2_1_OPCODE_MODE_LAUNCH,		GF2, TM_FG2_1_OPCODE_MODE_LAUNCH),
+	GCU_LATENCY_OP("FG2 GCU PROGRAM",	FG2,	TM_FG2_1_OPCODE_MODE_GCU_PROGRAM,	GF2, TM_FG2_1_OPCODE_MODE_GCU_PROGRAM),
+	GCU_LATENCY_OP("FG2 COMM START",	FG2,	TM_FG2_1_OPCODE_MSL_COMM_START,		GF2, TM_FG2_1_OPCODE_MSL_COMM_START),
+	GCU_LATENCY_OP("FG2 START GNC",		FG2,	TM_FG2_1_OPCODE_MSL_START_GNC,		GF2, TM_FG2_1_OPCODE_MSL_START_GNC),
+	GCU_LATENCY_OP("FG2 ACT TEST START",	FG2,	TM_FG2_1_OPCODE_ACT_TEST_START,	GF2, TM_FG2_1_OPCODE_ACT_TEST_START),
+	GCU_LATENCY_OP("FG2 ACT TEST END",	FG2,	TM_FG2_1_OPCODE_ACT_TEST_END,		GF2, TM_FG2_1_OPCODE_ACT_TEST_END),
+	GCU_LATENCY_OP("FG2 MOTOR ON",		FG2,	TM_FG2_1_OPCODE_MSL_MOTOR_ON,		GF2, TM_FG2_1_OPCODE_MSL_MOTOR_ON),
+	GCU_LATENCY_OP("FG2_2",				FG2,	TM_FG2_2_OPCODE,					GF2, TM_FG2_2_OPCODE),
+	GCU_LATENCY_OP("FG2_3",				FG2,	TM_FG2_3_OPCODE,					GF2, TM_FG2_3_OPCODE),
+	GCU_LATENCY_OP("FG3_3 SW TX",		FG33,	TM_FG3_3_OPCODE_SW_TX,				GF3, TM_FG3_3_OPCODE_SW_TX),
+	GCU_LATENCY_OP("FG3_4 SW VER",		FG3,	TM_FG3_4_OPCODE,					GF3, TM_FG3_4_OPCODE),
+	GCU_LATENCY_OP("FG5",				FG5,	TM_FG5_OPCODE,						GF5, TM_GF5_OPCODE),
+	GCU_LATENCY_OP("FG7 GCA",			FG7,	TM_FG7_1_OPCODE_GCA,				GF7, TM_FG7_1_OPCODE_GCA),
+	GCU_LATENCY_OP("FG7 SHA",			FG7,	TM_FG7_1_OPCODE_SHA,				GF7, TM_FG7_1_OPCODE_SHA),
+};
+
+/*
+ * sidLock serializes posters, readers and resets; tSdlcRecvGcu never
+ * takes it, and counts into bank[bankIdx] of the items.
+ */
+typedef struct {
+	SEM_ID			sidLock;
+	atomic32_t		numPending;		/* lets the receiver skip the scan */
+	atomic32_t		bankIdx;
+	GcuLatencyItem	item[GCU_LATENCY_OP_NUM];
+} GcuLatencyUnit;
+
+LOCAL GcuLatencyUnit g_gcuLatency[GCU_UNIT_MAX];
+
+LOCAL UINT32 g_gcuLatencyTimeoutUs = GCU_LATENCY_TIMEOUT_MS * 1000;
+
+LOCAL int findOp(int fgCmd, UINT16 opcode) {
+	int i;
+	
+	for (i = 0; i < GCU_LATENCY_OP_NUM; i++) {
+		if ((g_gcuLatencyOps[i].fgCmd == fgCmd) && (g_gcuLatencyOps[i].opcode == opcode))
+			return i;
+	}
+	
+	return ERROR;
+}
+
+/* Takes the pending stamp tTxUs of the item, if no one else took it first. */
+LOCAL BOOL claimTx(int unit, GcuLatencyItem *pItem, atomic32Val_t tTxUs) {
+	if ((tTxUs == 0) || (vxAtomic32Cas(&pItem->tTxUs, tTxUs, 0) == FALSE))
+		return FALSE;
+	
+	vxAtomic32Dec(&g_gcuLatency[unit].numPending);
+	
+	return TRUE;
+}
+
+LOCAL void expire(int unit, atomic32Val_t tNowUs) {
+	GcuLatencyItem *pItem;
+	atomic32Val_t tTxUs;
+	int i;
+	
+	for (i = 0; i < GCU_LATENCY_OP_NUM; i++) {
+		pItem = &g_gcuLatency[unit].item[i];
+		tTxUs = vxAtomic32Get(&pItem->tTxUs);
+		if ((tTxUs != 0) && (GCU_LATENCY_ELAPSED_US(tNowUs, tTxUs) > (INT32)g_gcuLatencyTimeoutUs) &&
+			claimTx(unit, pItem, tTxUs))
+			vxAtomic32Inc(&pItem->numTimeouts);
+	}
+}
+
+STATUS GcuLatencyInit(void) {
+	int unit, i;
+	
+	for (unit = 0; unit < GCU_UNIT_MAX; unit++) {
+		if (g_gcuLatency[unit].sidLock != SEM_ID_NULL)
+			continue;
+		
+		for (i = 0; i < GCU_LATENCY_OP_NUM; i++) {
+			isHistReset(&g_gcuLatency[unit].item[i].bank[0].latencyUs);
+			isHistReset(&g_gcuLatency[unit].item[i].bank[1].latencyUs);
+		}
+		
+		g_gcuLatency[unit].sidLock =
+			semMCreate(SEM_Q_PRIORITY | SEM_DELETE_SAFE | SEM_INVERSION_SAFE);
+		if (g_gcuLatency[unit].sidLock == SEM_ID_NULL) {
+			LOGMSG("semMCreate() error!\n");
+			return ERROR;
+		}
+	}
+	
+	return OK;
+}
+
+/* Called as fgCmd with opcode is posted to SdlcSendGcu of the unit. */
+void GcuLatencyTx(int unit, int fgCmd, UINT16 opcode, UINT64 timeNs) {
+	GcuLatencyItem *pItem;
+	atomic32Val_t tTxUs = GCU_LATENCY_US(timeNs);
+	int op;
+	
+	if ((unit < 0) || (unit >= GCU_UNIT_MAX) || (g_gcuLatency[unit].sidLock == SEM_ID_NULL))
+		return;
+	
+	if ((op = findOp(fgCmd, opcode)) == ERROR)
+		return;
+	
+	pItem = &g_gcuLatency[unit].item[op];
+	if (tTxUs == 0)
+		tTxUs = 1;
+	
+	semTake(g_gcuLatency[unit].sidLock, WAIT_FOREVER);
+	/* Count it pending first, so the receiver cannot see it and skip the scan. */
+	vxAtomic32Inc(&g_gcuLatency[unit].numPending);
+	if (vxAtomic32Set(&pItem->tTxUs, tTxUs) != 0) {
+		vxAtomic32Dec(&g_gcuLatency[unit].numPending);
+		vxAtomic32Inc(&pItem->numTimeouts);
+	}
+	pItem->numTx++;
+	semGive(g_gcuLatency[unit].sidLock);
+}
+
+/*
+ * Called by tSdlcRecvGcu for every frame of a type with a response word,
+ * with the HwTime of its receipt. Costs one read unless an FG of the unit
+ * is waiting, and never blocks.
+ *
+ * The response word stays in every frame until the GCU answers the next
+ * command, so a frame received before the FG was posted still shows the
+ * answer to the same opcode sent earlier; it is not taken as the response.
+ */
+void GcuLatencyRx(int unit, TmWaitSrc type, UINT16 resp, UINT64 timeNs) {
+	const GcuLatencyOp *pOp;
+	GcuLatencyItem *pItem;
+	GcuLatencyBank *pBank;
+	atomic32Val_t tNowUs = GCU_LATENCY_US(timeNs);
+	atomic32Val_t tTxUs;
+	int i;
+	
+	if ((unit < 0) || (unit >= GCU_UNIT_MAX) || (vxAtomic32Get(&g_gcuLatency[unit].numPending) == 0))
+		return;
+	
+	expire(unit, tNowUs);
+	for (i = 0; i < GCU_LATENCY_OP_NUM; i++) {
+		pOp = &g_gcuLatencyOps[i];
+		if ((pOp->respSrc != type) || (pOp->respCode != (resp & GCU_LATENCY_RESP_MASK)))
+			continue;
+		
+		pItem = &g_gcuLatency[unit].item[i];
+		tTxUs = vxAtomic32Get(&pItem->tTxUs);
+		if ((GCU_LATENCY_ELAPSED_US(tNowUs, tTxUs) <= 0) || (claimTx(unit, pItem, tTxUs) == FALSE))
+			continue;
+		
+		pBank = &pItem->bank[vxAtomic32Get(&g_gcuLatency[unit].bankIdx)];
+		isHistAdd(&pBank->latencyUs, (UINT32)(tNowUs - tTxUs));
+		pBank->numRx++;
+	}
+}
+
+int GcuLatencySummaryGet(int unit, GcuLatencySummary *pSummary, int maxNum) {
+	const GcuLatencyItem *pItem;
+	const GcuLatencyBank *pBank;
+	int num = 0;
+	int i;
+	
+	if ((unit < 0) || (unit >= GCU_UNIT_MAX) || (g_gcuLatency[unit].sidLock == SEM_ID_NULL))
+		return 0;
+	
+	semTake(g_gcuLatency[unit].sidLock, WAIT_FOREVER);
+	expire(unit, GCU_LATENCY_US(HwTimeNow()));
+	for (i = 0; (i < GCU_LATENCY_OP_NUM) && (num < maxNum); i++) {
+		pItem = &g_gcuLatency[unit].item[i];
+		pBank = &pItem->bank[vxAtomic32Get(&g_gcuLatency[unit].bankIdx)];
+		pSummary[num].opcode = g_gcuLatencyOps[i].opcode;
+		pSummary[num].respCode = g_gcuLatencyOps[i].respCode;
+		pSummary[num].respSrc = (UINT8)g_gcuLatencyOps[i].respSrc;
+		pSummary[num].isPending = (vxAtomic32Get(&pItem->tTxUs) != 0);
+		pSummary[num].fgCmd = (UINT8)g_gcuLatencyOps[i].fgCmd;
+		pSummary[num].numTx = pItem->numTx;
+		pSummary[num].numRx = pBank->numRx;
+		pSummary[num].numTimeouts = (UINT32)vxAtomic32Get(&pItem->numTimeouts);
+		pSummary[num].p50Us = isHistPercentile(&pBank->latencyUs, 50);
+		pSummary[num].p99Us = isHistPercentile(&pBank->latencyUs, 99);
+		pSummary[num].maxUs = pBank->latencyUs.max;
+		num++;
+	}
+	semGive(g_gcuLatency[unit].sidLock);
+	
+	return num;
+}
+
+/* An FG unanswered for timeoutMs is counted as a timeout. */
+STATUS GcuLatencyConfig(int timeoutMs) {
+	if ((timeoutMs <= 0) || (timeoutMs > GCU_LATENCY_TIMEOUT_MAX_MS))
+		return ERROR;
+	
+	g_gcuLatencyTimeoutUs = (UINT32)timeoutMs * 1000;
+	
+	return OK;
+}
+
+/*
+ * GcuLatencyRx() may be adding a sample while this runs, so the bank it
+ * counts into is not cleared: the other bank is, and then replaces it. A
+ * sample that was already on its way lands in the retired bank, which is
+ * not read until the next reset clears it.
+ */
+void GcuLatencyReset(int unit) {
+	GcuLatencyItem *pItem;
+	GcuLatencyBank *pBank;
+	atomic32Val_t bankIdx;
+	int i;
+	
+	if ((unit < 0) || (unit >= GCU_UNIT_MAX) || (g_gcuLatency[unit].sidLock == SEM_ID_NULL))
+		return;
+	
+	semTake(g_gcuLatency[unit].sidLock, WAIT_FOREVER);
+	bankIdx = vxAtomic32Get(&g_gcuLatency[unit].bankIdx) ^ 1;
+	for (i = 0; i < GCU_LATENCY_OP_NUM; i++) {
+		pItem = &g_gcuLatency[unit].item[i];
+		claimTx(unit, pItem, vxAtomic32Get(&pItem->tTxUs));
+		pItem->numTx = 0;
+		vxAtomic32Set(&pItem->numTimeouts, 0);
+		pBank = &pItem->bank[bankIdx];
+		pBank->numRx = 0;
+		isHistReset(&pBank->latencyUs);
+	}
+	VX_MEM_BARRIER_W();
+	vxAtomic32Set(&g_gcuLatency[unit].bankIdx, bankIdx);
+	semGive(g_gcuLatency[unit].sidLock);
+}
+
+void gcuLatencyShow(int unit) {
+	GcuLatencySummary summary[GCU_LATENCY_OP_NUM];
+	int num, i;
+	
+	num = GcuLatencySummaryGet(unit, summary, GCU_LATENCY_OP_NUM);
+	if (num == 0) {
+		printf("no latency statistics for unit %d\n", unit);
+		return;
+	}
+	
+	printf("unit %d, timeout %u ms\n", unit, g_gcuLatencyTimeoutUs / 1000);
+	printf("%-20s %7s %8s %8s %8s %10s %10s %10s\n",
+		   "OPCODE", "RESP", "TX", "RX", "TIMEOUT", "P50 US", "P99 US", "MAX US");
+	for (i = 0; i < num; i++) {
+		if (summary[i].numTx == 0)
+			continue;
+		
+		printf("%-20s %3s %04X %8u %8u %8u %10u %10u %10u%s\n",
+			   g_gcuLatencyOps[i].szName, SdlcGfDescGet(summary[i].respSrc)->szName,
+			   summary[i].respCode, summary[i].numTx, summary[i].numRx,
+			   summary[i].numTimeouts, summary[i].p50Us, summary[i].p99Us,
+			   summary[i].maxUs, summary[i].isPending ? " *" : "");
+	}
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <vxWorks.h>
+
+#include "../lib/util/isHist.h"
+#include "TmWait.h"
+
+/*
+ * Command -> response latency of each FG type and opcode, per GCU unit.
+ * An FG posted to SdlcSendGcu is stamped with its HwTime; the first frame
+ * of the response type received after it whose response word, masked
+ * with 0xFF00 as WAIT_RESPONSE does, is the expected one closes it with
+ * the HwTime of its receipt. An FG that is not answered within the
+ * timeout, or that is posted again before it is, counts as a timeout.
+ *
+ * Only the opcodes in the table of GcuLatency.c are matched; BulkXfer
+ * blocks keep their own round-trip statistics.
+ */
+#define GCU_LATENCY_OP_MAX			(32)
+#define GCU_LATENCY_TIMEOUT_MS		(1000)
+#define GCU_LATENCY_RESP_MASK		(0xFF00)
+
+/* One element of the mtsGcuLatency result vector. */
+typedef struct {
+	UINT16	opcode;			/* FG opcode */
+	UINT16	respCode;		/* expected response word, under GCU_LATENCY_RESP_MASK */
+	UINT8	respSrc;		/* response type, TM_WAIT_SRC_GFn */
+	UINT8	isPending;
+	UINT8	fgCmd;			/* SDLC_SEND_GCU_TX_FGn the FG is posted with */
+	UINT8	reserved;
+	UINT32	numTx;
+	UINT32	numRx;
+	UINT32	numTimeouts;
+	UINT32	p50Us;
+	UINT32	p99Us;
+	UINT32	maxUs;
+} GcuLatencySummary;
+
+IMPORT STATUS	GcuLatencyInit(void);
+IMPORT void		GcuLatencyTx(int unit, int fgCmd, UINT16 opcode, UINT64 timeNs);
+IMPORT void		GcuLatencyRx(int unit, TmWaitSrc type, UINT16 resp, UINT64 timeNs);
+IMPORT int		GcuLatencySummaryGet(int unit, GcuLatencySummary *pSummary, int maxNum);
+IMPORT STATUS	GcuLatencyConfig(int timeoutMs);
+IMPORT void		GcuLatencyReset(int unit);
+IMPORT void		gcuLatencyShow(int unit);
@@ -0,0 +1,189 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../lib/util/isDebug.h"
+#include "common.h"
+#include "Monitoring.h"
+#include "GcuUnit.h"
+
+#define GCU_UNIT_ITEM(n) \
+	{ n, n, NULL, NULL, &g_gcuUnitFrames[n].commSts, \
+	  &g_gcuUnitFrames[n].fg2, &g_gcuUnitFrames[n].fg3, \
+	  &g_gcuUnitFrames[n].fg5, &g_gcuUnitFrames[n].fg7 }
+
+/* Counters and FG frames of a unit whose send side is not bound yet. */
+typedef struct {
+	TM_COMM_STS	commSts;
+	TM_TYPE_FG2	fg2;
+	TM_TYPE_FG3	fg3;
+	TM_TYPE_FG5	fg5;
+	TM_TYPE_FG7	fg7;
+} GcuUnitFrames;
+
+LOCAL GcuUnitFrames g_gcuUnitFrames[GCU_UNIT_NUM];
+
+/* One item per unit served; add items here when GCU_UNIT_MAX grows. */
+LOCAL GcuUnit g_gcuUnit[GCU_UNIT_NUM] = {
+	GCU_UNIT_ITEM(0),
+#if GCU_UNIT_NUM > 1
+	GCU_UNIT_ITEM(1),
+#endif
+#if GCU_UNIT_NUM > 2
+	GCU_UNIT_ITEM(2),
+#endif
+#if GCU_UNIT_NUM > 3
+	GCU_UNIT_ITEM(3),
+#endif
+};
+
+#if GCU_UNIT_MAX > 4
+#error "g_gcuUnit has items for 4 units only."
+#endif
+
+LOCAL GcuUnitSendSpawn g_pfnGcuUnitSendSpawn = NULL;
+
+/*
+ * Called by tSdlcRecvGcu of unit 0 before any unit is spawned. Unit 0
+ * keeps g_pTmCommSts, which SdlcSendGcu counts its frames in.
+ */
+void GcuUnitInit(void) {
+	g_gcuUnit[0].pCommSts = g_pTmCommSts;
+	GcuUnitBindSend(0, g_hSdlcSendGcu, g_pTmFg2, g_pTmFg3, g_pTmFg5, g_pTmFg7);
+}
+
+/* NULL unless 0 <= unit < GCU_UNIT_NUM. */
+GcuUnit *GcuUnitGet(int unit) {
+	if ((unit < 0) || (unit >= GCU_UNIT_NUM))
+		return NULL;
+	
+	return &g_gcuUnit[unit];
+}
+
+STATUS GcuUnitBindRecv(int unit, const ModuleInst *hRecv) {
+	GcuUnit *pUnit = GcuUnitGet(unit);
+	
+	if (pUnit == NULL)
+		return ERROR;
+	
+	pUnit->hRecv = hRecv;
+	
+	return OK;
+}
+
+STATUS GcuUnitBindSend(int unit, const ModuleInst *hSend,
+					   TM_TYPE_FG2 *pTmFg2, TM_TYPE_FG3 *pTmFg3,
+					   TM_TYPE_FG5 *pTmFg5, TM_TYPE_FG7 *pTmFg7) {
+	GcuUnit *pUnit = GcuUnitGet(unit);
+	
+	if ((pUnit == NULL) || (hSend == NULL) || (pTmFg2 == NULL) ||
+		(pTmFg3 == NULL) || (pTmFg5 == NULL) || (pTmFg7 == NULL))
+		return ERROR;
+	
+	pUnit->pTmFg2 = pTmFg2;
+	pUnit->pTmFg3 = pTmFg3;
+	pUnit->pTmFg5 = pTmFg5;
+	pUnit->pTmFg7 = pTmFg7;
+	pUnit->hSend = hSend;
+	
+	return OK;
+}
+
+/* Called by SdlcSendGcu before tSdlcRecvGcu of unit 0 starts. */
+void GcuUnitSetSendSpawn(GcuUnitSendSpawn pfnSpawn) {
+	g_pfnGcuUnitSendSpawn = pfnSpawn;
+}
+
+/* Spawns the send module of the unit on its channel and binds it. */
+STATUS GcuUnitSpawnSend(int unit) {
+	GcuUnit *pUnit = GcuUnitGet(unit);
+	const ModuleInst *hSend = NULL;
+	TM_TYPE_FG2 *pTmFg2 = NULL;
+	TM_TYPE_FG3 *pTmFg3 = NULL;
+	TM_TYPE_FG5 *pTmFg5 = NULL;
+	TM_TYPE_FG7 *pTmFg7 = NULL;
+	
+	if (pUnit == NULL)
+		return ERROR;
+	
+	if (pUnit->hSend != NULL)
+		return OK;
+	
+	if (g_pfnGcuUnitSendSpawn == NULL) {
+		LOGMSG("No SdlcSendGcu spawn function for unit %d.\n", unit);
+		return ERROR;
+	}
+	
+	if (g_pfnGcuUnitSendSpawn(unit, pUnit->sdlcCh, &hSend,
+							  &pTmFg2, &pTmFg3, &pTmFg5, &pTmFg7) == ERROR) {
+		LOGMSG("SdlcSendGcu spawn of unit %d error!\n", unit);
+		return ERROR;
+	}
+	
+	return GcuUnitBindSend(unit, hSend, pTmFg2, pTmFg3, pTmFg5, pTmFg7);
+}
+
+/*
+ * Splits "name@n" into the command name and the unit. A name without
+ * a suffix is for unit 0; a bad suffix or an unserved unit is ERROR.
+ */
+STATUS GcuUnitSplitName(const char *szCmd, char *szName, int size, int *pUnit) {
+	const char *pSep = strchr(szCmd, GCU_UNIT_SEP);
+	char *pEnd;
+	long unit = 0;
+	int len;
+	
+	if (pSep != NULL) {
+		unit = strtol(pSep + 1, &pEnd, 10);
+		if ((pEnd == pSep + 1) || (*pEnd != '\0') || (GcuUnitGet((int)unit) == NULL))
+			return ERROR;
+		len = (int)(pSep - szCmd);
+	} else {
+		len = (int)strlen(szCmd);
+	}
+	
+	if (len >= size)
+		return ERROR;
+	
+	memcpy(szName, szCmd, len);
+	szName[len] = '\0';
+	*pUnit = (int)unit;
+	
+	return OK;
+}
+
+/* Posts cmd to tSdlcRecvGcu of every unit that runs one. */
+STATUS GcuUnitPostRecv(int cmd) {
+	STATUS nRet = OK;
+	int i;
+	
+	for (i = 0; i < GCU_UNIT_NUM; i++) {
+		if ((g_gcuUnit[i].hRecv != NULL) && (PostCmd(g_gcuUnit[i].hRecv, cmd) == ERROR))
+			nRet = ERROR;
+	}
+	
+	return nRet;
+}
+
+void gcuUnitShow(void) {
+	const GcuUnit *pUnit;
+	FrameRingStats stats;
+	UINT32 numFrames;
+	int i, src;
+	
+	printf("%4s %4s %4s %4s %10s %8s %8s\n",
+		   "UNIT", "CH", "RECV", "SEND", "FRAMES", "ADDR ERR", "CTRL ERR");
+	for (i = 0; i < GCU_UNIT_NUM; i++) {
+		pUnit = &g_gcuUnit[i];
+		
+		for (numFrames = 0, src = 0; src < TM_WAIT_SRC_TYPES; src++) {
+			FrameRingStatsGet(GCU_SRC(pUnit, src), &stats);
+			numFrames += stats.numFrames;
+		}
+		
+		printf("%4d %4d %4s %4s %10u %8u %8u\n", pUnit->unit, pUnit->sdlcCh,
+			   (pUnit->hRecv != NULL) ? "yes" : "-",
+			   (pUnit->hSend != NULL) ? "yes" : "-", numFrames,
+			   pUnit->pCommSts->wAddressErrCnt, pUnit->pCommSts->wControlErrCnt);
+	}
+}
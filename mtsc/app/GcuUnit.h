@@ -0,0 +1,73 @@
+#pragma once
+
+#include <vxWorks.h>
+
+#include "../lib/util/ModuleCommon.h"
+#include "typeDef/tmType/tmSts.h"
+#include "SdlcRecvGcu.h"
+#include "SdlcSendGcu.h"
+#include "TmWait.h"
+#include "FrameRing.h"
+
+/*
+ * One GCU under test, driven over SDLC channel sdlcCh by its own
+ * tSdlcRecvGcu instance and its own SdlcSendGcu instance. A command
+ * selects the unit with an "@n" suffix on its name ("mtsChkGf2@1");
+ * without one it runs on unit 0.
+ *
+ * GCU_UNIT_NUM units are served, unit n on SDLC channel n; a station
+ * build sets it to the number of channels it wires. tSdlcRecvGcu of unit
+ * 0 spawns the receive side of every other unit and, through the spawn
+ * function SdlcSendGcu registers with GcuUnitSetSendSpawn(), its send
+ * side, and binds the pair. Unit 0 is bound to g_hSdlcSendGcu. Until a
+ * unit is bound it has its own FG frames, but a post to it fails.
+ */
+#define GCU_UNIT_MAX			TM_WAIT_UNIT_MAX
+#ifndef GCU_UNIT_NUM
+#define GCU_UNIT_NUM			(1)
+#endif
+#if (GCU_UNIT_NUM < 1) || (GCU_UNIT_NUM > GCU_UNIT_MAX)
+#error "GCU_UNIT_NUM must be 1 to GCU_UNIT_MAX."
+#endif
+#define GCU_UNIT_SEP			'@'
+
+/* Source of frame type src (TM_WAIT_SRC_GFn) of the unit. */
+#define GCU_SRC(pUnit, src)		TM_WAIT_SRC((pUnit)->unit, src)
+
+/* Latest GFn of the unit, e.g. GCU_GF(pUnit, 2)->m_GCU_RESP. */
+#define GCU_GF(pUnit, n) \
+	((const TM_TYPE_GF##n *)FrameRingLatest(GCU_SRC(pUnit, TM_WAIT_SRC_GF##n)))
+
+/*
+ * Spawns the send module of unit on sdlcCh and returns its handle and the
+ * FG frames it sends from.
+ */
+typedef STATUS (*GcuUnitSendSpawn)(int unit, int sdlcCh, const ModuleInst **phSend,
+								   TM_TYPE_FG2 **ppTmFg2, TM_TYPE_FG3 **ppTmFg3,
+								   TM_TYPE_FG5 **ppTmFg5, TM_TYPE_FG7 **ppTmFg7);
+
+typedef struct {
+	int					unit;
+	int					sdlcCh;
+	const ModuleInst *	hRecv;			/* set once its tSdlcRecvGcu runs */
+	const ModuleInst *	hSend;			/* NULL until bound */
+	TM_COMM_STS *		pCommSts;
+	TM_TYPE_FG2 *		pTmFg2;
+	TM_TYPE_FG3 *		pTmFg3;
+	TM_TYPE_FG5 *		pTmFg5;
+	TM_TYPE_FG7 *		pTmFg7;
+	UINT64				rxTimeNs;		/* HwTime of the frame being handled */
+	UINT64				txTimeNs;		/* HwTime of the last FG posted */
+} GcuUnit;
+
+IMPORT void			GcuUnitInit(void);
+IMPORT GcuUnit *	GcuUnitGet(int unit);
+IMPORT STATUS		GcuUnitBindRecv(int unit, const ModuleInst *hRecv);
+IMPORT STATUS		GcuUnitBindSend(int unit, const ModuleInst *hSend,
+									TM_TYPE_FG2 *pTmFg2, TM_TYPE_FG3 *pTmFg3,
+									TM_TYPE_FG5 *pTmFg5, TM_TYPE_FG7 *pTmFg7);
+IMPORT void			GcuUnitSetSendSpawn(GcuUnitSendSpawn pfnSpawn);
+IMPORT STATUS		GcuUnitSpawnSend(int unit);
+IMPORT STATUS		GcuUnitSplitName(const char *szCmd, char *szName, int size, int *pUnit);
+IMPORT STATUS		GcuUnitPostRecv(int cmd);
+IMPORT void			gcuUnitShow(void);
@@ -0,0 +1,255 @@
+#include <semLib.h>
+#include <taskLib.h>
+#include <vxAtomicLib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "../lib/util/isDebug.h"
+#include "../lib/util/isClock.h"
+#include "../lib/mtsLib.h"
+#include "../drv/axiDio.h"
+#include "common.h"
+#include "HwTime.h"
+
+#define HW_TIME_NS_PER_SEC		((INT64)IS_CLOCK_NS_PER_SEC)
+#define HW_TIME_INIT_NONE		(0)
+#define HW_TIME_INIT_BUSY		(1)
+#define HW_TIME_INIT_DONE		(2)
+
+typedef struct {
+	HwTimePpsHook	pfnHook;
+	void *			arg;
+} HwTimePpsHookEntry;
+
+/*
+ * The PPS interrupt is the only writer of the discipline; readers copy
+ * it under seq, which is odd while an edge is being applied.
+ */
+typedef struct {
+	atomic32_t			initState;
+	SEM_ID				sidLock;		/* hook table */
+	volatile UINT32		seq;
+	BOOL				isLocked;
+	UINT32				numBadInRow;
+	UINT64				edgeCount;		/* counter at the last good edge */
+	UINT64				edgeNs;			/* its time, a whole second */
+	UINT64				periodNs;		/* counter ns per second */
+	HwTimeStats			stats;
+	HwTimePpsHookEntry	hook[HW_TIME_PPS_HOOK_MAX];
+} HwTime;
+
+LOCAL HwTime g_hwTime = { HW_TIME_INIT_NONE, SEM_ID_NULL, };
+
+LOCAL void applyEdge(UINT64 count, UINT64 edgeNs, UINT64 period) {
+	g_hwTime.seq++;
+	VX_MEM_BARRIER_W();
+	g_hwTime.edgeCount = count;
+	g_hwTime.edgeNs = edgeNs;
+	g_hwTime.periodNs = period;
+	g_hwTime.isLocked = TRUE;
+	VX_MEM_BARRIER_W();
+	g_hwTime.seq++;
+}
+
+/*
+ * An edge within the tolerance of a whole number of seconds after the
+ * last good one advances the discipline. After HW_TIME_PPS_RELOCK_EDGES
+ * bad edges in a row, e.g. once the PPS source is switched, the next
+ * edge is taken as a whole second of the time it lands on.
+ */
+LOCAL void hwTimePpsIsr(PPS_ISR_ARG arg) {
+	UINT64 count = HwTimeCount();
+	UINT64 elapsed, nSec, period, now;
+	UINT32 dev;
+	HwTimePpsHook pfnHook;
+	int i;
+	
+	g_hwTime.stats.numEdges++;
+	
+	elapsed = count - g_hwTime.edgeCount;
+	nSec = (elapsed + HW_TIME_NS_PER_SEC / 2) / HW_TIME_NS_PER_SEC;
+	period = (nSec == 0) ? 0 : elapsed / nSec;
+	dev = (UINT32)((period > HW_TIME_NS_PER_SEC) ?
+				   period - HW_TIME_NS_PER_SEC : HW_TIME_NS_PER_SEC - period);
+	
+	if (g_hwTime.isLocked && (nSec != 0) && (dev <= HW_TIME_PPS_TOLERANCE_NS)) {
+		applyEdge(count, g_hwTime.edgeNs + nSec * HW_TIME_NS_PER_SEC, period);
+		g_hwTime.numBadInRow = 0;
+		g_hwTime.stats.numMissed += (UINT32)(nSec - 1);
+		g_hwTime.stats.periodNs = period;
+		isHistAdd(&g_hwTime.stats.jitterNs, dev);
+	} else if (!g_hwTime.isLocked ||
+			   (++g_hwTime.numBadInRow >= HW_TIME_PPS_RELOCK_EDGES)) {
+		now = HwTimeToNs(count);
+		applyEdge(count,
+				  ((now + HW_TIME_NS_PER_SEC / 2) / HW_TIME_NS_PER_SEC) * HW_TIME_NS_PER_SEC,
+				  g_hwTime.isLocked ? g_hwTime.periodNs : HW_TIME_NS_PER_SEC);
+		g_hwTime.numBadInRow = 0;
+		g_hwTime.stats.numRelocks++;
+	} else {
+		g_hwTime.stats.numGlitches++;
+	}
+	
+	for (i = 0; i < HW_TIME_PPS_HOOK_MAX; i++) {
+		if ((pfnHook = g_hwTime.hook[i].pfnHook) != NULL)
+			pfnHook(g_hwTime.hook[i].arg);
+	}
+}
+
+/*
+ * Takes over the PPS interrupt; called by each module that uses HwTime,
+ * from tasks that may start together. The first caller initialises, the
+ * others wait for its result; after a failure the next call tries again.
+ */
+STATUS HwTimeInit(void) {
+	SEM_ID sidLock;
+	
+	if (vxAtomic32Cas(&g_hwTime.initState, HW_TIME_INIT_NONE, HW_TIME_INIT_BUSY) == FALSE) {
+		while (vxAtomic32Get(&g_hwTime.initState) == HW_TIME_INIT_BUSY)
+			taskDelay(1);
+		
+		return (vxAtomic32Get(&g_hwTime.initState) == HW_TIME_INIT_DONE) ? OK : ERROR;
+	}
+	
+	isHistReset(&g_hwTime.stats.jitterNs);
+	
+	sidLock = semMCreate(SEM_Q_PRIORITY | SEM_DELETE_SAFE | SEM_INVERSION_SAFE);
+	if (sidLock == SEM_ID_NULL) {
+		LOGMSG("semMCreate() error!\n");
+		vxAtomic32Set(&g_hwTime.initState, HW_TIME_INIT_NONE);
+		return ERROR;
+	}
+	
+	if (axiDioSetPpsIsr(hwTimePpsIsr, NULL) == ERROR) {
+		LOGMSG("axiDioSetPpsIsr() error!\n");
+		semDelete(sidLock);
+		vxAtomic32Set(&g_hwTime.initState, HW_TIME_INIT_NONE);
+		return ERROR;
+	}
+	
+	if (mtsLibPpsIntEn(TRUE) == ERROR) {
+		LOGMSG("mtsLibPpsIntEn(TRUE) error!\n");
+		semDelete(sidLock);
+		vxAtomic32Set(&g_hwTime.initState, HW_TIME_INIT_NONE);
+		return ERROR;
+	}
+	
+	/* Published last: the hook functions take it once it is set. */
+	g_hwTime.sidLock = sidLock;
+	vxAtomic32Set(&g_hwTime.initState, HW_TIME_INIT_DONE);
+	
+	return OK;
+}
+
+/* Raw free-running count in ns; cheap enough for an interrupt. */
+UINT64 HwTimeCount(void) {
+	return isClockNs();
+}
+
+/*
+ * PPS-disciplined time of a count: the seconds of the last edge plus the
+ * count since, rescaled from the measured period to 1 s. A count taken
+ * just before an edge and converted after it comes out negative relative
+ * to the edge, which the signed arithmetic handles.
+ */
+UINT64 HwTimeToNs(UINT64 count) {
+	UINT64 edgeCount, edgeNs, period;
+	BOOL isLocked;
+	UINT32 seq;
+	INT64 delta;
+	
+	do {
+		seq = g_hwTime.seq;
+		VX_MEM_BARRIER_R();
+		isLocked = g_hwTime.isLocked;
+		edgeCount = g_hwTime.edgeCount;
+		edgeNs = g_hwTime.edgeNs;
+		period = g_hwTime.periodNs;
+		VX_MEM_BARRIER_R();
+	} while ((seq & 1) || (g_hwTime.seq != seq));
+	
+	if (!isLocked)
+		return count;
+	
+	delta = (INT64)(count - edgeCount);
+	
+	return (UINT64)((INT64)edgeNs + delta +
+					delta * (HW_TIME_NS_PER_SEC - (INT64)period) / (INT64)period);
+}
+
+UINT64 HwTimeNow(void) {
+	return HwTimeToNs(HwTimeCount());
+}
+
+/* pfnHook runs in the PPS interrupt after the discipline is updated. */
+STATUS HwTimePpsHookAdd(HwTimePpsHook pfnHook, void *arg) {
+	STATUS nRet = ERROR;
+	int i;
+	
+	if ((pfnHook == NULL) || (g_hwTime.sidLock == SEM_ID_NULL))
+		return ERROR;
+	
+	semTake(g_hwTime.sidLock, WAIT_FOREVER);
+	for (i = 0; i < HW_TIME_PPS_HOOK_MAX; i++) {
+		if (g_hwTime.hook[i].pfnHook == pfnHook) {
+			nRet = OK;
+			break;
+		}
+	}
+	for (i = 0; (nRet == ERROR) && (i < HW_TIME_PPS_HOOK_MAX); i++) {
+		if (g_hwTime.hook[i].pfnHook == NULL) {
+			g_hwTime.hook[i].arg = arg;
+			VX_MEM_BARRIER_W();
+			g_hwTime.hook[i].pfnHook = pfnHook;
+			nRet = OK;
+		}
+	}
+	semGive(g_hwTime.sidLock);
+	
+	return nRet;
+}
+
+STATUS HwTimePpsHookRemove(HwTimePpsHook pfnHook) {
+	STATUS nRet = ERROR;
+	int i;
+	
+	if (g_hwTime.sidLock == SEM_ID_NULL)
+		return ERROR;
+	
+	semTake(g_hwTime.sidLock, WAIT_FOREVER);
+	for (i = 0; i < HW_TIME_PPS_HOOK_MAX; i++) {
+		if (g_hwTime.hook[i].pfnHook == pfnHook) {
+			g_hwTime.hook[i].pfnHook = NULL;
+			nRet = OK;
+		}
+	}
+	semGive(g_hwTime.sidLock);
+	
+	return nRet;
+}
+
+void HwTimeStatsGet(HwTimeStats *pStats) {
+	*pStats = g_hwTime.stats;
+}
+
+void hwTimeShow(void) {
+	HwTimeStats stats;
+	UINT64 count = HwTimeCount();
+	int i;
+	
+	HwTimeStatsGet(&stats);
+	
+	printf("%s, now %llu ns (count %llu)\n",
+		   g_hwTime.isLocked ? "PPS locked" : "free-running",
+		   (unsigned long long)HwTimeToNs(count), (unsigned long long)count);
+	printf(" edges            : %u (%u glitches, %u relocks, %u seconds missed)\n",
+		   stats.numEdges, stats.numGlitches, stats.numRelocks, stats.numMissed);
+	printf(" period           : %llu ns (%+lld ppb)\n", (unsigned long long)stats.periodNs,
+		   stats.periodNs ? (long long)stats.periodNs - HW_TIME_NS_PER_SEC : 0LL);
+	for (i = 0; i < HW_TIME_PPS_HOOK_MAX; i++) {
+		if (g_hwTime.hook[i].pfnHook != NULL)
+			printf(" hook %d           : %p\n", i, (void *)g_hwTime.hook[i].pfnHook);
+	}
+	if (stats.jitterNs.count > 0)
+		isHistShow(&stats.jitterNs, "PPS period error (ns)");
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <vxWorks.h>
+
+#include "../lib/util/isHist.h"
+
+/*
+ * Nanosecond timestamps for frames and log records. A free-running
+ * counter (isClockNs()) is read as close to the event as possible and
+ * mapped onto PPS-disciplined time by HwTimeToNs(): whole seconds are
+ * counted in PPS edges and the fraction is scaled by the counter rate
+ * measured over the last second, so counter drift does not accumulate.
+ * Until the first PPS edge the counter is used as is; after a run of
+ * bad edges, e.g. a switch of the PPS source, the discipline realigns.
+ *
+ * HwTime owns the axiDio PPS interrupt. Others that need the edge hook
+ * into it with HwTimePpsHookAdd(); hooks run at interrupt level.
+ */
+#define HW_TIME_PPS_HOOK_MAX		(4)
+#define HW_TIME_PPS_TOLERANCE_NS	(1000000)	/* period beyond 1 s +- this is a glitch */
+#define HW_TIME_PPS_RELOCK_EDGES	(3)
+
+typedef void (*HwTimePpsHook)(void *arg);
+
+typedef struct {
+	UINT32	numEdges;
+	UINT32	numGlitches;		/* edges outside the tolerance, ignored */
+	UINT32	numRelocks;			/* first edge, or realigned after glitches */
+	UINT32	numMissed;			/* seconds without an edge */
+	UINT64	periodNs;			/* counter ns per PPS second */
+	IsHist	jitterNs;			/* |period - 1 s| */
+} HwTimeStats;
+
+IMPORT STATUS	HwTimeInit(void);
+IMPORT UINT64	HwTimeCount(void);
+IMPORT UINT64	HwTimeToNs(UINT64 count);
+IMPORT UINT64	HwTimeNow(void);
+IMPORT STATUS	HwTimePpsHookAdd(HwTimePpsHook pfnHook, void *arg);
+IMPORT STATUS	HwTimePpsHookRemove(HwTimePpsHook pfnHook);
+IMPORT void		HwTimeStatsGet(HwTimeStats *pStats);
+IMPORT void		hwTimeShow(void);
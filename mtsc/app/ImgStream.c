@@ -0,0 +1,166 @@
+#include <taskLib.h>
+#include <semLib.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../lib/util/isDebug.h"
+#include "../lib/util/isClock.h"
+#include "../lib/util/isCksum.h"
+#include "common.h"
+#include "ImgStream.h"
+
+#define IMG_STREAM_TASK_NAME		"tImgStream"
+#define IMG_STREAM_PRIORITY			(100)
+#define IMG_STREAM_STACK_SIZE		(20000)
+
+LOCAL void imgStreamReader(ImgStream *pStream);
+
+LOCAL void imgStreamReader(ImgStream *pStream) {
+	int wrIdx = 0;
+	int len;
+	UINT64 tStart;
+	
+	FOREVER {
+		semTake(pStream->sidFree, WAIT_FOREVER);
+		if (pStream->quitReq)
+			break;
+	
+		tStart = isClockNs();
+		len = fread(pStream->pBuf[wrIdx], 1, IMG_STREAM_CHUNK_BYTES, pStream->fpFile);
+		if ((len < IMG_STREAM_CHUNK_BYTES) && ferror(pStream->fpFile))
+			len = -1;
+		pStream->readUs += isClockNsToUs(isClockNs() - tStart);
+	
+		if (len > 0) {
+			isCksumUpdate(&pStream->cksum, pStream->pBuf[wrIdx], len);
+			pStream->totalBytes += len;
+		}
+	
+		pStream->len[wrIdx] = len;
+		semGive(pStream->sidFull);
+	
+		if (len < IMG_STREAM_CHUNK_BYTES) {
+			if (len >= 0)
+				isCksumFinal(&pStream->cksum);
+			break;
+		}
+	
+		wrIdx = (wrIdx + 1) % IMG_STREAM_NUM_BUFS;
+	}
+	
+	semGive(pStream->sidDone);
+}
+
+STATUS ImgStreamOpen(ImgStream *pStream, const char *szFile) {
+	int i;
+	
+	memset(pStream, 0, sizeof(ImgStream));
+	strncpy(pStream->szFile, szFile, sizeof(pStream->szFile) - 1);
+	isCksumInit(&pStream->cksum, IS_CKSUM_SUM | IS_CKSUM_CRC32);
+	
+	if ((pStream->fpFile = fopen(szFile, "rb")) == NULL) {
+		LOGMSG("fopen(%s) error!\n", szFile);
+		return ERROR;
+	}
+	
+	for (i = 0; i < IMG_STREAM_NUM_BUFS; i++) {
+		if ((pStream->pBuf[i] = (char *)malloc(IMG_STREAM_CHUNK_BYTES)) == NULL) {
+			LOGMSG("malloc(%d) error!\n", IMG_STREAM_CHUNK_BYTES);
+			ImgStreamClose(pStream);
+			return ERROR;
+		}
+	}
+	
+	pStream->sidFree = semCCreate(SEM_Q_FIFO, IMG_STREAM_NUM_BUFS);
+	pStream->sidFull = semCCreate(SEM_Q_FIFO, 0);
+	pStream->sidDone = semBCreate(SEM_Q_FIFO, SEM_EMPTY);
+	if ((pStream->sidFree == SEM_ID_NULL) || (pStream->sidFull == SEM_ID_NULL) ||
+		(pStream->sidDone == SEM_ID_NULL)) {
+		LOGMSG("semCreate() error!\n");
+		ImgStreamClose(pStream);
+		return ERROR;
+	}
+	
+	pStream->tidReader = taskSpawn(IMG_STREAM_TASK_NAME, IMG_STREAM_PRIORITY, 0,
+								   IMG_STREAM_STACK_SIZE, (FUNCPTR)imgStreamReader,
+								   (_Vx_usr_arg_t)pStream, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+	if (pStream->tidReader == TASK_ID_ERROR) {
+		LOGMSG("taskSpawn(%s) error!\n", IMG_STREAM_TASK_NAME);
+		pStream->tidReader = TASK_ID_NULL;
+		ImgStreamClose(pStream);
+		return ERROR;
+	}
+	
+	return OK;
+}
+
+/*
+ * Waits for the next chunk. A chunk shorter than IMG_STREAM_CHUNK_BYTES
+ * (possibly empty) is the last one. It stays valid until
+ * ImgStreamRelease(), while the reader fills the other buffer.
+ */
+STATUS ImgStreamNext(ImgStream *pStream, const void **ppData, int *pNumBytes) {
+	UINT64 tStart = isClockNs();
+	
+	*ppData = NULL;
+	*pNumBytes = 0;
+	
+	if (semTake(pStream->sidFull, GET_DELAY_TICK(IMG_STREAM_WAIT_MS)) == ERROR) {
+		LOGMSG("%s : read timeout.\n", pStream->szFile);
+		return ERROR;
+	}
+	pStream->stallUs += isClockNsToUs(isClockNs() - tStart);
+	
+	if (pStream->len[pStream->rdIdx] < 0) {
+		LOGMSG("%s : read error.\n", pStream->szFile);
+		return ERROR;
+	}
+	
+	*ppData = pStream->pBuf[pStream->rdIdx];
+	*pNumBytes = pStream->len[pStream->rdIdx];
+	if (*pNumBytes > 0)
+		pStream->numChunks++;
+	
+	return OK;
+}
+
+void ImgStreamRelease(ImgStream *pStream) {
+	pStream->rdIdx = (pStream->rdIdx + 1) % IMG_STREAM_NUM_BUFS;
+	semGive(pStream->sidFree);
+}
+
+/* Safe on a partly opened stream and before the reader reaches EOF. */
+void ImgStreamClose(ImgStream *pStream) {
+	int i;
+	
+	if (pStream->tidReader != TASK_ID_NULL) {
+		pStream->quitReq = TRUE;
+		semGive(pStream->sidFree);
+	
+		if (semTake(pStream->sidDone, GET_DELAY_TICK(IMG_STREAM_WAIT_MS)) == ERROR) {
+			LOGMSG("%s : reader did not stop.\n", pStream->szFile);
+			taskDelete(pStream->tidReader);
+		}
+		pStream->tidReader = TASK_ID_NULL;
+	}
+	
+	if (pStream->sidDone != SEM_ID_NULL)
+		semDelete(pStream->sidDone);
+	if (pStream->sidFull != SEM_ID_NULL)
+		semDelete(pStream->sidFull);
+	if (pStream->sidFree != SEM_ID_NULL)
+		semDelete(pStream->sidFree);
+	pStream->sidDone = pStream->sidFull = pStream->sidFree = SEM_ID_NULL;
+	
+	for (i = 0; i < IMG_STREAM_NUM_BUFS; i++) {
+		free(pStream->pBuf[i]);
+		pStream->pBuf[i] = NULL;
+	}
+	
+	if (pStream->fpFile != NULL) {
+		if (fclose(pStream->fpFile) == EOF)
+			LOGMSG("fclose(%s) error!\n", pStream->szFile);
+		pStream->fpFile = NULL;
+	}
+}
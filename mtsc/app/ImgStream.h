@@ -0,0 +1,44 @@
+#pragma once
+
+#include <vxWorks.h>
+#include <semLib.h>
+#include <stdio.h>
+
+#include "../lib/util/isCksum.h"
+#include "BulkXfer.h"
+
+/*
+ * Double-buffered file reader for image uploads. A reader task fills one
+ * chunk while the caller transmits the other, and keeps the running
+ * size and digests of everything read so far.
+ *
+ * A chunk is a whole number of FG3-3 blocks, so each one can be handed
+ * to BulkXferRun() as is with firstBlock advanced by the blocks sent.
+ */
+#define IMG_STREAM_CHUNK_BLOCKS		(512)
+#define IMG_STREAM_CHUNK_BYTES		(IMG_STREAM_CHUNK_BLOCKS * BULK_XFER_WORDS_PER_BLOCK * 2)
+#define IMG_STREAM_NUM_BUFS			(2)
+#define IMG_STREAM_WAIT_MS			(5000)
+
+typedef struct {
+	char			szFile[64];
+	FILE *			fpFile;
+	TASK_ID			tidReader;
+	SEM_ID			sidFree;
+	SEM_ID			sidFull;
+	SEM_ID			sidDone;
+	volatile BOOL	quitReq;
+	char *			pBuf[IMG_STREAM_NUM_BUFS];
+	volatile int	len[IMG_STREAM_NUM_BUFS];	/* 0 at EOF, -1 on read error */
+	int				rdIdx;
+	volatile int	totalBytes;
+	IsCksum			cksum;		/* sum and CRC-32, final once the last chunk is read */
+	int				numChunks;
+	UINT32			readUs;		/* reader time spent in fread() */
+	UINT32			stallUs;	/* caller time spent waiting for a chunk */
+} ImgStream;
+
+IMPORT STATUS	ImgStreamOpen(ImgStream *pStream, const char *szFile);
+IMPORT STATUS	ImgStreamNext(ImgStream *pStream, const void **ppData, int *pNumBytes);
+IMPORT void		ImgStreamRelease(ImgStream *pStream);
+IMPORT void		ImgStreamClose(ImgStream *pStream);
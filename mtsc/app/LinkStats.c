@@ -0,0 +1,422 @@
+#include <semLib.h>
+#include <taskLib.h>
+#include <stdio.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "../lib/util/isDebug.h"
+#include "../lib/util/isClock.h"
+#include "../drv/axiSdlc.h"
+#include "common.h"
+#include "typeDef/tmType/tmSts.h"
+#include "SdlcGfTbl.h"
+#include "GcuUnit.h"
+#include "HwTime.h"
+#include "LinkStats.h"
+
+#define LINK_STATS_TX_CNT(n) \
+	{ "FG" #n, offsetof(TM_COMM_STS, wFg##n##TxCnt), offsetof(TM_COMM_STS, wFg##n##TxErrCnt) }
+#define LINK_STATS_AVG_SHIFT	(3)		/* the newest interval weighs 1/8 */
+#define LINK_STATS_READ_SPINS	(16)	/* copy attempts before readRxLocked() sleeps */
+
+typedef struct {
+	const char *	szName;
+	UINT16			cntOffset;
+	UINT16			errCntOffset;
+} LinkStatsTxCnt;
+
+typedef struct {
+	UINT64	numFrames;
+	UINT64	numBytes;
+	UINT64	numSizeErrs;
+	UINT64	numOpErrs;
+	UINT64	numGaps;
+	UINT64	numMissed;
+	UINT64	tFirstNs;
+	UINT64	tLastNs;
+	UINT64	avgNs;				/* moving average of the intervals */
+	IsHist	interUs;
+	IsHist	jitterUs;
+} LinkStatsRxType;
+
+typedef struct {
+	UINT64			numAddrErrs;
+	UINT64			numCtrlErrs;
+	UINT64			numLenErrs;
+	LinkStatsRxType	type[TM_WAIT_SRC_TYPES];
+} LinkStatsRxSide;
+
+/*
+ * rx is written by tSdlcRecvGcu of the unit only. A reset is requested
+ * by bumping resetReq and applied by the next update; until then readers
+ * report the receive side as cleared.
+ */
+typedef struct {
+	volatile UINT32	seq;			/* odd while tSdlcRecvGcu updates rx */
+	volatile UINT32	resetReq;
+	UINT32			resetDone;
+	LinkStatsRxSide	rx;
+	SEM_ID			sidLock;		/* the members below */
+	LinkStatsRxSide	copy;			/* rx as last read */
+	UINT16			txLast[LINK_STATS_TX_TYPES];
+	UINT16			txErrLast[LINK_STATS_TX_TYPES];
+	UINT32			crcLast;
+	UINT64			numTx[LINK_STATS_TX_TYPES];
+	UINT64			numTxErrs[LINK_STATS_TX_TYPES];
+	UINT64			numCrcErrs;
+} LinkStatsUnit;
+
+LOCAL const LinkStatsTxCnt g_linkStatsTxCnts[LINK_STATS_TX_TYPES] = {
+	LINK_STATS_TX_CNT(2),
+	LINK_STATS_TX_CNT(3),
+	LINK_STATS_TX_CNT(5),
+	LINK_STATS_TX_CNT(6),
+	LINK_STATS_TX_CNT(7),
+};
+
+LOCAL LinkStatsUnit g_linkStats[GCU_UNIT_MAX];
+
+/* Expected period of each type; 0 learns it. */
+LOCAL UINT32 g_linkStatsPeriodUs[TM_WAIT_SRC_TYPES];
+
+LOCAL void clearRx(LinkStatsRxSide *pRx) {
+	int i;
+	
+	memset(pRx, 0, sizeof(LinkStatsRxSide));
+	for (i = 0; i < TM_WAIT_SRC_TYPES; i++) {
+		isHistReset(&pRx->type[i].interUs);
+		isHistReset(&pRx->type[i].jitterUs);
+	}
+}
+
+LOCAL UINT32 expectedUs(const LinkStatsRxType *pType, int type, BOOL *pIsLearnt) {
+	*pIsLearnt = (g_linkStatsPeriodUs[type] == 0);
+	if (!*pIsLearnt)
+		return g_linkStatsPeriodUs[type];
+	
+	return (pType->numFrames > LINK_STATS_LEARN_FRAMES) ?
+		isClockNsToUs(pType->avgNs) : 0;
+}
+
+LOCAL LinkStatsUnit *beginUpdate(int unit) {
+	LinkStatsUnit *pStats;
+	UINT32 resetReq;
+	
+	if ((unit < 0) || (unit >= GCU_UNIT_MAX) || (g_linkStats[unit].sidLock == SEM_ID_NULL))
+		return NULL;
+	
+	pStats = &g_linkStats[unit];
+	pStats->seq++;
+	VX_MEM_BARRIER_W();
+	if ((resetReq = pStats->resetReq) != pStats->resetDone) {
+		clearRx(&pStats->rx);
+		pStats->resetDone = resetReq;
+	}
+	
+	return pStats;
+}
+
+LOCAL void endUpdate(LinkStatsUnit *pStats) {
+	VX_MEM_BARRIER_W();
+	pStats->seq++;
+}
+
+/* Called with sidLock of the unit held. */
+LOCAL void sampleLocked(LinkStatsUnit *pStats, GcuUnit *pUnit) {
+	const char *pCommSts = (const char *)pUnit->pCommSts;
+	UINT16 cnt;
+	UINT32 crc;
+	int i;
+	
+	for (i = 0; i < LINK_STATS_TX_TYPES; i++) {
+		cnt = *(const volatile UINT16 *)(pCommSts + g_linkStatsTxCnts[i].cntOffset);
+		pStats->numTx[i] += (UINT16)(cnt - pStats->txLast[i]);
+		pStats->txLast[i] = cnt;
+		
+		cnt = *(const volatile UINT16 *)(pCommSts + g_linkStatsTxCnts[i].errCntOffset);
+		pStats->numTxErrs[i] += (UINT16)(cnt - pStats->txErrLast[i]);
+		pStats->txErrLast[i] = cnt;
+	}
+	
+	crc = axiSdlcGetRxCrcCnt(pUnit->sdlcCh);
+	pStats->numCrcErrs += crc - pStats->crcLast;
+	pStats->crcLast = crc;
+	pUnit->pCommSts->wCrcErrCnt = (UINT16)crc;
+}
+
+/*
+ * Called with sidLock of the unit held; retries like FrameRingRead().
+ * An odd seq may be a receive task preempted by this one mid-update, which
+ * on a uniprocessor only finishes once this task sleeps: after
+ * LINK_STATS_READ_SPINS tries each retry waits a tick, long enough for a
+ * writer of any priority.
+ */
+LOCAL void readRxLocked(LinkStatsUnit *pStats) {
+	UINT32 seq;
+	int numTries = 0;
+	
+	for (;;) {
+		seq = pStats->seq;
+		VX_MEM_BARRIER_R();
+		if ((seq & 1) == 0) {
+			pStats->copy = pStats->rx;
+			VX_MEM_BARRIER_R();
+			if (pStats->seq == seq)
+				break;
+		}
+		if (++numTries >= LINK_STATS_READ_SPINS)
+			taskDelay(1);
+	}
+	
+	if (pStats->resetReq != pStats->resetDone)
+		clearRx(&pStats->copy);
+}
+
+STATUS LinkStatsInit(void) {
+	int unit;
+	
+	for (unit = 0; unit < GCU_UNIT_MAX; unit++) {
+		if (g_linkStats[unit].sidLock != SEM_ID_NULL)
+			continue;
+		
+		clearRx(&g_linkStats[unit].rx);
+		clearRx(&g_linkStats[unit].copy);
+		
+		g_linkStats[unit].sidLock =
+			semMCreate(SEM_Q_PRIORITY | SEM_DELETE_SAFE | SEM_INVERSION_SAFE);
+		if (g_linkStats[unit].sidLock == SEM_ID_NULL) {
+			LOGMSG("semMCreate() error!\n");
+			return ERROR;
+		}
+		
+		LinkStatsReset(unit);
+	}
+	
+	return OK;
+}
+
+/*
+ * Called by tSdlcRecvGcu for every frame of its type's size, with the
+ * HwTime of its receipt.
+ */
+void LinkStatsRx(int unit, TmWaitSrc type, UINT32 size, UINT64 timeNs) {
+	LinkStatsUnit *pStats;
+	LinkStatsRxType *pType;
+	UINT64 dtNs, sampleNs;
+	UINT32 dtUs, expUs;
+	BOOL isLearnt;
+	
+	if ((type >= TM_WAIT_SRC_TYPES) || ((pStats = beginUpdate(unit)) == NULL))
+		return;
+	
+	pType = &pStats->rx.type[type];
+	if (pType->numFrames == 0) {
+		pType->tFirstNs = timeNs;
+	} else if (timeNs > pType->tLastNs) {
+		dtNs = timeNs - pType->tLastNs;
+		dtUs = isClockNsToUs(dtNs);
+		isHistAdd(&pType->interUs, dtUs);
+		
+		expUs = expectedUs(pType, type, &isLearnt);
+		if ((expUs != 0) && (expUs != LINK_STATS_PERIOD_NONE)) {
+			if ((UINT64)dtUs * 100 > (UINT64)expUs * LINK_STATS_GAP_PCT) {
+				pType->numGaps++;
+				pType->numMissed += (dtUs + expUs / 2) / expUs - 1;
+			} else {
+				isHistAdd(&pType->jitterUs, (dtUs > expUs) ? dtUs - expUs : expUs - dtUs);
+			}
+		}
+		
+		/* A gap moves the average by an eighth of itself at most. */
+		sampleNs = ((pType->avgNs != 0) && (dtNs > 2 * pType->avgNs)) ?
+			2 * pType->avgNs : dtNs;
+		if (pType->numFrames == 1)
+			pType->avgNs = dtNs;
+		else if (sampleNs >= pType->avgNs)
+			pType->avgNs += (sampleNs - pType->avgNs) >> LINK_STATS_AVG_SHIFT;
+		else
+			pType->avgNs -= (pType->avgNs - sampleNs) >> LINK_STATS_AVG_SHIFT;
+	}
+	pType->tLastNs = timeNs;
+	pType->numFrames++;
+	pType->numBytes += size;
+	
+	endUpdate(pStats);
+}
+
+/* Called by tSdlcRecvGcu; type is used by the errors of a frame type only. */
+void LinkStatsError(int unit, LinkStatsErr err, TmWaitSrc type) {
+	LinkStatsUnit *pStats;
+	
+	if ((pStats = beginUpdate(unit)) == NULL)
+		return;
+	
+	switch (err) {
+	case LINK_STATS_ERR_ADDRESS:
+		pStats->rx.numAddrErrs++;
+		break;
+	case LINK_STATS_ERR_CONTROL:
+		pStats->rx.numCtrlErrs++;
+		break;
+	case LINK_STATS_ERR_LENGTH:
+		pStats->rx.numLenErrs++;
+		break;
+	case LINK_STATS_ERR_SIZE:
+		if (type < TM_WAIT_SRC_TYPES)
+			pStats->rx.type[type].numSizeErrs++;
+		break;
+	case LINK_STATS_ERR_OPCODE:
+		if (type < TM_WAIT_SRC_TYPES)
+			pStats->rx.type[type].numOpErrs++;
+		break;
+	}
+	
+	endUpdate(pStats);
+}
+
+/* Widens the send side counters; each must move less than 64K in between. */
+void LinkStatsSample(int unit) {
+	GcuUnit *pUnit = GcuUnitGet(unit);
+	
+	if ((pUnit == NULL) || (g_linkStats[unit].sidLock == SEM_ID_NULL))
+		return;
+	
+	semTake(g_linkStats[unit].sidLock, WAIT_FOREVER);
+	sampleLocked(&g_linkStats[unit], pUnit);
+	semGive(g_linkStats[unit].sidLock);
+}
+
+STATUS LinkStatsGet(int unit, LinkStatsLinkSummary *pLink,
+					LinkStatsRxSummary *pRx, int maxRx) {
+	GcuUnit *pUnit = GcuUnitGet(unit);
+	LinkStatsUnit *pStats;
+	const LinkStatsRxType *pType;
+	LinkStatsRxSummary *pSummary;
+	BOOL isLearnt;
+	int i;
+	
+	if ((pUnit == NULL) || (g_linkStats[unit].sidLock == SEM_ID_NULL))
+		return ERROR;
+	
+	pStats = &g_linkStats[unit];
+	
+	semTake(pStats->sidLock, WAIT_FOREVER);
+	sampleLocked(pStats, pUnit);
+	readRxLocked(pStats);
+	
+	memset(pLink, 0, sizeof(LinkStatsLinkSummary));
+	pLink->unit = (UINT16)unit;
+	pLink->numRxTypes = (UINT8)((maxRx < TM_WAIT_SRC_TYPES) ? maxRx : TM_WAIT_SRC_TYPES);
+	pLink->numTxTypes = LINK_STATS_TX_TYPES;
+	pLink->timeNs = HwTimeNow();
+	pLink->numAddrErrs = pStats->copy.numAddrErrs;
+	pLink->numCtrlErrs = pStats->copy.numCtrlErrs;
+	pLink->numLenErrs = pStats->copy.numLenErrs;
+	pLink->numCrcErrs = pStats->numCrcErrs;
+	for (i = 0; i < LINK_STATS_TX_TYPES; i++) {
+		pLink->numTx[i] = pStats->numTx[i];
+		pLink->numTxErrs[i] = pStats->numTxErrs[i];
+	}
+	
+	for (i = 0; i < pLink->numRxTypes; i++) {
+		pType = &pStats->copy.type[i];
+		pSummary = &pRx[i];
+		memset(pSummary, 0, sizeof(LinkStatsRxSummary));
+		pSummary->type = (UINT8)i;
+		pSummary->periodUs = expectedUs(pType, i, &isLearnt);
+		pSummary->isLearnt = isLearnt;
+		pSummary->numFrames = pType->numFrames;
+		pSummary->numBytes = pType->numBytes;
+		pSummary->numSizeErrs = pType->numSizeErrs;
+		pSummary->numOpErrs = pType->numOpErrs;
+		pSummary->numGaps = pType->numGaps;
+		pSummary->numMissed = pType->numMissed;
+		pSummary->tFirstNs = pType->tFirstNs;
+		pSummary->tLastNs = pType->tLastNs;
+		pSummary->rateMilliHz = (pType->avgNs != 0) ?
+			(UINT32)(1000ULL * IS_CLOCK_NS_PER_SEC / pType->avgNs) : 0;
+		pSummary->interP50Us = isHistPercentile(&pType->interUs, 50);
+		pSummary->interP99Us = isHistPercentile(&pType->interUs, 99);
+		pSummary->interMaxUs = pType->interUs.max;
+		pSummary->jitterP50Us = isHistPercentile(&pType->jitterUs, 50);
+		pSummary->jitterP99Us = isHistPercentile(&pType->jitterUs, 99);
+		pSummary->jitterMaxUs = pType->jitterUs.max;
+	}
+	semGive(pStats->sidLock);
+	
+	return OK;
+}
+
+/*
+ * Expected period of frame type (TM_WAIT_SRC_GFn) for every unit: 0
+ * learns it, LINK_STATS_PERIOD_NONE turns gap detection off.
+ */
+STATUS LinkStatsConfig(int type, UINT32 periodUs) {
+	if ((type < 0) || (type >= TM_WAIT_SRC_TYPES))
+		return ERROR;
+	
+	g_linkStatsPeriodUs[type] = periodUs;
+	
+	return OK;
+}
+
+void LinkStatsReset(int unit) {
+	GcuUnit *pUnit = GcuUnitGet(unit);
+	LinkStatsUnit *pStats;
+	
+	if ((pUnit == NULL) || (g_linkStats[unit].sidLock == SEM_ID_NULL))
+		return;
+	
+	pStats = &g_linkStats[unit];
+	
+	semTake(pStats->sidLock, WAIT_FOREVER);
+	pStats->resetReq++;
+	sampleLocked(pStats, pUnit);
+	memset(pStats->numTx, 0, sizeof(pStats->numTx));
+	memset(pStats->numTxErrs, 0, sizeof(pStats->numTxErrs));
+	pStats->numCrcErrs = 0;
+	semGive(pStats->sidLock);
+}
+
+void linkStatsShow(int unit) {
+	LinkStatsLinkSummary link;
+	LinkStatsRxSummary rx[TM_WAIT_SRC_TYPES];
+	const LinkStatsRxSummary *pRx;
+	const SdlcGfDesc *pDesc;
+	int i;
+	
+	if (LinkStatsGet(unit, &link, rx, TM_WAIT_SRC_TYPES) == ERROR) {
+		printf("Invalid unit %d.\n", unit);
+		return;
+	}
+	
+	printf("unit %d, errors: address %llu, control %llu, length %llu, crc %llu\n", unit,
+		   (unsigned long long)link.numAddrErrs, (unsigned long long)link.numCtrlErrs,
+		   (unsigned long long)link.numLenErrs, (unsigned long long)link.numCrcErrs);
+	
+	printf("%-4s %10s %10s\n", "TX", "FRAMES", "ERRORS");
+	for (i = 0; i < link.numTxTypes; i++) {
+		printf("%-4s %10llu %10llu\n", g_linkStatsTxCnts[i].szName,
+			   (unsigned long long)link.numTx[i], (unsigned long long)link.numTxErrs[i]);
+	}
+	
+	printf("%-4s %10s %12s %8s %8s %9s %10s %9s %9s %8s %8s\n",
+		   "RX", "FRAMES", "BYTES", "SIZE ERR", "OP ERR", "RATE HZ", "PERIOD US",
+		   "P99 US", "JIT P99", "GAPS", "MISSED");
+	for (i = 0; i < link.numRxTypes; i++) {
+		pRx = &rx[i];
+		if ((pRx->numFrames == 0) && (pRx->numSizeErrs == 0))
+			continue;
+		
+		pDesc = SdlcGfDescGet(pRx->type);
+		printf("%-4s %10llu %12llu %8llu %8llu %9.3f %9u%c %9u %9u %8llu %8llu\n",
+			   (pDesc != NULL) ? pDesc->szName : "?",
+			   (unsigned long long)pRx->numFrames, (unsigned long long)pRx->numBytes,
+			   (unsigned long long)pRx->numSizeErrs, (unsigned long long)pRx->numOpErrs,
+			   pRx->rateMilliHz / 1000.0,
+			   (pRx->periodUs == LINK_STATS_PERIOD_NONE) ? 0 : pRx->periodUs,
+			   pRx->isLearnt ? '*' : ' ', pRx->interP99Us, pRx->jitterP99Us,
+			   (unsigned long long)pRx->numGaps, (unsigned long long)pRx->numMissed);
+	}
+	printf("* period learnt from the intervals\n");
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <vxWorks.h>
+
+#include "../lib/util/isHist.h"
+#include "TmWait.h"
+
+/*
+ * SDLC link health of each GCU unit, in 64-bit counters that do not wrap.
+ *
+ * The receive side is written by tSdlcRecvGcu of the unit alone, without
+ * a lock: per frame type it counts frames, bytes and errors and keeps the
+ * inter-arrival time of the frames in HwTime. An interval beyond
+ * LINK_STATS_GAP_PCT of the expected period is a gap, and the periods
+ * it spans are counted as missing frames. The expected period of a type is
+ * configured with LinkStatsConfig(); until it is, it is learnt from the
+ * intervals themselves. Readers copy the receive side under a sequence
+ * count, like FrameRing slots.
+ *
+ * The send side is counted by SdlcSendGcu in the 16-bit TM_COMM_STS
+ * counters; LinkStatsSample() widens them, as does every report. The
+ * Monitoring period keeps the samples well inside their wrap.
+ */
+#define LINK_STATS_TX_TYPES			(5)			/* FG2, FG3, FG5, FG6, FG7 */
+#define LINK_STATS_GAP_PCT			(150)
+#define LINK_STATS_LEARN_FRAMES		(8)			/* intervals before a learnt period is used */
+#define LINK_STATS_PERIOD_NONE		(0xFFFFFFFF)	/* aperiodic type, no gap detection */
+
+typedef enum {
+	LINK_STATS_ERR_ADDRESS,
+	LINK_STATS_ERR_CONTROL,
+	LINK_STATS_ERR_LENGTH,		/* longer than any frame */
+	LINK_STATS_ERR_SIZE,		/* size of the type */
+	LINK_STATS_ERR_OPCODE		/* response code of the type */
+} LinkStatsErr;
+
+/* Link errors and send side of a unit. */
+typedef struct {
+	UINT16	unit;
+	UINT8	numRxTypes;			/* LinkStatsRxSummary elements filled in */
+	UINT8	numTxTypes;
+	UINT32	reserved;
+	UINT64	timeNs;				/* HwTime of the report */
+	UINT64	numAddrErrs;
+	UINT64	numCtrlErrs;
+	UINT64	numLenErrs;
+	UINT64	numCrcErrs;
+	UINT64	numTx[LINK_STATS_TX_TYPES];
+	UINT64	numTxErrs[LINK_STATS_TX_TYPES];
+} LinkStatsLinkSummary;
+
+/* One frame type of a unit. */
+typedef struct {
+	UINT8	type;				/* TM_WAIT_SRC_GFn */
+	UINT8	isLearnt;			/* periodUs is learnt, not configured */
+	UINT16	reserved;
+	UINT32	periodUs;			/* expected period, 0 if not known yet */
+	UINT64	numFrames;
+	UINT64	numBytes;
+	UINT64	numSizeErrs;
+	UINT64	numOpErrs;
+	UINT64	numGaps;
+	UINT64	numMissed;
+	UINT64	tFirstNs;
+	UINT64	tLastNs;
+	UINT32	rateMilliHz;		/* over the recent intervals */
+	UINT32	interP50Us;
+	UINT32	interP99Us;
+	UINT32	interMaxUs;
+	UINT32	jitterP50Us;		/* |interval - period| of the intervals without a gap */
+	UINT32	jitterP99Us;
+	UINT32	jitterMaxUs;
+	UINT32	reserved2;
+} LinkStatsRxSummary;
+
+/* One element of the mtsLinkStats result vector. */
+typedef struct {
+	LinkStatsLinkSummary	link;
+	LinkStatsRxSummary		rx[TM_WAIT_SRC_TYPES];
+} LinkStatsSummary;
+
+IMPORT STATUS	LinkStatsInit(void);
+IMPORT void		LinkStatsRx(int unit, TmWaitSrc type, UINT32 size, UINT64 timeNs);
+IMPORT void		LinkStatsError(int unit, LinkStatsErr err, TmWaitSrc type);
+IMPORT void		LinkStatsSample(int unit);
+IMPORT STATUS	LinkStatsGet(int unit, LinkStatsLinkSummary *pLink,
+							 LinkStatsRxSummary *pRx, int maxRx);
+IMPORT STATUS	LinkStatsConfig(int type, UINT32 periodUs);
+IMPORT void		LinkStatsReset(int unit);
+IMPORT void		linkStatsShow(int unit);
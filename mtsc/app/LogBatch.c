@@ -0,0 +1,318 @@
+#include <semLib.h>
+#include <taskLib.h>
+#include <vxAtomicLib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "../lib/util/isDebug.h"
+#include "../lib/util/isClock.h"
+#include "common.h"
+#include "LogBatch.h"
+
+#define LOG_BATCH_TASK_NAME			"tLogBatch"
+#define LOG_BATCH_TASK_PRIORITY		(60)
+#define LOG_BATCH_TASK_STACK_SIZE	(8192)
+
+#define LOG_BATCH_INIT_NONE			(0)
+#define LOG_BATCH_INIT_BUSY			(1)
+#define LOG_BATCH_INIT_DONE			(2)
+
+typedef enum {
+	LOG_BATCH_BY_SIZE,
+	LOG_BATCH_BY_DEADLINE,
+	LOG_BATCH_BY_URGENT
+} LogBatchReason;
+
+typedef struct {
+	atomic32_t		initState;
+	SEM_ID			sidLock;		/* also guards stats */
+	SEM_ID			sidKick;		/* given when a record opens a batch */
+	volatile BOOL	isEnabled;		/* LogBatchEnable(), off by default */
+	int				mtu;
+	int				deadlineMs;
+	UINT32			gen;			/* batches flushed so far */
+	UINT64			tFirst;
+	int				used;
+	LogBatchStats	stats;
+	union {
+		LogBatchHdr	hdr;
+		UINT8		buf[LOG_BATCH_MTU_MAX];
+	} dgram;
+} LogBatch;
+
+LOCAL LogBatch g_logBatch = {
+	LOG_BATCH_INIT_NONE, SEM_ID_NULL, SEM_ID_NULL, FALSE, LOG_BATCH_MTU_DEFAULT,
+	LOG_BATCH_DEADLINE_MS,
+};
+
+/* Called with sidLock held. */
+LOCAL void flushLocked(LogBatchReason reason) {
+	LogBatchStats *pStats = &g_logBatch.stats;
+	
+	if (g_logBatch.dgram.hdr.numRecords == 0)
+		return;
+	
+	/* Without the opcode LogBatchEnable() fails, so no batch is ever opened. */
+#ifdef LOG_SEND_TX_BATCH
+	PostLogSendCmdEx(LOG_SEND_TX_BATCH, (const char *)g_logBatch.dgram.buf, g_logBatch.used);
+#endif
+	
+	pStats->numDatagrams++;
+	pStats->numBytes += g_logBatch.used;
+	if (reason == LOG_BATCH_BY_SIZE)
+		pStats->numBySize++;
+	else if (reason == LOG_BATCH_BY_DEADLINE)
+		pStats->numByDeadline++;
+	else
+		pStats->numByUrgent++;
+	isHistAdd(&pStats->waitUs, isClockNsToUs(isClockNs() - g_logBatch.tFirst));
+	
+	g_logBatch.gen++;
+	g_logBatch.dgram.hdr.numRecords = 0;
+	g_logBatch.used = sizeof(LogBatchHdr);
+}
+
+/*
+ * Sleeps out the deadline of each batch that is opened. A batch flushed
+ * for size or urgency in the meantime has a new generation and is left
+ * alone; the kick of the batch after it is already pending.
+ */
+LOCAL void logBatchTask(void) {
+	UINT32 gen;
+	
+	FOREVER {
+		semTake(g_logBatch.sidKick, WAIT_FOREVER);
+		gen = g_logBatch.gen;
+		taskDelay(GET_DELAY_TICK(g_logBatch.deadlineMs));
+		
+		semTake(g_logBatch.sidLock, WAIT_FOREVER);
+		if (g_logBatch.gen == gen)
+			flushLocked(LOG_BATCH_BY_DEADLINE);
+		semGive(g_logBatch.sidLock);
+	}
+}
+
+/*
+ * Called by each module that logs, before its first record. The first
+ * caller sets the batch up; one that comes in meanwhile waits for it.
+ * sidLock is published last, so a record posted before that goes out
+ * unbatched.
+ */
+STATUS LogBatchInit(void) {
+	SEM_ID sidLock;
+	
+	if (vxAtomic32Cas(&g_logBatch.initState, LOG_BATCH_INIT_NONE, LOG_BATCH_INIT_BUSY) == FALSE) {
+		while (vxAtomic32Get(&g_logBatch.initState) == LOG_BATCH_INIT_BUSY)
+			taskDelay(1);
+		
+		return (vxAtomic32Get(&g_logBatch.initState) == LOG_BATCH_INIT_DONE) ? OK : ERROR;
+	}
+	
+	isHistReset(&g_logBatch.stats.waitUs);
+	g_logBatch.dgram.hdr.magic = LOG_BATCH_MAGIC;
+	g_logBatch.used = sizeof(LogBatchHdr);
+	
+	if (g_logBatch.sidKick == SEM_ID_NULL) {
+		g_logBatch.sidKick = semBCreate(SEM_Q_FIFO, SEM_EMPTY);
+		if (g_logBatch.sidKick == SEM_ID_NULL) {
+			LOGMSG("semBCreate() error!\n");
+			vxAtomic32Set(&g_logBatch.initState, LOG_BATCH_INIT_NONE);
+			return ERROR;
+		}
+	}
+	
+	sidLock = semMCreate(SEM_Q_PRIORITY | SEM_DELETE_SAFE | SEM_INVERSION_SAFE);
+	if (sidLock == SEM_ID_NULL) {
+		LOGMSG("semMCreate() error!\n");
+		vxAtomic32Set(&g_logBatch.initState, LOG_BATCH_INIT_NONE);
+		return ERROR;
+	}
+	
+	if (taskSpawn(LOG_BATCH_TASK_NAME, LOG_BATCH_TASK_PRIORITY, 0,
+				  LOG_BATCH_TASK_STACK_SIZE, (FUNCPTR)logBatchTask,
+				  0, 0, 0, 0, 0, 0, 0, 0, 0, 0) == TASK_ID_ERROR) {
+		LOGMSG("taskSpawn(%s) error!\n", LOG_BATCH_TASK_NAME);
+		semDelete(sidLock);
+		vxAtomic32Set(&g_logBatch.initState, LOG_BATCH_INIT_NONE);
+		return ERROR;
+	}
+	
+	VX_MEM_BARRIER_W();
+	g_logBatch.sidLock = sidLock;
+	vxAtomic32Set(&g_logBatch.initState, LOG_BATCH_INIT_DONE);
+	
+	return OK;
+}
+
+/*
+ * Queues len bytes of pLog, stamped timeNs, for LogSend. An urgent
+ * record, e.g. a limit violation, goes out with whatever is batched
+ * ahead of it at once. Unbatched records only have their tickLog.
+ */
+void LogBatchPost(const LOG_DATA *pLog, int len, UINT64 timeNs, BOOL isUrgent) {
+	LogBatchStats *pStats = &g_logBatch.stats;
+	SEM_ID sidLock = g_logBatch.sidLock;
+	LogBatchRec rec;
+	
+	rec.len = (UINT16)len;
+	rec.timeNs = timeNs;
+	
+	if ((sidLock != SEM_ID_NULL) && g_logBatch.isEnabled &&
+		(sizeof(LogBatchHdr) + sizeof(rec) + len <= g_logBatch.mtu)) {
+		semTake(sidLock, WAIT_FOREVER);
+		
+		if (g_logBatch.used + sizeof(rec) + len > g_logBatch.mtu)
+			flushLocked(LOG_BATCH_BY_SIZE);
+		
+		if (g_logBatch.dgram.hdr.numRecords == 0) {
+			g_logBatch.tFirst = isClockNs();
+			semGive(g_logBatch.sidKick);
+		}
+		
+		memcpy(&g_logBatch.dgram.buf[g_logBatch.used], &rec, sizeof(rec));
+		memcpy(&g_logBatch.dgram.buf[g_logBatch.used + sizeof(rec)], pLog, len);
+		g_logBatch.used += sizeof(rec) + len;
+		g_logBatch.dgram.hdr.numRecords++;
+		pStats->numRecords++;
+		
+		if (isUrgent)
+			flushLocked(LOG_BATCH_BY_URGENT);
+		
+		semGive(sidLock);
+		return;
+	}
+	
+	/* Batching off or not initialised yet, or too large for one datagram. */
+	if (sidLock != SEM_ID_NULL) {
+		semTake(sidLock, WAIT_FOREVER);
+		/* Keep the order of records already batched. */
+		flushLocked(LOG_BATCH_BY_URGENT);
+	}
+	
+	PostLogSendCmdEx(LOG_SEND_TX, (const char *)pLog, len);
+	pStats->numRecords++;
+	pStats->numDatagrams++;
+	pStats->numBytes += len;
+	
+	if (sidLock != SEM_ID_NULL)
+		semGive(sidLock);
+}
+
+void LogBatchFlush(void) {
+	if (g_logBatch.sidLock == SEM_ID_NULL)
+		return;
+	
+	semTake(g_logBatch.sidLock, WAIT_FOREVER);
+	flushLocked(LOG_BATCH_BY_URGENT);
+	semGive(g_logBatch.sidLock);
+}
+
+/*
+ * Turns batching on or off at run time. Turning it off sends what is
+ * batched first. It cannot be turned on when LogSend has no
+ * LOG_SEND_TX_BATCH.
+ */
+STATUS LogBatchEnable(BOOL isEnable) {
+#ifndef LOG_SEND_TX_BATCH
+	if (isEnable) {
+		LOGMSG("LogSend has no LOG_SEND_TX_BATCH.\n");
+		return ERROR;
+	}
+#endif
+	
+	if (g_logBatch.sidLock == SEM_ID_NULL) {
+		g_logBatch.isEnabled = isEnable;
+		return OK;
+	}
+	
+	semTake(g_logBatch.sidLock, WAIT_FOREVER);
+	if (!isEnable)
+		flushLocked(LOG_BATCH_BY_URGENT);
+	g_logBatch.isEnabled = isEnable;
+	semGive(g_logBatch.sidLock);
+	
+	return OK;
+}
+
+/*
+ * LogSend's handler of LOG_SEND_TX_BATCH: checks the datagram built by
+ * flushLocked() and sends it to pDst in one sendto().
+ */
+STATUS LogBatchOnTx(int sockFd, const struct sockaddr *pDst, int dstLen,
+					const char *pBuf, int len) {
+	const LogBatchHdr *pHdr = (const LogBatchHdr *)pBuf;
+	LogBatchRec rec;
+	int off = sizeof(LogBatchHdr);
+	int i;
+	
+	if ((len < (int)sizeof(LogBatchHdr)) || (len > LOG_BATCH_MTU_MAX) ||
+		(pHdr->magic != LOG_BATCH_MAGIC))
+		return ERROR;
+	
+	for (i = 0; i < pHdr->numRecords; i++) {
+		if (off + (int)sizeof(rec) > len)
+			return ERROR;
+		memcpy(&rec, pBuf + off, sizeof(rec));
+		off += sizeof(rec) + rec.len;
+	}
+	
+	if (off != len)
+		return ERROR;
+	
+	return (sendto(sockFd, (char *)pBuf, len, 0, (struct sockaddr *)pDst, dstLen) == len) ?
+		   OK : ERROR;
+}
+
+STATUS LogBatchConfig(int mtu, int deadlineMs) {
+	if ((mtu < (int)sizeof(LogBatchHdr)) || (mtu > LOG_BATCH_MTU_MAX) || (deadlineMs <= 0))
+		return ERROR;
+	
+	if (g_logBatch.sidLock != SEM_ID_NULL)
+		semTake(g_logBatch.sidLock, WAIT_FOREVER);
+	
+	if (mtu < g_logBatch.used)
+		flushLocked(LOG_BATCH_BY_SIZE);
+	g_logBatch.mtu = mtu;
+	g_logBatch.deadlineMs = deadlineMs;
+	
+	if (g_logBatch.sidLock != SEM_ID_NULL)
+		semGive(g_logBatch.sidLock);
+	
+	return OK;
+}
+
+void LogBatchStatsGet(LogBatchStats *pStats) {
+	if (g_logBatch.sidLock != SEM_ID_NULL)
+		semTake(g_logBatch.sidLock, WAIT_FOREVER);
+	*pStats = g_logBatch.stats;
+	if (g_logBatch.sidLock != SEM_ID_NULL)
+		semGive(g_logBatch.sidLock);
+}
+
+void logBatchShow(void) {
+	LogBatchStats stats;
+	
+	LogBatchStatsGet(&stats);
+	
+	printf("%s, MTU %d, deadline %d ms\n", g_logBatch.isEnabled ? "batched" : "unbatched",
+		   g_logBatch.mtu, g_logBatch.deadlineMs);
+	printf(" records          : %u\n", stats.numRecords);
+	printf(" datagrams        : %u (%u by size, %u by deadline, %u urgent)\n",
+		   stats.numDatagrams, stats.numBySize, stats.numByDeadline, stats.numByUrgent);
+	printf(" records/datagram : %.2f\n",
+		   stats.numDatagrams ? (double)stats.numRecords / stats.numDatagrams : 0.0);
+	printf(" sends saved      : %u\n", stats.numRecords - stats.numDatagrams);
+	printf(" bytes/datagram   : %.1f\n",
+		   stats.numDatagrams ? (double)stats.numBytes / stats.numDatagrams : 0.0);
+	if (stats.waitUs.count > 0)
+		isHistShow(&stats.waitUs, "added latency (us)");
+}
+
+void logBatchReset(void) {
+	if (g_logBatch.sidLock != SEM_ID_NULL)
+		semTake(g_logBatch.sidLock, WAIT_FOREVER);
+	memset(&g_logBatch.stats, 0, sizeof(LogBatchStats));
+	isHistReset(&g_logBatch.stats.waitUs);
+	if (g_logBatch.sidLock != SEM_ID_NULL)
+		semGive(g_logBatch.sidLock);
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <vxWorks.h>
+#include <sockLib.h>
+
+#include "../lib/util/isHist.h"
+#include "LogSend.h"
+
+/*
+ * Coalesces LogSend records into jumbo datagrams. Records are packed
+ * behind a LogBatchHdr, each prefixed with a LogBatchRec giving its length
+ * and its HwTime in ns, and the whole buffer goes to LogSend as one
+ * LOG_SEND_TX_BATCH message, i.e. one
+ * sendto(). A batch is flushed when the next record would not fit in the
+ * MTU, LOG_BATCH_DEADLINE_MS after its first record, or right after an
+ * urgent record.
+ *
+ * Batching is off until LogBatchEnable(TRUE): every record then goes to
+ * LogSend on its own as a LOG_SEND_TX message, as before. So does a
+ * record posted before LogBatchInit() or one too large for the MTU.
+ * LogSend carries LOG_SEND_TX_BATCH in its command enum, announced with
+ * "#define LOG_SEND_TX_BATCH LOG_SEND_TX_BATCH", and hands the message to
+ * LogBatchOnTx(); built against a LogSend without it, batching cannot be
+ * enabled.
+ */
+#define LOG_BATCH_MTU_DEFAULT		(1472)		/* Ethernet payload */
+#define LOG_BATCH_MTU_MAX			(8972)		/* 9000-byte jumbo frame */
+#define LOG_BATCH_DEADLINE_MS		(2)
+#define LOG_BATCH_MAGIC				(0x4C54)	/* "LT", records carry a time */
+
+typedef struct {
+	UINT16	magic;
+	UINT16	numRecords;
+} LogBatchHdr;
+
+typedef struct {
+	UINT16	len;			/* of the record that follows */
+	UINT64	timeNs;			/* HwTime of the event, e.g. the frame receipt */
+} __attribute__((packed)) LogBatchRec;
+
+typedef struct {
+	UINT32	numRecords;
+	UINT32	numDatagrams;
+	UINT32	numBySize;
+	UINT32	numByDeadline;
+	UINT32	numByUrgent;
+	UINT64	numBytes;
+	IsHist	waitUs;			/* first record of a datagram, post -> flush */
+} LogBatchStats;
+
+IMPORT STATUS	LogBatchInit(void);
+IMPORT void		LogBatchPost(const LOG_DATA *pLog, int len, UINT64 timeNs, BOOL isUrgent);
+IMPORT void		LogBatchFlush(void);
+IMPORT STATUS	LogBatchEnable(BOOL isEnable);
+IMPORT STATUS	LogBatchOnTx(int sockFd, const struct sockaddr *pDst, int dstLen,
+							 const char *pBuf, int len);
+IMPORT STATUS	LogBatchConfig(int mtu, int deadlineMs);
+IMPORT void		LogBatchStatsGet(LogBatchStats *pStats);
+IMPORT void		logBatchShow(void);
+IMPORT void		logBatchReset(void);
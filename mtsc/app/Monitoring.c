@@ -6,15 +6,18 @@
 
 #include "../drv/axiDio.h"
 #include "../drv/axiAdc.h"
-#include "../drv/axiSdlc.h"
 #include "../lib/util/isDebug.h"
 #include "../lib/mtsLibPsCtrl.h"
 #include "../lib/steLib.h"
 #include "common.h"
 #include "Monitoring.h"
 #include "LogSend.h"
+#include "LogBatch.h"
 #include "UdpRecvRs1.h"
 #include "UdpRecvRs4.h"
+#include "GcuUnit.h"
+#include "HwTime.h"
+#include "LinkStats.h"
 
 #define MONITORING_MSG_Q_LEN	(20)
 #define MONITORING_PERIOD_SEC	(0)
@@ -194,6 +197,7 @@ LOCAL STATUS OnExecute(MonitoringInst *this) {
 	MonitoringLog *pLogBody = &g_stMonitoringLog.formatted.body.monitoring;
 	static UINT32 precPwrMslExtEn = 0;
 	UINT32 currPwrMslExtEn = 0;
+	int unit;
 #ifdef CLEAR_LAR_BUFFER
 	static UINT32 prevPwrLarPg = 0;
 	UINT32 currPwrLarPg = 0;
@@ -233,7 +237,7 @@ LOCAL STATUS OnExecute(MonitoringInst *this) {
 	currPwrMslExtEn = pLogBody->doSys.bit.pwrMslExtEn;
 #if 1
 	if ((prevPwrMslExtEn == 0) && (currPwrMslExtEn == 1)) {
-		PostCmd(g_hSdlcRecvGcu, SDLC_RECV_GCU_INIT_RX_FRAME);
+		GcuUnitPostRecv(SDLC_RECV_GCU_INIT_RX_FRAMES);
 	}
 #else
 	if ((prevPwrMslExtEn == 1) && (currPwrMslExtEn == 0)) {
@@ -242,6 +246,9 @@ LOCAL STATUS OnExecute(MonitoringInst *this) {
 #endif
 	prevPwrMslExtEn = currPwrMslExtEn;
 	
+	for (unit = 0; unit < GCU_UNIT_NUM; unit++)
+		LinkStatsSample(unit);
+	
 #ifdef CLEAR_LAR_BUFFER
 	currPwrLarPg = steLibDiBitPwrLarPg();
 #if 1
@@ -272,9 +279,10 @@ LOCAL STATUS OnExecute(MonitoringInst *this) {
 	prevPwrLnsPg = currPwrLnsPg;
 #endif
 	g_stMonitoringLog.formatted.tickLog = tickGet();
-	PostLogSendCmdEx(LOG_SENT_TX, (const char *)(&g_stMonitoringLog),
-					sizeof(MonitoringLog) + OFFSET(LOG_DATA, formatted.body));
-					
+	LogBatchPost(&g_stMonitoringLog,
+				 sizeof(MonitoringLog) + OFFSET(LOG_DATA, formatted.body),
+				 HwTimeNow(), FALSE);
+	
 	return OK;
 }
 
@@ -291,77 +299,7 @@ void MonitoringMain(ModuleInst *pModuleInst) {
 	}
 }
 
-void mtsShowTmCommSts(void) {
-	g_pTmCommSts->wCrcErrCnt = (UINT16)axiSdlcGetRxCrcCnt(0);
-	
-	printf("\n g_pTmCommSts->wAddressErrCnt		= 0x%08x", g_pTmCommSts->wAddressErrCnt);
-	printf("\n g_pTmCommSts->wControlErrCnt		= 0x%08x", g_pTmCommSts->wControlErrCnt);
-	printf("\n g_pTmCommSts->wCrcErrCnt			= 0x%08x", g_pTmCommSts->wCrcErrCnt);
-	printf("\n");
-	printf("\n g_pTmCommSts->wFg2TxCnt			= 0x%08x", g_pTmCommSts->wFg2TxCnt);	
-	printf("\n g_pTmCommSts->wFg3TxCnt			= 0x%08x", g_pTmCommSts->wFg3TxCnt);
-	printf("\n g_pTmCommSts->wFg5TxCnt			= 0x%08x", g_pTmCommSts->wFg5TxCnt);
-	printf("\n g_pTmCommSts->wFg6TxCnt			= 0x%08x", g_pTmCommSts->wFg6TxCnt);	
-	printf("\n g_pTmCommSts->wFg7TxCnt			= 0x%08x", g_pTmCommSts->wFg7TxCnt);		
-	printf("\n g_pTmCommSts->wFg2TxErrCnt		= 0x%08x", g_pTmCommSts->wFg2TxErrCnt);	
-	printf("\n g_pTmCommSts->wFg3TxErrCnt		= 0x%08x", g_pTmCommSts->wFg3TxErrCnt);	
-	printf("\n g_pTmCommSts->wFg5TxErrCnt		= 0x%08x", g_pTmCommSts->wFg5TxErrCnt);	
-	printf("\n g_pTmCommSts->wFg6TxErrCnt		= 0x%08x", g_pTmCommSts->wFg6TxErrCnt);	
-	printf("\n g_pTmCommSts->wFg7TxErrCnt		= 0x%08x", g_pTmCommSts->wFg7TxErrCnt);	
-	printf("\n");
-	printf("\n g_pTmCommSts->wFg61TxCnt			= 0x%08x", g_pTmCommSts->wFg61TxCnt);	
-	printf("\n g_pTmCommSts->wFg62TxCnt			= 0x%08x", g_pTmCommSts->wFg62TxCnt);
-	printf("\n g_pTmCommSts->wFg63TxCnt			= 0x%08x", g_pTmCommSts->wFg63TxCnt);
-	printf("\n g_pTmCommSts->wFg64TxCnt			= 0x%08x", g_pTmCommSts->wFg64TxCnt);	
-	printf("\n g_pTmCommSts->wFg65TxCnt			= 0x%08x", g_pTmCommSts->wFg65TxCnt);		
-	printf("\n");
-	printf("\n g_pTmCommSts->wGf2TxCnt			= 0x%08x", g_pTmCommSts->wGf2TxCnt);	
-	printf("\n g_pTmCommSts->wGf3TxCnt			= 0x%08x", g_pTmCommSts->wGf3TxCnt);
-	printf("\n g_pTmCommSts->wGf5TxCnt			= 0x%08x", g_pTmCommSts->wGf5TxCnt);
-	printf("\n g_pTmCommSts->wGf6TxCnt			= 0x%08x", g_pTmCommSts->wGf6TxCnt);	
-	printf("\n g_pTmCommSts->wGf7TxCnt			= 0x%08x", g_pTmCommSts->wGf7TxCnt);
-	printf("\n g_pTmCommSts->wGf8TxCnt			= 0x%08x", g_pTmCommSts->wGf8TxCnt);	
-	printf("\n g_pTmCommSts->wGf9TxCnt			= 0x%08x", g_pTmCommSts->wGf9TxCnt);
-	printf("\n g_pTmCommSts->wGf11TxCnt			= 0x%08x", g_pTmCommSts->wGf11TxCnt);
-	printf("\n g_pTmCommSts->wGf12TxCnt			= 0x%08x", g_pTmCommSts->wGf12TxCnt);	
-	printf("\n");
-	printf("\n g_pTmCommSts->wGf21TxCnt			= 0x%08x", g_pTmCommSts->wGf21TxCnt);	
-	printf("\n g_pTmCommSts->wGf22TxCnt			= 0x%08x", g_pTmCommSts->wGf22TxCnt);
-	printf("\n g_pTmCommSts->wGf23TxCnt			= 0x%08x", g_pTmCommSts->wGf23TxCnt);
-	printf("\n g_pTmCommSts->wGf24TxCnt			= 0x%08x", g_pTmCommSts->wGf24TxCnt);	
-	printf("\n g_pTmCommSts->wGf28TxCnt			= 0x%08x", g_pTmCommSts->wGf28TxCnt);
-	printf("\n g_pTmCommSts->wGf29TxCnt			= 0x%08x", g_pTmCommSts->wGf29TxCnt);	
-	printf("\n");
-	printf("\n g_pTmCommSts->wFg61TxCnt			= 0x%08x", g_pTmCommSts->wFg61TxCnt);	
-	printf("\n g_pTmCommSts->wFg62TxCnt			= 0x%08x", g_pTmCommSts->wFg62TxCnt);
-	printf("\n g_pTmCommSts->wFg63TxCnt			= 0x%08x", g_pTmCommSts->wFg63TxCnt);
-	printf("\n g_pTmCommSts->wFg64TxCnt			= 0x%08x", g_pTmCommSts->wFg64TxCnt);	
-	printf("\n g_pTmCommSts->wFg65TxCnt			= 0x%08x", g_pTmCommSts->wFg65TxCnt);		
-	printf("\n");
-	printf("\n g_pTmCommSts->wGf72TxCnt			= 0x%08x", g_pTmCommSts->wGf72TxCnt);	
-	printf("\n g_pTmCommSts->wGf73TxCnt			= 0x%08x", g_pTmCommSts->wGf73TxCnt);
-	printf("\n g_pTmCommSts->wGf74TxCnt			= 0x%08x", g_pTmCommSts->wGf74TxCnt);
-	printf("\n g_pTmCommSts->wGf75TxCnt			= 0x%08x", g_pTmCommSts->wGf75TxCnt);	
-	printf("\n g_pTmCommSts->wGf76TxCnt			= 0x%08x", g_pTmCommSts->wGf76TxCnt);
-	printf("\n g_pTmCommSts->wGf77TxCnt			= 0x%08x", g_pTmCommSts->wGf77TxCnt);
-	printf("\n g_pTmCommSts->wGf78TxCnt			= 0x%08x", g_pTmCommSts->wGf78TxCnt);
-	printf("\n g_pTmCommSts->wGf79TxCnt			= 0x%08x", g_pTmCommSts->wGf79TxCnt);	
-	printf("\n");
-	printf("\n g_pTmCommSts->wGf2OpCodeErrCnt	= 0x%08x", g_pTmCommSts->wGf2OpCodeErrCnt);	
-	printf("\n g_pTmCommSts->wGf3OpCodeErrCnt	= 0x%08x", g_pTmCommSts->wGf3OpCodeErrCnt);
-	printf("\n g_pTmCommSts->wGf5OpCodeErrCnt	= 0x%08x", g_pTmCommSts->wGf5OpCodeErrCnt);
-	printf("\n g_pTmCommSts->wGf6OpCodeErrCnt	= 0x%08x", g_pTmCommSts->wGf6OpCodeErrCnt);	
-	printf("\n g_pTmCommSts->wGf7OpCodeErrCnt	= 0x%08x", g_pTmCommSts->wGf7OpCodeErrCnt);
-	printf("\n");
-	printf("\n g_pTmCommSts->wGf2SizeErrCnt		= 0x%08x", g_pTmCommSts->wGf2SizeErrCnt);	
-	printf("\n g_pTmCommSts->wGf3SizeErrCnt		= 0x%08x", g_pTmCommSts->wGf3SizeErrCnt);
-	printf("\n g_pTmCommSts->wGf5SizeErrCnt		= 0x%08x", g_pTmCommSts->wGf5SizeErrCnt);	
-	printf("\n g_pTmCommSts->wGf6SizeErrCnt		= 0x%08x", g_pTmCommSts->wGf6SizeErrCnt);
-	printf("\n g_pTmCommSts->wGf7SizeErrCnt		= 0x%08x", g_pTmCommSts->wGf7SizeErrCnt);	
-	printf("\n g_pTmCommSts->wGf8SizeErrCnt		= 0x%08x", g_pTmCommSts->wGf8SizeErrCnt);
-	printf("\n g_pTmCommSts->wGf9SizeErrCnt		= 0x%08x", g_pTmCommSts->wGf9SizeErrCnt);
-	printf("\n g_pTmCommSts->wGf11SizeErrCnt	= 0x%08x", g_pTmCommSts->wGf11SizeErrCnt);
-	printf("\n g_pTmCommSts->wGf12SizeErrCnt	= 0x%08x", g_pTmCommSts->wGf12SizeErrCnt);
-	printf("\n");
+/* The TM_COMM_STS counters of the unit, widened and timed by LinkStats. */
+void mtsShowTmCommSts(int unit) {
+	linkStatsShow(unit);
 }
-
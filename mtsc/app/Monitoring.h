@@ -54,6 +54,7 @@ IMPORT const ModuleInst *g_hMonitoring;
 IMPORT TM_COMM_STS * g_pTmCommSts;
 
 IMPORT void MonitoringMain(ModuleInst *pModuleInst);
+IMPORT void mtsShowTmCommSts(int unit);
 
 
 
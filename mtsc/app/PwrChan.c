@@ -0,0 +1,175 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "../lib/util/isDebug.h"
+#include "../lib/util/isHash.h"
+#include "../lib/mtsLib.h"
+#include "../lib/steLib.h"
+#include "PwrChan.h"
+
+#define PWR_CHAN_HASH_MASK		(PWR_CHAN_HASH_SIZE - 1)
+#define PWR_CHAN_FMT_DEFAULT	"%0.3lf"
+
+#define PWR_CHAN_ITEM(id, name, volt, curr, set, pg, seq, seqMs) \
+	[id] = { name, 0, { volt, curr }, set, pg, { "V", "A" }, \
+			 PWR_CHAN_FMT_DEFAULT, seq, seqMs }
+
+/*
+ * Only this table changes when a rail is added; a NULL entry means the
+ * rail has no such getter, setter or power-good bit.
+ */
+LOCAL PwrChan g_pwrChanTbl[PWR_CHAN_MAX] = {
+	PWR_CHAN_ITEM(PWR_CHAN_TLM_EXT, "TLM_EXT",
+				  mtsLibAdcTlmExtVoltage, mtsLibAdcTlmExtCurrent,
+				  mtsLibDoSysPwrTlmExtEn, mtsLibDiBitPwrTlmExtPg,
+				  PWR_CHAN_CLU_EXT, 500),
+	PWR_CHAN_ITEM(PWR_CHAN_CLU_EXT, "CLU_EXT",
+				  mtsLibAdcCluExtVoltage, mtsLibAdcCluExtCurrent,
+				  mtsLibDoSysPwrCluExtEn, mtsLibDiBitPwrCluExtPg,
+				  PWR_CHAN_NONE, 0),
+	PWR_CHAN_ITEM(PWR_CHAN_MSL_EXT, "MSL_EXT",
+				  mtsLibAdcMslExtVoltage, mtsLibAdcMslExtCurrent,
+				  mtsLibDoSysPwrMslExtEn, mtsLibDiBitPwrMslExtPg,
+				  PWR_CHAN_NONE, 0),
+	PWR_CHAN_ITEM(PWR_CHAN_TBAT, "TBAT",
+				  steLibAdcTbatVoltage, steLibAdcTbatCurrent,
+				  NULL, NULL,
+				  PWR_CHAN_NONE, 0),
+	PWR_CHAN_ITEM(PWR_CHAN_CBAT, "CBAT",
+				  steLibAdcCbatVoltage, steLibAdcCbatCurrent,
+				  NULL, NULL,
+				  PWR_CHAN_NONE, 0),
+	PWR_CHAN_ITEM(PWR_CHAN_BAT, "BAT",
+				  steLibAdcBatVoltage, steLibAdcBatCurrent,
+				  NULL, NULL,
+				  PWR_CHAN_NONE, 0),
+	PWR_CHAN_ITEM(PWR_CHAN_LNS, "LNS",
+				  steLibAdcLnsExtVoltage, steLibAdcLnsExtCurrent,
+				  steLibDoSysPwrLnsEn, steLibDiBitPwrLnsPg,
+				  PWR_CHAN_NONE, 0),
+	PWR_CHAN_ITEM(PWR_CHAN_LAR, "LAR",
+				  steLibAdcLarExtVoltage, steLibAdcLarExtCurrent,
+				  steLibDoSysPwrLarEn, steLibDiBitPwrLarPg,
+				  PWR_CHAN_NONE, 0),
+};
+
+LOCAL const char *g_szPwrChanQty[PWR_CHAN_QTY_MAX] = {
+	"VOLT",
+	"CURR",
+};
+
+/* Slot holds the channel ID + 1, so zero marks an empty slot. */
+LOCAL UINT8 g_pwrChanHash[PWR_CHAN_HASH_SIZE];
+
+STATUS PwrChanInit(void) {
+	PwrChan *pChan;
+	UINT32 slot;
+	int i;
+	
+	memset(g_pwrChanHash, 0, sizeof(g_pwrChanHash));
+	
+	for (i = 0; i < PWR_CHAN_MAX; i++) {
+		pChan = &g_pwrChanTbl[i];
+		if (pChan->szName == NULL) {
+			LOGMSG("Power channel #%d is not registered.\n", i);
+			return ERROR;
+		}
+		
+		pChan->hash = isHashFnv1a(pChan->szName);
+		
+		for (slot = pChan->hash & PWR_CHAN_HASH_MASK;
+			 g_pwrChanHash[slot] != 0;
+			 slot = (slot + 1) & PWR_CHAN_HASH_MASK) {
+			if (strcmp(g_pwrChanTbl[g_pwrChanHash[slot] - 1].szName, pChan->szName) == 0) {
+				LOGMSG("Duplicated power channel \"%s\".\n", pChan->szName);
+				return ERROR;
+			}
+		}
+		g_pwrChanHash[slot] = (UINT8)(i + 1);
+	}
+	
+	return OK;
+}
+
+const PwrChan *PwrChanGet(int id) {
+	if ((id < 0) || (id >= PWR_CHAN_MAX))
+		return NULL;
+	
+	return &g_pwrChanTbl[id];
+}
+
+const PwrChan *PwrChanFind(const char *szName) {
+	const PwrChan *pChan;
+	UINT32 hash = isHashFnv1a(szName);
+	UINT32 slot;
+	
+	for (slot = hash & PWR_CHAN_HASH_MASK;
+		 g_pwrChanHash[slot] != 0;
+		 slot = (slot + 1) & PWR_CHAN_HASH_MASK) {
+		pChan = &g_pwrChanTbl[g_pwrChanHash[slot] - 1];
+		if ((pChan->hash == hash) && (strcmp(pChan->szName, szName) == 0))
+			return pChan;
+	}
+	
+	return NULL;
+}
+
+/* A numeric argument selects by PwrChanId, anything else by name. */
+const PwrChan *PwrChanResolve(const CmdArg *pArg) {
+	if (pArg->isLong)
+		return PwrChanGet((int)pArg->lVal);
+	
+	return PwrChanFind(pArg->str);
+}
+
+STATUS PwrChanQtyFind(const char *szName, PwrChanQty *pQty) {
+	int i;
+	
+	for (i = 0; i < PWR_CHAN_QTY_MAX; i++) {
+		if (strcmp(g_szPwrChanQty[i], szName) == 0) {
+			*pQty = (PwrChanQty)i;
+			return OK;
+		}
+	}
+	
+	return ERROR;
+}
+
+STATUS PwrChanMeasure(const PwrChan *pChan, PwrChanQty qty, double *pVal) {
+	if ((qty >= PWR_CHAN_QTY_MAX) || (pChan->pfnGet[qty] == NULL))
+		return ERROR;
+	
+	*pVal = pChan->pfnGet[qty]();
+	
+	return OK;
+}
+
+void pwrChanShow(void) {
+	const PwrChan *pChan;
+	char szVal[PWR_CHAN_QTY_MAX][32];
+	double dVal;
+	int i, q;
+	
+	printf("\n ID  Name      Hash        Voltage     Current     PG  Seq");
+	printf("\n --- --------- ----------  ----------  ----------  --- ---------");
+	
+	for (i = 0; i < PWR_CHAN_MAX; i++) {
+		pChan = &g_pwrChanTbl[i];
+		
+		for (q = 0; q < PWR_CHAN_QTY_MAX; q++) {
+			szVal[q][0] = '\0';
+			if (PwrChanMeasure(pChan, (PwrChanQty)q, &dVal) == OK) {
+				snprintf(szVal[q], sizeof(szVal[q]), pChan->szFmt, dVal);
+				strncat(szVal[q], pChan->szUnit[q], sizeof(szVal[q]) - strlen(szVal[q]) - 1);
+			}
+		}
+		
+		printf("\n %3d %-9s 0x%08X  %10s  %10s  %3s %s",
+			   i, pChan->szName, pChan->hash, szVal[PWR_CHAN_QTY_VOLT],
+			   szVal[PWR_CHAN_QTY_CURR],
+			   (pChan->pfnPg != NULL) ? ((pChan->pfnPg() != 0) ? "1" : "0") : "-",
+			   (pChan->seqNext != PWR_CHAN_NONE) ? g_pwrChanTbl[pChan->seqNext].szName : "");
+	}
+	
+	printf("\n");
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <vxWorks.h>
+
+#include "CmdArgs.h"
+
+/* Power-of-two open-addressing table, at least twice PWR_CHAN_MAX. */
+#define PWR_CHAN_HASH_SIZE		(32)
+#define PWR_CHAN_NONE			(-1)
+
+typedef enum {
+	PWR_CHAN_TLM_EXT,
+	PWR_CHAN_CLU_EXT,
+	PWR_CHAN_MSL_EXT,
+	PWR_CHAN_TBAT,
+	PWR_CHAN_CBAT,
+	PWR_CHAN_BAT,
+	PWR_CHAN_LNS,
+	PWR_CHAN_LAR,
+	PWR_CHAN_MAX
+} PwrChanId;
+
+typedef enum {
+	PWR_CHAN_QTY_VOLT,
+	PWR_CHAN_QTY_CURR,
+	PWR_CHAN_QTY_MAX
+} PwrChanQty;
+
+typedef struct {
+	const char *	szName;
+	UINT32			hash;
+	double			(*pfnGet[PWR_CHAN_QTY_MAX])(void);
+	STATUS			(*pfnSet)(int on);
+	UINT32			(*pfnPg)(void);
+	const char *	szUnit[PWR_CHAN_QTY_MAX];
+	const char *	szFmt;
+	int				seqNext;		/* switched after this rail, or PWR_CHAN_NONE */
+	int				seqDelayMs;
+} PwrChan;
+
+IMPORT STATUS			PwrChanInit(void);
+IMPORT const PwrChan *	PwrChanGet(int id);
+IMPORT const PwrChan *	PwrChanFind(const char *szName);
+IMPORT const PwrChan *	PwrChanResolve(const CmdArg *pArg);
+IMPORT STATUS			PwrChanQtyFind(const char *szName, PwrChanQty *pQty);
+IMPORT STATUS			PwrChanMeasure(const PwrChan *pChan, PwrChanQty qty, double *pVal);
+IMPORT void				pwrChanShow(void);
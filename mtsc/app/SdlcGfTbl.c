@@ -0,0 +1,343 @@
+#include <semLib.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "../lib/util/isDebug.h"
+#include "../lib/util/isClock.h"
+#include "../lib/util/isSwap.h"
+#include "common.h"
+#include "typeDef/tmType/tmSts.h"
+#include "SdlcRecvGcu.h"
+#include "SdlcSwap.h"
+#include "SdlcGfTbl.h"
+
+#define SDLC_GF_CNT(member)		offsetof(TM_COMM_STS, member)
+#define SDLC_GF_TBL_NUM			NELEMENTS(g_sdlcGfTbl)
+
+#define SDLC_GF_OP(code, member, id) \
+	{ code, SDLC_GF_CNT(member), id }
+#define SDLC_GF_OP_NO_CNT(code, id) \
+	{ code, SDLC_GF_CNT_NONE, id }
+
+#define SDLC_GF_ITEM(n, id) \
+	{ "GF" #n, TM_GF##n##_SDLC_CONTROL, id, sizeof(TM_TYPE_GF##n), \
+	  TM_WAIT_SRC_GF##n, tmSwapGf##n, (void **)&g_pTmGf##n, \
+	  SDLC_GF_CNT(wGf##n##RxCnt), SDLC_GF_CNT(wGf##n##SizeErrCnt), \
+	  SDLC_GF_CNT_NONE, 0, NULL, 0, NULL, NULL }
+
+#define SDLC_GF_ITEM_OPS(n, id, resp, ops, opErrCnt) \
+	{ "GF" #n, TM_GF##n##_SDLC_CONTROL, id, sizeof(TM_TYPE_GF##n), \
+	  TM_WAIT_SRC_GF##n, tmSwapGf##n, (void **)&g_pTmGf##n, \
+	  SDLC_GF_CNT(wGf##n##RxCnt), SDLC_GF_CNT(wGf##n##SizeErrCnt), \
+	  SDLC_GF_CNT(opErrCnt), offsetof(TM_TYPE_GF##n, resp), \
+	  ops, NELEMENTS(ops), NULL, NULL }
+
+#define SDLC_GF_BENCH_FRAMES	(100000)
+
+LOCAL const SdlcGfOp g_sdlcGf2Ops[] = {
+	SDLC_GF_OP(TM_FG2_1_OPCODE_MODE_LAUNCH,			wGf21RxCnt, 0),
+	SDLC_GF_OP(TM_FG2_1_OPCODE_MODE_HILS,			wGf21RxCnt, 0),
+	SDLC_GF_OP(TM_FG2_1_OPCODE_MODE_TEST,			wGf21RxCnt, 0),
+	SDLC_GF_OP(TM_FG2_1_OPCODE_MODE_GCU_PROGRAM,	wGf21RxCnt, 0),
+	SDLC_GF_OP(TM_FG2_1_OPCODE_MSL_COMM_START,		wGf21RxCnt, 0),
+	SDLC_GF_OP(TM_FG2_1_OPCODE_MSL_START_GNC,		wGf21RxCnt, 0),
+	SDLC_GF_OP(TM_FG2_1_OPCODE_ACT_TEST_START,		wGf21RxCnt, 0),
+	SDLC_GF_OP(TM_FG2_1_OPCODE_ACT_TEST_END,		wGf21RxCnt, 0),
+	SDLC_GF_OP(TM_FG2_2_OPCODE,						wGf22RxCnt, 0),
+	SDLC_GF_OP(TM_FG2_3_OPCODE,						wGf23RxCnt, 0),
+	SDLC_GF_OP(TM_FG2_4_OPCODE,						wGf24RxCnt, 0),
+	SDLC_GF_OP(TM_FG2_1_OPCODE_MSL_MOTOR_ON,		wGf28RxCnt, 0),
+	SDLC_GF_OP(TM_FG2_2_OPCODE_MSL_LIFT_OFF_READY,	wGf29RxCnt, 0),
+	SDLC_GF_OP_NO_CNT(TM_FG3_1_OPCODE,				0),
+};
+
+LOCAL const SdlcGfOp g_sdlcGf3Ops[] = {
+	SDLC_GF_OP_NO_CNT(TM_TCS_GCU_RESP_CODE_GF3_1,	0x31),
+	SDLC_GF_OP_NO_CNT(TM_TCS_GCU_RESP_CODE_GF3_2,	0x32),
+	SDLC_GF_OP_NO_CNT(TM_TCS_GCU_RESP_CODE_GF3_A,	0x33),
+	SDLC_GF_OP_NO_CNT(TM_TCS_GCU_RESP_CODE_GF3_B,	0x33),
+	SDLC_GF_OP_NO_CNT(TM_TCS_GCU_RESP_CODE_GF3_4,	0x34),
+};
+
+LOCAL const SdlcGfOp g_sdlcGf5Ops[] = {
+	SDLC_GF_OP_NO_CNT(TM_GF5_OPCODE,				0x50),
+};
+
+LOCAL const SdlcGfOp g_sdlcGf6Ops[] = {
+	SDLC_GF_OP(TM_GF6_1_OPCODE,						wGf61RxCnt, 0x61),
+	SDLC_GF_OP(TM_GF6_2_OPCODE,						wGf62RxCnt, 0x62),
+	SDLC_GF_OP(TM_GF6_3_OPCODE,						wGf63RxCnt, 0x63),
+	SDLC_GF_OP(TM_GF6_4_OPCODE,						wGf64RxCnt, 0x64),
+	SDLC_GF_OP(TM_GF6_5_OPCODE,						wGf65RxCnt, 0x65),
+};
+
+LOCAL const SdlcGfOp g_sdlcGf7Ops[] = {
+	SDLC_GF_OP(TM_TCS_INS_RESP_CODE_GF7_2,			wGf72RxCnt, 0),
+	SDLC_GF_OP(TM_TCS_INS_RESP_CODE_GF7_3,			wGf73RxCnt, 0),
+	SDLC_GF_OP(TM_TCS_INS_RESP_CODE_GF7_4,			wGf74RxCnt, 0),
+	SDLC_GF_OP(TM_TCS_INS_RESP_CODE_GF7_5,			wGf75RxCnt, 0),
+	SDLC_GF_OP(TM_TCS_INS_RESP_CODE_GF7_6,			wGf76RxCnt, 0),
+	SDLC_GF_OP(TM_TCS_INS_RESP_CODE_GF7_7,			wGf77RxCnt, 0),
+	SDLC_GF_OP(TM_TCS_INS_RESP_CODE_GF7_8,			wGf78RxCnt, 0),
+	SDLC_GF_OP(TM_TCS_INS_RESP_CODE_GF7_9,			wGf79RxCnt, 0),
+};
+
+LOCAL SdlcGfDesc g_sdlcGfTbl[] = {
+	SDLC_GF_ITEM_OPS(2, 0x20, m_GCU_RESP, g_sdlcGf2Ops, wGf2OpCodeErrCnt),
+	SDLC_GF_ITEM_OPS(3, 0x30, gf3_1.m_GCU_RESP, g_sdlcGf3Ops, wGf3OpCodeErrCnt),
+	SDLC_GF_ITEM_OPS(5, 0x50, m_MAR_RESP, g_sdlcGf5Ops, wGf5OpCodeErrCnt),
+	SDLC_GF_ITEM_OPS(6, 0x60, gf6_1.m_MAR_RESP, g_sdlcGf6Ops, wGf60pCodeErrCnt),
+	SDLC_GF_ITEM_OPS(7, 0x70, m_NAV_RESP, g_sdlcGf7Ops, wGf7OpCodeErrCnt),
+	SDLC_GF_ITEM(8, 0x80),
+	SDLC_GF_ITEM(9, 0x90),
+	SDLC_GF_ITEM(11, 0xB0),
+	SDLC_GF_ITEM(12, 0xC0),
+};
+
+/* Control byte -> table index + 1, so zero marks an unknown control. */
+LOCAL UINT8 g_sdlcGfIndex[256];
+LOCAL IsSwapPlan g_sdlcGfPlan[SDLC_GF_TBL_NUM];
+LOCAL SEM_ID g_sidSdlcGfRoutine = SEM_ID_NULL;
+
+/*
+ * Derives the swap plan of pDesc from its tmSwapGfN(). Two probe frames
+ * tag every byte with its position, so the swapped probes show where each
+ * byte went. The plan is then checked against the routine on a scrambled
+ * frame; a routine that is not a pure byte permutation keeps no plan.
+ */
+LOCAL STATUS learnPlan(const SdlcGfDesc *pDesc, IsSwapPlan *pPlan) {
+	int size = pDesc->size;
+	UINT8 *pIn = (UINT8 *)malloc(size);
+	UINT8 *pOut = (UINT8 *)malloc(size);
+	UINT8 *pRef = (UINT8 *)malloc(size);
+	UINT16 *pMap = (UINT16 *)malloc(size * sizeof(UINT16));
+	STATUS ret = ERROR;
+	int i;
+	
+	if ((pIn != NULL) && (pOut != NULL) && (pRef != NULL) && (pMap != NULL)) {
+		for (i = 0; i < size; i++)
+			pIn[i] = (UINT8)i;
+		memcpy(pOut, pIn, size);
+		SdlcGfSwapRoutine(pDesc, pOut, pIn);
+		for (i = 0; i < size; i++)
+			pMap[i] = pOut[i];
+		
+		for (i = 0; i < size; i++)
+			pIn[i] = (UINT8)(i >> 8);
+		memcpy(pOut, pIn, size);
+		SdlcGfSwapRoutine(pDesc, pOut, pIn);
+		for (i = 0; i < size; i++)
+			pMap[i] |= (UINT16)(pOut[i] << 8);
+		
+		if (isSwapPlanBuild(pPlan, pMap, size) == OK) {
+			for (i = 0; i < size; i++)
+				pIn[i] = (UINT8)((i * 2654435761U) >> 24);
+			memcpy(pRef, pIn, size);
+			SdlcGfSwapRoutine(pDesc, pRef, pIn);
+			isSwapPlanRun(pPlan, pOut, pIn);
+			if (memcmp(pOut, pRef, size) == 0)
+				ret = OK;
+		}
+	}
+	
+	free(pIn);
+	free(pOut);
+	free(pRef);
+	free(pMap);
+	
+	return ret;
+}
+
+/* Called by tSdlcRecvGcu of unit 0 before any unit receives anything. */
+STATUS SdlcGfTblInit(void) {
+	SdlcGfDesc *pDesc;
+	int i;
+	
+	if (g_sidSdlcGfRoutine == SEM_ID_NULL) {
+		g_sidSdlcGfRoutine = semMCreate(SEM_Q_PRIORITY | SEM_DELETE_SAFE | SEM_INVERSION_SAFE);
+		if (g_sidSdlcGfRoutine == SEM_ID_NULL) {
+			LOGMSG("semMCreate() error!\n");
+			return ERROR;
+		}
+	}
+	
+	memset(g_sdlcGfIndex, 0, sizeof(g_sdlcGfIndex));
+	
+	for (i = 0; i < SDLC_GF_TBL_NUM; i++) {
+		pDesc = &g_sdlcGfTbl[i];
+		if (g_sdlcGfIndex[pDesc->control] != 0) {
+			LOGMSG("Duplicated control 0x%02X (%s).\n", pDesc->control, pDesc->szName);
+			return ERROR;
+		}
+		g_sdlcGfIndex[pDesc->control] = (UINT8)(i + 1);
+		
+		pDesc->pPlan = (learnPlan(pDesc, &g_sdlcGfPlan[i]) == OK) ? &g_sdlcGfPlan[i] : NULL;
+	}
+	
+	return OK;
+}
+
+const SdlcGfDesc *SdlcGfDescFind(UINT8 control) {
+	UINT8 index = g_sdlcGfIndex[control];
+	
+	return (index == 0) ? NULL : &g_sdlcGfTbl[index - 1];
+}
+
+const SdlcGfDesc *SdlcGfDescGet(TmWaitSrc src) {
+	int i;
+	
+	for (i = 0; i < SDLC_GF_TBL_NUM; i++) {
+		if (g_sdlcGfTbl[i].src == TM_WAIT_SRC_TYPE(src))
+			return &g_sdlcGfTbl[i];
+	}
+	
+	return NULL;
+}
+
+STATUS SdlcGfHookSet(UINT8 control, SdlcGfHook pfnHook) {
+	UINT8 index = g_sdlcGfIndex[control];
+	
+	if (index == 0)
+		return ERROR;
+	
+	g_sdlcGfTbl[index - 1].pfnHook = pfnHook;
+	
+	return OK;
+}
+
+/* Response word of a swapped frame of a type with response codes. */
+UINT16 SdlcGfResp(const SdlcGfDesc *pDesc, const void *pFrame) {
+	UINT16 resp;
+	
+	memcpy(&resp, (const UINT8 *)pFrame + pDesc->respOffset, sizeof(resp));
+	
+	return resp;
+}
+
+const SdlcGfOp *SdlcGfOpFind(const SdlcGfDesc *pDesc, const void *pFrame) {
+	UINT16 resp;
+	int i;
+	
+	if (pDesc->numOps == 0)
+		return NULL;
+	
+	resp = SdlcGfResp(pDesc, pFrame) & SDLC_GF_RESP_MASK;
+	
+	for (i = 0; i < pDesc->numOps; i++) {
+		if (pDesc->pOps[i].code == resp)
+			return &pDesc->pOps[i];
+	}
+	
+	return NULL;
+}
+
+/* Swaps the received frame pSrc into pDst; reentrant when the type has a plan. */
+void SdlcGfSwap(const SdlcGfDesc *pDesc, void *pDst, const void *pSrc) {
+	if (pDesc->pPlan == NULL) {
+		SdlcGfSwapRoutine(pDesc, pDst, pSrc);
+		return;
+	}
+	
+	isSwapPlanRun(pDesc->pPlan, pDst, pSrc);
+}
+
+/*
+ * The same through tmSwapGfN(), which only works on g_pTmSdlcGfRx and
+ * g_pTmGfN. Those are shared by every unit, so calls are serialized, and
+ * they are pointed back where they were once the routine has run: pDst
+ * and pSrc may be a probe buffer that is about to be freed.
+ */
+void SdlcGfSwapRoutine(const SdlcGfDesc *pDesc, void *pDst, const void *pSrc) {
+	TM_TYPE_SDLC_RX *pPrevRx;
+	void *pPrevFrame;
+	
+	semTake(g_sidSdlcGfRoutine, WAIT_FOREVER);
+	pPrevRx = g_pTmSdlcGfRx;
+	pPrevFrame = *pDesc->ppFrame;
+	g_pTmSdlcGfRx = (TM_TYPE_SDLC_RX *)pSrc;
+	*pDesc->ppFrame = pDst;
+	pDesc->pfnSwap();
+	g_pTmSdlcGfRx = pPrevRx;
+	*pDesc->ppFrame = pPrevFrame;
+	semGive(g_sidSdlcGfRoutine);
+}
+
+void sdlcGfTblShow(void) {
+	const SdlcGfDesc *pDesc;
+	int i;
+	
+	printf("swap kernel: %s\n", isSwapKernel());
+	printf("%-5s %4s %5s %3s %4s %5s %4s %s\n",
+		   "TYPE", "CTRL", "SIZE", "SRC", "LOG", "CODES", "HOOK", "SWAP");
+	for (i = 0; i < SDLC_GF_TBL_NUM; i++) {
+		pDesc = &g_sdlcGfTbl[i];
+		printf("%-5s 0x%02X %5d %3d 0x%02X %5d %4s ", pDesc->szName, pDesc->control,
+			   pDesc->size, pDesc->src, pDesc->logId, pDesc->numOps,
+			   (pDesc->pfnHook != NULL) ? "yes" : "-");
+		if (pDesc->pPlan != NULL)
+			printf("plan, %d runs\n", pDesc->pPlan->numRuns);
+		else
+			printf("tmSwap%s()\n", pDesc->szName);
+	}
+}
+
+/* Frames per second of tmSwapGfN() against the learnt plan for every type. */
+void sdlcGfSwapBench(int numFrames) {
+	const SdlcGfDesc *pDesc;
+	UINT8 *pIn, *pRef, *pOut;
+	UINT64 tRoutine, tPlan;
+	int i, j, size;
+	
+	if (numFrames <= 0)
+		numFrames = SDLC_GF_BENCH_FRAMES;
+	
+	size = sizeof(TM_TYPE_SDLC_RX);
+	pIn = (UINT8 *)malloc(size);
+	pRef = (UINT8 *)malloc(size);
+	pOut = (UINT8 *)malloc(size);
+	if ((pIn == NULL) || (pRef == NULL) || (pOut == NULL)) {
+		printf("malloc(%d) error!\n", size);
+		free(pIn);
+		free(pRef);
+		free(pOut);
+		return;
+	}
+	
+	for (j = 0; j < size; j++)
+		pIn[j] = (UINT8)((j * 2654435761U) >> 24);
+	memcpy(pRef, pIn, size);
+	memcpy(pOut, pIn, size);
+	
+	printf("swap kernel: %s, %d frames per type\n", isSwapKernel(), numFrames);
+	printf("%-5s %5s %5s %12s %12s %6s\n",
+		   "TYPE", "SIZE", "RUNS", "ROUTINE f/s", "PLAN f/s", "GAIN");
+	for (i = 0; i < SDLC_GF_TBL_NUM; i++) {
+		pDesc = &g_sdlcGfTbl[i];
+		tRoutine = isClockNs();
+		for (j = 0; j < numFrames; j++)
+			SdlcGfSwapRoutine(pDesc, pRef, pIn);
+		tRoutine = isClockNs() - tRoutine;
+		
+		if (pDesc->pPlan == NULL) {
+			printf("%-5s %5d %5s %12.0f %12s %6s\n", pDesc->szName, pDesc->size, "-",
+				   numFrames * 1e9 / (tRoutine + 1), "-", "-");
+			continue;
+		}
+		
+		tPlan = isClockNs();
+		for (j = 0; j < numFrames; j++)
+			isSwapPlanRun(pDesc->pPlan, pOut, pIn);
+		tPlan = isClockNs() - tPlan;
+		
+		printf("%-5s %5d %5d %12.0f %12.0f %5.1fx%s\n", pDesc->szName, pDesc->size,
+			   pDesc->pPlan->numRuns, numFrames * 1e9 / (tRoutine + 1),
+			   numFrames * 1e9 / (tPlan + 1), (double)(tRoutine + 1) / (tPlan + 1),
+			   (memcmp(pOut, pRef, pDesc->size) == 0) ? "" : " MISMATCH");
+	}
+	
+	free(pIn);
+	free(pRef);
+	free(pOut);
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <vxWorks.h>
+
+#include "../lib/util/isSwap.h"
+#include "TmWait.h"
+
+/*
+ * One descriptor per received GF frame type, found by the SDLC control
+ * byte. It holds everything tSdlcRecvGcu does per type: the expected
+ * size, the swap, the TM_COMM_STS counters, the response codes with their
+ * counters and LogSend ids, and an optional hook run after the frame is
+ * logged. The table has no receive-side state, so offline decoders can
+ * use it to size, swap and classify recorded frames.
+ *
+ * src is the frame type; the receiver qualifies it with its unit.
+ *
+ * Counters are byte offsets into TM_COMM_STS. A type without response
+ * codes has numOps 0 and counts every frame it receives.
+ */
+#define SDLC_GF_CNT_NONE		(0xFFFF)
+#define SDLC_GF_RESP_MASK		(0xFF00)
+
+/* Run by tSdlcRecvGcu of the unit that received the frame. */
+typedef void (*SdlcGfHook)(int unit, const void *pFrame);
+
+typedef struct {
+	UINT16	code;			/* response word & SDLC_GF_RESP_MASK */
+	UINT16	cntOffset;		/* counter of this code, or SDLC_GF_CNT_NONE */
+	UINT8	logId;			/* 0 keeps the id of the frame type */
+} SdlcGfOp;
+
+typedef struct {
+	const char *		szName;
+	UINT8				control;
+	UINT8				logId;
+	UINT16				size;
+	TmWaitSrc			src;
+	void				(*pfnSwap)(void);	/* tmSwapGfN(), g_pTmSdlcGfRx into *ppFrame */
+	void **				ppFrame;			/* &g_pTmGfN */
+	UINT16				rxCntOffset;
+	UINT16				sizeErrCntOffset;
+	UINT16				opErrCntOffset;
+	UINT16				respOffset;			/* response word in the frame */
+	const SdlcGfOp *	pOps;
+	int					numOps;
+	SdlcGfHook			pfnHook;
+	const IsSwapPlan *	pPlan;				/* NULL until learnt, or if it cannot be */
+} SdlcGfDesc;
+
+IMPORT STATUS				SdlcGfTblInit(void);
+IMPORT const SdlcGfDesc *	SdlcGfDescFind(UINT8 control);
+IMPORT const SdlcGfDesc *	SdlcGfDescGet(TmWaitSrc src);
+IMPORT STATUS				SdlcGfHookSet(UINT8 control, SdlcGfHook pfnHook);
+IMPORT UINT16				SdlcGfResp(const SdlcGfDesc *pDesc, const void *pFrame);
+IMPORT const SdlcGfOp *		SdlcGfOpFind(const SdlcGfDesc *pDesc, const void *pFrame);
+IMPORT void					SdlcGfSwap(const SdlcGfDesc *pDesc, void *pDst, const void *pSrc);
+IMPORT void					SdlcGfSwapRoutine(const SdlcGfDesc *pDesc, void *pDst, const void *pSrc);
+IMPORT void					sdlcGfTblShow(void);
+IMPORT void					sdlcGfSwapBench(int numFrames);
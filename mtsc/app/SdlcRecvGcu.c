@@ -15,12 +15,25 @@
 #include "SdlcSwap.h"
 #include "tickLib.h"
 #include "Monitoring.h"
+#include "TmWait.h"
+#include "TmField.h"
+#include "TmLimit.h"
+#include "FrameRing.h"
+#include "SdlcGfTbl.h"
+#include "LogBatch.h"
+#include "BulkXfer.h"
+#include "GcuUnit.h"
+#include "HwTime.h"
+#include "GcuLatency.h"
+#include "LinkStats.h"
 
 #define SDLC_RECV_GCU_MSG_Q_LEN		(20)
 #define SDLC_RECV_GCU_EVENT_SDLC	(VXEV01)
 #define SDLC_RECV_GCU_EVENT_CMD		(VXEV02)
 #define SDLC_RECV_GCU_EVENTS \
 	(SDLC_RECV_GCU_EVENT_SDLC | SDLC_RECV_GCU_EVENT_CMD)
+#define SDLC_RECV_GCU_UNIT_PRIORITY		(100)
+#define SDLC_RECV_GCU_UNIT_STACK_SIZE	(100000)
 	
 #define NAV_VE_TOLERANCE			(0.5)
 #define NAV_VN_TOLERANCE			(0.5)
@@ -29,7 +42,8 @@
 #define NAV_ALONG_TOLERANCE			(30.0)
 #define NAV_AHEIGHT_TOLERANCE		(60.0)
 
-#define  SDLC_RECV_GCU_SDLC_CH		(0)
+#define SDLC_GF_COUNT(pUnit, offset) \
+	((*(UINT16 *)((char *)(pUnit)->pCommSts + (offset)))++)
 
 typedef enum {
 	RUNNING,
@@ -50,42 +64,44 @@ typedef struct {
 #endif
 	SdlcRecvGcuState	state;
 	SEM_ID				sidSdlcRx;
+	GcuUnit *			pUnit;
+	char				szName[16];
+	const TM_TYPE_SDLC_RX *	pRx;			/* frame being handled, in the device buffer */
+	UINT32				nRxSize;
+	UINT64				rxCount;		/* HwTimeCount() at the SDLC Rx event */
+	FrameSlot			rxRing[TM_WAIT_SRC_TYPES][FRAME_RING_DEPTH];
+	LOG_DATA			monNavLog;
 } SdlcRecvGcuInst;
 
-LOCAL SdlcRecvGcuInst g_stSdlcRecvGcuInst = {
-	TASK_ID_ERROR, MSGQ, {MSG_Q_ID_NULL}, "",
+/* One instance per GCU unit; unit 0 is the module the start-up spawns. */
+LOCAL SdlcRecvGcuInst g_stSdlcRecvGcuInst[GCU_UNIT_MAX] = {
+	{ TASK_ID_ERROR, MSGQ, {MSG_Q_ID_NULL}, "", },
+	{ TASK_ID_ERROR, MSGQ, {MSG_Q_ID_NULL}, "", },
+	{ TASK_ID_ERROR, MSGQ, {MSG_Q_ID_NULL}, "", },
+	{ TASK_ID_ERROR, MSGQ, {MSG_Q_ID_NULL}, "", },
 };
 
-LOCAL TM_TYPE_SDLC_RX	g_stSdlcRxBuf;
-LOCAL UINT32			g_nSdlcRxSize;
-
-LOCAL LOG_DATA			g_tmGf2Log;
-LOCAL LOG_DATA			g_tmGf3Log;
-LOCAL LOG_DATA			g_tmGf5Log;
-LOCAL LOG_DATA			g_tmGf6Log;
-LOCAL LOG_DATA			g_tmGf7Log;
-LOCAL LOG_DATA			g_tmGf8Log;
-LOCAL LOG_DATA			g_tmGf9Log;
-LOCAL LOG_DATA			g_tmGf11Log;
-LOCAL LOG_DATA			g_tmGf12Log;
-
-LOCAL LOG_DATA			g_monNavLog;
-
-const ModuleInst *g_hSdlcRecvGcu = (ModuleInst *)&g_stSdlcRecvGcuInst;
-
-TM_TYPE_SDLC_TX * g_pTmSdlcGfRx = &g_stSdlcRxBuf;
-TM_TYPE_GF2 * g_pTmGf2 = &g_tmGf2Log.formatted.body.sdlcRx.gf2;
-TM_TYPE_GF3 * g_pTmGf3 = &g_tmGf3Log.formatted.body.sdlcRx.gf3;
-TM_TYPE_GF5 * g_pTmGf5 = &g_tmGf5Log.formatted.body.sdlcRx.gf5;
-TM_TYPE_GF6 * g_pTmGf6 = &g_tmGf6Log.formatted.body.sdlcRx.gf6;
-TM_TYPE_GF7 * g_pTmGf7 = &g_tmGf7Log.formatted.body.sdlcRx.gf7;
-TM_TYPE_GF8 * g_pTmGf8 = &g_tmGf8Log.formatted.body.sdlcRx.gf8;
-TM_TYPE_GF8 * g_pTmGf9 = &g_tmGf9Log.formatted.body.sdlcRx.gf9;
-TM_TYPE_GF11 * g_pTmGf11 = &g_tmGf11Log.formatted.body.sdlcRx.gf11;
-TM_TYPE_GF12 * g_pTmGf12 = &g_tmGf12Log.formatted.body.sdlcRx.gf12;
-
-MonitoringNavLog * g_pMonNav = &g_monNavLog.formatted.body.monitoringNav;
-
+const ModuleInst *g_hSdlcRecvGcu = (ModuleInst *)&g_stSdlcRecvGcuInst[0];
+
+/* Deprecated: the nav check of unit 0 only; use the MONITORING_NAV log. */
+MonitoringNavLog * g_pMonNav = &g_stSdlcRecvGcuInst[0].monNavLog.formatted.body.monitoringNav;
+
+/* Working pointers of the tmSwapGfN() routines, see SdlcGfSwapRoutine(). */
+TM_TYPE_SDLC_RX * g_pTmSdlcGfRx;
+TM_TYPE_GF2 * g_pTmGf2;
+TM_TYPE_GF3 * g_pTmGf3;
+TM_TYPE_GF5 * g_pTmGf5;
+TM_TYPE_GF6 * g_pTmGf6;
+TM_TYPE_GF7 * g_pTmGf7;
+TM_TYPE_GF8 * g_pTmGf8;
+TM_TYPE_GF9 * g_pTmGf9;
+TM_TYPE_GF11 * g_pTmGf11;
+TM_TYPE_GF12 * g_pTmGf12;
+
+LOCAL STATUS	initShared(void);
+LOCAL STATUS	spawnUnits(void);
+LOCAL void		relayCommand(SdlcRecvGcuInst *this, int cmd);
+LOCAL void		attachRxRing(SdlcRecvGcuInst *this, TmWaitSrc src);
 LOCAL STATUS	InitSdlcRecvGcu(SdlcRecvGcuInst *this);
 LOCAL STATUS	FinalizeSdlcRecvGcu(SdlcRecvGcuInst *this);
 LOCAL STATUS	ExecuteSdlcRecvGcu(SdlcRecvGcuInst *this);
@@ -97,25 +113,134 @@ LOCAL STATUS	OnInitRxFrames(SdlcRecvGcuInst *this);
 LOCAL STATUS 	procCommand(SdlcRecvGcuInst *this);
 LOCAL STATUS	procSdlc(SdlcRecvGcuInst *this);
 
-LOCAL STATUS	handleSdlcRxBuf(void);
-LOCAL STATUS	handleSdlcGf2(void);
-LOCAL STATUS	handleSdlcGf3(void);
-LOCAL STATUS	handleSdlcGf5(void);
-LOCAL STATUS	handleSdlcGf6(void);
-LOCAL STATUS	handleSdlcGf7(void);
-LOCAL STATUS	handleSdlcGf8(void);
-LOCAL STATUS	handleSdlcGf9(void);
-LOCAL STATUS	handleSdlcGf11(void);
-LOCAL STATUS	handleSdlcGf12(void);
+LOCAL void		handleSdlcRxBuf(SdlcRecvGcuInst *this);
+LOCAL void		handleSdlcGf(SdlcRecvGcuInst *this, const SdlcGfDesc *pDesc);
+LOCAL void		postSdlcGf3(int unit, const void *pFrame);
+LOCAL void		postSdlcGf7(int unit, const void *pFrame);
 
 LOCAL int		mtsCheckRange(double dLowerLimit,
 							  double dUpperLimit, double dMeasure);
-LOCAL STATUS	calcNavData(void);
+LOCAL STATUS	calcNavData(SdlcRecvGcuInst *this, const TM_TYPE_GF7 *pGf7);
+
+/* Modules every unit shares, set up once by unit 0. */
+LOCAL STATUS initShared(void) {
+	GcuUnitInit();
+	
+	if (HwTimeInit() == ERROR) {
+		LOGMSG("HwTimeInit() error!\n");
+		return ERROR;
+	}
+	
+	if (LogBatchInit() == ERROR) {
+		LOGMSG("LogBatchInit() error!\n");
+		return ERROR;
+	}
+	
+	if (TmWaitInit() == ERROR) {
+		LOGMSG("TmWaitInit() error!\n");
+		return ERROR;
+	}
+	
+	if (TmFieldInit() == ERROR) {
+		LOGMSG("TmFieldInit() error!\n");
+		return ERROR;
+	}
+	
+	if (TmLimitInit() == ERROR) {
+		LOGMSG("TmLimitInit() error!\n");
+		return ERROR;
+	}
+	
+	if (GcuLatencyInit() == ERROR) {
+		LOGMSG("GcuLatencyInit() error!\n");
+		return ERROR;
+	}
+	
+	if (LinkStatsInit() == ERROR) {
+		LOGMSG("LinkStatsInit() error!\n");
+		return ERROR;
+	}
+	
+	if (SdlcGfTblInit() == ERROR) {
+		LOGMSG("SdlcGfTblInit() error!\n");
+		return ERROR;
+	}
+	
+	SdlcGfHookSet(TM_GF3_SDLC_CONTROL, postSdlcGf3);
+	SdlcGfHookSet(TM_GF7_SDLC_CONTROL, postSdlcGf7);
+	
+	return OK;
+}
+
+/*
+ * Spawns tSdlcRecvGcu and the SdlcSendGcu of the other units; the
+ * receive side follows unit 0 through relayCommand(). A unit whose send
+ * side cannot be spawned still receives.
+ */
+LOCAL STATUS spawnUnits(void) {
+	SdlcRecvGcuInst *pInst;
+	int i;
+	
+	for (i = 1; i < GCU_UNIT_NUM; i++) {
+		pInst = &g_stSdlcRecvGcuInst[i];
+		snprintf(pInst->szName, sizeof(pInst->szName), "%s%d", SDLC_RECV_GCU_TASK_NAME, i);
+		if (taskSpawn(pInst->szName, SDLC_RECV_GCU_UNIT_PRIORITY, VX_FP_TASK,
+					  SDLC_RECV_GCU_UNIT_STACK_SIZE, (FUNCPTR)SdlcRecvGcuMain,
+					  (_Vx_usr_arg_t)pInst, 0, 0, 0, 0, 0, 0, 0, 0, 0) == TASK_ID_ERROR) {
+			LOGMSG("taskSpawn(%s) error!\n", pInst->szName);
+			return ERROR;
+		}
+		
+		GcuUnitSpawnSend(i);
+	}
+	
+	return OK;
+}
+
+/* Start, stop and quit of unit 0 apply to every unit. */
+LOCAL void relayCommand(SdlcRecvGcuInst *this, int cmd) {
+	const GcuUnit *pUnit;
+	int i;
+	
+	if (this->pUnit->unit != 0)
+		return;
+	
+	for (i = 1; i < GCU_UNIT_NUM; i++) {
+		pUnit = GcuUnitGet(i);
+		if ((pUnit->hRecv != NULL) && (PostCmd(pUnit->hRecv, cmd) == ERROR))
+			LOGMSG("PostCmd(%s, %d) error!\n", g_stSdlcRecvGcuInst[i].szName, cmd);
+	}
+}
+
+LOCAL void attachRxRing(SdlcRecvGcuInst *this, TmWaitSrc src) {
+	FrameSlot *pSlots = this->rxRing[src];
+	int i;
+	
+	for (i = 0; i < FRAME_RING_DEPTH; i++) {
+		pSlots[i].log.formatted.index.kind = LOG_SEND_INDEX_KIND_GCU;
+		pSlots[i].log.formatted.index.direction = LOG_SEND_INDEX_DIRECTION_RX;
+		pSlots[i].refCnt = 0;
+		pSlots[i].seq = 0;
+	}
+	
+	FrameRingAttach(GCU_SRC(this->pUnit, src), pSlots, SdlcGfDescGet(src)->size);
+}
 
 LOCAL STATUS	InitSdlcRecvGcu(SdlcRecvGcuInst *this) {
+	int src;
+	
 	this->taskId = taskIdSelf();
-	this->state = STOP;
 	this->sidSdlcRx = SEM_ID_NULL;
+	this->pUnit = GcuUnitGet(this - g_stSdlcRecvGcuInst);
+	
+	if (this->pUnit->unit == 0) {
+		strcpy(this->szName, SDLC_RECV_GCU_TASK_NAME);
+		this->state = STOP;
+		if (initShared() == ERROR)
+			return ERROR;
+	} else {
+		this->state = g_stSdlcRecvGcuInst[0].state;
+	}
 	
 	this->ipcObj.msgQId = msgQCreate(SDLC_RECV_GCU_MSG_Q_LEN,
 									 sizeof(SdlcRecvGcuMsg), MSG_Q_FIFO);
@@ -129,8 +254,8 @@ LOCAL STATUS	InitSdlcRecvGcu(SdlcRecvGcuInst *this) {
 		return ERROR;
 	}
 	
-	if (axiSdlcGetRxSemaphore(SDLC_RECV_GCU_SDLC_CH, &this->sidSdlcRx) == ERROR) {
-		LOGMSG("axiSdlcGetRxSemaphore(%d) error!\n", SDLC_RECV_GCU_SDLC_CH);
+	if (axiSdlcGetRxSemaphore(this->pUnit->sdlcCh, &this->sidSdlcRx) == ERROR) {
+		LOGMSG("axiSdlcGetRxSemaphore(%d) error!\n", this->pUnit->sdlcCh);
 		return ERROR;
 	}
 	
@@ -141,27 +266,16 @@ LOCAL STATUS	InitSdlcRecvGcu(SdlcRecvGcuInst *this) {
 		return ERROR;
 	}
 	
-	g_tmGf2Log.formatted.index.kind = LOG_SEND_INDEX_KIND_GCU;
-	g_tmGf2Log.formatted.index.direction = LOG_SEND_INDEX_DIRECTION_RX;
-	g_tmGf3Log.formatted.index.kind = LOG_SEND_INDEX_KIND_GCU;
-	g_tmGf3Log.formatted.index.direction = LOG_SEND_INDEX_DIRECTION_RX;
-	g_tmGf5Log.formatted.index.kind = LOG_SEND_INDEX_KIND_GCU;
-	g_tmGf5Log.formatted.index.direction = LOG_SEND_INDEX_DIRECTION_RX;
-	g_tmGf6Log.formatted.index.kind = LOG_SEND_INDEX_KIND_GCU;
-	g_tmGf6Log.formatted.index.direction = LOG_SEND_INDEX_DIRECTION_RX;
-	g_tmGf7Log.formatted.index.kind = LOG_SEND_INDEX_KIND_GCU;
-	g_tmGf7Log.formatted.index.direction = LOG_SEND_INDEX_DIRECTION_RX;
-	g_tmGf8Log.formatted.index.kind = LOG_SEND_INDEX_KIND_GCU;
-	g_tmGf8Log.formatted.index.direction = LOG_SEND_INDEX_DIRECTION_RX;
-	g_tmGf9Log.formatted.index.kind = LOG_SEND_INDEX_KIND_GCU;
-	g_tmGf9Log.formatted.index.direction = LOG_SEND_INDEX_DIRECTION_RX;
-	g_tmGf11Log.formatted.index.kind = LOG_SEND_INDEX_KIND_GCU;
-	g_tmGf11Log.formatted.index.direction = LOG_SEND_INDEX_DIRECTION_RX;
-	g_tmGf12Log.formatted.index.kind = LOG_SEND_INDEX_KIND_GCU;
-	g_tmGf12Log.formatted.index.direction = LOG_SEND_INDEX_DIRECTION_RX;
-	
-	g_monNavLog.formatted.index.kind = LOG_SEND_INDEX_KIND_MTE_STS;
-	g_monNavLog.formatted.index.id = LOG_SEND_INDEX_ID_MONITORING_NAV;
+	for (src = 0; src < TM_WAIT_SRC_TYPES; src++)
+		attachRxRing(this, (TmWaitSrc)src);
+	
+	this->monNavLog.formatted.index.kind = LOG_SEND_INDEX_KIND_MTE_STS;
+	this->monNavLog.formatted.index.id = LOG_SEND_INDEX_ID_MONITORING_NAV;
+	
+	GcuUnitBindRecv(this->pUnit->unit, (ModuleInst *)this);
+	
+	if (this->pUnit->unit == 0)
+		return spawnUnits();
 	
 	return OK;
 }
@@ -202,6 +316,10 @@ LOCAL STATUS ExecuteSdlcRecvGcu(SdlcRecvGcuInst *this) {
 			nRet = ERROR;
 			break;
 		}
+		
+		/* As close to the Rx interrupt as the driver lets us get. */
+		if (event & SDLC_RECV_GCU_EVENT_SDLC)
+			this->rxCount = HwTimeCount();
 
 #ifdef USE_CHK_TASK_STATUS
 		updateTaskStatus(this->taskStatus);
@@ -227,22 +345,22 @@ LOCAL void OnStop(SdlcRecvGcuInst *this) {
 	this->state = STOP;
 }
 
+/* Publishes a cleared frame of every type, without waking any waiter. */
 LOCAL STATUS OnInitRxFrames(SdlcRecvGcuInst *this) {
+	TmWaitSrc src;
+	LOG_DATA *pLog;
+	int type;
+	
 	if (this->state == STOP)
 		return ERROR;
 	
-	memset(g_pTmSdlcGfRx, 0x0, sizeof(TM_TYPE_SDLC_RX));
-	
-	memset(g_pTmGf2, 0x0, sizeof(TM_TYPE_GF2));
-	memset(g_pTmGf3, 0x0, sizeof(TM_TYPE_GF3));
-	memset(g_pTmGf5, 0x0, sizeof(TM_TYPE_GF5));
-	memset(g_pTmGf6, 0x0, sizeof(TM_TYPE_GF6));
-	memset(g_pTmGf7, 0x0, sizeof(TM_TYPE_GF7));
-	memset(g_pTmGf8, 0x0, sizeof(TM_TYPE_GF8));
-	memset(g_pTmGf9, 0x0, sizeof(TM_TYPE_GF9));
-	memset(g_pTmGf11, 0x0, sizeof(TM_TYPE_GF11));
-	memset(g_pTmGf12, 0x0, sizeof(TM_TYPE_GF12));
-						 
+	for (type = 0; type < TM_WAIT_SRC_TYPES; type++) {
+		src = GCU_SRC(this->pUnit, type);
+		pLog = FrameRingNext(src);
+		memset(&pLog->formatted.body, 0x0, SdlcGfDescGet(type)->size);
+		FrameRingPublish(src);
+	}
+	
 	return OK;
 }
 
@@ -251,15 +369,19 @@ LOCAL STATUS procCommand(SdlcRecvGcuInst *this) {
 	
 	while (msgQReceive(this->ipcObj.msgQId, (char *)&stMsg, sizeof(stMsg),
 					   NO_WAIT) != ERROR) {
-		if (stMsg.cmd == SDLC_RECV_GCU_QUIT)
+		if (stMsg.cmd == SDLC_RECV_GCU_QUIT) {
+			relayCommand(this, SDLC_RECV_GCU_QUIT);
 			return ERROR;
+		}
 		
 		switch (stMsg.cmd) {
 			case SDLC_RECV_GCU_START:
 				OnStart(this);
+				relayCommand(this, SDLC_RECV_GCU_START);
 				break;
 			case SDLC_RECV_GCU_STOP:
 				OnStop(this);
+				relayCommand(this, SDLC_RECV_GCU_STOP);
 				break;
 			case SDLC_RECV_GCU_INIT_RX_FRAMES:
 				OnInitRxFrames(this);
@@ -276,369 +398,123 @@ LOCAL STATUS procSdlc(SdlcRecvGcuInst *this) {
 	if (semTake(this->sidSdlcRx, NO_WAIT) == ERROR)
 		return ERROR;
 	
-	g_nSdlcRxSize = axiSdlcGetRxLen(SDLC_RECV_GCU_SDLC_CH);
-	if (g_nSdlcRxSize > sizeof(TM_TYPE_SDLC_RX)) {
+	this->pUnit->rxTimeNs = HwTimeToNs(this->rxCount);
+	
+	this->nRxSize = axiSdlcGetRxLen(this->pUnit->sdlcCh);
+	if (this->nRxSize > sizeof(TM_TYPE_SDLC_RX)) {
+		LinkStatsError(this->pUnit->unit, LINK_STATS_ERR_LENGTH, TM_WAIT_SRC_TYPES);
 		LOGMSG("[%s] Invalid Rx. Size...(%d)\n",
-			   SDLC_RECV_GCU_TASK_NAME, g_nSdlcRxSize);
-			   
+			   this->szName, this->nRxSize);
+		
 		return ERROR;
 	}
 	
-	const void * restrict pAxiSdlcRxBuf = axiSdlcGetRxBuf(SDLC_RECV_GCU_SDLC_CH);
+	const void * restrict pAxiSdlcRxBuf = axiSdlcGetRxBuf(this->pUnit->sdlcCh);
 	if (pAxiSdlcRxBuf == NULL) {
 		LOGMSG("Cannot Get SDLC Rx. Buffer...\n");
 		
 		return ERROR;
 	}
 	
-	memcpy(g_pTmSdlcGfRx, pAxiSdlcRxBuf, g_nSdlcRxSize);
+	/* Decoded in place; the frame is swapped from the device buffer. */
+	this->pRx = (const TM_TYPE_SDLC_RX *)pAxiSdlcRxBuf;
 	
-	if (g_pTmSdlcGfRx->gf2.m_ADDRESS != TM_SDLC_ADDRESS) {
-		g_pTmCommSts->wAddressErrCnt++;
+	if (this->pRx->gf2.m_ADDRESS != TM_SDLC_ADDRESS) {
+		this->pUnit->pCommSts->wAddressErrCnt++;
+		LinkStatsError(this->pUnit->unit, LINK_STATS_ERR_ADDRESS, TM_WAIT_SRC_TYPES);
 		
 		return ERROR;
 	}
 	
-	handleSdlcRxBuf();
+	handleSdlcRxBuf(this);
 	
 	return OK;
 }
 
-LOCAL void handleSdlcRxBuf(void){
-	switch (g_pTmSdlcGfRx->gf2.m_CONTROL) {
-		case TM_GF2_SDLC_CONTROL:
-			if (g_nSdlcRxSize == sizeof(TM_TYPE_GF2)) {
-				handleSdlcGf2();
-			}
-			else {
-				g_pTmCommSts->wGf2SizeErrCnt++;
-			}
-			break;	
-		case TM_GF3_SDLC_CONTROL:
-			if (g_nSdlcRxSize == sizeof(TM_TYPE_GF3)) {
-				handleSdlcGf3();
-			}
-			else {
-				g_pTmCommSts->wGf3SizeErrCnt++;
-			}
-			break;
-		case TM_GF5_SDLC_CONTROL:
-			if (g_nSdlcRxSize == sizeof(TM_TYPE_GF5)) {
-				handleSdlcGf5();
-			}
-			else {
-				g_pTmCommSts->wGf5SizeErrCnt++;
-			}
-			break;
-		case TM_GF6_SDLC_CONTROL:
-			if (g_nSdlcRxSize == sizeof(TM_TYPE_GF6)) {
-				handleSdlcGf6();
-			}
-			else {
-				g_pTmCommSts->wGf6SizeErrCnt++;
-			}
-			break;
-		case TM_GF7_SDLC_CONTROL:
-			if (g_nSdlcRxSize == sizeof(TM_TYPE_GF7)) {
-				handleSdlcGf7();
-			}
-			else {
-				g_pTmCommSts->wGf7SizeErrCnt++;
-			}
-			break;
-		case TM_GF8_SDLC_CONTROL:
-			if (g_nSdlcRxSize == sizeof(TM_TYPE_GF8)) {
-				handleSdlcGf8();
-			}
-			else {
-				g_pTmCommSts->wGf8SizeErrCnt++;
-			}
-			break;
-		case TM_GF9_SDLC_CONTROL:
-			if (g_nSdlcRxSize == sizeof(TM_TYPE_GF9)) {
-				handleSdlcGf9();
-			}
-			else {
-				g_pTmCommSts->wGf9SizeErrCnt++;
-			}
-			break;
-		case TM_GF11_SDLC_CONTROL:
-			if (g_nSdlcRxSize == sizeof(TM_TYPE_GF11)) {
-				handleSdlcGf11();
-			}
-			else {
-				g_pTmCommSts->wGf11SizeErrCnt++;
-			}
-			break;
-		case TM_GF12_SDLC_CONTROL:
-			if (g_nSdlcRxSize == sizeof(TM_TYPE_GF12)) {
-				handleSdlcGf12();
-			}
-			else {
-				g_pTmCommSts->wGf12SizeErrCnt++;
-			}
-			break;
-		default:
-			g_pTmCommSts->wControlErrCnt++;
-			break;
-	}
-}
-
-LOCAL void handleSdlcGf2(void) {
-	tmSwapGf2();
-	
-	switch (g_pTmGf2->m_GCU_RESP & 0xFF00) {
-		case TM_FG2_1_OPCODE_MODE_LAUNCH:
-		case TM_FG2_1_OPCODE_MODE_HILS:
-		case TM_FG2_1_OPCODE_MODE_TEST:
-		case TM_FG2_1_OPCODE_MODE_GCU_PROGRAM:
-		case TM_FG2_1_OPCODE_MSL_COMM_START:
-		case TM_FG2_1_OPCODE_MSL_START_GNC:
-		case TM_FG2_1_OPCODE_ACT_TEST_START:
-		case TM_FG2_1_OPCODE_ACT_TEST_END:
-			g_pTmCommSts->wGf2RxCnt++;
-			g_pTmCommSts->wGf21RxCnt++;
-			break;
-		case TM_FG2_2_OPCODE:
-			g_pTmCommSts->wGf2RxCnt++;
-			g_pTmCommSts->wGf22RxCnt++;
-			break;
-		case TM_FG2_2_OPCODE:
-			g_pTmCommSts->wGf2RxCnt++;
-			g_pTmCommSts->wGf22RxCnt++;
-			break;
-		case TM_FG2_3_OPCODE:
-			g_pTmCommSts->wGf2RxCnt++;
-			g_pTmCommSts->wGf23RxCnt++;
-			break;
-		case TM_FG2_4_OPCODE:
-			g_pTmCommSts->wGf2RxCnt++;
-			g_pTmCommSts->wGf24RxCnt++;
-			break;
-			
-		case TM_FG2_1_OPCODE_MSL_MOTOR_ON:
-			g_pTmCommSts->wGf2RxCnt++;
-			g_pTmCommSts->wGf28RxCnt++;
-			break;
-		
-		case TM_FG2_2_OPCODE_MSL_LIFT_OFF_READY:
-			g_pTmCommSts->wGf2RxCnt++;
-			g_pTmCommSts->wGf29RxCnt++;
-			break;
-			
-		case TM_FG3_1_OPCODE:
-			g_pTmCommSts->wGf2RxCnt++;
-			break;
-			
-		default:
-			g_pTmCommSts->wGf2OpCodeErrCnt++;
-			break;
-	}
+LOCAL void handleSdlcRxBuf(SdlcRecvGcuInst *this) {
+	const SdlcGfDesc *pDesc = SdlcGfDescFind(this->pRx->gf2.m_CONTROL);
 	
-	g_tmGf2Log.formatted.tickLog = tickGet();
-	g_tmGf2Log.formatted.index.id = 0x20;
-	PostLogSendCmdEx(LOG_SEND_TX, (const char *)(&g_tmGf2Log),
-					 sizeof(TM_TYPE_GF2) + OFFSET(LOG_DATA, formatted.body));
-}
-
-LOCAL void handleSdlcGf3(void) {
-	tmSwapGf3();
-	
-	switch (g_pTmGf3->gf3_1.m_GCU_RESP & 0xFF00) {
-		case TM_TCS_GCU_RESP_CODE_GF3_1:
-			g_tmGf3Log.formatted.index.id = 0x31;
-			g_pTmCommSts->wGf3RxCnt++;
-			break;
-			
-		case TM_TCS_GCU_RESP_CODE_GF3_2:
-			g_tmGf3Log.formatted.index.id = 0x32;
-			g_pTmCommSts->wGf3RxCnt++;
-			break;
-		case TM_TCS_GCU_RESP_CODE_GF3_A:
-		case TM_TCS_GCU_RESP_CODE_GF3_B:
-			g_tmGf3Log.formatted.index.id = 0x33;
-			g_pTmCommSts->wGf3RxCnt++;
-			break;
-		case TM_TCS_GCU_RESP_CODE_GF3_4:
-			g_tmGf3Log.formatted.index.id = 0x34;
-			g_pTmCommSts->wGf3RxCnt++;
-			break;
-		
-		default:
-			g_pTmCommSts->wGf3OpCodeErrCnt++;
-			break;
+	if (pDesc == NULL) {
+		this->pUnit->pCommSts->wControlErrCnt++;
+		LinkStatsError(this->pUnit->unit, LINK_STATS_ERR_CONTROL, TM_WAIT_SRC_TYPES);
+		return;
 	}
 	
-	g_tmGf3Log.formatted.tickLog = tickGet();
-	PostLogSendCmdEx(LOG_SEND_TX, (const char *)(&g_tmGf3Log),
-					 sizeof(TM_TYPE_GF3) + OFFSET(LOG_DATA, formatted, body));
-}
-
-LOCAL void handleSdlcGf5(void) {
-	tmSwapGf5();
-	
-	switch (g_pTmGf5->m_MAR_RESP & 0xFF00) {
-		case TM_GF5_OPCODE:
-		g_pTmCommSts->wGf5RxCnt++;
-		g_tmGf5Log.formatted.index.id = 0x50;
-		break;
-		
-		default:
-			g_pTmCommSts->wGf5OpCodeErrCnt++;
-			break;
-	}
-	
-	g_tmGf5Log.formatted.ticklog = tickGet();
-	PostLogSendCmdEx(LOG_SEND_TX, (const char *)(&g_tmGf5Log),
-					 sizeof(TM_TYPE_GF5) + OFFSET(LOG_DATA, formatted.body));
-}
-
-LOCAL void handleSdlcGf6(void) {
-	tmSwapGf6();
-	
-	switch (g_pTmGf6->gf6_1.m_MAR_RESP & 0xFF00) {
-		case TM_GF6_1_OPCODE:
-			g_pTmCommSts->wGf6RxCnt++;
-			g_pTmCommSts->wGf61RxCnt++;
-			g_tmGf6Log.formatted.index.id = 0x61;
-			break;
-		
-		case TM_GF6_2_OPCODE:
-			g_pTmCommSts->wGf6RxCnt++;
-			g_pTmCommSts->wGf62RxCnt++;
-			g_tmGf6Log.formatted.index.id = 0x62;
-			break;
-		
-		case TM_GF6_3_OPCODE:
-			g_pTmCommSts->wGf6RxCnt++;
-			g_pTmCommSts->wGf63RxCnt++;
-			g_tmGf6Log.formatted.index.id = 0x63;
-			break;
-		
-		case TM_GF6_4_OPCODE:
-			g_pTmCommSts->wGf6RxCnt++;
-			g_pTmCommSts->wGf64RxCnt++;
-			g_tmGf6Log.formatted.index.id = 0x64;
-			break;
-			
-		case TM_GF6_5_OPCODE:
-			g_pTmCommSts->wGf6RxCnt++;
-			g_pTmCommSts->wGf65RxCnt++;
-			g_tmGf6Log.formatted.index.id = 0x65;
-			break;
-			
-		default:
-			g_pTmCommSts->wGf60pCodeErrCnt++;
-			break;
+	if (this->nRxSize != pDesc->size) {
+		SDLC_GF_COUNT(this->pUnit, pDesc->sizeErrCntOffset);
+		LinkStatsError(this->pUnit->unit, LINK_STATS_ERR_SIZE, pDesc->src);
+		return;
 	}
 	
-	g_tmGf6Log.formatted.ticklog = tickGet();
-	PostLogSendCmdEx(LOG_SEND_TX, (const char *)(&g_tmGf6Log),
-					 sizeof(TM_TYPE_GF5) + OFFSET(LOG_DATA, formatted.body));
+	handleSdlcGf(this, pDesc);
 }
 
-LOCAL void handleSdlcGf7(void) {
-	tmSwapGf7();
-	
-	switch (g_pTmGf7->m_NAV_RESP & 0xFF00) {
-		case TM_TCS_INS_RESP_CODE_GF7_2;
-			g_pTmCommSts->wGf7RxCnt++;
-			g_pTmCommSts->wGf72RxCnt++;
-			break;
-			
-		case TM_TCS_INS_RESP_CODE_GF7_3;
-			g_pTmCommSts->wGf7RxCnt++;
-			g_pTmCommSts->wGf73RxCnt++;
-			break;
-			
-		case TM_TCS_INS_RESP_CODE_GF7_4;
-			g_pTmCommSts->wGf7RxCnt++;
-			g_pTmCommSts->wGf74RxCnt++;
-			break;
-		
-		case TM_TCS_INS_RESP_CODE_GF7_5;
-			g_pTmCommSts->wGf7RxCnt++;
-			g_pTmCommSts->wGf75RxCnt++;
-			break;
-			
-		case TM_TCS_INS_RESP_CODE_GF7_6;
-			g_pTmCommSts->wGf7RxCnt++;
-			g_pTmCommSts->wGf76RxCnt++;
-			break;
-			
-		case TM_TCS_INS_RESP_CODE_GF7_7;
-			g_pTmCommSts->wGf7RxCnt++;
-			g_pTmCommSts->wGf77RxCnt++;
-			break;
-			
-		case TM_TCS_INS_RESP_CODE_GF7_8;
-			g_pTmCommSts->wGf7RxCnt++;
-			g_pTmCommSts->wGf78RxCnt++;
-			break;
-			
-		case TM_TCS_INS_RESP_CODE_GF7_9;
-			g_pTmCommSts->wGf7RxCnt++;
-			g_pTmCommSts->wGf79RxCnt++;
-			break;
-		
-		default:
-			g_pTmCommSts->wGf7OpCodeErrCnt++;
-			break;
-	}
-	
-	g_tmGf7Log.formatted.tickLog = tickGet();
-	g_tmGf7Log.formatted.index.id = 0x70;
-	PostLogSendCmdEx(LOG_SEND_TX, (const char *)(&g_tmGf7Log),
-					 sizeof(TM_TYPE_GF7) + OFFSET(LOG_DATA, formatted.body));
-	if (calcNavData() == OK) {
-		g_monNavLog.formatted.tickLog = tickGet();
-		PostLogSendCmdEx(LOG_SEND_TX, (const char *)(&g_monNavLog),
-						 sizeof(MonitoringNavLog) + OFFSET(LOG_DATA, formatted.body));
+/*
+ * The frame is swapped from the device buffer into the next ring slot
+ * of its type and unit, counted by its response code, published and
+ * logged.
+ */
+LOCAL void handleSdlcGf(SdlcRecvGcuInst *this, const SdlcGfDesc *pDesc) {
+	GcuUnit *pUnit = this->pUnit;
+	TmWaitSrc src = GCU_SRC(pUnit, pDesc->src);
+	LOG_DATA *pLog = FrameRingNext(src);
+	void *pFrame = &pLog->formatted.body;
+	const SdlcGfOp *pOp;
+	
+	SdlcGfSwap(pDesc, pFrame, this->pRx);
+	FrameRingPublish(src);
+	
+	LinkStatsRx(pUnit->unit, pDesc->src, pDesc->size, pUnit->rxTimeNs);
+	
+	pLog->formatted.index.id = pDesc->logId;
+	if (pDesc->numOps == 0) {
+		SDLC_GF_COUNT(pUnit, pDesc->rxCntOffset);
+	} else if ((pOp = SdlcGfOpFind(pDesc, pFrame)) != NULL) {
+		SDLC_GF_COUNT(pUnit, pDesc->rxCntOffset);
+		if (pOp->cntOffset != SDLC_GF_CNT_NONE)
+			SDLC_GF_COUNT(pUnit, pOp->cntOffset);
+		if (pOp->logId != 0)
+			pLog->formatted.index.id = pOp->logId;
+	} else {
+		SDLC_GF_COUNT(pUnit, pDesc->opErrCntOffset);
+		LinkStatsError(pUnit->unit, LINK_STATS_ERR_OPCODE, pDesc->src);
 	}
-}
-
-LOCAL void handleSdlcGf8(void) {
-	tmSwapGf8();
 	
-	g_pTmCommSts->wGf8RxCnt++;
+	/* Before the publish, so a command woken by the response sees its latency. */
+	if (pDesc->numOps != 0)
+		GcuLatencyRx(pUnit->unit, pDesc->src, SdlcGfResp(pDesc, pFrame), pUnit->rxTimeNs);
 	
-	g_tmGf8Log.formatted.tickLog = tickGet();
-	g_tmGf8Log.formatted.index.id = 0x80;
-	PostLogSendCmdEx(LOG_SEND_TX, (const char *)(&g_tmGf8Log),
-					 sizeof(TM_TYPE_GF8) + OFFSET(LOG_DATA, formatted.body));
-}
-
-LOCAL void handleSdlcGf9(void) {
-	tmSwapGf9();
+	TmWaitPublish(src, this->rxCount);
+	TmLimitEval(src, pFrame, pUnit->rxTimeNs);
 	
-	g_pTmCommSts->wGf9RxCnt++;
+	pLog->formatted.tickLog = tickGet();
+	FrameRingPost(src, pLog, pDesc->size + OFFSET(LOG_DATA, formatted.body),
+				  pUnit->rxTimeNs);
 	
-	g_tmGf9Log.formatted.tickLog = tickGet();
-	g_tmGf9Log.formatted.index.id = 0x90;
-	PostLogSendCmdEx(LOG_SEND_TX, (const char *)(&g_tmGf9Log),
-					 sizeof(TM_TYPE_GF9) + OFFSET(LOG_DATA, formatted.body));
+	if (pDesc->pfnHook != NULL)
+		pDesc->pfnHook(pUnit->unit, pFrame);
 }
 
-LOCAL void handleSdlcGf11(void) {
-	tmSwapGf11();
-	
-	g_pTmCommSts->wGf11RxCnt++;
+LOCAL void postSdlcGf3(int unit, const void *pFrame) {
+	const TM_TYPE_GF3 *pGf3 = (const TM_TYPE_GF3 *)pFrame;
 	
-	g_tmGf11Log.formatted.tickLog = tickGet();
-	g_tmGf11Log.formatted.index.id = 0xB0;
-	PostLogSendCmdEx(LOG_SEND_TX, (const char *)(&g_tmGf11Log),
-					 sizeof(TM_TYPE_GF11) + OFFSET(LOG_DATA, formatted.body));
+	switch (pGf3->gf3_1.m_GCU_RESP & 0xFF00) {
+		case TM_TCS_GCU_RESP_CODE_GF3_A:
+		case TM_TCS_GCU_RESP_CODE_GF3_B:
+			BulkXferAck(unit, pGf3->gf3_3.m_IDX);
+			break;
+	}
 }
 
-LOCAL void handleSdlcGf12(void) {
-	tmSwapGf12();
+LOCAL void postSdlcGf7(int unit, const void *pFrame) {
+	SdlcRecvGcuInst *this = &g_stSdlcRecvGcuInst[unit];
 	
-	g_pTmCommSts->wGf12RxCnt++;
-	
-	g_tmGf12Log.formatted.tickLog = tickGet();
-	g_tmGf12Log.formatted.index.id = 0xC0;
-	PostLogSendCmdEx(LOG_SEND_TX, (const char *)(&g_tmGf12Log),
-					 sizeof(TM_TYPE_GF12) + OFFSET(LOG_DATA, formatted.body));
+	if (calcNavData(this, (const TM_TYPE_GF7 *)pFrame) == OK) {
+		this->monNavLog.formatted.tickLog = tickGet();
+		LogBatchPost(&this->monNavLog,
+					 sizeof(MonitoringNavLog) + OFFSET(LOG_DATA, formatted.body),
+					 this->pUnit->rxTimeNs, FALSE);
+	}
 }
 
 LOCAL int mtsCheckRange(double dLowerLimit, double dUpperLimit, double dMeasure) {
@@ -652,102 +528,104 @@ LOCAL int mtsCheckRange(double dLowerLimit, double dUpperLimit, double dMeasure)
 	return resultType;
 }
 
-LOCAL STATUS calcNavData(void) {
+LOCAL STATUS calcNavData(SdlcRecvGcuInst *this, const TM_TYPE_GF7 *pGf7) {
+	MonitoringNavLog *pMonNav = &this->monNavLog.formatted.body.monitoringNav;
+	const TM_TYPE_FG3 *pFg3 = this->pUnit->pTmFg3;
 	double latTemp, lonTemp, htTemp;
 	
-	if ((g_pTmGf7->m_NAV_STS & 0xF) == 0x4) {
-		g_pMonNav->flightTime = g_pTmGf7->m_MODE_TIME;
+	if ((pGf7->m_NAV_STS & 0xF) == 0x4) {
+		pMonNav->flightTime = pGf7->m_MODE_TIME;
 	} else {
 		return ERROR;
 	}
 	
-	if (g_pMonNav->flightTime < 61) {
-		g_pMonNav->ve60 = (double)(g_pTmGf7->m_AVE * 0.000025);
-		g_pMonNav->vn60 = (double)(g_pTmGf7->m_AVN * 0.000025);
-		g_pMonNav->vu60 = (double)(g_pTmGf7->m_AVU * 0.000025);
+	if (pMonNav->flightTime < 61) {
+		pMonNav->ve60 = (double)(pGf7->m_AVE * 0.000025);
+		pMonNav->vn60 = (double)(pGf7->m_AVN * 0.000025);
+		pMonNav->vu60 = (double)(pGf7->m_AVU * 0.000025);
 		
-		latTemp = fabs(((double)g_pTmGf7->m_ALAT) * 0.000000083819031754);
-		g_pMonNav->errLat60 = (fabs(g_pTmFg3->fg3_1.mXLATL) - latTemp) * 111180;
+		latTemp = fabs(((double)pGf7->m_ALAT) * 0.000000083819031754);
+		pMonNav->errLat60 = (fabs(pFg3->fg3_1.mXLATL) - latTemp) * 111180;
 		
-		lonTemp = fabs(((double)g_pTmGf7->m_ALON) * 0.000000083819031754);
-		g_pMonNav->errLon60 = (fabs(g_pTmFg3->fg3_1.mXLONL) - lonTemp) * 89165;
+		lonTemp = fabs(((double)pGf7->m_ALON) * 0.000000083819031754);
+		pMonNav->errLon60 = (fabs(pFg3->fg3_1.mXLONL) - lonTemp) * 89165;
 		
-		htTemp = fabs(((double)g_pTmGf7->m_AHEIGHT) * 0.005);
-		g_pMonNav->errHt60 = (fabs(g_pTmFg3->fg3_1.m_HL) - htTemp);
+		htTemp = fabs(((double)pGf7->m_AHEIGHT) * 0.005);
+		pMonNav->errHt60 = (fabs(pFg3->fg3_1.m_HL) - htTemp);
 		
-		g_pMonNav->sts60.bit.ve = RESULT_TYPE_ONGOING;
-		g_pMonNav->sts60.bit.vn = RESULT_TYPE_ONGOING;
-		g_pMonNav->sts60.bit.vu = RESULT_TYPE_ONGOING;
+		pMonNav->sts60.bit.ve = RESULT_TYPE_ONGOING;
+		pMonNav->sts60.bit.vn = RESULT_TYPE_ONGOING;
+		pMonNav->sts60.bit.vu = RESULT_TYPE_ONGOING;
 		
-		g_pMonNav->sts60.bit.errLat = RESULT_TYPE_ONGOING;
-		g_pMonNav->sts60.bit.errLon = RESULT_TYPE_ONGOING;
-		g_pMonNav->sts60.bit.errHt = RESULT_TYPE_ONGOING;
-	} else if (g_pMonNav->flightTime == 61) {
-		g_pMonNav->sts60.bit.ve = mtsCheckRange(-NAV_VE_TOLERANCE, NAV_VE_TOLERANCE, g_pMonNav->ve60);
-		g_pMonNav->sts60.bit.vn = mtsCheckRange(-NAV_VN_TOLERANCE, NAV_VN_TOLERANCE, g_pMonNav->vn60);
-		g_pMonNav->sts60.bit.vu = mtsCheckRange(-NAV_VU_TOLERANCE, NAV_VU_TOLERANCE, g_pMonNav->vu60);
+		pMonNav->sts60.bit.errLat = RESULT_TYPE_ONGOING;
+		pMonNav->sts60.bit.errLon = RESULT_TYPE_ONGOING;
+		pMonNav->sts60.bit.errHt = RESULT_TYPE_ONGOING;
+	} else if (pMonNav->flightTime == 61) {
+		pMonNav->sts60.bit.ve = mtsCheckRange(-NAV_VE_TOLERANCE, NAV_VE_TOLERANCE, pMonNav->ve60);
+		pMonNav->sts60.bit.vn = mtsCheckRange(-NAV_VN_TOLERANCE, NAV_VN_TOLERANCE, pMonNav->vn60);
+		pMonNav->sts60.bit.vu = mtsCheckRange(-NAV_VU_TOLERANCE, NAV_VU_TOLERANCE, pMonNav->vu60);
 		
-		g_pMonNav->sts60.bit.errLat = mtsCheckRange(-NAV_ALAT_TOLERANCE, NAV_ALAT_TOLERANCE, g_pMonNav->errLat60);
-		g_pMonNav->sts60.bit.errLon = mtsCheckRange(-NAV_ALONG_TOLERANCE, NAV_ALONG_TOLERANCE, g_pMonNav->errLon60);
-		g_pMonNav->sts60.bit.errHt = mtsCheckRange(-NAV_AHEIGHT_TOLERANCE, NAV_AHEIGHT_TOLERANCE, g_pMonNav->errHt60);
-	} else if (g_pMonNav->flightTime > 61 && g_pMonNav->flightTime < 181) {
-		g_pMonNav->ve180 = (double)(g_pTmGf7->m_AVE * 0.000025);
-		g_pMonNav->vn180 = (double)(g_pTmGf7->m_AVN * 0.000025);
-		g_pMonNav->vu180 = (double)(g_pTmGf7->m_AVU * 0.000025);
+		pMonNav->sts60.bit.errLat = mtsCheckRange(-NAV_ALAT_TOLERANCE, NAV_ALAT_TOLERANCE, pMonNav->errLat60);
+		pMonNav->sts60.bit.errLon = mtsCheckRange(-NAV_ALONG_TOLERANCE, NAV_ALONG_TOLERANCE, pMonNav->errLon60);
+		pMonNav->sts60.bit.errHt = mtsCheckRange(-NAV_AHEIGHT_TOLERANCE, NAV_AHEIGHT_TOLERANCE, pMonNav->errHt60);
+	} else if (pMonNav->flightTime > 61 && pMonNav->flightTime < 181) {
+		pMonNav->ve180 = (double)(pGf7->m_AVE * 0.000025);
+		pMonNav->vn180 = (double)(pGf7->m_AVN * 0.000025);
+		pMonNav->vu180 = (double)(pGf7->m_AVU * 0.000025);
 		
-		latTemp = fabs(((double)g_pTmGf7->m_ALAT) * 0.000000083819031754);
-		g_pMonNav->errLat180 = (fabs(g_pTmFg3->fg3_1.m_XLATL) - latTemp) * 111180;
+		latTemp = fabs(((double)pGf7->m_ALAT) * 0.000000083819031754);
+		pMonNav->errLat180 = (fabs(pFg3->fg3_1.m_XLATL) - latTemp) * 111180;
 		
-		lonTemp = fabs(((double)g_pTmGf7->m_ALON) * 0.000000083819031754);
-		g_pMonNav->errLon180 = (fabs(g_pTmFg3->fg3_1.m_XLONL) - lonTemp) * 89165;
+		lonTemp = fabs(((double)pGf7->m_ALON) * 0.000000083819031754);
+		pMonNav->errLon180 = (fabs(pFg3->fg3_1.m_XLONL) - lonTemp) * 89165;
 		
-		htTemp =  fabs(((double)g_pTmGf7->m_AHEIGHT) * 0.005);
-		g_pMonNav->errHt180 = (fabs(g_pTmFg3->fg3_1.m_HL) - htTemp);
+		htTemp =  fabs(((double)pGf7->m_AHEIGHT) * 0.005);
+		pMonNav->errHt180 = (fabs(pFg3->fg3_1.m_HL) - htTemp);
 		
-		g_pMonNav->sts180.bit.ve = RESULT_TYPE_ONGOING;
-		g_pMonNav->sts180.bit.vn = RESULT_TYPE_ONGOING;
-		g_pMonNav->sts180.bit.vu = RESULT_TYPE_ONGOING;
+		pMonNav->sts180.bit.ve = RESULT_TYPE_ONGOING;
+		pMonNav->sts180.bit.vn = RESULT_TYPE_ONGOING;
+		pMonNav->sts180.bit.vu = RESULT_TYPE_ONGOING;
 		
-		g_pMonNav->sts180.bit.errLat = RESULT_TYPE_ONGOING;
-		g_pMonNav->sts180.bit.errLon = RESULT_TYPE_ONGOING;
-		g_pMonNav->sts180.bit.errHt = RESULT_TYPE_ONGOING;
-	} else if (g_pMonNav->flightTime == 181) {
-		g_pMonNav->sts180.bit.ve = mtsCheckRange(-NAV_VE_TOLERANCE, NAV_VE_TOLERANCE, g_pMonNav->ve180);
-		g_pMonNav->sts180.bit.vn = mtsCheckRange(-NAV_VN_TOLERANCE, NAV_VN_TOLERANCE, g_pMonNav->vn180);
-		g_pMonNav->sts180.bit.vu = mtsCheckRange(-NAV_VU_TOLERANCE, NAV_VU_TOLERANCE, g_pMonNav->vu180);
+		pMonNav->sts180.bit.errLat = RESULT_TYPE_ONGOING;
+		pMonNav->sts180.bit.errLon = RESULT_TYPE_ONGOING;
+		pMonNav->sts180.bit.errHt = RESULT_TYPE_ONGOING;
+	} else if (pMonNav->flightTime == 181) {
+		pMonNav->sts180.bit.ve = mtsCheckRange(-NAV_VE_TOLERANCE, NAV_VE_TOLERANCE, pMonNav->ve180);
+		pMonNav->sts180.bit.vn = mtsCheckRange(-NAV_VN_TOLERANCE, NAV_VN_TOLERANCE, pMonNav->vn180);
+		pMonNav->sts180.bit.vu = mtsCheckRange(-NAV_VU_TOLERANCE, NAV_VU_TOLERANCE, pMonNav->vu180);
 		
-		g_pMonNav->sts180.bit.errLat = mtsCheckRange(-NAV_ALAT_TOLERANCE, NAV_ALAT_TOLERANCE, g_pMonNav->errLat180);
-		g_pMonNav->sts180.bit.errLon = mtsCheckRange(-NAV_ALONG_TOLERANCE, NAV_ALONG_TOLERANCE, g_pMonNav->errLon180);
-		g_pMonNav->sts180.bit.errHt = mtsCheckRange(-NAV_AHEIGHT_TOLERANCE, NAV_AHEIGHT_TOLERANCE, g_pMonNav->errHt180);
-	} else if (g_pMonNav->flightTime > 181 && g_pMonNav->flightTime < 301) {
-		g_pMonNav->ve300 = (double)(g_pTmGf7->m_AVE * 0.000025);
-		g_pMonNav->vn300 = (double)(g_pTmGf7->m_AVN * 0.000025);
-		g_pMonNav->vu300 = (double)(g_pTmGf7->m_AVU * 0.000025);
+		pMonNav->sts180.bit.errLat = mtsCheckRange(-NAV_ALAT_TOLERANCE, NAV_ALAT_TOLERANCE, pMonNav->errLat180);
+		pMonNav->sts180.bit.errLon = mtsCheckRange(-NAV_ALONG_TOLERANCE, NAV_ALONG_TOLERANCE, pMonNav->errLon180);
+		pMonNav->sts180.bit.errHt = mtsCheckRange(-NAV_AHEIGHT_TOLERANCE, NAV_AHEIGHT_TOLERANCE, pMonNav->errHt180);
+	} else if (pMonNav->flightTime > 181 && pMonNav->flightTime < 301) {
+		pMonNav->ve300 = (double)(pGf7->m_AVE * 0.000025);
+		pMonNav->vn300 = (double)(pGf7->m_AVN * 0.000025);
+		pMonNav->vu300 = (double)(pGf7->m_AVU * 0.000025);
 		
-		latTemp = fabs(((double)g_pTmGf7->m_ALAT) * 0.000000083819031754);
-		g_pMonNav->errLat300 = (fabs(g_pTmFg3->fg3_1.m_XLATL) - latTemp) * 111180;
+		latTemp = fabs(((double)pGf7->m_ALAT) * 0.000000083819031754);
+		pMonNav->errLat300 = (fabs(pFg3->fg3_1.m_XLATL) - latTemp) * 111180;
 		
-		lonTemp = fabs(((double)g_pTmGf7->m_ALON) * 0.000000083819031754);
-		g_pMonNav->errLon300 = (fabs(g_pTmFg3->fg3_1.m_XLATL) - lonTemp) * 89165;
+		lonTemp = fabs(((double)pGf7->m_ALON) * 0.000000083819031754);
+		pMonNav->errLon300 = (fabs(pFg3->fg3_1.m_XLATL) - lonTemp) * 89165;
 		
-		htTemp = fabs(((double)g_pTmGf7->m_AHEIGHT) * 0.0H);
-		g_pMonNav->errHt300 = (fabs(g_pTmFg3->fg3_1.m_HL) - htTemp);
+		htTemp = fabs(((double)pGf7->m_AHEIGHT) * 0.0H);
+		pMonNav->errHt300 = (fabs(pFg3->fg3_1.m_HL) - htTemp);
 		
-		g_pMonNav->sts300.bit.ve = RESULT_TYPE_ONGOING;
-		g_pMonNav->sts300.bit.vn = RESULT_TYPE_ONGOING;
-		g_pMonNav->sts300.bit.vu = RESULT_TYPE_ONGOING;
+		pMonNav->sts300.bit.ve = RESULT_TYPE_ONGOING;
+		pMonNav->sts300.bit.vn = RESULT_TYPE_ONGOING;
+		pMonNav->sts300.bit.vu = RESULT_TYPE_ONGOING;
 		
-		g_pMonNav->sts300.bit.errLat = RESULT_TYPE_ONGOING;
-		g_pMonNav->sts300.bit.errLon = RESULT_TYPE_ONGOING;
-		g_pMonNav->sts300.bit.errHt = RESULT_TYPE_ONGOING;
-	} else if (g_pMonNav->flightTime == 301) {
-		g_pMonNav->sts300.bit.ve = mtsCheckRange(-NAV_VE_TOLERANCE, NAV_VE_TOLERANCE, g_pMonNav->ve300);
-		g_pMonNav->sts300.bit.vn = mtsCheckRange(-NAV_VN_TOLERANCE, NAV_VN_TOLERANCE, g_pMonNav->vn300);
-		g_pMonNav->sts300.bit.vu = mtsCheckRange(-NAV_VU_TOLERANCE, NAV_VU_TOLERANCE, g_pMonNav->vu300);
+		pMonNav->sts300.bit.errLat = RESULT_TYPE_ONGOING;
+		pMonNav->sts300.bit.errLon = RESULT_TYPE_ONGOING;
+		pMonNav->sts300.bit.errHt = RESULT_TYPE_ONGOING;
+	} else if (pMonNav->flightTime == 301) {
+		pMonNav->sts300.bit.ve = mtsCheckRange(-NAV_VE_TOLERANCE, NAV_VE_TOLERANCE, pMonNav->ve300);
+		pMonNav->sts300.bit.vn = mtsCheckRange(-NAV_VN_TOLERANCE, NAV_VN_TOLERANCE, pMonNav->vn300);
+		pMonNav->sts300.bit.vu = mtsCheckRange(-NAV_VU_TOLERANCE, NAV_VU_TOLERANCE, pMonNav->vu300);
 		
-		g_pMonNav->sts300.bit.errLat = mtsCheckRange(-NAV_ALAT_TOLERANCE, NAV_ALAT_TOLERANCE, g_pMonNav->errLat300);
-		g_pMonNav->sts300.bit.errLon = mtsCheckRange(-NAV_ALONG_TOLERANCE, NAV_ALONG_TOLERANCE, g_pMonNav->errLon300);
-		g_pMonNav->sts300.bit.errHt = mtsCheckRange(-NAV_AHEIGHT_TOLERANCE, NAV_AHEIGHT_TOLERANCE, g_pMonNav->errHt300);
+		pMonNav->sts300.bit.errLat = mtsCheckRange(-NAV_ALAT_TOLERANCE, NAV_ALAT_TOLERANCE, pMonNav->errLat300);
+		pMonNav->sts300.bit.errLon = mtsCheckRange(-NAV_ALONG_TOLERANCE, NAV_ALONG_TOLERANCE, pMonNav->errLon300);
+		pMonNav->sts300.bit.errHt = mtsCheckRange(-NAV_AHEIGHT_TOLERANCE, NAV_AHEIGHT_TOLERANCE, pMonNav->errHt300);
 	} else {
 		return ERROR;
 	}
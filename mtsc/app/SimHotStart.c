@@ -6,16 +6,17 @@
 
 #include "../lib/util/isDebug.h"
 #include "../lib/util/isUtil.h"
+#include "../lib/util/isCksum.h"
 #include "../lib/mtsLib.h"
-#include "../drv/axiDio.h"
 #include "typedef/tmType/tmTypeFg6.h"
 #include "common.h"
 #include "SimHotStart.h"
+#include "AssetCache.h"
 #include "UdpSendOps.h"
 #include "SdlcSendGcu.h"
+#include "HwTime.h"
 
 #define SIM_HOTSTART_MSG_Q_LEN		(20)
-#define SIM_HOTSTART_DATA_FILE		(NET_DEV_REPO_NAME "/HotStart.bin")
 #define SIM_HOTSTART_MAX_FG6_FRAMES	(1000)
 #define SIM_HOTSTART_FRAME_SIZE		(sizeof(TM_TYPE_FG6))
 #define SIM_HOTSTART_FRAME_GAP_TIME	(3)
@@ -58,7 +59,7 @@ LOCAL STATUS 	OnStop(SimHotStartInst *this, const SimHotStartMsg *pRxMsg);
 LOCAL STATUS 	OnLoadData(SimHotStartInst *this, const SimHotStartMsg *pRxMsg);
 LOCAL STATUS 	OnTx(SimHotStartInst *this);
 
-LOCAL void		SimHotStart_PpsIsr(PPS_ISR_ARG arg);
+LOCAL void		SimHotStart_PpsHook(void *arg);
 
 LOCAL STATUS InitSimHotStart(SimHotStartInst *this) {
 	
@@ -81,6 +82,11 @@ LOCAL STATUS InitSimHotStart(SimHotStartInst *this) {
 		return ERROR;
 	}
 	
+	if (HwTimeInit() == ERROR) {
+		LOGMSG("HwTimeInit() error!\n");
+		return ERROR;
+	}
+	
 	return OK;
 }
 
@@ -152,17 +158,16 @@ LOCAL STATUS OnStart(SimHotStartInst *this, const SimHotStartMsg *pRxMsg) {
 	this->state = RUNNING;
 	
 	this->currIdx = 0;
-	axiDioSetPpsIsr(SimHotStart_PpsIsr, NULL);
-	if (mtsLibPpsCtrlSource(PPS_SOURCE_INTERNAL) == ERROR) {
-		DEBUG("mtsLibPpsCtrlSource(Internal) Error.\n");
+	if (HwTimePpsHookAdd(SimHotStart_PpsHook, NULL) == ERROR) {
+		DEBUG("HwTimePpsHookAdd() Error.\n");
 		if (reportResult == TRUE)
 			UdpSendOpsTxResult(RESULT_TYPE_FAIL, "ERROR");
 		
 		return ERROR;
 	}
 	
-	if (mtsLibPpsIntEn(TRUE) == ERROR) {
-		DEBUG("mtsLibPpsIntEn(TRUE) Error. \n");
+	if (mtsLibPpsCtrlSource(PPS_SOURCE_INTERNAL) == ERROR) {
+		DEBUG("mtsLibPpsCtrlSource(Internal) Error.\n");
 		if (reportResult == TRUE)
 			UdpSendOpsTxResult(RESULT_TYPE_FAIL, "ERROR");
 		
@@ -180,14 +185,8 @@ LOCAL STATUS OnStop(SimHotStartInst *this, const SimHotStartMsg *pRxMsg) {
 	
 	BOOL reportResult =
 		(((pRxMsg->len == 0) || (pRxMsg->body.reportResult == FALSE)) ? FALSE : TRUE);
-		
-	if (mtsLibPpsIntEn(FALSE) == ERROR) {
-		DEBUG("mtsLibPpsIntEn(FALSE) Error.\n");
-		if (reportResult == TRUE)
-			UdpSendOpsTxResult(RESULT_TYPE_FAIL, "ERROR");
-		
-		return ERROR;
-	}
+	
+	HwTimePpsHookRemove(SimHotStart_PpsHook);
 	
 	if (mtsLibPpsCtrlSource(PPS_SOURCE_EXTERNAL) == ERROR) {
 		DEBUG("mtsLibPpsCtrlSource(External) Error.\n");
@@ -196,7 +195,6 @@ LOCAL STATUS OnStop(SimHotStartInst *this, const SimHotStartMsg *pRxMsg) {
 		
 		return ERROR;
 	}
-	axiDioSetPpsIsr(NULL, NULL);
 	
 	if (reportResult == TRUE)
 		UdpSendOpsTxResult(RESULT_TYPE_PASS, "OK");
@@ -204,6 +202,39 @@ LOCAL STATUS OnStop(SimHotStartInst *this, const SimHotStartMsg *pRxMsg) {
 	return OK;
 }
 
+/* The expected CRC-32 of the data file, from SIM_HOTSTART_CRC_FILE. */
+LOCAL STATUS readExpectedCrc(UINT32 *pCrc) {
+	FILE *fpFile;
+	char szFile[ASSET_CACHE_PATH_LEN];
+	unsigned int crc;
+	int numRead;
+	
+	if (AssetCacheResolve(SIM_HOTSTART_CRC_FILE, szFile, sizeof(szFile)) == ERROR)
+		return ERROR;
+	
+	if ((fpFile = fopen(szFile, "r")) == NULL) {
+		DEBUG("Cannot open %s...!!", szFile);
+		AssetCacheRelease(szFile);
+		
+		return ERROR;
+	}
+	
+	numRead = fscanf(fpFile, "%x", &crc);
+	fclose(fpFile);
+	AssetCacheRelease(szFile);
+	
+	if (numRead != 1)
+		return ERROR;
+	
+	*pCrc = (UINT32)crc;
+	
+	return OK;
+}
+
+/*
+ * The whole file, a partial trailing frame included, must match the
+ * CRC-32 of SIM_HOTSTART_CRC_FILE; otherwise nothing is loaded.
+ */
 LOCAL STATUS OnLoadData(SimHotStartInst *this, const SimHotStartMsg *pRxMsg) {
 	if (this->state == RUNNING) {
 		LOGMSG("Sim. HotStart is running...\n");
@@ -214,25 +245,50 @@ LOCAL STATUS OnLoadData(SimHotStartInst *this, const SimHotStartMsg *pRxMsg) {
 	
 	FILE *fpFile;
 	size_t readBytes;
+	char szFile[ASSET_CACHE_PATH_LEN];
+	UINT32 expectedCrc;
+	IsCksum cksum;
+	BOOL isTooLong = FALSE;
 	BOOL reportResult =
 		(((pRxMsg->len == 0) || (pRxMsg->body.reportResult == FALSE)) ? FALSE : TRUE);
-		
-	if ((fpFile = fopen(SIM_HOTSTART_DATA_FILE, "rb")) == NULL) {
-		DEBUG("Cannot open %s...!!", SIM_HOTSTART_DATA_FILE);
+	
+	this->numFg6Frames = 0;
+	
+	if (readExpectedCrc(&expectedCrc) == ERROR) {
+		LOGMSG("No expected CRC-32 in %s...!!\n", SIM_HOTSTART_CRC_FILE);
 		if (reportResult == TRUE)
 			UdpSendOpsTxResult(RESULT_TYPE_FAIL, "ERROR");
 		
 		return ERROR;
 	}
+	
+	AssetCacheResolve(SIM_HOTSTART_DATA_FILE, szFile, sizeof(szFile));
 		
-	this->numFg6Frames = 0;
+	if ((fpFile = fopen(szFile, "rb")) == NULL) {
+		DEBUG("Cannot open %s...!!", szFile);
+		AssetCacheRelease(szFile);
+		if (reportResult == TRUE)
+			UdpSendOpsTxResult(RESULT_TYPE_FAIL, "ERROR");
+		
+		return ERROR;
+	}
+	
+	isCksumInit(&cksum, IS_CKSUM_CRC32);
 	
 	FOREVER {
+		if (this->numFg6Frames >= SIM_HOTSTART_MAX_FG6_FRAMES) {
+			isTooLong = (fgetc(fpFile) != EOF) ? TRUE : FALSE;
+			isCksumFinal(&cksum);
+			break;
+		}
+		
 		readBytes = fread(this->fg6Frames[this->numFg6Frames].body.buf,
 							1, SIM_HOTSTART_FRAME_SIZE, fpFile);
 		
+		isCksumUpdate(&cksum, this->fg6Frames[this->numFg6Frames].body.buf, readBytes);
+		
 		if (readBytes < SIM_HOTSTART_FRAME_SIZE) {
-			LOGMSG(" %d Frames Read.\n", this->numFg6Frames);
+			isCksumFinal(&cksum);
 			break;
 		}
 		
@@ -240,7 +296,27 @@ LOCAL STATUS OnLoadData(SimHotStartInst *this, const SimHotStartMsg *pRxMsg) {
 	}
 	
 	if (fclose(fpFile) == EOF) {
-		DEBUG("Cannot close %s...!!", SIM_HOTSTART_DATA_FILE);
+		DEBUG("Cannot close %s...!!", szFile);
+		AssetCacheRelease(szFile);
+		this->numFg6Frames = 0;
+		
+		return ERROR;
+	}
+	AssetCacheRelease(szFile);
+	
+	if (isTooLong) {
+		LOGMSG("More than %d frames in %s...!!\n", SIM_HOTSTART_MAX_FG6_FRAMES, szFile);
+		this->numFg6Frames = 0;
+	} else if (cksum.crc32 != expectedCrc) {
+		LOGMSG("CRC-32 mismatch : 0x%08X, expected 0x%08X...!!\n", cksum.crc32, expectedCrc);
+		this->numFg6Frames = 0;
+	} else {
+		LOGMSG(" %d Frames Read. (CRC-32 0x%08X)\n", this->numFg6Frames, cksum.crc32);
+	}
+	
+	if (this->numFg6Frames == 0) {
+		if (reportResult == TRUE)
+			UdpSendOpsTxResult(RESULT_TYPE_FAIL, "ERROR");
 		
 		return ERROR;
 	}
@@ -298,7 +374,8 @@ LOCAL STATUS OnTx(SimHotStartInst *this) {
 	return OK;
 }
 
-LOCAL void SimHotStart_PpsIsr(PPS_ISR_ARG arg) {
+/* PPS edge, from the interrupt through HwTime. */
+LOCAL void SimHotStart_PpsHook(void *arg) {
 	PostCmd(g_hSimHotStart, SIM_HOTSTART_TX);
 }
 
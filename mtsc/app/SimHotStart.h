@@ -5,6 +5,9 @@
 #include "../lib/util/ModuleCommon.h"
 
 #define SIM_HOTSTART_TASK_NAME		"tSimHotStart"
+#define SIM_HOTSTART_DATA_FILE		(NET_DEV_REPO_NAME "/HotStart.bin")
+/* CRC-32 of HotStart.bin as hex text, e.g. "0x1A2B3C4D"; a load must match it. */
+#define SIM_HOTSTART_CRC_FILE		(NET_DEV_REPO_NAME "/HotStart.crc")
 
 typedef enum {
 	SIM_HOTSTART_NULL,
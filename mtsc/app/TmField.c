@@ -0,0 +1,300 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../lib/util/isDebug.h"
+#include "../lib/util/isHash.h"
+#include "common.h"
+#include "SdlcRecvGcu.h"
+#include "FrameRing.h"
+#include "TmField.h"
+
+#define TM_FIELD_HASH_MASK		(TM_FIELD_HASH_SIZE - 1)
+#define TM_FIELD_MAX			NELEMENTS(g_tmFieldTbl)
+
+#define TM_FIELD_SRC_ITEM(id, name, frameType) \
+	[id] = { name, sizeof(frameType) }
+
+#define GF2_FIELD(name, member, bitNo, chkType, lsb) \
+	TM_FIELD_ITEM(name, TM_WAIT_SRC_GF2, TM_TYPE_GF2, member, bitNo, chkType, lsb)
+#define GF3_FIELD(name, member, bitNo, chkType, lsb) \
+	TM_FIELD_ITEM(name, TM_WAIT_SRC_GF3, TM_TYPE_GF3, member, bitNo, chkType, lsb)
+#define GF5_FIELD(name, member, bitNo, chkType, lsb) \
+	TM_FIELD_ITEM(name, TM_WAIT_SRC_GF5, TM_TYPE_GF5, member, bitNo, chkType, lsb)
+#define GF6_FIELD(name, member, bitNo, chkType, lsb) \
+	TM_FIELD_ITEM(name, TM_WAIT_SRC_GF6, TM_TYPE_GF6, member, bitNo, chkType, lsb)
+#define GF7_FIELD(name, member, bitNo, chkType, lsb) \
+	TM_FIELD_ITEM(name, TM_WAIT_SRC_GF7, TM_TYPE_GF7, member, bitNo, chkType, lsb)
+
+typedef struct {
+	const char *	szName;
+	int				size;
+} TmFieldSrc;
+
+LOCAL TmFieldSrc g_tmFieldSrc[TM_WAIT_SRC_TYPES] = {
+	TM_FIELD_SRC_ITEM(TM_WAIT_SRC_GF2, "GF2", TM_TYPE_GF2),
+	TM_FIELD_SRC_ITEM(TM_WAIT_SRC_GF3, "GF3", TM_TYPE_GF3),
+	TM_FIELD_SRC_ITEM(TM_WAIT_SRC_GF5, "GF5", TM_TYPE_GF5),
+	TM_FIELD_SRC_ITEM(TM_WAIT_SRC_GF6, "GF6", TM_TYPE_GF6),
+	TM_FIELD_SRC_ITEM(TM_WAIT_SRC_GF7, "GF7", TM_TYPE_GF7),
+	TM_FIELD_SRC_ITEM(TM_WAIT_SRC_GF8, "GF8", TM_TYPE_GF8),
+	TM_FIELD_SRC_ITEM(TM_WAIT_SRC_GF9, "GF9", TM_TYPE_GF9),
+	TM_FIELD_SRC_ITEM(TM_WAIT_SRC_GF11, "GF11", TM_TYPE_GF11),
+	TM_FIELD_SRC_ITEM(TM_WAIT_SRC_GF12, "GF12", TM_TYPE_GF12),
+};
+
+/*
+ * Names and scale factors follow mtsChkGf2, mtsSwVerChk and mtsChkGf7.
+ * Fields of GF8, GF9, GF11 and GF12 are addressed as "@offset:size".
+ */
+LOCAL TmField g_tmFieldTbl[] = {
+	GF2_FIELD("GCU_28V", m_GCU_28V, TM_FIELD_WHOLE, TM_FIELD_CHK_RANGE, 0.002),
+	GF2_FIELD("ABAT_VTG", m_ABAT_VTG, TM_FIELD_WHOLE, TM_FIELD_CHK_RANGE, 0.01),
+	GF2_FIELD("BAT1_VTG", m_BAT1_VTG, TM_FIELD_WHOLE, TM_FIELD_CHK_RANGE, 0.002),
+	GF2_FIELD("BAT2_VTG", m_BAT2_VTG, TM_FIELD_WHOLE, TM_FIELD_CHK_RANGE, 0.002),
+	GF2_FIELD("FIN1_FB", m_FIN1_FB, TM_FIELD_WHOLE, TM_FIELD_CHK_RANGE, 0.001),
+	GF2_FIELD("FIN2_FB", m_FIN2_FB, TM_FIELD_WHOLE, TM_FIELD_CHK_RANGE, 0.001),
+	GF2_FIELD("FIN3_FB", m_FIN3_FB, TM_FIELD_WHOLE, TM_FIELD_CHK_RANGE, 0.001),
+	GF2_FIELD("FIN4_FB", m_FIN4_FB, TM_FIELD_WHOLE, TM_FIELD_CHK_RANGE, 0.001),
+	GF2_FIELD("GCU_FAIL", m_MSL_STS, 15, TM_FIELD_CHK_EQUAL, 1.0),
+	GF2_FIELD("ACU_FAIL", m_MSL_STS, 14, TM_FIELD_CHK_EQUAL, 1.0),
+	GF2_FIELD("GPS_FAIL", m_MSL_STS, 13, TM_FIELD_CHK_EQUAL, 1.0),
+	GF2_FIELD("IMU_FAIL", m_MSL_STS, 11, TM_FIELD_CHK_EQUAL, 1.0),
+	GF2_FIELD("FUZ_FAIL", m_MSL_STS, 10, TM_FIELD_CHK_EQUAL, 1.0),
+	GF2_FIELD("PARAM_FAIL", m_MSL_STS, 8, TM_FIELD_CHK_EQUAL, 1.0),
+	GF2_FIELD("ACU_STS", m_ACU_STS, TM_FIELD_WHOLE, TM_FIELD_CHK_EQUAL, 1.0),
+	GF2_FIELD("MSL_STS", m_MSL_STS, TM_FIELD_WHOLE, TM_FIELD_CHK_EQUAL, 1.0),
+	GF2_FIELD("GCU_MODE", m_GCU_MODE, TM_FIELD_WHOLE, TM_FIELD_CHK_EQUAL, 1.0),
+	GF2_FIELD("GCU_RESP", m_GCU_RESP, TM_FIELD_WHOLE, TM_FIELD_CHK_EQUAL, 1.0),
+	GF2_FIELD("GCU_DIO_STS", m_GCU_DIO_STS, TM_FIELD_WHOLE, TM_FIELD_CHK_EQUAL, 1.0),
+	
+	GF3_FIELD("XLATL", gf3_1.m_XLATL, TM_FIELD_WHOLE, TM_FIELD_CHK_RANGE, 1.0),
+	GF3_FIELD("XLONL", gf3_1.m_XLONL, TM_FIELD_WHOLE, TM_FIELD_CHK_RANGE, 1.0),
+	GF3_FIELD("HL", gf3_1.m_HL, TM_FIELD_WHOLE, TM_FIELD_CHK_RANGE, 1.0),
+	GF3_FIELD("XLATT", gf3_1.m_XLATT, TM_FIELD_WHOLE, TM_FIELD_CHK_RANGE, 1.0),
+	GF3_FIELD("XLONT", gf3_1.m_XLONT, TM_FIELD_WHOLE, TM_FIELD_CHK_RANGE, 1.0),
+	GF3_FIELD("HT", gf3_1.m_HT, TM_FIELD_WHOLE, TM_FIELD_CHK_RANGE, 1.0),
+	GF3_FIELD("IMU_LA_X", gf3_1.m_IMU_LA_X, TM_FIELD_WHOLE, TM_FIELD_CHK_RANGE, 1.0),
+	GF3_FIELD("IMU_LA_Y", gf3_1.m_IMU_LA_Y, TM_FIELD_WHOLE, TM_FIELD_CHK_RANGE, 1.0),
+	GF3_FIELD("IMU_LA_Z", gf3_1.m_IMU_LA_Z, TM_FIELD_WHOLE, TM_FIELD_CHK_RANGE, 1.0),
+	GF3_FIELD("ROLL", gf3_1.m_ROLL, TM_FIELD_WHOLE, TM_FIELD_CHK_RANGE, 1.0),
+	GF3_FIELD("PITCH", gf3_1.m_PITCH, TM_FIELD_WHOLE, TM_FIELD_CHK_RANGE, 1.0),
+	GF3_FIELD("YAW", gf3_1.m_YAW, TM_FIELD_WHOLE, TM_FIELD_CHK_RANGE, 1.0),
+	GF3_FIELD("AQQC1", gf3_1.m_AQQC1, TM_FIELD_WHOLE, TM_FIELD_CHK_RANGE, 1.0),
+	GF3_FIELD("AQQC2", gf3_1.m_AQQC2, TM_FIELD_WHOLE, TM_FIELD_CHK_RANGE, 1.0),
+	GF3_FIELD("AQQC3", gf3_1.m_AQQC3, TM_FIELD_WHOLE, TM_FIELD_CHK_RANGE, 1.0),
+	GF3_FIELD("AQQC4", gf3_1.m_AQQC4, TM_FIELD_WHOLE, TM_FIELD_CHK_RANGE, 1.0),
+	GF3_FIELD("GCU_SW_VER", gf3_4.m_GCU_SW_VER, TM_FIELD_WHOLE, TM_FIELD_CHK_EQUAL, 1.0),
+	GF3_FIELD("GCU_SW_CREATE", gf3_4.m_GCU_SW_CREATE, TM_FIELD_WHOLE, TM_FIELD_CHK_EQUAL, 1.0),
+	GF3_FIELD("GCU_FW_VER", gf3_4.m_GCU_FW_VER, TM_FIELD_WHOLE, TM_FIELD_CHK_EQUAL, 1.0),
+	GF3_FIELD("GCU_FW_CREATE", gf3_4.m_GCU_FW_CREATE, TM_FIELD_WHOLE, TM_FIELD_CHK_EQUAL, 1.0),
+	GF3_FIELD("INS_UPDATE_VER1", gf3_4.m_INS_UPDATE_VER1, TM_FIELD_WHOLE, TM_FIELD_CHK_EQUAL, 1.0),
+	GF3_FIELD("INS_UPDATE_VER2", gf3_4.m_INS_UPDATE_VER2, TM_FIELD_WHOLE, TM_FIELD_CHK_EQUAL, 1.0),
+	GF3_FIELD("ACU_VER", gf3_4.m_ACU_VER, TM_FIELD_WHOLE, TM_FIELD_CHK_EQUAL, 1.0),
+	GF3_FIELD("ACU_UPDATE", gf3_4.m_ACU_UPDATE, TM_FIELD_WHOLE, TM_FIELD_CHK_EQUAL, 1.0),
+	GF3_FIELD("MAR_VER", gf3_4.m_MAR_VER, TM_FIELD_WHOLE, TM_FIELD_CHK_EQUAL, 1.0),
+	GF3_FIELD("MAR_UPDATE", gf3_4.m_MAR_UPDATE, TM_FIELD_WHOLE, TM_FIELD_CHK_EQUAL, 1.0),
+	
+	GF5_FIELD("MAR_RESP", m_MAR_RESP, TM_FIELD_WHOLE, TM_FIELD_CHK_EQUAL, 1.0),
+	
+	GF6_FIELD("MAR_RESP", gf6_1.m_MAR_RESP, TM_FIELD_WHOLE, TM_FIELD_CHK_EQUAL, 1.0),
+	
+	GF7_FIELD("NAV_STS", m_NAV_STS, TM_FIELD_WHOLE, TM_FIELD_CHK_EQUAL, 1.0),
+	GF7_FIELD("ALIGN_STS", m_ALIGN_STS, TM_FIELD_WHOLE, TM_FIELD_CHK_EQUAL, 1.0),
+	GF7_FIELD("NAV_RESP", m_NAV_RESP, TM_FIELD_WHOLE, TM_FIELD_CHK_EQUAL, 1.0),
+	GF7_FIELD("MODE_TIME", m_MODE_TIME, TM_FIELD_WHOLE, TM_FIELD_CHK_RANGE, 1.0),
+	GF7_FIELD("AQQC1", m_AQQC1, TM_FIELD_WHOLE, TM_FIELD_CHK_NONE, 0.0000000005),
+	GF7_FIELD("AQQC2", m_AQQC2, TM_FIELD_WHOLE, TM_FIELD_CHK_NONE, 0.0000000005),
+	GF7_FIELD("AQQC3", m_AQQC3, TM_FIELD_WHOLE, TM_FIELD_CHK_NONE, 0.0000000005),
+	GF7_FIELD("AQQC4", m_AQQC4, TM_FIELD_WHOLE, TM_FIELD_CHK_NONE, 0.0000000005),
+	GF7_FIELD("AVE", m_AVE, TM_FIELD_WHOLE, TM_FIELD_CHK_RANGE, 0.000025),
+	GF7_FIELD("AVN", m_AVN, TM_FIELD_WHOLE, TM_FIELD_CHK_RANGE, 0.000025),
+	GF7_FIELD("AVU", m_AVU, TM_FIELD_WHOLE, TM_FIELD_CHK_RANGE, 0.000025),
+	GF7_FIELD("ALAT", m_ALAT, TM_FIELD_WHOLE, TM_FIELD_CHK_RANGE, 0.000000083819031754),
+	GF7_FIELD("ALON", m_ALON, TM_FIELD_WHOLE, TM_FIELD_CHK_RANGE, 0.000000083819031754),
+	GF7_FIELD("AHEIGHT", m_AHEIGHT, TM_FIELD_WHOLE, TM_FIELD_CHK_RANGE, 0.005),
+};
+
+/* Slot holds the field index + 1, so zero marks an empty slot. */
+LOCAL UINT8 g_tmFieldHash[TM_FIELD_HASH_SIZE];
+
+/* The same name may exist in several frames, so the source is part of the key. */
+LOCAL UINT32 hashField(TmWaitSrc src, const char *szName) {
+	return isHashFnv1a(szName) ^ ((UINT32)src * 0x9E3779B1);
+}
+
+STATUS TmFieldInit(void) {
+	TmField *pField;
+	UINT32 slot;
+	int i;
+	
+	memset(g_tmFieldHash, 0, sizeof(g_tmFieldHash));
+	
+	for (i = 0; i < TM_FIELD_MAX; i++) {
+		pField = &g_tmFieldTbl[i];
+		pField->hash = hashField(pField->src, pField->szName);
+		
+		for (slot = pField->hash & TM_FIELD_HASH_MASK;
+			 g_tmFieldHash[slot] != 0;
+			 slot = (slot + 1) & TM_FIELD_HASH_MASK) {
+			if ((g_tmFieldTbl[g_tmFieldHash[slot] - 1].src == pField->src) &&
+				(strcmp(g_tmFieldTbl[g_tmFieldHash[slot] - 1].szName, pField->szName) == 0)) {
+				LOGMSG("Duplicated field \"%s.%s\".\n",
+					   g_tmFieldSrc[pField->src].szName, pField->szName);
+				return ERROR;
+			}
+		}
+		g_tmFieldHash[slot] = (UINT8)(i + 1);
+	}
+	
+	return OK;
+}
+
+STATUS TmFieldSrcFind(const char *szName, TmWaitSrc *pSrc) {
+	int i;
+	
+	for (i = 0; i < TM_WAIT_SRC_TYPES; i++) {
+		if (strcmp(g_tmFieldSrc[i].szName, szName) == 0) {
+			*pSrc = (TmWaitSrc)i;
+			return OK;
+		}
+	}
+	
+	return ERROR;
+}
+
+const TmField *TmFieldFind(TmWaitSrc src, const char *szName) {
+	const TmField *pField;
+	UINT32 hash = hashField(src, szName);
+	UINT32 slot;
+	
+	for (slot = hash & TM_FIELD_HASH_MASK;
+		 g_tmFieldHash[slot] != 0;
+		 slot = (slot + 1) & TM_FIELD_HASH_MASK) {
+		pField = &g_tmFieldTbl[g_tmFieldHash[slot] - 1];
+		if ((pField->hash == hash) && (pField->src == src) &&
+			(strcmp(pField->szName, szName) == 0))
+			return pField;
+	}
+	
+	return NULL;
+}
+
+/*
+ * "@offset:size" names an unsigned 1, 2 or 4 byte field that has no
+ * entry in g_tmFieldTbl. It is compared for equality like a status word.
+ */
+STATUS TmFieldParseRaw(TmWaitSrc src, const char *szSpec, TmField *pField) {
+	char *pEnd;
+	unsigned long offset, size;
+	
+	if ((src >= TM_WAIT_SRC_TYPES) || (szSpec[0] != '@'))
+		return ERROR;
+	
+	offset = strtoul(&szSpec[1], &pEnd, 0);
+	if ((pEnd == &szSpec[1]) || (*pEnd != ':'))
+		return ERROR;
+	
+	size = strtoul(pEnd + 1, &pEnd, 0);
+	if ((*pEnd != '\0') || ((size != 1) && (size != 2) && (size != 4)))
+		return ERROR;
+	
+	if (offset + size > g_tmFieldSrc[src].size)
+		return ERROR;
+	
+	memset(pField, 0, sizeof(TmField));
+	pField->szName = szSpec;
+	pField->src = src;
+	pField->offset = (UINT16)offset;
+	pField->size = (UINT8)size;
+	pField->type = TM_FIELD_UINT;
+	pField->bit = TM_FIELD_WHOLE;
+	pField->chk = TM_FIELD_CHK_EQUAL;
+	pField->scale = 1.0;
+	
+	return OK;
+}
+
+/*
+ * Copies the last complete frame of src, a source of any unit; returns
+ * its size or ERROR. Never blocks tSdlcRecvGcu, see FrameRingRead().
+ */
+int TmFieldSnapshot(TmWaitSrc src, void *pDst, int size) {
+	if ((src >= TM_WAIT_SRC_MAX) || (size < g_tmFieldSrc[TM_WAIT_SRC_TYPE(src)].size))
+		return ERROR;
+	
+	return FrameRingRead(src, pDst, size);
+}
+
+/* Raw bits of an integer field, sign-extended to 32 bits when signed. */
+UINT32 TmFieldGetBits(const TmField *pField, const void *pFrame) {
+	const UINT8 *p = (const UINT8 *)pFrame + pField->offset;
+	UINT8 u8;
+	UINT16 u16;
+	UINT32 raw;
+	
+	switch (pField->size) {
+	case 1:
+		memcpy(&u8, p, 1);
+		raw = (pField->type == TM_FIELD_INT) ? (UINT32)(INT8)u8 : u8;
+		break;
+	case 2:
+		memcpy(&u16, p, 2);
+		raw = (pField->type == TM_FIELD_INT) ? (UINT32)(INT16)u16 : u16;
+		break;
+	default:
+		memcpy(&raw, p, 4);
+		break;
+	}
+	
+	if (pField->bit != TM_FIELD_WHOLE)
+		raw = (raw >> pField->bit) & 0x1;
+	
+	return raw;
+}
+
+/* Engineering value: the field times its scale. */
+double TmFieldGet(const TmField *pField, const void *pFrame) {
+	const UINT8 *p = (const UINT8 *)pFrame + pField->offset;
+	float fValue;
+	double dValue;
+	UINT32 raw;
+	
+	if (pField->type == TM_FIELD_REAL) {
+		if (pField->size == sizeof(float)) {
+			memcpy(&fValue, p, sizeof(float));
+			dValue = fValue;
+		} else {
+			memcpy(&dValue, p, sizeof(double));
+		}
+	} else {
+		raw = TmFieldGetBits(pField, pFrame);
+		if ((pField->type == TM_FIELD_INT) && (pField->bit == TM_FIELD_WHOLE))
+			dValue = (double)(INT32)raw;
+		else
+			dValue = (double)raw;
+	}
+	
+	return dValue * pField->scale;
+}
+
+void tmFieldShow(void) {
+	const char *szType[] = { "UINT", "INT", "REAL" };
+	const char *szChk[] = { "-", "RANGE", "EQUAL" };
+	const TmField *pField;
+	int i;
+	
+	printf("%-5s %-16s %6s %4s %-4s %3s %-5s %s\n",
+		   "SRC", "NAME", "OFFSET", "SIZE", "TYPE", "BIT", "CHECK", "SCALE");
+	for (i = 0; i < TM_FIELD_MAX; i++) {
+		pField = &g_tmFieldTbl[i];
+		printf("%-5s %-16s %6u %4u %-4s %3d %-5s %g\n",
+			   g_tmFieldSrc[pField->src].szName, pField->szName,
+			   pField->offset, pField->size, szType[pField->type],
+			   pField->bit, szChk[pField->chk], pField->scale);
+	}
+	
+	for (i = 0; i < TM_WAIT_SRC_TYPES; i++) {
+		printf("%-5s %4d bytes\n", g_tmFieldSrc[i].szName, g_tmFieldSrc[i].size);
+	}
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <vxWorks.h>
+#include <stddef.h>
+
+#include "TmWait.h"
+
+/*
+ * Named fields of the received GF frames. A field is located by its
+ * offset in the frame, so a check can be evaluated on a private copy
+ * taken with TmFieldSnapshot() instead of the live frame, which
+ * tSdlcRecvGcu may overwrite between two reads.
+ *
+ * The src of a field is its frame type. TmLimitAdd() and TmWaitFor()
+ * take the source of one unit, so qualify it with TM_WAIT_SRC() first.
+ */
+#define TM_FIELD_HASH_SIZE		(256)
+#define TM_FIELD_WHOLE			(-1)
+
+typedef enum {
+	TM_FIELD_UINT,
+	TM_FIELD_INT,
+	TM_FIELD_REAL
+} TmFieldType;
+
+typedef enum {
+	TM_FIELD_CHK_NONE,		/* report only */
+	TM_FIELD_CHK_RANGE,		/* min <= value * scale <= max */
+	TM_FIELD_CHK_EQUAL		/* (value & mask) == ref */
+} TmFieldChk;
+
+typedef struct {
+	const char *	szName;
+	UINT32			hash;
+	TmWaitSrc		src;
+	UINT16			offset;
+	UINT8			size;
+	UINT8			type;			/* TmFieldType */
+	INT8			bit;			/* single bit, or TM_FIELD_WHOLE */
+	UINT8			chk;			/* TmFieldChk */
+	double			scale;
+} TmField;
+
+/* One element of the mtsChkTmMulti result vector. */
+typedef struct {
+	double	dValue;
+	UINT32	eResult;
+	UINT32	reserved;
+} TmFieldResult;
+
+#define TM_FIELD_TYPE_OF(x) \
+	(((__typeof__(x))0.5 != 0) ? TM_FIELD_REAL : \
+	 ((__typeof__(x))-1 < 0) ? TM_FIELD_INT : TM_FIELD_UINT)
+
+#define TM_FIELD_ITEM(name, srcId, frameType, member, bitNo, chkType, lsb) \
+	{ name, 0, srcId, offsetof(frameType, member), \
+	  sizeof(((frameType *)0)->member), \
+	  TM_FIELD_TYPE_OF(((frameType *)0)->member), \
+	  bitNo, chkType, lsb }
+
+IMPORT STATUS			TmFieldInit(void);
+IMPORT STATUS			TmFieldSrcFind(const char *szName, TmWaitSrc *pSrc);
+IMPORT const TmField *	TmFieldFind(TmWaitSrc src, const char *szName);
+IMPORT STATUS			TmFieldParseRaw(TmWaitSrc src, const char *szSpec, TmField *pField);
+IMPORT int				TmFieldSnapshot(TmWaitSrc src, void *pDst, int size);
+IMPORT UINT32			TmFieldGetBits(const TmField *pField, const void *pFrame);
+IMPORT double			TmFieldGet(const TmField *pField, const void *pFrame);
+IMPORT void				tmFieldShow(void);
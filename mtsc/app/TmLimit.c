@@ -0,0 +1,356 @@
+#include <semLib.h>
+#include <tickLib.h>
+#include <taskLib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "../lib/util/isDebug.h"
+#include "common.h"
+#include "LogSend.h"
+#include "LogBatch.h"
+#include "TmLimit.h"
+
+#define TM_LIMIT_NAME_LEN		(24)
+
+/*
+ * Flat view of the limits of one source. tSdlcRecvGcu only reads the
+ * active bank; a change is compiled into the other one and made active
+ * with a single index flip, so the receiver never waits for a rebuild.
+ * Neither does it take a lock: it publishes the bank it evaluates in
+ * g_tmLimitInEval, and an editor about to rebuild that bank waits for
+ * the one frame to finish instead.
+ */
+typedef struct {
+	int		num;
+	UINT16	id[TM_LIMIT_MAX];
+	UINT16	offset[TM_LIMIT_MAX];
+	UINT8	size[TM_LIMIT_MAX];
+	UINT8	type[TM_LIMIT_MAX];
+	INT8	bit[TM_LIMIT_MAX];
+	UINT8	chk[TM_LIMIT_MAX];
+	UINT32	mask[TM_LIMIT_MAX];
+	double	scale[TM_LIMIT_MAX];
+	double	lo[TM_LIMIT_MAX];
+	double	hi[TM_LIMIT_MAX];
+} TmLimitBank;
+
+typedef struct {
+	BOOL			inUse;
+	TmField			field;
+	char			szName[TM_LIMIT_NAME_LEN];
+	double			lo;
+	double			hi;
+	UINT32			mask;
+	volatile BOOL	isFailing;
+	volatile UINT32	numViolations;
+	double			dValue;			/* last checked value */
+} TmLimitDef;
+
+#define TM_LIMIT_BANK_IDLE		(-1)
+
+LOCAL SEM_ID g_sidTmLimitEdit = SEM_ID_NULL;	/* g_tmLimitDef and the inactive banks */
+LOCAL TmLimitDef g_tmLimitDef[TM_LIMIT_MAX];
+LOCAL TmLimitBank g_tmLimitBank[TM_WAIT_SRC_MAX][2];
+LOCAL volatile int g_tmLimitActive[TM_WAIT_SRC_MAX];
+LOCAL volatile int g_tmLimitInEval[TM_WAIT_SRC_MAX];
+LOCAL LOG_DATA g_tmLimitLog[TM_WAIT_UNIT_MAX];		/* one per receiving task */
+
+/* Rebuilds the inactive bank of src from g_tmLimitDef and flips to it. */
+LOCAL void compileBank(TmWaitSrc src) {
+	int bank = !g_tmLimitActive[src];
+	TmLimitBank *pBank = &g_tmLimitBank[src][bank];
+	const TmLimitDef *pDef;
+	int n = 0;
+	int i;
+	
+	/* A frame that started before the last flip may still read it. */
+	VX_MEM_BARRIER_RW();
+	while (g_tmLimitInEval[src] == bank) {
+		taskDelay(1);
+	}
+	
+	for (i = 0; i < TM_LIMIT_MAX; i++) {
+		pDef = &g_tmLimitDef[i];
+		if (!pDef->inUse || (pDef->field.src != src))
+			continue;
+		
+		pBank->id[n] = (UINT16)i;
+		pBank->offset[n] = pDef->field.offset;
+		pBank->size[n] = pDef->field.size;
+		pBank->type[n] = pDef->field.type;
+		pBank->bit[n] = pDef->field.bit;
+		pBank->chk[n] = pDef->field.chk;
+		pBank->mask[n] = pDef->mask;
+		pBank->scale[n] = pDef->field.scale;
+		pBank->lo[n] = pDef->lo;
+		pBank->hi[n] = pDef->hi;
+		n++;
+	}
+	pBank->num = n;
+	
+	VX_MEM_BARRIER_W();
+	g_tmLimitActive[src] = bank;
+}
+
+/* lo and hi come from the bank, which editors leave alone while it is read. */
+LOCAL void postEvent(TmWaitSrc src, const TmLimitBank *pBank, int i,
+					 TmLimitEventType event, double dValue, UINT64 timeNs) {
+	LOG_DATA *pLog = &g_tmLimitLog[TM_WAIT_SRC_UNIT(src)];
+	TmLimitEvent *pEvent = (TmLimitEvent *)&pLog->formatted.body;
+	
+	pEvent->timeNs = timeNs;
+	pEvent->frameSeq = TmWaitSeq(src);
+	pEvent->id = pBank->id[i];
+	pEvent->src = (UINT8)src;
+	pEvent->event = (UINT8)event;
+	pEvent->dValue = dValue;
+	pEvent->lo = pBank->lo[i];
+	pEvent->hi = pBank->hi[i];
+	
+	pLog->formatted.tickLog = tickGet();
+	LogBatchPost(pLog, sizeof(TmLimitEvent) + OFFSET(LOG_DATA, formatted.body), timeNs, TRUE);
+}
+
+STATUS TmLimitInit(void) {
+	int i;
+	
+	if (g_sidTmLimitEdit != SEM_ID_NULL)
+		return OK;
+	
+	memset(g_tmLimitDef, 0, sizeof(g_tmLimitDef));
+	memset(g_tmLimitBank, 0, sizeof(g_tmLimitBank));
+	
+	for (i = 0; i < TM_WAIT_SRC_MAX; i++) {
+		g_tmLimitActive[i] = 0;
+		g_tmLimitInEval[i] = TM_LIMIT_BANK_IDLE;
+	}
+	
+	for (i = 0; i < TM_WAIT_UNIT_MAX; i++) {
+		g_tmLimitLog[i].formatted.index.kind = LOG_SEND_INDEX_KIND_MTE_STS;
+		g_tmLimitLog[i].formatted.index.id = TM_LIMIT_LOG_INDEX_ID;
+	}
+	
+	g_sidTmLimitEdit = semMCreate(SEM_Q_PRIORITY | SEM_DELETE_SAFE | SEM_INVERSION_SAFE);
+	if (g_sidTmLimitEdit == SEM_ID_NULL) {
+		LOGMSG("semMCreate() error!\n");
+		return ERROR;
+	}
+	
+	return OK;
+}
+
+/*
+ * RANGE fields fail outside lo..hi, EQUAL fields when (bits & mask) is
+ * not lo. Returns the limit ID, or ERROR when the table is full.
+ */
+int TmLimitAdd(const TmField *pField, double lo, double hi, UINT32 mask) {
+	TmLimitDef *pDef;
+	int id;
+	
+	if ((g_sidTmLimitEdit == SEM_ID_NULL) || (pField->src >= TM_WAIT_SRC_MAX) ||
+		(pField->chk == TM_FIELD_CHK_NONE))
+		return ERROR;
+	
+	semTake(g_sidTmLimitEdit, WAIT_FOREVER);
+	
+	for (id = 0; id < TM_LIMIT_MAX; id++) {
+		if (!g_tmLimitDef[id].inUse)
+			break;
+	}
+	if (id == TM_LIMIT_MAX) {
+		semGive(g_sidTmLimitEdit);
+		return ERROR;
+	}
+	
+	pDef = &g_tmLimitDef[id];
+	memset(pDef, 0, sizeof(TmLimitDef));
+	pDef->field = *pField;
+	strncpy(pDef->szName, pField->szName, sizeof(pDef->szName) - 1);
+	pDef->field.szName = pDef->szName;
+	pDef->lo = lo;
+	pDef->hi = hi;
+	pDef->mask = mask;
+	pDef->inUse = TRUE;
+	
+	compileBank(pField->src);
+	
+	semGive(g_sidTmLimitEdit);
+	
+	return id;
+}
+
+STATUS TmLimitRemove(int id) {
+	TmWaitSrc src;
+	
+	if ((g_sidTmLimitEdit == SEM_ID_NULL) || (id < 0) || (id >= TM_LIMIT_MAX))
+		return ERROR;
+	
+	semTake(g_sidTmLimitEdit, WAIT_FOREVER);
+	
+	if (!g_tmLimitDef[id].inUse) {
+		semGive(g_sidTmLimitEdit);
+		return ERROR;
+	}
+	
+	src = g_tmLimitDef[id].field.src;
+	g_tmLimitDef[id].inUse = FALSE;
+	compileBank(src);
+	
+	semGive(g_sidTmLimitEdit);
+	
+	return OK;
+}
+
+/* Removes the limits of src, or all of them for TM_WAIT_SRC_MAX. */
+void TmLimitClear(TmWaitSrc src) {
+	int i;
+	
+	if (g_sidTmLimitEdit == SEM_ID_NULL)
+		return;
+	
+	semTake(g_sidTmLimitEdit, WAIT_FOREVER);
+	
+	for (i = 0; i < TM_LIMIT_MAX; i++) {
+		if ((src == TM_WAIT_SRC_MAX) || (g_tmLimitDef[i].field.src == src))
+			g_tmLimitDef[i].inUse = FALSE;
+	}
+	
+	for (i = 0; i < TM_WAIT_SRC_MAX; i++) {
+		if ((src == TM_WAIT_SRC_MAX) || (i == src))
+			compileBank((TmWaitSrc)i);
+	}
+	
+	semGive(g_sidTmLimitEdit);
+}
+
+/*
+ * Called by tSdlcRecvGcu once a frame of src has been stored, with the
+ * frame it stored and the time it was received. Only the task of the
+ * unit of src calls it, so it is the only reader of the banks of src.
+ */
+void TmLimitEval(TmWaitSrc src, const void *pFrame, UINT64 timeNs) {
+	const TmLimitBank *pBank;
+	const UINT8 *p;
+	TmLimitDef *pDef;
+	UINT8 u8;
+	UINT16 u16;
+	UINT32 raw;
+	float fValue;
+	double dValue;
+	BOOL isFailing;
+	int bank, i;
+	
+	if ((src >= TM_WAIT_SRC_MAX) || (g_sidTmLimitEdit == SEM_ID_NULL))
+		return;
+	
+	/* Publish the bank, then make sure it was not flipped away meanwhile. */
+	do {
+		bank = g_tmLimitActive[src];
+		g_tmLimitInEval[src] = bank;
+		VX_MEM_BARRIER_RW();
+	} while (bank != g_tmLimitActive[src]);
+	
+	pBank = &g_tmLimitBank[src][bank];
+	
+	for (i = 0; i < pBank->num; i++) {
+		p = (const UINT8 *)pFrame + pBank->offset[i];
+		
+		if (pBank->type[i] == TM_FIELD_REAL) {
+			if (pBank->size[i] == sizeof(float)) {
+				memcpy(&fValue, p, sizeof(float));
+				dValue = fValue;
+			} else {
+				memcpy(&dValue, p, sizeof(double));
+			}
+			dValue *= pBank->scale[i];
+			isFailing = (dValue < pBank->lo[i]) || (dValue > pBank->hi[i]);
+		} else {
+			switch (pBank->size[i]) {
+			case 1:
+				memcpy(&u8, p, 1);
+				raw = (pBank->type[i] == TM_FIELD_INT) ? (UINT32)(INT8)u8 : u8;
+				break;
+			case 2:
+				memcpy(&u16, p, 2);
+				raw = (pBank->type[i] == TM_FIELD_INT) ? (UINT32)(INT16)u16 : u16;
+				break;
+			default:
+				memcpy(&raw, p, 4);
+				break;
+			}
+			if (pBank->bit[i] != TM_FIELD_WHOLE)
+				raw = (raw >> pBank->bit[i]) & 0x1;
+			
+			if (pBank->chk[i] == TM_FIELD_CHK_EQUAL) {
+				dValue = (double)raw;
+				isFailing = ((raw & pBank->mask[i]) != (UINT32)(INT64)pBank->lo[i]);
+			} else {
+				if ((pBank->type[i] == TM_FIELD_INT) && (pBank->bit[i] == TM_FIELD_WHOLE))
+					dValue = (double)(INT32)raw * pBank->scale[i];
+				else
+					dValue = (double)raw * pBank->scale[i];
+				isFailing = (dValue < pBank->lo[i]) || (dValue > pBank->hi[i]);
+			}
+		}
+		
+		pDef = &g_tmLimitDef[pBank->id[i]];
+		pDef->dValue = dValue;
+		if (isFailing == pDef->isFailing)
+			continue;
+		
+		pDef->isFailing = isFailing;
+		if (isFailing)
+			pDef->numViolations++;
+		
+		postEvent(src, pBank, i,
+				  isFailing ? TM_LIMIT_EVENT_VIOLATED : TM_LIMIT_EVENT_CLEARED,
+				  dValue, timeNs);
+	}
+	
+	VX_MEM_BARRIER_RW();
+	g_tmLimitInEval[src] = TM_LIMIT_BANK_IDLE;
+}
+
+int TmLimitStatusGet(TmLimitStatus *pStatus, int maxNum) {
+	const TmLimitDef *pDef;
+	int n = 0;
+	int i;
+	
+	for (i = 0; (i < TM_LIMIT_MAX) && (n < maxNum); i++) {
+		pDef = &g_tmLimitDef[i];
+		if (!pDef->inUse)
+			continue;
+		
+		pStatus[n].id = (UINT16)i;
+		pStatus[n].src = (UINT8)pDef->field.src;
+		pStatus[n].isFailing = (UINT8)pDef->isFailing;
+		pStatus[n].numViolations = pDef->numViolations;
+		pStatus[n].dValue = pDef->dValue;
+		n++;
+	}
+	
+	return n;
+}
+
+void tmLimitShow(void) {
+	const TmLimitDef *pDef;
+	int i;
+	
+	printf("%2s %-4s %-16s %14s %14s %14s %4s %6s\n",
+		   "ID", "SRC", "FIELD", "LO", "HI", "VALUE", "FAIL", "COUNT");
+	for (i = 0; i < TM_LIMIT_MAX; i++) {
+		pDef = &g_tmLimitDef[i];
+		if (!pDef->inUse)
+			continue;
+		
+		printf("%2d %-4d %-16s %14g %14g %14g %4s %6u\n",
+			   i, pDef->field.src, pDef->szName, pDef->lo, pDef->hi,
+			   pDef->dValue, pDef->isFailing ? "*" : "", pDef->numViolations);
+	}
+	
+	for (i = 0; i < TM_WAIT_SRC_MAX; i++) {
+		if (g_tmLimitBank[i][g_tmLimitActive[i]].num > 0)
+			printf("src %d : %d limits in bank %d\n", i,
+				   g_tmLimitBank[i][g_tmLimitActive[i]].num, g_tmLimitActive[i]);
+	}
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <vxWorks.h>
+
+#include "TmField.h"
+
+/*
+ * Limits checked by tSdlcRecvGcu on every received GF frame. The limits
+ * of one frame type are compiled into flat arrays, and a frame is checked
+ * in a single loop over them. A limit that starts or stops failing is
+ * reported once through LogSend.
+ */
+#define TM_LIMIT_MAX			(32)
+#define TM_LIMIT_LOG_INDEX_ID	(0xE0)
+
+typedef enum {
+	TM_LIMIT_EVENT_CLEARED,
+	TM_LIMIT_EVENT_VIOLATED
+} TmLimitEventType;
+
+/* LogSend body of one limit transition. */
+typedef struct {
+	UINT64	timeNs;			/* HwTime of the frame's receipt */
+	UINT32	frameSeq;		/* TmWaitSeq() of the frame */
+	UINT16	id;
+	UINT8	src;			/* TmWaitSrc, TM_WAIT_SRC(unit, type) */
+	UINT8	event;			/* TmLimitEventType */
+	double	dValue;
+	double	lo;
+	double	hi;
+} __attribute__((packed)) TmLimitEvent;
+
+/* One element of the mtsLimitShow result vector. */
+typedef struct {
+	UINT16	id;
+	UINT8	src;
+	UINT8	isFailing;
+	UINT32	numViolations;
+	double	dValue;
+} TmLimitStatus;
+
+IMPORT STATUS	TmLimitInit(void);
+IMPORT int		TmLimitAdd(const TmField *pField, double lo, double hi, UINT32 mask);
+IMPORT STATUS	TmLimitRemove(int id);
+IMPORT void		TmLimitClear(TmWaitSrc src);
+IMPORT void		TmLimitEval(TmWaitSrc src, const void *pFrame, UINT64 timeNs);
+IMPORT int		TmLimitStatusGet(TmLimitStatus *pStatus, int maxNum);
+IMPORT void		tmLimitShow(void);
@@ -0,0 +1,424 @@
+#include <taskLib.h>
+#include <semLib.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../lib/util/isDebug.h"
+#include "../lib/util/isClock.h"
+#include "../lib/util/isHist.h"
+#include "common.h"
+#include "TmWait.h"
+#include "FrameRing.h"
+
+#define TM_WAIT_BENCH_TASK_NAME		"tTmWaitBench"
+#define TM_WAIT_BENCH_PRIORITY		(90)
+#define TM_WAIT_BENCH_STACK_SIZE	(16384)
+#define TM_WAIT_BENCH_MAX_GAP		(5)
+
+/* tmWaitBench() publishes on a source of its own, past those of the units. */
+#define TM_WAIT_SRC_BENCH			((TmWaitSrc)TM_WAIT_SRC_MAX)
+#define TM_WAIT_SRC_ALL				(TM_WAIT_SRC_MAX + 1)
+
+typedef enum {
+	TM_WAITER_FREE,
+	TM_WAITER_WAITING,
+	TM_WAITER_MATCHED,
+	TM_WAITER_ABORTED
+} TmWaiterState;
+
+typedef struct {
+	volatile TmWaiterState	state;
+	TASK_ID					tid;
+	TmWaitPred				pred;
+	INT32					val;
+	UINT64					rxCount;		/* of the frame that matched */
+	UINT64					tPublish;
+	SEM_ID					sidWake;
+} TmWaiter;
+
+typedef struct {
+	UINT32	numWaits;
+	UINT32	numMatched;
+	UINT32	numImmediate;
+	UINT32	numTimeouts;
+	UINT32	numAborts;
+	IsHist	wakeUs;			/* publish -> waiter running again */
+} TmWaitStats;
+
+LOCAL SEM_ID g_sidTmWaitLock = SEM_ID_NULL;
+LOCAL TmWaiter g_tmWaiters[TM_WAIT_MAX_WAITERS];
+LOCAL volatile UINT32 g_tmWaitSeq[TM_WAIT_SRC_ALL];
+LOCAL UINT64 g_tmWaitRxCount[TM_WAIT_SRC_ALL];		/* latest frame, under the lock */
+LOCAL TmWaitStats g_tmWaitStats;
+
+/* readField() widens fields of up to 32 bits; evalPred() compares those. */
+LOCAL BOOL isPredValid(const TmWaitPred *pPred) {
+	return (pPred->src < TM_WAIT_SRC_ALL) &&
+		   ((pPred->size == 1) || (pPred->size == 2) || (pPred->size == 4));
+}
+
+/*
+ * A field of a received frame is read from the latest frame of its
+ * source, whichever ring slot the predicate was built from. pPred passed
+ * isPredValid().
+ */
+LOCAL INT32 readField(const TmWaitPred *pPred) {
+	const volatile void *pField = pPred->pField;
+	int offset = FrameRingOffset(pPred->src, pField);
+	UINT32 raw;
+	
+	if (offset != ERROR)
+		pField = (const char *)FrameRingLatest(pPred->src) + offset;
+	
+	switch (pPred->size) {
+	case 1:
+		raw = *(const volatile UINT8 *)pField;
+		return pPred->isSigned ? (INT32)(INT8)raw : (INT32)raw;
+	case 2:
+		raw = *(const volatile UINT16 *)pField;
+		return pPred->isSigned ? (INT32)(INT16)raw : (INT32)raw;
+	default:
+		return (INT32)*(const volatile UINT32 *)pField;
+	}
+}
+
+LOCAL BOOL evalPred(const TmWaitPred *pPred, INT32 val) {
+	INT64 lhs = (INT64)((UINT32)val & pPred->mask);
+	INT64 rhs = pPred->ref;
+	
+	if (pPred->isSigned && (pPred->mask == 0xFFFFFFFF))
+		lhs = val;
+	
+	switch (pPred->op) {
+	case TM_WAIT_OP_EQ:	return (lhs == rhs);
+	case TM_WAIT_OP_NE:	return (lhs != rhs);
+	case TM_WAIT_OP_LT:	return (lhs < rhs);
+	case TM_WAIT_OP_LE:	return (lhs <= rhs);
+	case TM_WAIT_OP_GT:	return (lhs > rhs);
+	case TM_WAIT_OP_GE:	return (lhs >= rhs);
+	case TM_WAIT_OP_IN:	return ((lhs >= rhs) && (lhs <= pPred->ref2));
+	}
+	
+	return FALSE;
+}
+
+LOCAL TmWaiter *findWaiter(TASK_ID tid) {
+	int i;
+	
+	for (i = 0; i < TM_WAIT_MAX_WAITERS; i++) {
+		if ((g_tmWaiters[i].state != TM_WAITER_FREE) && (g_tmWaiters[i].tid == tid))
+			return &g_tmWaiters[i];
+	}
+	
+	return NULL;
+}
+
+STATUS TmWaitInit(void) {
+	int i;
+	
+	if (g_sidTmWaitLock != SEM_ID_NULL)
+		return OK;
+	
+	memset(g_tmWaiters, 0, sizeof(g_tmWaiters));
+	memset(&g_tmWaitStats, 0, sizeof(g_tmWaitStats));
+	isHistReset(&g_tmWaitStats.wakeUs);
+	
+	for (i = 0; i < TM_WAIT_MAX_WAITERS; i++) {
+		g_tmWaiters[i].sidWake = semBCreate(SEM_Q_PRIORITY, SEM_EMPTY);
+		if (g_tmWaiters[i].sidWake == SEM_ID_NULL) {
+			LOGMSG("semBCreate() error!\n");
+			return ERROR;
+		}
+	}
+	
+	g_sidTmWaitLock = semMCreate(SEM_Q_PRIORITY | SEM_DELETE_SAFE | SEM_INVERSION_SAFE);
+	if (g_sidTmWaitLock == SEM_ID_NULL) {
+		LOGMSG("semMCreate() error!\n");
+		return ERROR;
+	}
+	
+	return OK;
+}
+
+/*
+ * Called by tSdlcRecvGcu after a frame of src has been stored; rxCount
+ * is the HwTimeCount() of its receipt. Predicates are evaluated here, so
+ * only a waiter whose condition became true is woken.
+ */
+void TmWaitPublish(TmWaitSrc src, UINT64 rxCount) {
+	TmWaiter *pWaiter;
+	UINT64 tNow;
+	INT32 val;
+	int i;
+	
+	if ((src >= TM_WAIT_SRC_ALL) || (g_sidTmWaitLock == SEM_ID_NULL))
+		return;
+	
+	g_tmWaitSeq[src]++;
+	tNow = isClockNs();
+	
+	semTake(g_sidTmWaitLock, WAIT_FOREVER);
+	
+	g_tmWaitRxCount[src] = rxCount;
+	
+	for (i = 0; i < TM_WAIT_MAX_WAITERS; i++) {
+		pWaiter = &g_tmWaiters[i];
+		
+		if ((pWaiter->state != TM_WAITER_WAITING) || (pWaiter->pred.src != src))
+			continue;
+		
+		val = readField(&pWaiter->pred);
+		if (!evalPred(&pWaiter->pred, val))
+			continue;
+		
+		pWaiter->val = val;
+		pWaiter->rxCount = rxCount;
+		pWaiter->tPublish = tNow;
+		pWaiter->state = TM_WAITER_MATCHED;
+		semGive(pWaiter->sidWake);
+	}
+	
+	semGive(g_sidTmWaitLock);
+}
+
+UINT32 TmWaitSeq(TmWaitSrc src) {
+	return (src < TM_WAIT_SRC_ALL) ? g_tmWaitSeq[src] : 0;
+}
+
+/*
+ * Returns OK once the predicate holds, checking the current value first;
+ * *pRxCount, unless NULL, is then the receipt of the frame that holds it,
+ * or the time of the check if no frame of src has been published yet.
+ * Returns ERROR on timeout, on TmWaitAbort() or when pfnCancelled reports
+ * the caller cancelled; *pVal then holds the last value of the field and
+ * *pRxCount is 0. A field wider than 32 bits is not waited on: ERROR,
+ * with *pVal 0.
+ */
+STATUS TmWaitFor(const TmWaitPred *pPred, int timeout,
+				 TM_WAIT_CANCEL_FUNC pfnCancelled, INT32 *pVal, UINT64 *pRxCount) {
+	TmWaiter *pWaiter = NULL;
+	TmWaiterState state;
+	INT32 val;
+	UINT64 rxCount = 0;
+	int i;
+	
+	if (g_sidTmWaitLock == SEM_ID_NULL)
+		return ERROR;
+	
+	if (!isPredValid(pPred)) {
+		LOGMSG("Invalid telemetry wait : src %d, %d-byte field.\n", pPred->src, pPred->size);
+		*pVal = 0;
+		if (pRxCount != NULL)
+			*pRxCount = 0;
+		return ERROR;
+	}
+	
+	semTake(g_sidTmWaitLock, WAIT_FOREVER);
+	
+	g_tmWaitStats.numWaits++;
+	
+	val = readField(pPred);
+	if (evalPred(pPred, val)) {
+		g_tmWaitStats.numMatched++;
+		g_tmWaitStats.numImmediate++;
+		rxCount = g_tmWaitRxCount[pPred->src];
+		semGive(g_sidTmWaitLock);
+		/* Nothing published on src yet: the value is as of now. */
+		if (rxCount == 0)
+			rxCount = isClockNs();
+		*pVal = val;
+		if (pRxCount != NULL)
+			*pRxCount = rxCount;
+		return OK;
+	}
+	
+	for (i = 0; i < TM_WAIT_MAX_WAITERS; i++) {
+		if (g_tmWaiters[i].state == TM_WAITER_FREE) {
+			pWaiter = &g_tmWaiters[i];
+			break;
+		}
+	}
+	
+	if (pWaiter == NULL) {
+		semGive(g_sidTmWaitLock);
+		LOGMSG("No free telemetry waiter.\n");
+		*pVal = val;
+		if (pRxCount != NULL)
+			*pRxCount = 0;
+		return ERROR;
+	}
+	
+	/* A stale wake-up from an earlier timed-out wait must not count. */
+	semTake(pWaiter->sidWake, NO_WAIT);
+	pWaiter->tid = taskIdSelf();
+	pWaiter->pred = *pPred;
+	pWaiter->state = ((pfnCancelled != NULL) && pfnCancelled()) ?
+					 TM_WAITER_ABORTED : TM_WAITER_WAITING;
+	
+	semGive(g_sidTmWaitLock);
+	
+	if (pWaiter->state == TM_WAITER_WAITING)
+		semTake(pWaiter->sidWake, timeout);
+	
+	semTake(g_sidTmWaitLock, WAIT_FOREVER);
+	
+	state = pWaiter->state;
+	if (state == TM_WAITER_MATCHED) {
+		val = pWaiter->val;
+		rxCount = pWaiter->rxCount;
+		g_tmWaitStats.numMatched++;
+		isHistAdd(&g_tmWaitStats.wakeUs, isClockNsToUs(isClockNs() - pWaiter->tPublish));
+	} else {
+		val = readField(pPred);
+		if (state == TM_WAITER_ABORTED)
+			g_tmWaitStats.numAborts++;
+		else
+			g_tmWaitStats.numTimeouts++;
+	}
+	
+	pWaiter->state = TM_WAITER_FREE;
+	pWaiter->tid = TASK_ID_NULL;
+	
+	semGive(g_sidTmWaitLock);
+	
+	*pVal = val;
+	if (pRxCount != NULL)
+		*pRxCount = rxCount;
+	
+	return (state == TM_WAITER_MATCHED) ? OK : ERROR;
+}
+
+void TmWaitAbort(TASK_ID tid) {
+	TmWaiter *pWaiter;
+	
+	if (g_sidTmWaitLock == SEM_ID_NULL)
+		return;
+	
+	semTake(g_sidTmWaitLock, WAIT_FOREVER);
+	
+	if (((pWaiter = findWaiter(tid)) != NULL) && (pWaiter->state == TM_WAITER_WAITING)) {
+		pWaiter->state = TM_WAITER_ABORTED;
+		semGive(pWaiter->sidWake);
+	}
+	
+	semGive(g_sidTmWaitLock);
+}
+
+/* Frees the slot of a task that was deleted while it was waiting. */
+void TmWaitDrop(TASK_ID tid) {
+	TmWaiter *pWaiter;
+	
+	if (g_sidTmWaitLock == SEM_ID_NULL)
+		return;
+	
+	semTake(g_sidTmWaitLock, WAIT_FOREVER);
+	
+	if ((pWaiter = findWaiter(tid)) != NULL) {
+		pWaiter->state = TM_WAITER_FREE;
+		pWaiter->tid = TASK_ID_NULL;
+	}
+	
+	semGive(g_sidTmWaitLock);
+}
+
+void tmWaitShow(void) {
+	TmWaiter *pWaiter;
+	int i;
+	
+	printf("\n waits     : %u", g_tmWaitStats.numWaits);
+	printf("\n matched   : %u (immediate %u)",
+		   g_tmWaitStats.numMatched, g_tmWaitStats.numImmediate);
+	printf("\n timeouts  : %u", g_tmWaitStats.numTimeouts);
+	printf("\n aborts    : %u", g_tmWaitStats.numAborts);
+	printf("\n");
+	isHistShow(&g_tmWaitStats.wakeUs, "wake (us)");
+	
+	for (i = 0; i < TM_WAIT_MAX_WAITERS; i++) {
+		pWaiter = &g_tmWaiters[i];
+		if (pWaiter->state == TM_WAITER_FREE)
+			continue;
+		
+		printf(" waiter %d : %s src %d op %d ref 0x%X mask 0x%X\n",
+			   i, taskName(pWaiter->tid), pWaiter->pred.src,
+			   pWaiter->pred.op, pWaiter->pred.ref, pWaiter->pred.mask);
+	}
+}
+
+/*
+ * Shell benchmark: a helper task stores a new value and publishes it
+ * 1..TM_WAIT_BENCH_MAX_GAP ticks apart, and the shell task detects it
+ * first by the old taskDelay(1) polling, then with TmWaitFor(). The
+ * histograms are the publish-to-detect time each method adds to a step.
+ * It publishes on TM_WAIT_SRC_BENCH, so waits on received frames and
+ * their receipt counts are left alone.
+ */
+LOCAL volatile INT32 g_tmWaitBenchVal;
+LOCAL volatile UINT64 g_tmWaitBenchTPub;
+LOCAL volatile BOOL g_tmWaitBenchQuit;
+
+LOCAL void tmWaitBenchPub(int numSamples) {
+	int i;
+	
+	for (i = 1; (i <= numSamples) && !g_tmWaitBenchQuit; i++) {
+		taskDelay(1 + (rand() % TM_WAIT_BENCH_MAX_GAP));
+		g_tmWaitBenchTPub = isClockNs();
+		g_tmWaitBenchVal = i;
+		TmWaitPublish(TM_WAIT_SRC_BENCH, g_tmWaitBenchTPub);
+	}
+}
+
+LOCAL void tmWaitBenchRun(int numSamples, BOOL usePoll, IsHist *pHist) {
+	TmWaitPred pred;
+	INT32 val;
+	TASK_ID tid;
+	int i;
+	
+	isHistReset(pHist);
+	g_tmWaitBenchVal = 0;
+	g_tmWaitBenchQuit = FALSE;
+	
+	tid = taskSpawn(TM_WAIT_BENCH_TASK_NAME, TM_WAIT_BENCH_PRIORITY, 0,
+					TM_WAIT_BENCH_STACK_SIZE, (FUNCPTR)tmWaitBenchPub,
+					numSamples, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+	if (tid == TASK_ID_ERROR) {
+		printf("taskSpawn(%s) error!\n", TM_WAIT_BENCH_TASK_NAME);
+		return;
+	}
+	
+	for (i = 1; i <= numSamples; i++) {
+		if (usePoll) {
+			while (g_tmWaitBenchVal < i)
+				taskDelay(1);
+		} else {
+			TM_WAIT_PRED_INIT(pred, TM_WAIT_SRC_BENCH, g_tmWaitBenchVal,
+							  0xFFFFFFFF, TM_WAIT_OP_GE, i);
+			if (TmWaitFor(&pred, GET_DELAY_TICK(1000), NULL, &val, NULL) == ERROR) {
+				printf("TmWaitFor() timeout at sample %d\n", i);
+				break;
+			}
+		}
+		isHistAdd(pHist, isClockNsToUs(isClockNs() - g_tmWaitBenchTPub));
+	}
+	
+	g_tmWaitBenchQuit = TRUE;
+	taskDelay(TM_WAIT_BENCH_MAX_GAP + 1);
+}
+
+void tmWaitBench(int numSamples) {
+	IsHist histPoll, histEvent;
+	
+	if (numSamples <= 0)
+		numSamples = 200;
+	
+	if (TmWaitInit() == ERROR)
+		return;
+	
+	tmWaitBenchRun(numSamples, TRUE, &histPoll);
+	tmWaitBenchRun(numSamples, FALSE, &histEvent);
+	
+	isHistShow(&histPoll, "poll (us)");
+	isHistShow(&histEvent, "event (us)");
+	printf(" mean step time saved: %d us\n",
+		   (int)isHistMean(&histPoll) - (int)isHistMean(&histEvent));
+}
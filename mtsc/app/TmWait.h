@@ -0,0 +1,85 @@
+#pragma once
+
+#include <vxWorks.h>
+
+/*
+ * Predicate waits on received telemetry. SdlcRecvGcu publishes each GF
+ * frame once it has been swapped into its ring; a waiting task registers
+ * a predicate on one field of that frame and sleeps until a publish of
+ * the same source makes it true, the timeout expires or it is aborted.
+ *
+ * Each publish carries the HwTimeCount() of the frame's receipt, and a
+ * wait that succeeds returns that of the frame which satisfied it, so
+ * the caller can time the response from the frame rather than from its
+ * own wake-up.
+ *
+ * A source is one frame type of one GCU unit: TM_WAIT_SRC(unit, type).
+ * The enumerators below are the types, which are also the sources of
+ * unit 0.
+ */
+#define TM_WAIT_MAX_WAITERS		(8)
+#define TM_WAIT_UNIT_MAX		(4)
+
+typedef enum {
+	TM_WAIT_SRC_GF2,
+	TM_WAIT_SRC_GF3,
+	TM_WAIT_SRC_GF5,
+	TM_WAIT_SRC_GF6,
+	TM_WAIT_SRC_GF7,
+	TM_WAIT_SRC_GF8,
+	TM_WAIT_SRC_GF9,
+	TM_WAIT_SRC_GF11,
+	TM_WAIT_SRC_GF12,
+	TM_WAIT_SRC_TYPES
+} TmWaitSrc;
+
+#define TM_WAIT_SRC_MAX			(TM_WAIT_SRC_TYPES * TM_WAIT_UNIT_MAX)
+#define TM_WAIT_SRC(unit, type)	((TmWaitSrc)((unit) * TM_WAIT_SRC_TYPES + (type)))
+#define TM_WAIT_SRC_UNIT(src)	((int)(src) / TM_WAIT_SRC_TYPES)
+#define TM_WAIT_SRC_TYPE(src)	((TmWaitSrc)((int)(src) % TM_WAIT_SRC_TYPES))
+
+typedef enum {
+	TM_WAIT_OP_EQ,
+	TM_WAIT_OP_NE,
+	TM_WAIT_OP_LT,
+	TM_WAIT_OP_LE,
+	TM_WAIT_OP_GT,
+	TM_WAIT_OP_GE,
+	TM_WAIT_OP_IN		/* ref <= x <= ref2 */
+} TmWaitOp;
+
+/* (field & mask) op ref, with the field sign-extended when isSigned. */
+typedef struct {
+	TmWaitSrc				src;
+	const volatile void *	pField;
+	UINT8					size;
+	BOOL					isSigned;
+	UINT32					mask;
+	TmWaitOp				op;
+	INT32					ref;
+	INT32					ref2;
+} TmWaitPred;
+
+#define TM_WAIT_PRED_INIT(pred, srcId, field, chkMask, cmpOp, refVal) \
+	do { \
+		(pred).src = (srcId); \
+		(pred).pField = &(field); \
+		(pred).size = sizeof(field); \
+		(pred).isSigned = ((__typeof__(field))-1 < 0); \
+		(pred).mask = (chkMask); \
+		(pred).op = (cmpOp); \
+		(pred).ref = (refVal); \
+		(pred).ref2 = (refVal); \
+	} while (0)
+
+typedef BOOL (*TM_WAIT_CANCEL_FUNC)(void);
+
+IMPORT STATUS	TmWaitInit(void);
+IMPORT void		TmWaitPublish(TmWaitSrc src, UINT64 rxCount);
+IMPORT UINT32	TmWaitSeq(TmWaitSrc src);
+IMPORT STATUS	TmWaitFor(const TmWaitPred *pPred, int timeout,
+						  TM_WAIT_CANCEL_FUNC pfnCancelled, INT32 *pVal, UINT64 *pRxCount);
+IMPORT void		TmWaitAbort(TASK_ID tid);
+IMPORT void		TmWaitDrop(TASK_ID tid);
+IMPORT void		tmWaitShow(void);
+IMPORT void		tmWaitBench(int numSamples);
@@ -107,6 +107,14 @@ typedef struct {
 
 IMPORT const ModuleInst *g_hSdlcRecvGcu;
 
+/* Deprecated: the nav check of unit 0 only; other units log theirs. */
+IMPORT MonitoringNavLog * g_pMonNav;
+
+/*
+ * Working pointers of the tmSwapGfN() routines only: NULL except while
+ * SdlcGfSwapRoutine() runs one. Received frames are read through
+ * FrameRingRead() or GCU_GF(), never through these.
+ */
 IMPORT TM_TYPE_SDLC_RX * g_pTmSdlcGfRx;
 IMPORT TM_TYPE_GF2 * g_pTmGf2;
 IMPORT TM_TYPE_GF3 * g_pTmGf3;
@@ -118,6 +126,4 @@ IMPORT TM_TYPE_GF9 * g_pTmGf9;
 IMPORT TM_TYPE_GF11 * g_pTmGf11;
 IMPORT TM_TYPE_GF12 * g_pTmGf12;
 
-IMPORT MonitoringNavLog * g_pMonNav;
-
 IMPORT void SdlcRecvGcuMain(ModuleInst *pModuleInst);
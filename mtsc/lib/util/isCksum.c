@@ -0,0 +1,330 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+#include "isClock.h"
+#include "isCksum.h"
+
+#define IS_CKSUM_CRC32_POLY		(0xEDB88320U)
+#define IS_CKSUM_CRC16_POLY		(0x1021)
+#define IS_CKSUM_BENCH_LOOPS	(10)
+
+static UINT32 g_isCrc32Tbl[8][256];
+static UINT16 g_isCrc16Tbl[8][256];
+static volatile BOOL g_isCrcTblReady;
+
+/*
+ * Tk[b] is the CRC of byte b followed by k zero bytes, so eight input
+ * bytes fold into the state with eight lookups. Building the tables
+ * twice from two tasks writes the same values, so no lock is taken.
+ */
+static void isCksumBuildTables(void) {
+	UINT32 c32;
+	UINT16 c16;
+	int i, k;
+	
+	for (i = 0; i < 256; i++) {
+		c32 = (UINT32)i;
+		c16 = (UINT16)(i << 8);
+		for (k = 0; k < 8; k++) {
+			c32 = (c32 & 1) ? ((c32 >> 1) ^ IS_CKSUM_CRC32_POLY) : (c32 >> 1);
+			c16 = (c16 & 0x8000) ? (UINT16)((c16 << 1) ^ IS_CKSUM_CRC16_POLY) : (UINT16)(c16 << 1);
+		}
+		g_isCrc32Tbl[0][i] = c32;
+		g_isCrc16Tbl[0][i] = c16;
+	}
+	
+	for (k = 1; k < 8; k++) {
+		for (i = 0; i < 256; i++) {
+			c32 = g_isCrc32Tbl[k - 1][i];
+			g_isCrc32Tbl[k][i] = (c32 >> 8) ^ g_isCrc32Tbl[0][c32 & 0xFF];
+			c16 = g_isCrc16Tbl[k - 1][i];
+			g_isCrc16Tbl[k][i] = (UINT16)((c16 << 8) ^ g_isCrc16Tbl[0][c16 >> 8]);
+		}
+	}
+	
+	g_isCrcTblReady = TRUE;
+}
+
+static inline UINT32 isCksumLoad32(const UINT8 *p) {
+	UINT32 word;
+	
+	memcpy(&word, p, sizeof(word));
+	
+	return word;
+}
+
+/* Sum of numWords native 32-bit words; p need not be aligned. */
+static UINT32 isCksumSumWords(const UINT8 *p, int numWords) {
+	UINT32 sum = 0;
+#if defined(__SSE2__)
+	__m128i acc0 = _mm_setzero_si128(), acc1 = _mm_setzero_si128();
+	UINT32 lanes[4];
+	
+	for (; numWords >= 8; numWords -= 8, p += 32) {
+		acc0 = _mm_add_epi32(acc0, _mm_loadu_si128((const __m128i *)p));
+		acc1 = _mm_add_epi32(acc1, _mm_loadu_si128((const __m128i *)(p + 16)));
+	}
+	_mm_storeu_si128((__m128i *)lanes, _mm_add_epi32(acc0, acc1));
+	sum = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+#elif defined(__ARM_NEON)
+	uint32x4_t acc0 = vdupq_n_u32(0), acc1 = vdupq_n_u32(0);
+	
+	for (; numWords >= 8; numWords -= 8, p += 32) {
+		acc0 = vaddq_u32(acc0, vreinterpretq_u32_u8(vld1q_u8(p)));
+		acc1 = vaddq_u32(acc1, vreinterpretq_u32_u8(vld1q_u8(p + 16)));
+	}
+	acc0 = vaddq_u32(acc0, acc1);
+	sum = vgetq_lane_u32(acc0, 0) + vgetq_lane_u32(acc0, 1) +
+		  vgetq_lane_u32(acc0, 2) + vgetq_lane_u32(acc0, 3);
+#else
+	UINT32 s1 = 0, s2 = 0, s3 = 0;
+	
+	for (; numWords >= 4; numWords -= 4, p += 16) {
+		sum += isCksumLoad32(p);
+		s1 += isCksumLoad32(p + 4);
+		s2 += isCksumLoad32(p + 8);
+		s3 += isCksumLoad32(p + 12);
+	}
+	sum += s1 + s2 + s3;
+#endif
+
+	for (; numWords > 0; numWords--, p += 4)
+		sum += isCksumLoad32(p);
+	
+	return sum;
+}
+
+static UINT32 isCksumCrc32(UINT32 crc, const UINT8 *p, int len) {
+	UINT32 lo;
+	
+	for (; len >= 8; len -= 8, p += 8) {
+		lo = crc ^ ((UINT32)p[0] | ((UINT32)p[1] << 8) |
+					((UINT32)p[2] << 16) | ((UINT32)p[3] << 24));
+		crc = g_isCrc32Tbl[7][lo & 0xFF] ^ g_isCrc32Tbl[6][(lo >> 8) & 0xFF] ^
+			  g_isCrc32Tbl[5][(lo >> 16) & 0xFF] ^ g_isCrc32Tbl[4][lo >> 24] ^
+			  g_isCrc32Tbl[3][p[4]] ^ g_isCrc32Tbl[2][p[5]] ^
+			  g_isCrc32Tbl[1][p[6]] ^ g_isCrc32Tbl[0][p[7]];
+	}
+	
+	while (len-- > 0)
+		crc = (crc >> 8) ^ g_isCrc32Tbl[0][(crc ^ *p++) & 0xFF];
+	
+	return crc;
+}
+
+static UINT16 isCksumCrc16(UINT16 crc, const UINT8 *p, int len) {
+	for (; len >= 8; len -= 8, p += 8) {
+		crc = g_isCrc16Tbl[7][p[0] ^ (crc >> 8)] ^ g_isCrc16Tbl[6][p[1] ^ (crc & 0xFF)] ^
+			  g_isCrc16Tbl[5][p[2]] ^ g_isCrc16Tbl[4][p[3]] ^
+			  g_isCrc16Tbl[3][p[4]] ^ g_isCrc16Tbl[2][p[5]] ^
+			  g_isCrc16Tbl[1][p[6]] ^ g_isCrc16Tbl[0][p[7]];
+	}
+	
+	while (len-- > 0)
+		crc = (UINT16)((crc << 8) ^ g_isCrc16Tbl[0][(crc >> 8) ^ *p++]);
+	
+	return crc;
+}
+
+void isCksumInit(IsCksum *pCksum, UINT32 flags) {
+	if (!g_isCrcTblReady)
+		isCksumBuildTables();
+	
+	memset(pCksum, 0, sizeof(IsCksum));
+	pCksum->flags = flags;
+	pCksum->crc32 = 0xFFFFFFFF;
+	pCksum->crc16 = 0xFFFF;
+}
+
+void isCksumUpdate(IsCksum *pCksum, const void *pBuf, int len) {
+	const UINT8 *p = (const UINT8 *)pBuf;
+	int n;
+	
+	if (len <= 0)
+		return;
+	
+	pCksum->numBytes += len;
+	
+	if (pCksum->flags & IS_CKSUM_CRC32)
+		pCksum->crc32 = isCksumCrc32(pCksum->crc32, p, len);
+	if (pCksum->flags & IS_CKSUM_CRC16)
+		pCksum->crc16 = isCksumCrc16(pCksum->crc16, p, len);
+	
+	if (!(pCksum->flags & IS_CKSUM_SUM))
+		return;
+	
+	/* Complete a word left over from the previous chunk first. */
+	if (pCksum->tailLen > 0) {
+		n = 4 - pCksum->tailLen;
+		if (n > len)
+			n = len;
+		memcpy(&pCksum->tail[pCksum->tailLen], p, n);
+		pCksum->tailLen += n;
+		p += n;
+		len -= n;
+		
+		if (pCksum->tailLen < 4)
+			return;
+		pCksum->sum += isCksumLoad32(pCksum->tail);
+		pCksum->tailLen = 0;
+	}
+	
+	pCksum->sum += isCksumSumWords(p, len / 4);
+	
+	pCksum->tailLen = len & 3;
+	memcpy(pCksum->tail, p + (len & ~3), pCksum->tailLen);
+}
+
+void isCksumFinal(IsCksum *pCksum) {
+	if (pCksum->tailLen > 0) {
+		memset(&pCksum->tail[pCksum->tailLen], 0, 4 - pCksum->tailLen);
+		pCksum->sum += isCksumLoad32(pCksum->tail);
+		pCksum->tailLen = 0;
+	}
+	
+	pCksum->crc32 ^= 0xFFFFFFFF;
+}
+
+UINT32 isCksumSum(const void *pBuf, int len) {
+	IsCksum cksum;
+	
+	isCksumInit(&cksum, IS_CKSUM_SUM);
+	isCksumUpdate(&cksum, pBuf, len);
+	isCksumFinal(&cksum);
+	
+	return cksum.sum;
+}
+
+/* The word loop the GCU header checksum used before this module. */
+static UINT32 isCksumSumRef(const void *pBuf, int len) {
+	const int *pWord = (const int *)pBuf;
+	UINT32 sum = 0;
+	int i;
+	
+	for (i = 0; i < len; i += 4)
+		sum += (UINT32)*pWord++;
+	
+	return sum;
+}
+
+static UINT32 isCksumCrc32Ref(const UINT8 *p, int len) {
+	UINT32 crc = 0xFFFFFFFF;
+	int k;
+	
+	while (len-- > 0) {
+		crc ^= *p++;
+		for (k = 0; k < 8; k++)
+			crc = (crc & 1) ? ((crc >> 1) ^ IS_CKSUM_CRC32_POLY) : (crc >> 1);
+	}
+	
+	return crc ^ 0xFFFFFFFF;
+}
+
+/* CRC-16/CCITT, MSB first from 0xFFFF, as the GCU checks it. */
+static UINT16 isCksumCrc16Ref(const UINT8 *p, int len) {
+	UINT16 crc = 0xFFFF;
+	int k;
+	
+	while (len-- > 0) {
+		crc ^= (UINT16)(*p++ << 8);
+		for (k = 0; k < 8; k++)
+			crc = (crc & 0x8000) ? (UINT16)((crc << 1) ^ IS_CKSUM_CRC16_POLY) : (UINT16)(crc << 1);
+	}
+	
+	return crc;
+}
+
+static void isCksumBenchLine(const char *szName, UINT64 ns, int numBytes, UINT32 val, UINT32 ref) {
+	UINT32 us = isClockNsToUs(ns / IS_CKSUM_BENCH_LOOPS);
+	
+	printf("\n %-18s %8u us %8u KB/s  0x%08X %s", szName, us,
+		   (us > 0) ? (UINT32)(((UINT64)numBytes * 1000000) / ((UINT64)us * 1024)) : 0,
+		   val, (val == ref) ? "" : "MISMATCH");
+}
+
+/*
+ * Times each digest over numBytes (0 for a 2.5 MB image) against the
+ * plain word loop and bitwise CRCs, and checks they agree.
+ */
+void isCksumBench(int numBytes) {
+	UINT8 *pBuf;
+	IsCksum cksum;
+	UINT32 ref = 0, crcRef, crc16Ref, val = 0;
+	UINT64 t;
+	int i, off, n;
+	
+	if (numBytes <= 0)
+		numBytes = 0x00280000;
+	
+	if ((pBuf = (UINT8 *)malloc(numBytes + 4)) == NULL) {
+		printf("malloc(%d) error!\n", numBytes + 4);
+		return;
+	}
+	
+	for (i = 0; i < numBytes; i++)
+		pBuf[i] = (UINT8)((i * 2654435761U) >> 24);
+	memset(pBuf + numBytes, 0, 4);
+	
+	isCksumInit(&cksum, IS_CKSUM_ALL);
+	
+	printf("\n %d bytes, mean of %d runs", numBytes, IS_CKSUM_BENCH_LOOPS);
+	
+	t = isClockNs();
+	for (i = 0; i < IS_CKSUM_BENCH_LOOPS; i++)
+		ref = isCksumSumRef(pBuf, numBytes);
+	isCksumBenchLine("sum (word loop)", isClockNs() - t, numBytes, ref, ref);
+	
+	t = isClockNs();
+	for (i = 0; i < IS_CKSUM_BENCH_LOOPS; i++)
+		val = isCksumSum(pBuf, numBytes);
+	isCksumBenchLine("sum (isCksum)", isClockNs() - t, numBytes, val, ref);
+	
+	t = isClockNs();
+	crcRef = isCksumCrc32Ref(pBuf, numBytes);
+	isCksumBenchLine("crc32 (bitwise)", (isClockNs() - t) * IS_CKSUM_BENCH_LOOPS,
+					 numBytes, crcRef, crcRef);
+	
+	t = isClockNs();
+	for (i = 0; i < IS_CKSUM_BENCH_LOOPS; i++) {
+		isCksumInit(&cksum, IS_CKSUM_CRC32);
+		isCksumUpdate(&cksum, pBuf, numBytes);
+		isCksumFinal(&cksum);
+	}
+	isCksumBenchLine("crc32 (slice-8)", isClockNs() - t, numBytes, cksum.crc32, crcRef);
+	
+	t = isClockNs();
+	crc16Ref = isCksumCrc16Ref(pBuf, numBytes);
+	isCksumBenchLine("crc16 (bitwise)", (isClockNs() - t) * IS_CKSUM_BENCH_LOOPS,
+					 numBytes, crc16Ref, crc16Ref);
+	
+	t = isClockNs();
+	for (i = 0; i < IS_CKSUM_BENCH_LOOPS; i++) {
+		isCksumInit(&cksum, IS_CKSUM_CRC16);
+		isCksumUpdate(&cksum, pBuf, numBytes);
+		isCksumFinal(&cksum);
+	}
+	isCksumBenchLine("crc16 (slice-8)", isClockNs() - t, numBytes, cksum.crc16, crc16Ref);
+	
+	/* All three over odd-sized chunks, as ImgStream would feed them. */
+	t = isClockNs();
+	for (i = 0; i < IS_CKSUM_BENCH_LOOPS; i++) {
+		isCksumInit(&cksum, IS_CKSUM_ALL);
+		for (off = 0; off < numBytes; off += n) {
+			n = ((numBytes - off) < 4093) ? (numBytes - off) : 4093;
+			isCksumUpdate(&cksum, pBuf + off, n);
+		}
+		isCksumFinal(&cksum);
+	}
+	isCksumBenchLine("all (chunked)", isClockNs() - t, numBytes, cksum.sum, ref);
+	printf("  crc32 %s, crc16 %s\n", (cksum.crc32 == crcRef) ? "OK" : "MISMATCH",
+		   (cksum.crc16 == crc16Ref) ? "OK" : "MISMATCH");
+	
+	free(pBuf);
+}
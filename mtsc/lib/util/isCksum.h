@@ -0,0 +1,30 @@
+#pragma once
+
+#include <vxWorks.h>
+
+/*
+ * Incremental image digests: the GCU header sum (native 32-bit words,
+ * short tail zero-padded), CRC-32 (IEEE, reflected) and CRC-16/CCITT
+ * (0x1021, init 0xFFFF). Feed chunks of any size with isCksumUpdate()
+ * and read the results after isCksumFinal().
+ */
+#define IS_CKSUM_SUM		(1 << 0)
+#define IS_CKSUM_CRC32		(1 << 1)
+#define IS_CKSUM_CRC16		(1 << 2)
+#define IS_CKSUM_ALL		(IS_CKSUM_SUM | IS_CKSUM_CRC32 | IS_CKSUM_CRC16)
+
+typedef struct {
+	UINT32	flags;
+	UINT32	numBytes;
+	UINT32	sum;
+	UINT32	crc32;
+	UINT16	crc16;
+	UINT8	tail[4];
+	int		tailLen;
+} IsCksum;
+
+extern void		isCksumInit(IsCksum *pCksum, UINT32 flags);
+extern void		isCksumUpdate(IsCksum *pCksum, const void *pBuf, int len);
+extern void		isCksumFinal(IsCksum *pCksum);
+extern UINT32	isCksumSum(const void *pBuf, int len);
+extern void		isCksumBench(int numBytes);
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <vxWorks.h>
+#include <time.h>
+
+#define IS_CLOCK_NS_PER_US		(1000ULL)
+#define IS_CLOCK_NS_PER_SEC		(1000000000ULL)
+
+static inline UINT64 isClockNs(void) {
+	struct timespec ts;
+	
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	
+	return ((UINT64)ts.tv_sec * IS_CLOCK_NS_PER_SEC) + (UINT64)ts.tv_nsec;
+}
+
+static inline UINT32 isClockNsToUs(UINT64 ns) {
+	return (UINT32)(ns / IS_CLOCK_NS_PER_US);
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <vxWorks.h>
+
+/* 32-bit FNV-1a, used to key small name registries. */
+#define IS_HASH_FNV_OFFSET		(0x811C9DC5U)
+#define IS_HASH_FNV_PRIME		(0x01000193U)
+
+static inline UINT32 isHashFnv1a(const char *szStr) {
+	UINT32 hash = IS_HASH_FNV_OFFSET;
+	
+	while (*szStr != '\0') {
+		hash ^= (UINT8)*szStr++;
+		hash *= IS_HASH_FNV_PRIME;
+	}
+	
+	return hash;
+}
+
+/* 64-bit FNV-1a over a buffer; chain calls by passing the previous hash. */
+#define IS_HASH_FNV64_OFFSET	(0xCBF29CE484222325ULL)
+#define IS_HASH_FNV64_PRIME		(0x00000100000001B3ULL)
+
+static inline UINT64 isHashFnv1a64(UINT64 hash, const void *pBuf, int len) {
+	const UINT8 *p = (const UINT8 *)pBuf;
+	
+	while (len-- > 0) {
+		hash ^= *p++;
+		hash *= IS_HASH_FNV64_PRIME;
+	}
+	
+	return hash;
+}
@@ -0,0 +1,80 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "isHist.h"
+
+static int isHistBucket(UINT32 val) {
+	return (val == 0) ? 0 : (32 - __builtin_clz(val));
+}
+
+void isHistReset(IsHist *pHist) {
+	memset(pHist, 0, sizeof(IsHist));
+	pHist->min = 0xFFFFFFFF;
+}
+
+void isHistAdd(IsHist *pHist, UINT32 val) {
+	if (pHist->count == 0)
+		pHist->min = 0xFFFFFFFF;
+	
+	pHist->count++;
+	pHist->sum += val;
+	
+	if (val < pHist->min)
+		pHist->min = val;
+	if (val > pHist->max)
+		pHist->max = val;
+	
+	pHist->bucket[isHistBucket(val)]++;
+}
+
+UINT32 isHistMean(const IsHist *pHist) {
+	return (pHist->count) ? (UINT32)(pHist->sum / pHist->count) : 0;
+}
+
+/*
+ * Returns the upper bound of the bucket holding the pct-th percentile,
+ * clamped to the largest sample seen.
+ */
+UINT32 isHistPercentile(const IsHist *pHist, UINT32 pct) {
+	UINT64 rank, seen = 0;
+	UINT32 upper;
+	int b;
+	
+	if (pHist->count == 0)
+		return 0;
+	
+	rank = ((UINT64)pHist->count * pct + 99) / 100;
+	if (rank == 0)
+		rank = 1;
+	
+	for (b = 0; b < IS_HIST_NUM_BUCKETS; b++) {
+		seen += pHist->bucket[b];
+		if (seen >= rank)
+			break;
+	}
+	
+	if (b == 0)
+		return 0;
+	
+	upper = (b >= 32) ? 0xFFFFFFFF : (((UINT32)1 << b) - 1);
+	
+	return (upper < pHist->max) ? upper : pHist->max;
+}
+
+void isHistShow(const IsHist *pHist, const char *szName) {
+	int b;
+	
+	printf("\n %s : n %u, min %u, avg %u, p50 %u, p99 %u, max %u",
+		   szName, pHist->count, (pHist->count) ? pHist->min : 0,
+		   isHistMean(pHist), isHistPercentile(pHist, 50),
+		   isHistPercentile(pHist, 99), pHist->max);
+	
+	for (b = 0; b < IS_HIST_NUM_BUCKETS; b++) {
+		if (pHist->bucket[b] == 0)
+			continue;
+		
+		printf("\n   < %10u : %u", (b >= 32) ? 0xFFFFFFFF : ((UINT32)1 << b),
+			   pHist->bucket[b]);
+	}
+	printf("\n");
+}
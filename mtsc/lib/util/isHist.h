@@ -0,0 +1,23 @@
+#pragma once
+
+#include <vxWorks.h>
+
+/*
+ * Log2 histogram of unsigned samples (typically microseconds).
+ * Bucket 0 counts zero, bucket b counts [2^(b-1), 2^b).
+ */
+#define IS_HIST_NUM_BUCKETS		(33)
+
+typedef struct {
+	UINT32	count;
+	UINT32	min;
+	UINT32	max;
+	UINT64	sum;
+	UINT32	bucket[IS_HIST_NUM_BUCKETS];
+} IsHist;
+
+extern void		isHistReset(IsHist *pHist);
+extern void		isHistAdd(IsHist *pHist, UINT32 val);
+extern UINT32	isHistMean(const IsHist *pHist);
+extern UINT32	isHistPercentile(const IsHist *pHist, UINT32 pct);
+extern void		isHistShow(const IsHist *pHist, const char *szName);
@@ -0,0 +1,136 @@
+#include <string.h>
+
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#elif defined(__SSSE3__)
+#include <tmmintrin.h>
+#endif
+
+#include "isSwap.h"
+
+/* True when map[off..off+width-1] reverses the same bytes of the source. */
+static BOOL isSwapIsReversed(const UINT16 *pMap, int off, int width) {
+	int k;
+	
+	for (k = 0; k < width; k++) {
+		if (pMap[off + k] != off + width - 1 - k)
+			return FALSE;
+	}
+	
+	return TRUE;
+}
+
+/*
+ * Splits the map into runs, widest word first at every offset. Fails if
+ * a byte moves other than within its own word or the plan would need
+ * more than IS_SWAP_MAX_RUNS runs.
+ */
+STATUS isSwapPlanBuild(IsSwapPlan *pPlan, const UINT16 *pMap, int size) {
+	IsSwapRun *pRun = NULL;
+	int off, width;
+	
+	memset(pPlan, 0, sizeof(IsSwapPlan));
+	pPlan->size = size;
+	
+	for (off = 0; off < size; off += width) {
+		for (width = 8; width > 1; width >>= 1) {
+			if ((off + width <= size) && isSwapIsReversed(pMap, off, width))
+				break;
+		}
+		if ((width == 1) && (pMap[off] != off))
+			return ERROR;
+		
+		if ((pRun != NULL) && (pRun->width == width)) {
+			pRun->count++;
+			continue;
+		}
+		
+		if (pPlan->numRuns == IS_SWAP_MAX_RUNS)
+			return ERROR;
+		
+		pRun = &pPlan->run[pPlan->numRuns++];
+		pRun->offset = (UINT16)off;
+		pRun->count = 1;
+		pRun->width = (UINT8)width;
+	}
+	
+	return OK;
+}
+
+void isSwapPlanRun(const IsSwapPlan *pPlan, void *pDst, const void *pSrc) {
+	const IsSwapRun *pRun;
+	int i;
+	
+	for (i = 0; i < pPlan->numRuns; i++) {
+		pRun = &pPlan->run[i];
+		isSwapWords((UINT8 *)pDst + pRun->offset, (const UINT8 *)pSrc + pRun->offset,
+					pRun->width, pRun->count);
+	}
+}
+
+/* Reverses count words of width bytes from pSrc into pDst; neither need be aligned. */
+void isSwapWords(void *pDst, const void *pSrc, int width, int count) {
+	UINT8 *pD = (UINT8 *)pDst;
+	const UINT8 *pS = (const UINT8 *)pSrc;
+	int n = width * count;
+	UINT16 w16;
+	UINT32 w32;
+	UINT64 w64;
+	
+	if (width == 1) {
+		memcpy(pD, pS, n);
+		return;
+	}
+
+#if defined(__ARM_NEON)
+	for (; n >= 16; n -= 16, pD += 16, pS += 16) {
+		uint8x16_t v = vld1q_u8(pS);
+		
+		v = (width == 2) ? vrev16q_u8(v) : (width == 4) ? vrev32q_u8(v) : vrev64q_u8(v);
+		vst1q_u8(pD, v);
+	}
+#elif defined(__SSSE3__)
+	if (n >= 16) {
+		__m128i mask = (width == 2) ?
+			_mm_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14) :
+			(width == 4) ?
+			_mm_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12) :
+			_mm_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+		
+		for (; n >= 16; n -= 16, pD += 16, pS += 16) {
+			_mm_storeu_si128((__m128i *)pD,
+							 _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)pS), mask));
+		}
+	}
+#endif
+
+	for (; n > 0; n -= width, pD += width, pS += width) {
+		switch (width) {
+		case 2:
+			memcpy(&w16, pS, 2);
+			w16 = __builtin_bswap16(w16);
+			memcpy(pD, &w16, 2);
+			break;
+		case 4:
+			memcpy(&w32, pS, 4);
+			w32 = __builtin_bswap32(w32);
+			memcpy(pD, &w32, 4);
+			break;
+		default:
+			memcpy(&w64, pS, 8);
+			w64 = __builtin_bswap64(w64);
+			memcpy(pD, &w64, 8);
+			break;
+		}
+	}
+}
+
+const char *isSwapKernel(void) {
+#if defined(__ARM_NEON)
+	return "NEON";
+#elif defined(__SSSE3__)
+	return "SSSE3";
+#else
+	return "scalar";
+#endif
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <vxWorks.h>
+
+/*
+ * Byte-swap plans for packed big-endian frames. A plan is a list of runs
+ * of equal-width words (1 = copy, 2/4/8 = byte-reversed), so a frame is
+ * converted with one vector loop per run instead of one call per field.
+ * Runs are built from a byte map: map[i] is the source byte that ends up
+ * at destination byte i.
+ */
+#define IS_SWAP_MAX_RUNS	(96)
+
+typedef struct {
+	UINT16	offset;
+	UINT16	count;			/* words of the run */
+	UINT8	width;			/* bytes per word: 1, 2, 4 or 8 */
+	UINT8	reserved;
+} IsSwapRun;
+
+typedef struct {
+	int			size;
+	int			numRuns;
+	IsSwapRun	run[IS_SWAP_MAX_RUNS];
+} IsSwapPlan;
+
+extern STATUS		isSwapPlanBuild(IsSwapPlan *pPlan, const UINT16 *pMap, int size);
+extern void			isSwapPlanRun(const IsSwapPlan *pPlan, void *pDst, const void *pSrc);
+extern void			isSwapWords(void *pDst, const void *pSrc, int width, int count);
+extern const char *	isSwapKernel(void);
@@ -0,0 +1,6 @@
+#pragma once
+
+#include "vxWorks.h"
+
+IMPORT int		errnoGet(void);
+IMPORT STATUS	errnoSet(int errorValue);
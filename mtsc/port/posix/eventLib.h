@@ -0,0 +1,28 @@
+#pragma once
+
+#include "vxWorks.h"
+
+#define VXEV01	(0x00000001)
+#define VXEV02	(0x00000002)
+#define VXEV03	(0x00000004)
+#define VXEV04	(0x00000008)
+#define VXEV05	(0x00000010)
+#define VXEV06	(0x00000020)
+#define VXEV07	(0x00000040)
+#define VXEV08	(0x00000080)
+
+#define EVENTS_WAIT_ALL			(0x00)
+#define EVENTS_WAIT_ANY			(0x01)
+#define EVENTS_RETURN_ALL		(0x02)
+#define EVENTS_KEEP_UNWANTED	(0x04)
+#define EVENTS_FETCH			(0x80)
+
+#define EVENTS_OPTIONS_NONE		(0x00)
+#define EVENTS_SEND_ONCE		(0x01)
+#define EVENTS_ALLOW_OVERWRITE	(0x02)
+#define EVENTS_SEND_IF_FREE		(0x04)
+
+IMPORT STATUS	eventReceive(_Vx_event_t events, UINT8 options,
+							 _Vx_ticks_t timeout, _Vx_event_t *pEventsReceived);
+IMPORT STATUS	eventSend(TASK_ID taskId, _Vx_event_t events);
+IMPORT STATUS	eventClear(void);
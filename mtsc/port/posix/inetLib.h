@@ -0,0 +1,5 @@
+#pragma once
+
+#include <arpa/inet.h>
+
+#include "vxWorks.h"
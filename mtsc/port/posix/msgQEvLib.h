@@ -0,0 +1,7 @@
+#pragma once
+
+#include "eventLib.h"
+#include "msgQLib.h"
+
+IMPORT STATUS	msgQEvStart(MSG_Q_ID msgQId, _Vx_event_t events, UINT8 options);
+IMPORT STATUS	msgQEvStop(MSG_Q_ID msgQId);
@@ -0,0 +1,16 @@
+#pragma once
+
+#include "vxWorks.h"
+
+#define MSG_Q_FIFO			(0x00)
+#define MSG_Q_PRIORITY		(0x01)
+#define MSG_PRI_NORMAL		(0)
+#define MSG_PRI_URGENT		(1)
+
+IMPORT MSG_Q_ID	msgQCreate(int maxMsgs, size_t maxMsgLength, int options);
+IMPORT STATUS	msgQDelete(MSG_Q_ID msgQId);
+IMPORT STATUS	msgQSend(MSG_Q_ID msgQId, char *buffer, size_t nBytes,
+						 _Vx_ticks_t timeout, int priority);
+IMPORT ssize_t	msgQReceive(MSG_Q_ID msgQId, char *buffer, size_t maxNBytes,
+							_Vx_ticks_t timeout);
+IMPORT int		msgQNumMsgs(MSG_Q_ID msgQId);
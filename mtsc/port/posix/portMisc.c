@@ -0,0 +1,98 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <limits.h>
+#include <libgen.h>
+#include <sys/stat.h>
+
+#include "portPriv.h"
+#include "errnoLib.h"
+#include "usrLib.h"
+#include "rebootLib.h"
+#include "usrFsLib.h"
+
+#define PORT_CP_BUF_SIZE	(65536)
+
+int errnoGet(void) {
+	return errno;
+}
+
+STATUS errnoSet(int errorValue) {
+	errno = errorValue;
+	
+	return OK;
+}
+
+void printErrno(int errNo) {
+	if (errNo == 0)
+		errNo = errno;
+	
+	printf("errno = 0x%x (%s)\n", errNo, strerror(errNo));
+}
+
+/*
+ * logMsg() defers formatting to tLogTask on target; on the host the
+ * message goes straight to stderr so it interleaves with sanitizer output.
+ */
+int logMsgF(char *fmt, ...) {
+	va_list ap;
+	int nRet;
+	
+	va_start(ap, fmt);
+	nRet = vfprintf(stderr, fmt, ap);
+	va_end(ap);
+	
+	return nRet;
+}
+
+STATUS reboot(int startType) {
+	fprintf(stderr, "reboot(0x%x)\n", startType);
+	fflush(NULL);
+	exit(0);
+}
+
+STATUS cp(const char *src, const char *dest) {
+	char szDest[PATH_MAX];
+	char szSrc[PATH_MAX];
+	struct stat st;
+	FILE *fpSrc, *fpDest;
+	char *pBuf;
+	size_t len;
+	STATUS nRet = OK;
+	
+	/* Copying into a directory keeps the source file name, as on target. */
+	if ((stat(dest, &st) == 0) && S_ISDIR(st.st_mode)) {
+		strncpy(szSrc, src, sizeof(szSrc) - 1);
+		szSrc[sizeof(szSrc) - 1] = '\0';
+		snprintf(szDest, sizeof(szDest), "%s/%s", dest, basename(szSrc));
+		dest = szDest;
+	}
+	
+	if ((fpSrc = fopen(src, "rb")) == NULL)
+		return ERROR;
+	
+	if ((fpDest = fopen(dest, "wb")) == NULL) {
+		fclose(fpSrc);
+		return ERROR;
+	}
+	
+	if ((pBuf = malloc(PORT_CP_BUF_SIZE)) == NULL) {
+		nRet = ERROR;
+	} else {
+		while ((len = fread(pBuf, 1, PORT_CP_BUF_SIZE, fpSrc)) > 0) {
+			if (fwrite(pBuf, 1, len, fpDest) != len) {
+				nRet = ERROR;
+				break;
+			}
+		}
+		if (ferror(fpSrc))
+			nRet = ERROR;
+		free(pBuf);
+	}
+	
+	fclose(fpSrc);
+	if (fclose(fpDest) != 0)
+		nRet = ERROR;
+	
+	return nRet;
+}
@@ -0,0 +1,186 @@
+#include <stdlib.h>
+
+#include "portPriv.h"
+#include "msgQLib.h"
+#include "msgQEvLib.h"
+
+/*
+ * Bounded ring of fixed-size slots guarded by a mutex; glibc implements
+ * the mutex and both condition variables on futexes.
+ */
+struct portMsgQ {
+	pthread_mutex_t	lock;
+	pthread_cond_t	notEmpty;
+	pthread_cond_t	notFull;
+	int				maxMsgs;
+	size_t			maxMsgLength;
+	size_t			slotSize;
+	int				head;
+	int				count;
+	PORT_EV_RSRC	evRsrc;
+	char *			pSlots;
+};
+
+#define MSG_SLOT(q, idx)	((q)->pSlots + (size_t)(idx) * (q)->slotSize)
+
+MSG_Q_ID msgQCreate(int maxMsgs, size_t maxMsgLength, int options) {
+	MSG_Q_ID msgQId;
+	
+	if (maxMsgs <= 0)
+		return MSG_Q_ID_NULL;
+	
+	if ((msgQId = calloc(1, sizeof(struct portMsgQ))) == NULL)
+		return MSG_Q_ID_NULL;
+	
+	msgQId->maxMsgs = maxMsgs;
+	msgQId->maxMsgLength = maxMsgLength;
+	msgQId->slotSize = (sizeof(size_t) + maxMsgLength + 7) & ~(size_t)7;
+	
+	if ((msgQId->pSlots = malloc(msgQId->slotSize * maxMsgs)) == NULL) {
+		free(msgQId);
+		return MSG_Q_ID_NULL;
+	}
+	
+	pthread_mutex_init(&msgQId->lock, NULL);
+	portCondInit(&msgQId->notEmpty);
+	portCondInit(&msgQId->notFull);
+	
+	return msgQId;
+}
+
+STATUS msgQDelete(MSG_Q_ID msgQId) {
+	if (msgQId == MSG_Q_ID_NULL)
+		return ERROR;
+	
+	pthread_cond_destroy(&msgQId->notEmpty);
+	pthread_cond_destroy(&msgQId->notFull);
+	pthread_mutex_destroy(&msgQId->lock);
+	free(msgQId->pSlots);
+	free(msgQId);
+	
+	return OK;
+}
+
+STATUS msgQSend(MSG_Q_ID msgQId, char *buffer, size_t nBytes,
+				_Vx_ticks_t timeout, int priority) {
+	struct timespec abs;
+	char *pSlot;
+	int idx;
+	
+	if ((msgQId == MSG_Q_ID_NULL) || (nBytes > msgQId->maxMsgLength)) {
+		errno = S_objLib_OBJ_ID_ERROR;
+		return ERROR;
+	}
+	
+	if (timeout > 0)
+		portTicksToAbs(timeout, &abs);
+	
+	pthread_mutex_lock(&msgQId->lock);
+	
+	while (msgQId->count == msgQId->maxMsgs) {
+		if ((timeout == NO_WAIT) ||
+			(portCondWait(&msgQId->notFull, &msgQId->lock, timeout, &abs) == ETIMEDOUT)) {
+			pthread_mutex_unlock(&msgQId->lock);
+			errno = (timeout == NO_WAIT) ? S_objLib_OBJ_UNAVAILABLE : S_objLib_OBJ_TIMEOUT;
+			return ERROR;
+		}
+	}
+	
+	if (priority == MSG_PRI_URGENT) {
+		msgQId->head = (msgQId->head + msgQId->maxMsgs - 1) % msgQId->maxMsgs;
+		idx = msgQId->head;
+	} else {
+		idx = (msgQId->head + msgQId->count) % msgQId->maxMsgs;
+	}
+	
+	pSlot = MSG_SLOT(msgQId, idx);
+	*(size_t *)pSlot = nBytes;
+	memcpy(pSlot + sizeof(size_t), buffer, nBytes);
+	msgQId->count++;
+	
+	pthread_cond_signal(&msgQId->notEmpty);
+	portEvRsrcSend(&msgQId->evRsrc);
+	
+	pthread_mutex_unlock(&msgQId->lock);
+	
+	return OK;
+}
+
+ssize_t msgQReceive(MSG_Q_ID msgQId, char *buffer, size_t maxNBytes,
+					_Vx_ticks_t timeout) {
+	struct timespec abs;
+	char *pSlot;
+	size_t nBytes;
+	
+	if (msgQId == MSG_Q_ID_NULL) {
+		errno = S_objLib_OBJ_ID_ERROR;
+		return ERROR;
+	}
+	
+	if (timeout > 0)
+		portTicksToAbs(timeout, &abs);
+	
+	pthread_mutex_lock(&msgQId->lock);
+	
+	while (msgQId->count == 0) {
+		if ((timeout == NO_WAIT) ||
+			(portCondWait(&msgQId->notEmpty, &msgQId->lock, timeout, &abs) == ETIMEDOUT)) {
+			pthread_mutex_unlock(&msgQId->lock);
+			errno = (timeout == NO_WAIT) ? S_objLib_OBJ_UNAVAILABLE : S_objLib_OBJ_TIMEOUT;
+			return ERROR;
+		}
+	}
+	
+	pSlot = MSG_SLOT(msgQId, msgQId->head);
+	nBytes = *(size_t *)pSlot;
+	if (nBytes > maxNBytes)
+		nBytes = maxNBytes;
+	memcpy(buffer, pSlot + sizeof(size_t), nBytes);
+	
+	msgQId->head = (msgQId->head + 1) % msgQId->maxMsgs;
+	msgQId->count--;
+	
+	pthread_cond_signal(&msgQId->notFull);
+	pthread_mutex_unlock(&msgQId->lock);
+	
+	return (ssize_t)nBytes;
+}
+
+int msgQNumMsgs(MSG_Q_ID msgQId) {
+	int count;
+	
+	if (msgQId == MSG_Q_ID_NULL)
+		return ERROR;
+	
+	pthread_mutex_lock(&msgQId->lock);
+	count = msgQId->count;
+	pthread_mutex_unlock(&msgQId->lock);
+	
+	return count;
+}
+
+STATUS msgQEvStart(MSG_Q_ID msgQId, _Vx_event_t events, UINT8 options) {
+	if (msgQId == MSG_Q_ID_NULL)
+		return ERROR;
+	
+	pthread_mutex_lock(&msgQId->lock);
+	msgQId->evRsrc.taskId = taskIdSelf();
+	msgQId->evRsrc.events = events;
+	msgQId->evRsrc.options = options;
+	if ((options & EVENTS_SEND_IF_FREE) && (msgQId->count > 0))
+		portEvRsrcSend(&msgQId->evRsrc);
+	pthread_mutex_unlock(&msgQId->lock);
+	
+	return OK;
+}
+
+STATUS msgQEvStop(MSG_Q_ID msgQId) {
+	if (msgQId == MSG_Q_ID_NULL)
+		return ERROR;
+	
+	pthread_mutex_lock(&msgQId->lock);
+	msgQId->evRsrc.taskId = TASK_ID_NULL;
+	pthread_mutex_unlock(&msgQId->lock);
+	
+	return OK;
+}
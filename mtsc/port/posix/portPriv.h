@@ -0,0 +1,35 @@
+#pragma once
+
+#include <pthread.h>
+#include <time.h>
+
+#include "vxWorks.h"
+#include "taskLib.h"
+
+#define PORT_MAX_TASKS		(128)
+#define PORT_TASK_NAME_LEN	(32)
+
+struct portTcb {
+	BOOL			inUse;
+	pthread_t		thread;
+	char			name[PORT_TASK_NAME_LEN];
+	FUNCPTR			entry;
+	_Vx_usr_arg_t	args[10];
+	pthread_mutex_t	evLock;
+	pthread_cond_t	evCond;
+	_Vx_event_t		events;
+};
+
+/* Event registration shared by message queues and semaphores. */
+typedef struct {
+	TASK_ID		taskId;
+	_Vx_event_t	events;
+	UINT8		options;
+} PORT_EV_RSRC;
+
+IMPORT void		portCondInit(pthread_cond_t *pCond);
+IMPORT void		portTicksToAbs(_Vx_ticks_t ticks, struct timespec *pAbs);
+IMPORT int		portCondWait(pthread_cond_t *pCond, pthread_mutex_t *pLock,
+							 _Vx_ticks_t timeout, const struct timespec *pAbs);
+IMPORT void		portEvRsrcSend(PORT_EV_RSRC *pEvRsrc);
+IMPORT UINT64	portClockNs(void);
@@ -0,0 +1,181 @@
+#include <stdlib.h>
+
+#include "portPriv.h"
+#include "semLib.h"
+#include "semEvLib.h"
+
+typedef enum {
+	PORT_SEM_BINARY,
+	PORT_SEM_COUNTING,
+	PORT_SEM_MUTEX
+} PORT_SEM_TYPE;
+
+struct portSem {
+	pthread_mutex_t	lock;
+	pthread_cond_t	cond;
+	PORT_SEM_TYPE	type;
+	int				count;
+	TASK_ID			owner;
+	int				recurse;
+	UINT32			flushGen;
+	PORT_EV_RSRC	evRsrc;
+};
+
+LOCAL SEM_ID semCreate(PORT_SEM_TYPE type, int count) {
+	SEM_ID semId;
+	
+	if ((semId = calloc(1, sizeof(struct portSem))) == NULL)
+		return SEM_ID_NULL;
+	
+	semId->type = type;
+	semId->count = count;
+	pthread_mutex_init(&semId->lock, NULL);
+	portCondInit(&semId->cond);
+	
+	return semId;
+}
+
+SEM_ID semBCreate(int options, SEM_B_STATE initialState) {
+	return semCreate(PORT_SEM_BINARY, (initialState == SEM_FULL) ? 1 : 0);
+}
+
+SEM_ID semCCreate(int options, int initialCount) {
+	return semCreate(PORT_SEM_COUNTING, initialCount);
+}
+
+SEM_ID semMCreate(int options) {
+	return semCreate(PORT_SEM_MUTEX, 1);
+}
+
+STATUS semDelete(SEM_ID semId) {
+	if (semId == SEM_ID_NULL)
+		return ERROR;
+	
+	pthread_cond_destroy(&semId->cond);
+	pthread_mutex_destroy(&semId->lock);
+	free(semId);
+	
+	return OK;
+}
+
+STATUS semTake(SEM_ID semId, _Vx_ticks_t timeout) {
+	TASK_ID self = taskIdSelf();
+	struct timespec abs;
+	UINT32 flushGen;
+	
+	if (semId == SEM_ID_NULL) {
+		errno = S_objLib_OBJ_ID_ERROR;
+		return ERROR;
+	}
+	
+	if (timeout > 0)
+		portTicksToAbs(timeout, &abs);
+	
+	pthread_mutex_lock(&semId->lock);
+	
+	if ((semId->type == PORT_SEM_MUTEX) && (semId->owner == self)) {
+		semId->recurse++;
+		pthread_mutex_unlock(&semId->lock);
+		return OK;
+	}
+	
+	flushGen = semId->flushGen;
+	while (semId->count == 0) {
+		if ((timeout == NO_WAIT) ||
+			(portCondWait(&semId->cond, &semId->lock, timeout, &abs) == ETIMEDOUT)) {
+			pthread_mutex_unlock(&semId->lock);
+			errno = (timeout == NO_WAIT) ? S_objLib_OBJ_UNAVAILABLE : S_objLib_OBJ_TIMEOUT;
+			return ERROR;
+		}
+		
+		/* semFlush() releases every waiter without taking the semaphore. */
+		if (semId->flushGen != flushGen) {
+			pthread_mutex_unlock(&semId->lock);
+			return OK;
+		}
+	}
+	
+	semId->count--;
+	if (semId->type == PORT_SEM_MUTEX)
+		semId->owner = self;
+	
+	pthread_mutex_unlock(&semId->lock);
+	
+	return OK;
+}
+
+STATUS semGive(SEM_ID semId) {
+	if (semId == SEM_ID_NULL) {
+		errno = S_objLib_OBJ_ID_ERROR;
+		return ERROR;
+	}
+	
+	pthread_mutex_lock(&semId->lock);
+	
+	switch (semId->type) {
+	case PORT_SEM_MUTEX:
+		if (semId->owner != taskIdSelf()) {
+			pthread_mutex_unlock(&semId->lock);
+			return ERROR;
+		}
+		if (semId->recurse > 0) {
+			semId->recurse--;
+			pthread_mutex_unlock(&semId->lock);
+			return OK;
+		}
+		semId->owner = TASK_ID_NULL;
+		semId->count = 1;
+		break;
+	case PORT_SEM_BINARY:
+		semId->count = 1;
+		break;
+	case PORT_SEM_COUNTING:
+		semId->count++;
+		break;
+	}
+	
+	pthread_cond_signal(&semId->cond);
+	portEvRsrcSend(&semId->evRsrc);
+	
+	pthread_mutex_unlock(&semId->lock);
+	
+	return OK;
+}
+
+STATUS semFlush(SEM_ID semId) {
+	if ((semId == SEM_ID_NULL) || (semId->type == PORT_SEM_MUTEX))
+		return ERROR;
+	
+	pthread_mutex_lock(&semId->lock);
+	semId->flushGen++;
+	pthread_cond_broadcast(&semId->cond);
+	pthread_mutex_unlock(&semId->lock);
+	
+	return OK;
+}
+
+STATUS semEvStart(SEM_ID semId, _Vx_event_t events, UINT8 options) {
+	if (semId == SEM_ID_NULL)
+		return ERROR;
+	
+	pthread_mutex_lock(&semId->lock);
+	semId->evRsrc.taskId = taskIdSelf();
+	semId->evRsrc.events = events;
+	semId->evRsrc.options = options;
+	if ((options & EVENTS_SEND_IF_FREE) && (semId->count > 0))
+		portEvRsrcSend(&semId->evRsrc);
+	pthread_mutex_unlock(&semId->lock);
+	
+	return OK;
+}
+
+STATUS semEvStop(SEM_ID semId) {
+	if (semId == SEM_ID_NULL)
+		return ERROR;
+	
+	pthread_mutex_lock(&semId->lock);
+	semId->evRsrc.taskId = TASK_ID_NULL;
+	pthread_mutex_unlock(&semId->lock);
+	
+	return OK;
+}
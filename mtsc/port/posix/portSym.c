@@ -0,0 +1,196 @@
+#include <stdlib.h>
+#include <dlfcn.h>
+
+#include "portPriv.h"
+#include "symLib.h"
+#include "sysSymTbl.h"
+
+/*
+ * Symbol tables are short linked lists; the system table is the process
+ * itself, so lookups on it fall through to dlsym(). Link the host build
+ * with -rdynamic for the command functions to be visible there.
+ */
+typedef struct portSym {
+	struct portSym *	pNext;
+	char *				name;
+	SYM_VALUE			value;
+	SYM_TYPE			type;
+	SYM_GROUP			group;
+} PORT_SYM;
+
+struct portSymTbl {
+	pthread_mutex_t		lock;
+	BOOL				sameNameOk;
+	PORT_SYM *			pHead;
+};
+
+SYMTAB_ID sysSymTbl = NULL;
+
+SYMTAB_ID symTblCreate(int hashSizeLog2, BOOL sameNameOk, PART_ID symPartId) {
+	SYMTAB_ID symTblId;
+	
+	if ((symTblId = calloc(1, sizeof(struct portSymTbl))) == NULL)
+		return NULL;
+	
+	pthread_mutex_init(&symTblId->lock, NULL);
+	symTblId->sameNameOk = sameNameOk;
+	
+	return symTblId;
+}
+
+STATUS symTblDelete(SYMTAB_ID symTblId) {
+	PORT_SYM *pSym, *pNext;
+	
+	if (symTblId == NULL)
+		return ERROR;
+	
+	for (pSym = symTblId->pHead; pSym != NULL; pSym = pNext) {
+		pNext = pSym->pNext;
+		free(pSym->name);
+		free(pSym);
+	}
+	
+	pthread_mutex_destroy(&symTblId->lock);
+	free(symTblId);
+	
+	return OK;
+}
+
+LOCAL PORT_SYM *findByName(SYMTAB_ID symTblId, const char *name) {
+	PORT_SYM *pSym;
+	
+	for (pSym = symTblId->pHead; pSym != NULL; pSym = pSym->pNext) {
+		if (strcmp(pSym->name, name) == 0)
+			return pSym;
+	}
+	
+	return NULL;
+}
+
+STATUS symAdd(SYMTAB_ID symTblId, char *name, SYM_VALUE value,
+			  SYM_TYPE type, SYM_GROUP group) {
+	PORT_SYM *pSym;
+	
+	if ((symTblId == NULL) || (name == NULL))
+		return ERROR;
+	
+	pthread_mutex_lock(&symTblId->lock);
+	
+	if (!symTblId->sameNameOk && (findByName(symTblId, name) != NULL)) {
+		pthread_mutex_unlock(&symTblId->lock);
+		return ERROR;
+	}
+	
+	if (((pSym = calloc(1, sizeof(PORT_SYM))) == NULL) ||
+		((pSym->name = strdup(name)) == NULL)) {
+		free(pSym);
+		pthread_mutex_unlock(&symTblId->lock);
+		return ERROR;
+	}
+	
+	pSym->value = value;
+	pSym->type = type;
+	pSym->group = group;
+	pSym->pNext = symTblId->pHead;
+	symTblId->pHead = pSym;
+	
+	pthread_mutex_unlock(&symTblId->lock);
+	
+	return OK;
+}
+
+STATUS symRemove(SYMTAB_ID symTblId, char *name, SYM_TYPE type) {
+	PORT_SYM **ppSym, *pSym;
+	
+	if ((symTblId == NULL) || (name == NULL))
+		return ERROR;
+	
+	pthread_mutex_lock(&symTblId->lock);
+	
+	for (ppSym = &symTblId->pHead; (pSym = *ppSym) != NULL; ppSym = &pSym->pNext) {
+		if ((strcmp(pSym->name, name) == 0) && (pSym->type == type)) {
+			*ppSym = pSym->pNext;
+			free(pSym->name);
+			free(pSym);
+			pthread_mutex_unlock(&symTblId->lock);
+			return OK;
+		}
+	}
+	
+	pthread_mutex_unlock(&symTblId->lock);
+	
+	return ERROR;
+}
+
+LOCAL STATUS findSystem(SYMBOL_DESC *pSymbol) {
+	Dl_info info;
+	void *pAddr;
+	
+	if (pSymbol->mask & SYM_FIND_BY_VALUE) {
+		if ((dladdr(pSymbol->value, &info) == 0) || (info.dli_sname == NULL))
+			return ERROR;
+		
+		pSymbol->name = (char *)info.dli_sname;
+		pSymbol->value = info.dli_saddr;
+	} else {
+		if ((pAddr = dlsym(RTLD_DEFAULT, pSymbol->name)) == NULL)
+			return ERROR;
+		
+		pSymbol->value = pAddr;
+	}
+	
+	/* dlsym() cannot tell code from data; the callers only look up functions. */
+	pSymbol->type = SYM_GLOBAL | SYM_TEXT;
+	pSymbol->group = 0;
+	
+	return OK;
+}
+
+STATUS symFind(SYMTAB_ID symTblId, SYMBOL_DESC *pSymbol) {
+	PORT_SYM *pSym;
+	
+	if (pSymbol == NULL)
+		return ERROR;
+	
+	if (symTblId == NULL) {
+		if (findSystem(pSymbol) == ERROR) {
+			errno = S_symLib_SYMBOL_NOT_FOUND;
+			return ERROR;
+		}
+		return OK;
+	}
+	
+	pthread_mutex_lock(&symTblId->lock);
+	
+	for (pSym = symTblId->pHead; pSym != NULL; pSym = pSym->pNext) {
+		if ((pSymbol->mask & SYM_FIND_BY_VALUE) ?
+			(pSym->value == pSymbol->value) :
+			(strcmp(pSym->name, pSymbol->name) == 0))
+			break;
+	}
+	
+	if (pSym != NULL) {
+		pSymbol->name = pSym->name;
+		pSymbol->value = pSym->value;
+		pSymbol->type = pSym->type;
+		pSymbol->group = pSym->group;
+	}
+	
+	pthread_mutex_unlock(&symTblId->lock);
+	
+	if (pSym == NULL) {
+		errno = S_symLib_SYMBOL_NOT_FOUND;
+		return ERROR;
+	}
+	
+	return OK;
+}
+
+/* Partitions only back symbol tables here, which allocate from the heap. */
+PART_ID memPartCreate(char *pPool, size_t poolSize) {
+	return (pPool != NULL) ? pPool : NULL;
+}
+
+STATUS memPartDelete(PART_ID partId) {
+	return (partId != NULL) ? OK : ERROR;
+}
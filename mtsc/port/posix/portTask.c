@@ -0,0 +1,302 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <sched.h>
+
+#include "portPriv.h"
+#include "taskLib.h"
+#include "tickLib.h"
+#include "sysLib.h"
+#include "eventLib.h"
+
+LOCAL struct portTcb	g_portTcbs[PORT_MAX_TASKS];
+LOCAL pthread_mutex_t	g_portTcbLock = PTHREAD_MUTEX_INITIALIZER;
+LOCAL __thread TASK_ID	t_portSelf = TASK_ID_NULL;
+LOCAL int				g_portClkRate = PORT_SYS_CLK_RATE;
+LOCAL UINT64			g_portClkBase;
+
+LOCAL TASK_ID allocTcb(const char *name) {
+	TASK_ID tid = TASK_ID_NULL;
+	int i;
+	
+	pthread_mutex_lock(&g_portTcbLock);
+	for (i = 0; i < PORT_MAX_TASKS; i++) {
+		if (!g_portTcbs[i].inUse) {
+			tid = &g_portTcbs[i];
+			memset(tid, 0, sizeof(*tid));
+			tid->inUse = TRUE;
+			snprintf(tid->name, sizeof(tid->name), "%s", (name) ? name : "tTask");
+			pthread_mutex_init(&tid->evLock, NULL);
+			portCondInit(&tid->evCond);
+			break;
+		}
+	}
+	pthread_mutex_unlock(&g_portTcbLock);
+	
+	return tid;
+}
+
+LOCAL void freeTcb(void *arg) {
+	TASK_ID tid = (TASK_ID)arg;
+	
+	pthread_mutex_lock(&g_portTcbLock);
+	pthread_cond_destroy(&tid->evCond);
+	pthread_mutex_destroy(&tid->evLock);
+	tid->inUse = FALSE;
+	pthread_mutex_unlock(&g_portTcbLock);
+}
+
+LOCAL void *taskEntry(void *arg) {
+	TASK_ID tid = (TASK_ID)arg;
+	_Vx_usr_arg_t *a = tid->args;
+	
+	t_portSelf = tid;
+	
+	pthread_cleanup_push(freeTcb, tid);
+	tid->entry(a[0], a[1], a[2], a[3], a[4], a[5], a[6], a[7], a[8], a[9]);
+	pthread_cleanup_pop(1);
+	
+	return NULL;
+}
+
+void portCondInit(pthread_cond_t *pCond) {
+	pthread_condattr_t attr;
+	
+	pthread_condattr_init(&attr);
+	pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+	pthread_cond_init(pCond, &attr);
+	pthread_condattr_destroy(&attr);
+}
+
+UINT64 portClockNs(void) {
+	struct timespec ts;
+	
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	
+	return ((UINT64)ts.tv_sec * 1000000000ULL) + (UINT64)ts.tv_nsec;
+}
+
+void portTicksToAbs(_Vx_ticks_t ticks, struct timespec *pAbs) {
+	UINT64 ns = portClockNs() + ((UINT64)ticks * 1000000000ULL) / g_portClkRate;
+	
+	pAbs->tv_sec = ns / 1000000000ULL;
+	pAbs->tv_nsec = ns % 1000000000ULL;
+}
+
+/*
+ * Waits on pCond with pLock held. NO_WAIT callers never get here; for a
+ * finite timeout pAbs is the deadline computed once by the caller.
+ */
+LOCAL void unlockOnCancel(void *arg) {
+	pthread_mutex_unlock((pthread_mutex_t *)arg);
+}
+
+int portCondWait(pthread_cond_t *pCond, pthread_mutex_t *pLock,
+				 _Vx_ticks_t timeout, const struct timespec *pAbs) {
+	int nRet;
+	
+	/* A waiter removed by taskDelete() must not keep the object locked. */
+	pthread_cleanup_push(unlockOnCancel, pLock);
+	if (timeout == WAIT_FOREVER)
+		nRet = pthread_cond_wait(pCond, pLock);
+	else
+		nRet = pthread_cond_timedwait(pCond, pLock, pAbs);
+	pthread_cleanup_pop(0);
+	
+	return nRet;
+}
+
+TASK_ID taskSpawn(char *name, int priority, int options, size_t stackSize,
+				  FUNCPTR entryPt, _Vx_usr_arg_t arg1, _Vx_usr_arg_t arg2,
+				  _Vx_usr_arg_t arg3, _Vx_usr_arg_t arg4, _Vx_usr_arg_t arg5,
+				  _Vx_usr_arg_t arg6, _Vx_usr_arg_t arg7, _Vx_usr_arg_t arg8,
+				  _Vx_usr_arg_t arg9, _Vx_usr_arg_t arg10) {
+	pthread_attr_t attr;
+	TASK_ID tid;
+	
+	if ((tid = allocTcb(name)) == TASK_ID_NULL) {
+		errno = ENOMEM;
+		return TASK_ID_ERROR;
+	}
+	
+	tid->entry = entryPt;
+	tid->args[0] = arg1; tid->args[1] = arg2; tid->args[2] = arg3;
+	tid->args[3] = arg4; tid->args[4] = arg5; tid->args[5] = arg6;
+	tid->args[6] = arg7; tid->args[7] = arg8; tid->args[8] = arg9;
+	tid->args[9] = arg10;
+	
+	/* Priorities are not mapped: SCHED_FIFO needs privileges on the host. */
+	pthread_attr_init(&attr);
+	pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+	if (stackSize < (size_t)PTHREAD_STACK_MIN)
+		stackSize = PTHREAD_STACK_MIN;
+	pthread_attr_setstacksize(&attr, stackSize);
+	
+	if (pthread_create(&tid->thread, &attr, taskEntry, tid) != 0) {
+		pthread_attr_destroy(&attr);
+		freeTcb(tid);
+		return TASK_ID_ERROR;
+	}
+	pthread_setname_np(tid->thread, tid->name);
+	pthread_attr_destroy(&attr);
+	
+	return tid;
+}
+
+STATUS taskDelete(TASK_ID tid) {
+	if ((tid == TASK_ID_NULL) || (tid == taskIdSelf()))
+		pthread_exit(NULL);
+	
+	if (taskIdVerify(tid) == ERROR)
+		return ERROR;
+	
+	/* Deferred cancellation: the task ends at its next blocking call. */
+	return (pthread_cancel(tid->thread) == 0) ? OK : ERROR;
+}
+
+/* Threads not created by taskSpawn() (e.g. main) get a TCB on first use. */
+TASK_ID taskIdSelf(void) {
+	char name[PORT_TASK_NAME_LEN];
+	
+	if (t_portSelf == TASK_ID_NULL) {
+		snprintf(name, sizeof(name), "tHost%lu", (ULONG)pthread_self());
+		t_portSelf = allocTcb(name);
+		if (t_portSelf != TASK_ID_NULL)
+			t_portSelf->thread = pthread_self();
+	}
+	
+	return t_portSelf;
+}
+
+STATUS taskIdVerify(TASK_ID tid) {
+	if ((tid < &g_portTcbs[0]) || (tid >= &g_portTcbs[PORT_MAX_TASKS]))
+		return ERROR;
+	
+	return (tid->inUse) ? OK : ERROR;
+}
+
+char *taskName(TASK_ID tid) {
+	if (tid == TASK_ID_NULL)
+		tid = taskIdSelf();
+	
+	return (taskIdVerify(tid) == OK) ? tid->name : NULL;
+}
+
+STATUS taskDelay(_Vx_ticks_t ticks) {
+	struct timespec ts;
+	
+	if (ticks <= 0) {
+		sched_yield();
+		return OK;
+	}
+	
+	portTicksToAbs(ticks, &ts);
+	while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR)
+		;
+	
+	return OK;
+}
+
+int sysClkRateGet(void) {
+	return g_portClkRate;
+}
+
+STATUS sysClkRateSet(int ticksPerSecond) {
+	if (ticksPerSecond <= 0)
+		return ERROR;
+	
+	g_portClkRate = ticksPerSecond;
+	
+	return OK;
+}
+
+UINT64 tick64Get(void) {
+	UINT64 ns = portClockNs();
+	
+	if (g_portClkBase == 0)
+		g_portClkBase = ns;
+	
+	return ((ns - g_portClkBase) * g_portClkRate) / 1000000000ULL;
+}
+
+ULONG tickGet(void) {
+	return (ULONG)tick64Get();
+}
+
+STATUS eventSend(TASK_ID taskId, _Vx_event_t events) {
+	if (taskIdVerify(taskId) == ERROR)
+		return ERROR;
+	
+	pthread_mutex_lock(&taskId->evLock);
+	taskId->events |= events;
+	pthread_cond_broadcast(&taskId->evCond);
+	pthread_mutex_unlock(&taskId->evLock);
+	
+	return OK;
+}
+
+STATUS eventReceive(_Vx_event_t events, UINT8 options,
+					_Vx_ticks_t timeout, _Vx_event_t *pEventsReceived) {
+	TASK_ID self = taskIdSelf();
+	struct timespec abs;
+	_Vx_event_t got;
+	STATUS nRet = OK;
+	
+	pthread_mutex_lock(&self->evLock);
+	
+	if (options & EVENTS_FETCH) {
+		if (pEventsReceived)
+			*pEventsReceived = self->events;
+		pthread_mutex_unlock(&self->evLock);
+		return OK;
+	}
+	
+	if (timeout > 0)
+		portTicksToAbs(timeout, &abs);
+	
+	FOREVER {
+		got = self->events & events;
+		if ((options & EVENTS_WAIT_ANY) ? (got != 0) : (got == events))
+			break;
+		
+		if ((timeout == NO_WAIT) ||
+			(portCondWait(&self->evCond, &self->evLock, timeout, &abs) == ETIMEDOUT)) {
+			errno = (timeout == NO_WAIT) ? S_objLib_OBJ_UNAVAILABLE : S_objLib_OBJ_TIMEOUT;
+			nRet = ERROR;
+			break;
+		}
+	}
+	
+	if (pEventsReceived)
+		*pEventsReceived = (options & EVENTS_RETURN_ALL) ? self->events : got;
+	
+	if (options & EVENTS_RETURN_ALL)
+		self->events = 0;
+	else if (options & EVENTS_KEEP_UNWANTED)
+		self->events &= ~got;
+	else
+		self->events = 0;
+	
+	pthread_mutex_unlock(&self->evLock);
+	
+	return nRet;
+}
+
+STATUS eventClear(void) {
+	TASK_ID self = taskIdSelf();
+	
+	pthread_mutex_lock(&self->evLock);
+	self->events = 0;
+	pthread_mutex_unlock(&self->evLock);
+	
+	return OK;
+}
+
+void portEvRsrcSend(PORT_EV_RSRC *pEvRsrc) {
+	if (pEvRsrc->taskId == TASK_ID_NULL)
+		return;
+	
+	eventSend(pEvRsrc->taskId, pEvRsrc->events);
+	
+	if (pEvRsrc->options & EVENTS_SEND_ONCE)
+		pEvRsrc->taskId = TASK_ID_NULL;
+}
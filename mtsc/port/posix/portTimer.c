@@ -0,0 +1,196 @@
+#include <stdlib.h>
+
+#include "portPriv.h"
+#include "timers.h"
+
+/*
+ * Each timer owns a thread that sleeps on a condition variable until the
+ * armed deadline; the connected routine runs on that thread, so it may
+ * re-arm the timer exactly as it would from a VxWorks timer ISR.
+ */
+struct portTimer {
+	pthread_t			thread;
+	pthread_mutex_t		lock;
+	pthread_cond_t		cond;
+	BOOL				armed;
+	BOOL				quit;
+	UINT64				expiryNs;
+	UINT64				intervalNs;
+	PORT_TIMER_HANDLER	routine;
+	_Vx_usr_arg_t		arg;
+};
+
+LOCAL UINT64 tsToNs(const struct timespec *pTs) {
+	return (UINT64)pTs->tv_sec * 1000000000ULL + (UINT64)pTs->tv_nsec;
+}
+
+LOCAL void nsToTs(UINT64 ns, struct timespec *pTs) {
+	pTs->tv_sec = ns / 1000000000ULL;
+	pTs->tv_nsec = ns % 1000000000ULL;
+}
+
+LOCAL void *timerThread(void *arg) {
+	struct portTimer *pTimer = (struct portTimer *)arg;
+	PORT_TIMER_HANDLER routine;
+	_Vx_usr_arg_t routineArg;
+	struct timespec abs;
+	
+	pthread_mutex_lock(&pTimer->lock);
+	
+	while (!pTimer->quit) {
+		if (!pTimer->armed) {
+			pthread_cond_wait(&pTimer->cond, &pTimer->lock);
+			continue;
+		}
+		
+		if (portClockNs() < pTimer->expiryNs) {
+			nsToTs(pTimer->expiryNs, &abs);
+			pthread_cond_timedwait(&pTimer->cond, &pTimer->lock, &abs);
+			continue;
+		}
+		
+		if (pTimer->intervalNs != 0)
+			pTimer->expiryNs += pTimer->intervalNs;
+		else
+			pTimer->armed = FALSE;
+		
+		routine = pTimer->routine;
+		routineArg = pTimer->arg;
+		
+		pthread_mutex_unlock(&pTimer->lock);
+		if (routine != NULL)
+			routine((timer_t)pTimer, routineArg);
+		pthread_mutex_lock(&pTimer->lock);
+	}
+	
+	pthread_mutex_unlock(&pTimer->lock);
+	
+	return NULL;
+}
+
+int portTimerCreate(clockid_t clockId, struct sigevent *pEvp, timer_t *pTimerId) {
+	struct portTimer *pTimer;
+	
+	if (pTimerId == NULL)
+		return ERROR;
+	
+	if ((pTimer = calloc(1, sizeof(struct portTimer))) == NULL)
+		return ERROR;
+	
+	pthread_mutex_init(&pTimer->lock, NULL);
+	portCondInit(&pTimer->cond);
+	
+	if (pthread_create(&pTimer->thread, NULL, timerThread, pTimer) != 0) {
+		pthread_cond_destroy(&pTimer->cond);
+		pthread_mutex_destroy(&pTimer->lock);
+		free(pTimer);
+		return ERROR;
+	}
+	pthread_setname_np(pTimer->thread, "tPortTimer");
+	
+	*pTimerId = (timer_t)pTimer;
+	
+	return OK;
+}
+
+int portTimerDelete(timer_t timerId) {
+	struct portTimer *pTimer = (struct portTimer *)timerId;
+	
+	if (pTimer == NULL)
+		return ERROR;
+	
+	pthread_mutex_lock(&pTimer->lock);
+	pTimer->quit = TRUE;
+	pthread_cond_signal(&pTimer->cond);
+	pthread_mutex_unlock(&pTimer->lock);
+	
+	/* The routine may delete its own timer; it cannot join itself. */
+	if (pthread_equal(pTimer->thread, pthread_self()))
+		pthread_detach(pTimer->thread);
+	else
+		pthread_join(pTimer->thread, NULL);
+	
+	pthread_cond_destroy(&pTimer->cond);
+	pthread_mutex_destroy(&pTimer->lock);
+	free(pTimer);
+	
+	return OK;
+}
+
+int portTimerSettime(timer_t timerId, int flags,
+					 const struct itimerspec *pValue, struct itimerspec *pOvalue) {
+	struct portTimer *pTimer = (struct portTimer *)timerId;
+	UINT64 valueNs;
+	
+	if ((pTimer == NULL) || (pValue == NULL))
+		return ERROR;
+	
+	if (pOvalue != NULL)
+		portTimerGettime(timerId, pOvalue);
+	
+	valueNs = tsToNs(&pValue->it_value);
+	
+	pthread_mutex_lock(&pTimer->lock);
+	
+	pTimer->intervalNs = tsToNs(&pValue->it_interval);
+	pTimer->armed = (valueNs != 0);
+	if (flags == TIMER_ABSTIME)
+		pTimer->expiryNs = valueNs;
+	else
+		pTimer->expiryNs = portClockNs() + valueNs;
+	
+	pthread_cond_signal(&pTimer->cond);
+	pthread_mutex_unlock(&pTimer->lock);
+	
+	return OK;
+}
+
+int portTimerGettime(timer_t timerId, struct itimerspec *pValue) {
+	struct portTimer *pTimer = (struct portTimer *)timerId;
+	UINT64 nowNs;
+	
+	if ((pTimer == NULL) || (pValue == NULL))
+		return ERROR;
+	
+	memset(pValue, 0, sizeof(struct itimerspec));
+	
+	pthread_mutex_lock(&pTimer->lock);
+	if (pTimer->armed) {
+		nowNs = portClockNs();
+		nsToTs((pTimer->expiryNs > nowNs) ? (pTimer->expiryNs - nowNs) : 0,
+			   &pValue->it_value);
+		nsToTs(pTimer->intervalNs, &pValue->it_interval);
+	}
+	pthread_mutex_unlock(&pTimer->lock);
+	
+	return OK;
+}
+
+int portTimerCancel(timer_t timerId) {
+	struct portTimer *pTimer = (struct portTimer *)timerId;
+	
+	if (pTimer == NULL)
+		return ERROR;
+	
+	pthread_mutex_lock(&pTimer->lock);
+	pTimer->armed = FALSE;
+	pthread_cond_signal(&pTimer->cond);
+	pthread_mutex_unlock(&pTimer->lock);
+	
+	return OK;
+}
+
+int portTimerConnect(timer_t timerId, PORT_TIMER_HANDLER routine,
+					 _Vx_usr_arg_t arg) {
+	struct portTimer *pTimer = (struct portTimer *)timerId;
+	
+	if (pTimer == NULL)
+		return ERROR;
+	
+	pthread_mutex_lock(&pTimer->lock);
+	pTimer->routine = routine;
+	pTimer->arg = arg;
+	pthread_mutex_unlock(&pTimer->lock);
+	
+	return OK;
+}
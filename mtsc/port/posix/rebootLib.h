@@ -0,0 +1,10 @@
+#pragma once
+
+#include "vxWorks.h"
+
+#define BOOT_NORMAL				(0x00)
+#define BOOT_NO_AUTOBOOT		(0x01)
+#define BOOT_CLEAR				(0x02)
+#define BOOT_QUICK_AUTOBOOT		(0x04)
+
+IMPORT STATUS	reboot(int startType);
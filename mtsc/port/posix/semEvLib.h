@@ -0,0 +1,7 @@
+#pragma once
+
+#include "eventLib.h"
+#include "semLib.h"
+
+IMPORT STATUS	semEvStart(SEM_ID semId, _Vx_event_t events, UINT8 options);
+IMPORT STATUS	semEvStop(SEM_ID semId);
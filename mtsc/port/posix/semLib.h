@@ -0,0 +1,21 @@
+#pragma once
+
+#include "vxWorks.h"
+
+#define SEM_Q_FIFO				(0x00)
+#define SEM_Q_PRIORITY			(0x01)
+#define SEM_DELETE_SAFE			(0x04)
+#define SEM_INVERSION_SAFE		(0x08)
+
+typedef enum {
+	SEM_EMPTY,
+	SEM_FULL
+} SEM_B_STATE;
+
+IMPORT SEM_ID	semBCreate(int options, SEM_B_STATE initialState);
+IMPORT SEM_ID	semCCreate(int options, int initialCount);
+IMPORT SEM_ID	semMCreate(int options);
+IMPORT STATUS	semDelete(SEM_ID semId);
+IMPORT STATUS	semTake(SEM_ID semId, _Vx_ticks_t timeout);
+IMPORT STATUS	semGive(SEM_ID semId);
+IMPORT STATUS	semFlush(SEM_ID semId);
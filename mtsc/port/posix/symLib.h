@@ -0,0 +1,37 @@
+#pragma once
+
+#include "vxWorks.h"
+
+#define SYM_GLOBAL			(0x01)
+#define SYM_ABS				(0x02)
+#define SYM_TEXT			(0x04)
+#define SYM_DATA			(0x08)
+#define SYM_IS_TEXT(type)	((type) & SYM_TEXT)
+
+#define S_symLib_SYMBOL_NOT_FOUND	(0x1c0001)
+
+#define SYM_FIND_BY_NAME	(0x01)
+#define SYM_FIND_BY_VALUE	(0x02)
+
+typedef struct portSymTbl *	SYMTAB_ID;
+typedef void *				SYM_VALUE;
+typedef UINT8				SYM_TYPE;
+typedef UINT16				SYM_GROUP;
+
+typedef struct {
+	UINT32		mask;
+	char *		name;
+	SYM_VALUE	value;
+	SYM_TYPE	type;
+	SYM_GROUP	group;
+} SYMBOL_DESC;
+
+IMPORT SYMTAB_ID	symTblCreate(int hashSizeLog2, BOOL sameNameOk, PART_ID symPartId);
+IMPORT STATUS		symTblDelete(SYMTAB_ID symTblId);
+IMPORT STATUS		symAdd(SYMTAB_ID symTblId, char *name, SYM_VALUE value,
+						   SYM_TYPE type, SYM_GROUP group);
+IMPORT STATUS		symRemove(SYMTAB_ID symTblId, char *name, SYM_TYPE type);
+IMPORT STATUS		symFind(SYMTAB_ID symTblId, SYMBOL_DESC *pSymbol);
+
+IMPORT PART_ID		memPartCreate(char *pPool, size_t poolSize);
+IMPORT STATUS		memPartDelete(PART_ID partId);
@@ -0,0 +1,8 @@
+#pragma once
+
+#include "vxWorks.h"
+
+#define PORT_SYS_CLK_RATE	(1000)
+
+IMPORT int		sysClkRateGet(void);
+IMPORT STATUS	sysClkRateSet(int ticksPerSecond);
@@ -0,0 +1,6 @@
+#pragma once
+
+#include "symLib.h"
+
+/* NULL on the host: symFind() then resolves names with dlsym(). */
+IMPORT SYMTAB_ID	sysSymTbl;
@@ -0,0 +1,16 @@
+#pragma once
+
+#include "vxWorks.h"
+
+#define VX_FP_TASK		(0x0008)
+
+IMPORT TASK_ID	taskSpawn(char *name, int priority, int options, size_t stackSize,
+						  FUNCPTR entryPt, _Vx_usr_arg_t arg1, _Vx_usr_arg_t arg2,
+						  _Vx_usr_arg_t arg3, _Vx_usr_arg_t arg4, _Vx_usr_arg_t arg5,
+						  _Vx_usr_arg_t arg6, _Vx_usr_arg_t arg7, _Vx_usr_arg_t arg8,
+						  _Vx_usr_arg_t arg9, _Vx_usr_arg_t arg10);
+IMPORT STATUS	taskDelete(TASK_ID tid);
+IMPORT TASK_ID	taskIdSelf(void);
+IMPORT STATUS	taskIdVerify(TASK_ID tid);
+IMPORT char *	taskName(TASK_ID tid);
+IMPORT STATUS	taskDelay(_Vx_ticks_t ticks);
@@ -0,0 +1,6 @@
+#pragma once
+
+#include "vxWorks.h"
+
+IMPORT ULONG	tickGet(void);
+IMPORT UINT64	tick64Get(void);
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <time.h>
+#include <signal.h>
+
+#include "vxWorks.h"
+
+/*
+ * VxWorks timers are connected to a handler instead of raising a signal.
+ * The port runs each timer on its own thread and renames the calls so
+ * they do not clash with the C library.
+ */
+#define TIMER_RELTIME		(0)
+
+#define timer_create		portTimerCreate
+#define timer_delete		portTimerDelete
+#define timer_settime		portTimerSettime
+#define timer_gettime		portTimerGettime
+#define timer_cancel		portTimerCancel
+#define timer_connect		portTimerConnect
+
+typedef void (*PORT_TIMER_HANDLER)(timer_t timerId, _Vx_usr_arg_t arg);
+
+IMPORT int	portTimerCreate(clockid_t clockId, struct sigevent *pEvp, timer_t *pTimerId);
+IMPORT int	portTimerDelete(timer_t timerId);
+IMPORT int	portTimerSettime(timer_t timerId, int flags,
+							 const struct itimerspec *pValue, struct itimerspec *pOvalue);
+IMPORT int	portTimerGettime(timer_t timerId, struct itimerspec *pValue);
+IMPORT int	portTimerCancel(timer_t timerId);
+IMPORT int	portTimerConnect(timer_t timerId, PORT_TIMER_HANDLER routine,
+							 _Vx_usr_arg_t arg);
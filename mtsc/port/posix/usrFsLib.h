@@ -0,0 +1,5 @@
+#pragma once
+
+#include "vxWorks.h"
+
+IMPORT STATUS	cp(const char *src, const char *dest);
@@ -0,0 +1,5 @@
+#pragma once
+
+#include "vxWorks.h"
+
+IMPORT void		printErrno(int errNo);
@@ -0,0 +1,19 @@
+#pragma once
+
+#include "vxWorks.h"
+
+/* The 32-bit vxAtomicLib calls, on the GCC builtins; all are full barriers. */
+typedef int						atomic32Val_t;
+typedef volatile atomic32Val_t	atomic32_t;
+
+#define vxAtomic32Get(target)		__atomic_load_n((target), __ATOMIC_SEQ_CST)
+#define vxAtomic32Set(target, val)	__atomic_exchange_n((target), (val), __ATOMIC_SEQ_CST)
+#define vxAtomic32Add(target, val)	__atomic_fetch_add((target), (val), __ATOMIC_SEQ_CST)
+#define vxAtomic32Inc(target)		__atomic_fetch_add((target), 1, __ATOMIC_SEQ_CST)
+#define vxAtomic32Dec(target)		__atomic_fetch_sub((target), 1, __ATOMIC_SEQ_CST)
+
+static inline BOOL vxAtomic32Cas(atomic32_t *target, atomic32Val_t oldValue,
+								 atomic32Val_t newValue) {
+	return __atomic_compare_exchange_n(target, &oldValue, newValue, FALSE,
+									   __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST) ? TRUE : FALSE;
+}
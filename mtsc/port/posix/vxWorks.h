@@ -0,0 +1,70 @@
+#pragma once
+
+/*
+ * VxWorks compatibility layer for the host (Linux) build of mtsc.
+ * Put this directory first on the include path, e.g.
+ *   gcc -D_GNU_SOURCE -I port/posix ... -rdynamic -lpthread -ldl
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <sys/types.h>
+
+#define OK				(0)
+#define ERROR			(-1)
+#define TRUE			(1)
+#define FALSE			(0)
+
+#define LOCAL			static
+#define IMPORT			extern
+#define FOREVER			for (;;)
+#define NELEMENTS(array)	(sizeof(array) / sizeof((array)[0]))
+
+#define WAIT_FOREVER	(-1)
+#define NO_WAIT			(0)
+
+typedef int				STATUS;
+typedef int				BOOL;
+
+typedef int8_t			INT8;
+typedef int16_t			INT16;
+typedef int32_t			INT32;
+typedef int64_t			INT64;
+typedef uint8_t			UINT8;
+typedef uint16_t		UINT16;
+typedef uint32_t		UINT32;
+typedef uint64_t		UINT64;
+typedef unsigned char	UCHAR;
+typedef unsigned short	USHORT;
+typedef unsigned int	UINT;
+typedef unsigned long	ULONG;
+
+typedef intptr_t		_Vx_usr_arg_t;
+typedef int				_Vx_ticks_t;
+typedef UINT32			_Vx_event_t;
+
+typedef int		(*FUNCPTR)();
+typedef void	(*VOIDFUNCPTR)();
+typedef double	(*DBLFUNCPTR)();
+
+typedef struct portTcb *	TASK_ID;
+typedef struct portMsgQ *	MSG_Q_ID;
+typedef struct portSem *	SEM_ID;
+typedef char *				PART_ID;
+
+#define TASK_ID_NULL	((TASK_ID)0)
+#define TASK_ID_ERROR	((TASK_ID)-1)
+#define MSG_Q_ID_NULL	((MSG_Q_ID)0)
+#define SEM_ID_NULL		((SEM_ID)0)
+
+/* Host builds run on SMP Linux; a full fence covers every barrier flavour. */
+#define VX_MEM_BARRIER_R()	__atomic_thread_fence(__ATOMIC_SEQ_CST)
+#define VX_MEM_BARRIER_W()	__atomic_thread_fence(__ATOMIC_SEQ_CST)
+#define VX_MEM_BARRIER_RW()	__atomic_thread_fence(__ATOMIC_SEQ_CST)
+
+#define S_objLib_OBJ_ID_ERROR		(0x3d0001)
+#define S_objLib_OBJ_UNAVAILABLE	(0x3d0002)
+#define S_objLib_OBJ_TIMEOUT		(0x3d0004)
+#define S_objLib_OBJ_DELETED		(0x3d0003)
@@ -0,0 +1,81 @@
+#include <vxWorks.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "../drv/axiAdc.h"
+
+/*
+ * In-process stand-in for the two AXI ADC cores. Channel values are plain
+ * variables that a test sets through axiAdcSimSet().
+ */
+#define AXI_ADC_SIM_DEV_NUM		(2)
+#define AXI_ADC_SIM_CH_NUM		(10)
+
+LOCAL double g_dAxiAdcSimData[AXI_ADC_SIM_DEV_NUM][AXI_ADC_SIM_CH_NUM];
+LOCAL UINT32 g_dwAxiAdcSimDacCtrl;
+
+STATUS axiAdcSimSet(UINT32 dwDevNo, UINT32 dwCh, double dVal) {
+	if ((dwDevNo >= AXI_ADC_SIM_DEV_NUM) || (dwCh >= AXI_ADC_SIM_CH_NUM))
+		return ERROR;
+	
+	g_dAxiAdcSimData[dwDevNo][dwCh] = dVal;
+	
+	return OK;
+}
+
+STATUS axiAdcInit(void) {
+	memset(g_dAxiAdcSimData, 0, sizeof(g_dAxiAdcSimData));
+	g_dwAxiAdcSimDacCtrl = 0;
+	
+	return OK;
+}
+
+STATUS axiAdcShowRegs(UINT32 dwDevNo) {
+	UINT32 i;
+	
+	if (dwDevNo >= AXI_ADC_SIM_DEV_NUM)
+		return ERROR;
+	
+	for (i = 0; i < AXI_ADC_SIM_CH_NUM; i++)
+		printf(" ADC%u DATA%u : %f\n", dwDevNo, i, g_dAxiAdcSimData[dwDevNo][i]);
+	
+	return OK;
+}
+
+STATUS axiAdcShowRegsRaw(UINT32 dwDevNo) {
+	return axiAdcShowRegs(dwDevNo);
+}
+
+double axiAdc0Data0(void) { return g_dAxiAdcSimData[0][0]; }
+double axiAdc0Data1(void) { return g_dAxiAdcSimData[0][1]; }
+double axiAdc0Data2(void) { return g_dAxiAdcSimData[0][2]; }
+double axiAdc0Data3(void) { return g_dAxiAdcSimData[0][3]; }
+double axiAdc0Data4(void) { return g_dAxiAdcSimData[0][4]; }
+double axiAdc0Data5(void) { return g_dAxiAdcSimData[0][5]; }
+double axiAdc0Data6(void) { return g_dAxiAdcSimData[0][6]; }
+double axiAdc0Data7(void) { return g_dAxiAdcSimData[0][7]; }
+double axiAdc0Data8(void) { return g_dAxiAdcSimData[0][8]; }
+double axiAdc0Data9(void) { return g_dAxiAdcSimData[0][9]; }
+
+UINT32 axiAdc1DacCtrlRead(void) {
+	return g_dwAxiAdcSimDacCtrl;
+}
+
+STATUS axiAdc1DacCtrlWrite(UINT32 dwVal) {
+	g_dwAxiAdcSimDacCtrl = dwVal;
+	
+	return OK;
+}
+
+UINT32 axiAdc1DacCh(void) {
+	return g_dwAxiAdcSimDacCtrl & 0xF;
+}
+
+/* The DAC loops back to ADC1 channel 0 on the board. */
+double axiAdc1DacValue(void) {
+	return (double)(g_dwAxiAdcSimDacCtrl >> 16) * AXI_ADC1_DAC_DATA_GAIN;
+}
+
+double axiAdc1Data0(void) {
+	return axiAdc1DacValue();
+}
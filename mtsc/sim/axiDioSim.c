@@ -0,0 +1,81 @@
+#include <vxWorks.h>
+#include <taskLib.h>
+#include <time.h>
+
+#include "../drv/axiDio.h"
+
+/*
+ * In-process stand-in for the AXI DIO block. Registers are variables a
+ * test may poke through axiDioSimWrite(); the PPS interrupt is a task
+ * that calls the connected ISR on each whole second of CLOCK_MONOTONIC.
+ */
+#define AXI_DIO_SIM_PPS_TASK_NAME	"tAxiDioPps"
+#define AXI_DIO_SIM_PPS_PRIORITY	(50)
+#define AXI_DIO_SIM_PPS_STACK_SIZE	(16384)
+
+typedef enum {
+	AXI_DIO_SIM_DI_SYS,
+	AXI_DIO_SIM_DI_BIT,
+	AXI_DIO_SIM_DO_SYS,
+	AXI_DIO_SIM_PPS_CTRL,
+	AXI_DIO_SIM_PPS_ENABLE,
+	AXI_DIO_SIM_PPS_INT_STS,
+	AXI_DIO_SIM_REG_MAX
+} AxiDioSimReg;
+
+LOCAL volatile UINT32 g_dwAxiDioSimReg[AXI_DIO_SIM_REG_MAX];
+LOCAL void (*volatile g_pfnAxiDioSimPpsIsr)(PPS_ISR_ARG arg);
+LOCAL PPS_ISR_ARG g_axiDioSimPpsArg;
+LOCAL TASK_ID g_tidAxiDioSimPps = TASK_ID_NULL;
+
+LOCAL void axiDioSimPpsMain(void) {
+	void (*pfnIsr)(PPS_ISR_ARG arg);
+	struct timespec next;
+	
+	clock_gettime(CLOCK_MONOTONIC, &next);
+	
+	FOREVER {
+		next.tv_sec++;
+		next.tv_nsec = 0;
+		clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL);
+		
+		g_dwAxiDioSimReg[AXI_DIO_SIM_PPS_INT_STS] |= 1;
+		if ((pfnIsr = g_pfnAxiDioSimPpsIsr) != NULL)
+			pfnIsr(g_axiDioSimPpsArg);
+	}
+}
+
+STATUS axiDioSimWrite(UINT32 dwReg, UINT32 dwVal) {
+	if (dwReg >= AXI_DIO_SIM_REG_MAX)
+		return ERROR;
+	
+	g_dwAxiDioSimReg[dwReg] = dwVal;
+	
+	return OK;
+}
+
+UINT32 axiDioDiSysRead(void) { return g_dwAxiDioSimReg[AXI_DIO_SIM_DI_SYS]; }
+UINT32 axiDioDiBitRead(void) { return g_dwAxiDioSimReg[AXI_DIO_SIM_DI_BIT]; }
+UINT32 axiDioDoSysRead(void) { return g_dwAxiDioSimReg[AXI_DIO_SIM_DO_SYS]; }
+UINT32 axiDioPpsCtrlRead(void) { return g_dwAxiDioSimReg[AXI_DIO_SIM_PPS_CTRL]; }
+UINT32 axiDioPpsEnableRead(void) { return g_dwAxiDioSimReg[AXI_DIO_SIM_PPS_ENABLE]; }
+UINT32 axiDioPpsIntStsRead(void) { return g_dwAxiDioSimReg[AXI_DIO_SIM_PPS_INT_STS]; }
+
+STATUS axiDioSetPpsIsr(void (*pfnIsr)(PPS_ISR_ARG arg), PPS_ISR_ARG arg) {
+	g_axiDioSimPpsArg = arg;
+	g_pfnAxiDioSimPpsIsr = pfnIsr;
+	
+	if (g_tidAxiDioSimPps == TASK_ID_NULL) {
+		g_tidAxiDioSimPps = taskSpawn(AXI_DIO_SIM_PPS_TASK_NAME,
+									  AXI_DIO_SIM_PPS_PRIORITY, 0,
+									  AXI_DIO_SIM_PPS_STACK_SIZE,
+									  (FUNCPTR)axiDioSimPpsMain,
+									  0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+		if (g_tidAxiDioSimPps == TASK_ID_ERROR) {
+			g_tidAxiDioSimPps = TASK_ID_NULL;
+			return ERROR;
+		}
+	}
+	
+	return OK;
+}
@@ -0,0 +1,92 @@
+#include <vxWorks.h>
+#include <semLib.h>
+#include <string.h>
+
+#include "../drv/axiSdlc.h"
+
+/*
+ * In-process stand-in for the AXI SDLC controller. A test or benchmark
+ * hands a received frame to axiSdlcSimInject(); the driver interface then
+ * behaves as if the frame had arrived on the wire.
+ */
+#define AXI_SDLC_SIM_CH_NUM		(4)
+#define AXI_SDLC_SIM_BUF_SIZE	(4096)
+
+typedef struct {
+	SEM_ID	sidRx;
+	SEM_ID	sidLock;
+	int		rxLen;
+	UINT32	rxCrcCnt;
+	UINT8	rxBuf[AXI_SDLC_SIM_BUF_SIZE];
+} AxiSdlcSimCh;
+
+LOCAL AxiSdlcSimCh g_stAxiSdlcSimCh[AXI_SDLC_SIM_CH_NUM];
+
+LOCAL AxiSdlcSimCh *getCh(int ch) {
+	AxiSdlcSimCh *pCh;
+	
+	if ((ch < 0) || (ch >= AXI_SDLC_SIM_CH_NUM))
+		return NULL;
+	
+	pCh = &g_stAxiSdlcSimCh[ch];
+	if (pCh->sidRx == SEM_ID_NULL) {
+		pCh->sidRx = semBCreate(SEM_Q_FIFO, SEM_EMPTY);
+		pCh->sidLock = semMCreate(SEM_Q_PRIORITY);
+	}
+	
+	return pCh;
+}
+
+STATUS axiSdlcGetRxSemaphore(int ch, SEM_ID *pSid) {
+	AxiSdlcSimCh *pCh = getCh(ch);
+	
+	if ((pCh == NULL) || (pSid == NULL))
+		return ERROR;
+	
+	*pSid = pCh->sidRx;
+	
+	return OK;
+}
+
+int axiSdlcGetRxLen(int ch) {
+	AxiSdlcSimCh *pCh = getCh(ch);
+	
+	return (pCh == NULL) ? 0 : pCh->rxLen;
+}
+
+void *axiSdlcGetRxBuf(int ch) {
+	AxiSdlcSimCh *pCh = getCh(ch);
+	
+	return (pCh == NULL) ? NULL : pCh->rxBuf;
+}
+
+UINT32 axiSdlcGetRxCrcCnt(int ch) {
+	AxiSdlcSimCh *pCh = getCh(ch);
+	
+	return (pCh == NULL) ? 0 : pCh->rxCrcCnt;
+}
+
+STATUS axiSdlcSimInject(int ch, const void *pBuf, int len) {
+	AxiSdlcSimCh *pCh = getCh(ch);
+	
+	if ((pCh == NULL) || (pBuf == NULL) || (len < 0) || (len > AXI_SDLC_SIM_BUF_SIZE))
+		return ERROR;
+	
+	semTake(pCh->sidLock, WAIT_FOREVER);
+	memcpy(pCh->rxBuf, pBuf, len);
+	pCh->rxLen = len;
+	semGive(pCh->sidLock);
+	
+	return semGive(pCh->sidRx);
+}
+
+STATUS axiSdlcSimInjectCrcErr(int ch) {
+	AxiSdlcSimCh *pCh = getCh(ch);
+	
+	if (pCh == NULL)
+		return ERROR;
+	
+	pCh->rxCrcCnt++;
+	
+	return OK;
+}
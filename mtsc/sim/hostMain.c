@@ -0,0 +1,82 @@
+#include <vxWorks.h>
+#include <taskLib.h>
+#include <sysLib.h>
+#include <signal.h>
+#include <stdio.h>
+
+#include "../lib/util/isDebug.h"
+#include "../lib/util/ModuleCommon.h"
+#include "../app/CmdExec.h"
+#include "../app/Monitoring.h"
+#include "../app/SdlcRecvGcu.h"
+#include "../app/SimHotStart.h"
+
+/*
+ * Linux entry point for the host build. The modules are spawned the way
+ * the target start-up script does, then run until SIGINT or SIGTERM.
+ * Build every source under app, lib/util, port/posix and sim with
+ * -D_GNU_SOURCE -I port/posix, and link with -rdynamic -lpthread -ldl -lm
+ * so findFunc() can resolve command names through dlsym().
+ */
+#define HOST_TASK_PRIORITY		(100)
+#define HOST_TASK_STACK_SIZE	(100000)
+
+typedef struct {
+	char *		name;
+	void		(*entry)(ModuleInst *pModuleInst);
+	const ModuleInst * const *phModule;
+	int			startCmd;
+	int			quitCmd;
+} HostModule;
+
+LOCAL const HostModule g_stHostModules[] = {
+	{ SDLC_RECV_GCU_TASK_NAME,	SdlcRecvGcuMain,	&g_hSdlcRecvGcu,	SDLC_RECV_GCU_START,	SDLC_RECV_GCU_QUIT },
+	{ SIM_HOTSTART_TASK_NAME,	SimHotStartMain,	&g_hSimHotStart,	SIM_HOTSTART_NULL,		SIM_HOTSTART_QUIT },
+	{ MONITORING_TASK_NAME,		MonitoringMain,		&g_hMonitoring,		MONITORING_START,		MONITORING_QUIT },
+	{ CMD_EXEC_TASK_NAME,		CmdExecMain,		&g_hCmdExec,		CMD_EXEC_START,			CMD_EXEC_QUIT },
+};
+
+int main(int argc, char *argv[]) {
+	const HostModule *pModule;
+	sigset_t sigSet;
+	int sig;
+	int i;
+	
+	/* Block the stop signals before any task exists so only sigwait() sees them. */
+	sigemptyset(&sigSet);
+	sigaddset(&sigSet, SIGINT);
+	sigaddset(&sigSet, SIGTERM);
+	pthread_sigmask(SIG_BLOCK, &sigSet, NULL);
+	
+	for (i = 0; i < NELEMENTS(g_stHostModules); i++) {
+		pModule = &g_stHostModules[i];
+		if (taskSpawn(pModule->name, HOST_TASK_PRIORITY, VX_FP_TASK,
+					  HOST_TASK_STACK_SIZE, (FUNCPTR)pModule->entry,
+					  (_Vx_usr_arg_t)*pModule->phModule,
+					  0, 0, 0, 0, 0, 0, 0, 0, 0) == TASK_ID_ERROR) {
+			LOGMSG("taskSpawn(%s) error!\n", pModule->name);
+			return 1;
+		}
+	}
+	
+	/* Let each module create its message queue before the first post. */
+	taskDelay(sysClkRateGet() / 10);
+	
+	for (i = 0; i < NELEMENTS(g_stHostModules); i++) {
+		pModule = &g_stHostModules[i];
+		if (pModule->startCmd != 0)
+			PostCmd(*pModule->phModule, pModule->startCmd);
+	}
+	
+	LOGMSG("mtsc host build running, Ctrl-C to quit.\n");
+	sigwait(&sigSet, &sig);
+	
+	for (i = (int)NELEMENTS(g_stHostModules) - 1; i >= 0; i--) {
+		pModule = &g_stHostModules[i];
+		PostCmd(*pModule->phModule, pModule->quitCmd);
+	}
+	
+	taskDelay(sysClkRateGet() / 10);
+	
+	return 0;
+}
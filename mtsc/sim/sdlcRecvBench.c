@@ -0,0 +1,76 @@
+#include <vxWorks.h>
+#include <taskLib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "../lib/util/isClock.h"
+#include "../app/SdlcRecvGcu.h"
+#include "../app/LogSend.h"
+#include "../app/TmWait.h"
+#include "../app/FrameRing.h"
+
+/*
+ * Host benchmark of the SDLC receive path. GF2 frames are injected through
+ * the AXI SDLC stand-in one at a time while tSdlcRecvGcu is running, and
+ * each is waited for before the next goes in. The ring counters give the
+ * bytes copied per frame; the copy path it replaced is shown next to it.
+ */
+#define SDLC_RECV_BENCH_TIMEOUT_NS	(1000000000ULL)
+
+IMPORT STATUS axiSdlcSimInject(int ch, const void *pBuf, int len);
+
+void sdlcRecvBench(int numFrames) {
+	TM_TYPE_GF2 stFrame;
+	FrameRingStats stStart, stEnd;
+	UINT32 seq;
+	UINT64 tStart, tFrame, tElapsed;
+	int frameLen = sizeof(TM_TYPE_GF2);
+	int postLen = frameLen + OFFSET(LOG_DATA, formatted.body);
+	int numDone;
+	double dFrames;
+	
+	if (numFrames <= 0)
+		numFrames = 10000;
+	
+	memset(&stFrame, 0, sizeof(stFrame));
+	stFrame.m_ADDRESS = TM_SDLC_ADDRESS;
+	stFrame.m_CONTROL = TM_GF2_SDLC_CONTROL;
+	
+	FrameRingStatsGet(TM_WAIT_SRC_GF2, &stStart);
+	tStart = isClockNs();
+	
+	for (numDone = 0; numDone < numFrames; numDone++) {
+		seq = TmWaitSeq(TM_WAIT_SRC_GF2);
+		if (axiSdlcSimInject(0, &stFrame, frameLen) == ERROR) {
+			printf("axiSdlcSimInject() error!\n");
+			break;
+		}
+		
+		tFrame = isClockNs();
+		while (TmWaitSeq(TM_WAIT_SRC_GF2) == seq) {
+			if (isClockNs() - tFrame > SDLC_RECV_BENCH_TIMEOUT_NS)
+				break;
+			taskDelay(0);
+		}
+		
+		if (TmWaitSeq(TM_WAIT_SRC_GF2) == seq) {
+			printf("frame %d not received; is %s started?\n",
+				   numDone, SDLC_RECV_GCU_TASK_NAME);
+			break;
+		}
+	}
+	
+	tElapsed = isClockNs() - tStart;
+	FrameRingStatsGet(TM_WAIT_SRC_GF2, &stEnd);
+	
+	if (numDone == 0)
+		return;
+	
+	dFrames = stEnd.numFrames - stStart.numFrames;
+	printf(" frames           : %d in %u us\n", numDone, isClockNsToUs(tElapsed));
+	printf(" frames/s         : %.0f\n", numDone * 1e9 / tElapsed);
+	printf(" bytes/frame      : %.1f (copy path %d)\n",
+		   dFrames ? (stEnd.bytesCopied - stStart.bytesCopied) / dFrames : 0.0,
+		   frameLen + frameLen + postLen);
+	printf(" slot overruns    : %u\n", stEnd.numOverruns - stStart.numOverruns);
+}